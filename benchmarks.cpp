@@ -0,0 +1,435 @@
+// Google Benchmark suite for the storage, search, command and backup paths.
+//
+// Each benchmark runs against synthetic catalogs of 10k, 1M and 10M album records
+// (with a quarter as many artists) written by generateSyntheticCatalog. Catalogs are
+// generated on first use under bench_data/ (or $ALBUM_BENCH_DATA) and reused by later runs. Pick a size with
+// --benchmark_filter, e.g. --benchmark_filter='/10000(/|$)'.
+
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include "manager.h"
+
+namespace {
+
+const std::int64_t CATALOG_SIZES[] = {10000, 1000000, 10000000};
+
+struct LoadedCatalog {
+    std::int64_t records = 0;
+    std::string directory;
+    std::fstream artistFile;
+    std::fstream albumFile;
+    artistList artists;
+    albumList albums;
+    indexSet deletedArtists;
+    indexSet deletedAlbums;
+};
+
+std::unique_ptr<LoadedCatalog> currentCatalog;
+
+std::string benchDataRoot() {
+    const char* root = std::getenv("ALBUM_BENCH_DATA");
+    return root != nullptr && *root != '\0' ? root : "bench_data";
+}
+
+// Generates the catalog for `records` albums unless a finished copy with the same settings
+// is already on disk, and returns its directory.
+std::string ensureCatalog(std::int64_t records) {
+    std::string directory = benchDataRoot() + "/catalog_" + std::to_string(records);
+    if (prepareSyntheticCatalogDirectory(directory, records, &std::cerr).empty()) {
+        std::cerr << "Catalog generation failed" << std::endl;
+        std::exit(1);
+    }
+    return directory;
+}
+
+// Points the configuration at the catalog for `records` albums and returns its loaded
+// index. Only one catalog stays resident so the 10M index is not kept alongside the others.
+LoadedCatalog& useCatalog(std::int64_t records) {
+    if (currentCatalog && currentCatalog->records == records) {
+        return *currentCatalog;
+    }
+    currentCatalog.reset();
+    auto catalog = std::make_unique<LoadedCatalog>();
+    catalog->records = records;
+    catalog->directory = ensureCatalog(records);
+    loadApplicationConfig(catalog->directory + "/config.json");
+    loadArtist(catalog->artistFile, catalog->artists, catalog->deletedArtists);
+    loadAlbum(catalog->albumFile, catalog->albums, catalog->deletedAlbums);
+    currentCatalog = std::move(catalog);
+    return *currentCatalog;
+}
+
+std::int64_t fileBytes(const std::string& path) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    return ec ? 0 : static_cast<std::int64_t>(size);
+}
+
+void catalogSizes(benchmark::internal::Benchmark* bench) {
+    for (std::int64_t size : CATALOG_SIZES) {
+        bench->Arg(size);
+    }
+    bench->Unit(benchmark::kMillisecond);
+}
+
+// Sends the application's console output (prompts, progress lines, the blank line
+// openFile prints) to /dev/null while the benchmarks run.
+class CoutSilencer {
+public:
+    CoutSilencer() : previous_(std::cout.rdbuf(sink_.rdbuf())) {}
+    ~CoutSilencer() { std::cout.rdbuf(previous_); }
+
+private:
+    std::ofstream sink_{"/dev/null"};
+    std::streambuf* previous_;
+};
+
+// Undoing an add leaves its tombstoned slot at the end of the file; trim the file back so
+// the cached catalog stays identical between runs.
+void trimRecordFile(std::fstream& stream, const std::string& path, RecordKind kind, std::int64_t originalBytes) {
+    stream.close();
+    if (fileBytes(path) > originalBytes) {
+        std::filesystem::resize_file(path, static_cast<std::uintmax_t>(originalBytes));
+    }
+    openRecordFile(stream, path, kind);
+}
+
+// Generation
+
+void BM_GenerateCatalog(benchmark::State& state) {
+    std::string directory = benchDataRoot() + "/generate_scratch";
+    std::filesystem::create_directories(directory);
+    CatalogGeneratorSettings settings;
+    settings.artists = state.range(0) / 4;
+    settings.albums = state.range(0);
+    CatalogGeneratorReport report;
+    for (auto _ : state) {
+        if (!generateSyntheticCatalog(directory + "/Artist.bin", directory + "/Album.bin", settings, &report)) {
+            state.SkipWithError("generation failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (report.artistSlots + report.albumSlots));
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(report.bytesWritten));
+    std::filesystem::remove_all(directory);
+}
+BENCHMARK(BM_GenerateCatalog)->Apply(catalogSizes);
+
+// Load
+
+void BM_LoadArtists(benchmark::State& state) {
+    LoadedCatalog& catalog = useCatalog(state.range(0));
+    for (auto _ : state) {
+        std::fstream file;
+        artistList artists;
+        indexSet deleted;
+        benchmark::DoNotOptimize(loadArtist(file, artists, deleted));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(catalog.artists.artList.size()));
+    state.SetBytesProcessed(state.iterations() * fileBytes(artistFilePath));
+}
+BENCHMARK(BM_LoadArtists)->Apply(catalogSizes);
+
+void BM_LoadAlbums(benchmark::State& state) {
+    LoadedCatalog& catalog = useCatalog(state.range(0));
+    for (auto _ : state) {
+        std::fstream file;
+        albumList albums;
+        indexSet deleted;
+        benchmark::DoNotOptimize(loadAlbum(file, albums, deleted));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(catalog.albums.albList.size()));
+    state.SetBytesProcessed(state.iterations() * fileBytes(albumFilePath));
+}
+BENCHMARK(BM_LoadAlbums)->Apply(catalogSizes);
+
+// Search
+
+void BM_SearchArtistById(benchmark::State& state) {
+    LoadedCatalog& catalog = useCatalog(state.range(0));
+    std::string target = catalog.artists.artList[catalog.artists.artList.size() / 2].artistId;
+    indexSet result;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(searchArtistById(catalog.artists, result, target));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(catalog.artists.artList.size()));
+}
+BENCHMARK(BM_SearchArtistById)->Apply(catalogSizes);
+
+void BM_SearchArtistByName(benchmark::State& state) {
+    LoadedCatalog& catalog = useCatalog(state.range(0));
+    indexSet result;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(searchArtistByName(catalog.artists, result, "sa"));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(catalog.artists.artList.size()));
+}
+BENCHMARK(BM_SearchArtistByName)->Apply(catalogSizes);
+
+void BM_SearchAlbumByArtistId(benchmark::State& state) {
+    LoadedCatalog& catalog = useCatalog(state.range(0));
+    std::string target = catalog.albums.albList[catalog.albums.albList.size() / 2].artistId;
+    indexSet result;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(searchAlbumByArtistId(catalog.albumFile, catalog.albums, result, target));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(catalog.albums.albList.size()));
+}
+BENCHMARK(BM_SearchAlbumByArtistId)->Apply(catalogSizes);
+
+void BM_SearchAlbumByTitle(benchmark::State& state) {
+    LoadedCatalog& catalog = useCatalog(state.range(0));
+    indexSet result;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(searchAlbumByTitle(catalog.albumFile, catalog.albums, result, "Love"));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(catalog.albums.albList.size()));
+}
+BENCHMARK(BM_SearchAlbumByTitle)->Apply(catalogSizes);
+
+void BM_SearchAlbumByDateRange(benchmark::State& state) {
+    LoadedCatalog& catalog = useCatalog(state.range(0));
+    indexSet result;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(searchAlbumByDateRange(catalog.albumFile, catalog.albums, result, 1, 1, 1990, 31, 12, 1999));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(catalog.albums.albList.size()));
+}
+BENCHMARK(BM_SearchAlbumByDateRange)->Apply(catalogSizes);
+
+// Aggregate queries: second argument is the worker count, 0 for every core.
+
+void BM_AggregateTopArtists(benchmark::State& state) {
+    LoadedCatalog& catalog = useCatalog(state.range(0));
+    AggregateQuery query;
+    query.byArtist = true;
+    query.topK = 20;
+    query.threads = static_cast<unsigned>(state.range(1));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(runAggregateQuery(catalog.albums, query));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(catalog.albums.albList.size()));
+}
+BENCHMARK(BM_AggregateTopArtists)
+    ->ArgsProduct({{CATALOG_SIZES[0], CATALOG_SIZES[1], CATALOG_SIZES[2]}, {1, 0}})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_AggregateFormatShareByYear(benchmark::State& state) {
+    LoadedCatalog& catalog = useCatalog(state.range(0));
+    AggregateQuery query;
+    query.byYear = true;
+    query.byFormat = true;
+    query.threads = static_cast<unsigned>(state.range(1));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(runAggregateQuery(catalog.albums, query));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(catalog.albums.albList.size()));
+}
+BENCHMARK(BM_AggregateFormatShareByYear)
+    ->ArgsProduct({{CATALOG_SIZES[0], CATALOG_SIZES[1], CATALOG_SIZES[2]}, {1, 0}})
+    ->Unit(benchmark::kMillisecond);
+
+// Commands: each iteration applies the change and undoes it, so the catalog is unchanged.
+
+void BM_AddArtistWithUndo(benchmark::State& state) {
+    LoadedCatalog& catalog = useCatalog(state.range(0));
+    std::int64_t originalBytes = fileBytes(artistFilePath);
+    Artist art;
+    art.setName("Benchmark Artist");
+    art.setGender('F');
+    art.setPhone("0911000000");
+    art.setEmail("bench@example.com");
+    for (auto _ : state) {
+        if (!addArtistRecord(catalog.artistFile, catalog.artists, art) || !undoLastAction()) {
+            state.SkipWithError("add/undo failed");
+            break;
+        }
+    }
+    trimRecordFile(catalog.artistFile, artistFilePath, RecordKind::Artist, originalBytes);
+}
+BENCHMARK(BM_AddArtistWithUndo)->Apply(catalogSizes);
+
+void BM_EditArtistWithUndo(benchmark::State& state) {
+    LoadedCatalog& catalog = useCatalog(state.range(0));
+    Artist updated;
+    updated.setName("Edited Artist");
+    updated.setGender('M');
+    updated.setPhone("0911000001");
+    updated.setEmail("edited@example.com");
+    for (auto _ : state) {
+        int idx = static_cast<int>(catalog.artists.artList.size() / 2);
+        if (!editArtistRecord(catalog.artistFile, catalog.artists, idx, updated) || !undoLastAction()) {
+            state.SkipWithError("edit/undo failed");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_EditArtistWithUndo)->Apply(catalogSizes);
+
+void BM_DeleteArtistWithUndo(benchmark::State& state) {
+    LoadedCatalog& catalog = useCatalog(state.range(0));
+    for (auto _ : state) {
+        int idx = static_cast<int>(catalog.artists.artList.size() / 2);
+        if (!removeArtistRecord(catalog.artistFile, catalog.albumFile, catalog.artists, catalog.albums,
+                                catalog.deletedArtists, catalog.deletedAlbums, idx) || !undoLastAction()) {
+            state.SkipWithError("delete/undo failed");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_DeleteArtistWithUndo)->Apply(catalogSizes);
+
+// Export
+
+void BM_ExportArtistsCsv(benchmark::State& state) {
+    LoadedCatalog& catalog = useCatalog(state.range(0));
+    std::string output = catalog.directory + "/artists.csv";
+    for (auto _ : state) {
+        exportArtistsToCSV(catalog.artists, output);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(catalog.artists.artList.size()));
+    state.SetBytesProcessed(state.iterations() * fileBytes(output));
+    std::filesystem::remove(output);
+}
+BENCHMARK(BM_ExportArtistsCsv)->Apply(catalogSizes);
+
+void BM_ExportAlbumsCsv(benchmark::State& state) {
+    LoadedCatalog& catalog = useCatalog(state.range(0));
+    std::string output = catalog.directory + "/albums.csv";
+    for (auto _ : state) {
+        exportAlbumsToCSV(catalog.albums, output);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(catalog.albums.albList.size()));
+    state.SetBytesProcessed(state.iterations() * fileBytes(output));
+    std::filesystem::remove(output);
+}
+BENCHMARK(BM_ExportAlbumsCsv)->Apply(catalogSizes);
+
+void BM_ExportAlbumsColumnar(benchmark::State& state) {
+    LoadedCatalog& catalog = useCatalog(state.range(0));
+    std::string output = catalog.directory + "/albums.alcol";
+    for (auto _ : state) {
+        writeAlbumsColumnar(catalog.albums, albumFilePath, output);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(catalog.albums.albList.size()));
+    state.SetBytesProcessed(state.iterations() * fileBytes(output));
+    std::filesystem::remove(output);
+}
+BENCHMARK(BM_ExportAlbumsColumnar)->Apply(catalogSizes);
+
+void BM_ExportAlbumsJsonl(benchmark::State& state) {
+    LoadedCatalog& catalog = useCatalog(state.range(0));
+    std::string output = catalog.directory + "/albums.jsonl";
+    for (auto _ : state) {
+        writeAlbumsJsonl(catalog.albums, albumFilePath, output);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(catalog.albums.albList.size()));
+    state.SetBytesProcessed(state.iterations() * fileBytes(output));
+    std::filesystem::remove(output);
+}
+BENCHMARK(BM_ExportAlbumsJsonl)->Apply(catalogSizes);
+
+// Backup and restore
+
+void BM_BackupAlbums(benchmark::State& state) {
+    LoadedCatalog& catalog = useCatalog(state.range(0));
+    std::string snapshot = catalog.directory + "/backups/Album.bench.bin";
+    for (auto _ : state) {
+        if (!copyFileContents(albumFilePath, snapshot)) {
+            state.SkipWithError("copy failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * fileBytes(albumFilePath));
+    std::filesystem::remove(snapshot);
+}
+BENCHMARK(BM_BackupAlbums)->Apply(catalogSizes);
+
+void BM_RestoreAlbums(benchmark::State& state) {
+    LoadedCatalog& catalog = useCatalog(state.range(0));
+    std::string snapshot = catalog.directory + "/backups/Album.bench.bin";
+    std::string staged = catalog.directory + "/backups/Album.bench.staged";
+    copyFileContents(albumFilePath, snapshot);
+    for (auto _ : state) {
+        albumList albums;
+        indexSet deleted;
+        if (!stageRestoredRecords(snapshot, staged, albums, deleted)) {
+            state.SkipWithError("restore failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(catalog.albums.albList.size()));
+    state.SetBytesProcessed(state.iterations() * fileBytes(snapshot));
+    std::filesystem::remove(snapshot);
+    std::filesystem::remove(staged);
+}
+BENCHMARK(BM_RestoreAlbums)->Apply(catalogSizes);
+
+// Checksums
+
+void BM_ChecksumAlbums(benchmark::State& state) {
+    useCatalog(state.range(0));
+    auto algorithm = static_cast<ChecksumAlgorithm>(state.range(1));
+    state.SetLabel(checksumEngine(algorithm).name());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(computeFileChecksum(albumFilePath, algorithm));
+    }
+    state.SetBytesProcessed(state.iterations() * fileBytes(albumFilePath));
+}
+BENCHMARK(BM_ChecksumAlbums)
+    ->ArgsProduct({{CATALOG_SIZES[0], CATALOG_SIZES[1], CATALOG_SIZES[2]},
+                   {static_cast<std::int64_t>(ChecksumAlgorithm::Fnv1a32),
+                    static_cast<std::int64_t>(ChecksumAlgorithm::Crc32c),
+                    static_cast<std::int64_t>(ChecksumAlgorithm::XxHash64)}})
+    ->Unit(benchmark::kMillisecond);
+
+// Record decoding
+
+void BM_DecodeAlbumRecords(benchmark::State& state) {
+    LoadedCatalog& catalog = useCatalog(CATALOG_SIZES[0]);
+    auto path = static_cast<RecordDecoderPath>(state.range(0));
+    state.SetLabel(path == RecordDecoderPath::Simd && simdRecordDecoderAvailable() ? "simd" : "scalar");
+    std::vector<AlbumFile> records(catalog.albums.albList.size());
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        readRecordAt(catalog.albumFile, catalog.albums.albList[i].pos, records[i]);
+    }
+    std::vector<AlbumFile> scratch(records.size());
+    AlbumFieldLengths lengths;
+    for (auto _ : state) {
+        scratch = records;
+        for (AlbumFile& record : scratch) {
+            decodeRecord(record, lengths, path);
+            benchmark::DoNotOptimize(lengths);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(records.size()));
+}
+BENCHMARK(BM_DecodeAlbumRecords)
+    ->Arg(static_cast<std::int64_t>(RecordDecoderPath::Scalar))
+    ->Arg(static_cast<std::int64_t>(RecordDecoderPath::Simd))
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    std::ostream results(std::cout.rdbuf());
+    benchmark::ConsoleReporter reporter(benchmark::ConsoleReporter::OO_None);
+    reporter.SetOutputStream(&results);
+    reporter.SetErrorStream(&std::cerr);
+    {
+        CoutSilencer silence;
+        benchmark::RunSpecifiedBenchmarks(&reporter);
+        currentCatalog.reset();
+    }
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file catalog_generate.cpp
+ * @brief Writes synthetic Artist.bin/Album.bin files for benchmarks and soak tests.
+ *
+ * Usage: album_catalog_generate [options]
+ *   --artists N          live artist records (default 1000)
+ *   --albums N           live album records (default 4000)
+ *   --seed N             random seed; equal settings give identical files (default 1)
+ *   --zipf S             skew of albums per artist, 0 for uniform (default 1.1)
+ *   --max-title-words N  longest album title in words (default 8)
+ *   --years FIRST-LAST   publication year range (default 1960-2024)
+ *   --tombstones R       fraction of deleted slots in each file (default 0)
+ *   --out DIR            output directory (default: current directory)
+ */
+
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include "manager.h"
+
+namespace {
+
+void printUsage()
+{
+    std::cerr << "Usage: album_catalog_generate [--artists N] [--albums N] [--seed N] [--zipf S]\n"
+                 "                              [--max-title-words N] [--years FIRST-LAST]\n"
+                 "                              [--tombstones R] [--out DIR]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    CatalogGeneratorSettings settings;
+    std::string outDir = ".";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 2;
+        }
+        std::string value = argv[++i];
+        try {
+            if (arg == "--artists") {
+                settings.artists = std::stoll(value);
+            } else if (arg == "--albums") {
+                settings.albums = std::stoll(value);
+            } else if (arg == "--seed") {
+                settings.seed = std::stoull(value);
+            } else if (arg == "--zipf") {
+                settings.zipfExponent = std::stod(value);
+            } else if (arg == "--max-title-words") {
+                settings.maxTitleWords = static_cast<unsigned>(std::stoul(value));
+            } else if (arg == "--years") {
+                std::size_t dash = value.find('-');
+                if (dash == std::string::npos) {
+                    throw std::invalid_argument(value);
+                }
+                settings.firstYear = std::stoi(value.substr(0, dash));
+                settings.lastYear = std::stoi(value.substr(dash + 1));
+            } else if (arg == "--tombstones") {
+                settings.tombstoneRatio = std::stod(value);
+            } else if (arg == "--out") {
+                outDir = value;
+            } else {
+                printUsage();
+                return 2;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << value << std::endl;
+            return 2;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(outDir, ec);
+    std::string artistPath = (std::filesystem::path(outDir) / "Artist.bin").string();
+    std::string albumPath = (std::filesystem::path(outDir) / "Album.bin").string();
+
+    CatalogGeneratorReport report;
+    if (!generateSyntheticCatalog(artistPath, albumPath, settings, &report)) {
+        std::cerr << "Failed to generate catalog in " << outDir << std::endl;
+        return 1;
+    }
+    double megabytes = static_cast<double>(report.bytesWritten) / (1024.0 * 1024.0);
+    std::cout << artistPath << ": " << report.artistSlots << " slots (" << report.artistTombstones << " deleted)\n"
+              << albumPath << ": " << report.albumSlots << " slots (" << report.albumTombstones << " deleted)\n"
+              << megabytes << " MB in " << report.seconds << " s ("
+              << (report.seconds > 0.0 ? megabytes / report.seconds : 0.0) << " MB/s)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,37 @@
+/**
+ * @file log_decode.cpp
+ * @brief Offline decoder for binary logs (logFormat "binary" in config.json).
+ *
+ * Usage: album_log_decode [album_system.logb] [output.log]
+ * Without an output file the text lines are written to standard output.
+ */
+
+#include <fstream>
+#include <iostream>
+#include "manager.h"
+
+int main(int argc, char* argv[])
+{
+    std::string inputPath = argc > 1 ? argv[1] : Logger::BINARY_LOG_FILE;
+    std::ifstream in(inputPath, std::ios::binary);
+    if (!in) {
+        std::cerr << "Cannot open " << inputPath << std::endl;
+        return 2;
+    }
+    bool ok;
+    if (argc > 2) {
+        std::ofstream out(argv[2]);
+        if (!out) {
+            std::cerr << "Cannot create " << argv[2] << std::endl;
+            return 2;
+        }
+        ok = decodeBinaryLog(in, out);
+    } else {
+        ok = decodeBinaryLog(in, std::cout);
+    }
+    if (!ok) {
+        std::cerr << inputPath << ": not a binary log or damaged record; output stops there" << std::endl;
+        return 1;
+    }
+    return 0;
+}
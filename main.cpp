@@ -10,16 +10,76 @@
 using namespace std;
 #include <conio.h>
 #include <fstream>
+#include <cstdlib>
 #include "manager.h"
 
 /**
  * @brief Main entry point of the application.
+ *
+ * Passing --scrub migrates and verifies the data files without starting the UI;
+ * --import [--artists FILE] [--albums FILE] bulk-loads CSV or JSON files the same way and
+ * --export-columnar FILE writes the albums in the columnar analytics format.
+ * @param argc Argument count.
+ * @param argv Argument values.
  * @return Exit status (0 for success).
  */
-int main()
+int main(int argc, char* argv[])
 {
     loadApplicationConfig("config.json");
 
+    if (argc > 1 && std::string(argv[1]) == "--scrub") {
+        try {
+            fstream artistStream, albumStream;
+            openRecordFile(artistStream, artistFilePath, RecordKind::Artist);
+            openRecordFile(albumStream, albumFilePath, RecordKind::Album);
+        } catch (const FileException& e) {
+            cout << e.what() << endl;
+            return 2;
+        }
+        return scrubDataFiles(true) ? 0 : 1;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--import") {
+        std::string artistSource, albumSource;
+        for (int i = 2; i + 1 < argc; i += 2) {
+            std::string option = argv[i];
+            if (option == "--artists") {
+                artistSource = argv[i + 1];
+            } else if (option == "--albums") {
+                albumSource = argv[i + 1];
+            } else {
+                artistSource.clear();
+                albumSource.clear();
+                break;
+            }
+        }
+        if (artistSource.empty() && albumSource.empty()) {
+            cout << "Usage: " << argv[0] << " --import [--artists FILE] [--albums FILE]" << endl;
+            return 2;
+        }
+        ChangeJournal::instance().open(journalFile);
+        return importDataFiles(artistSource, albumSource) ? 0 : 1;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--export-columnar") {
+        if (argc != 3) {
+            cout << "Usage: " << argv[0] << " --export-columnar FILE" << endl;
+            return 2;
+        }
+        return exportColumnarDataFile(argv[2]) ? 0 : 1;
+    }
+
+    // Record every data file write so the backup menu can restore to a point in time
+    ChangeJournal::instance().open(journalFile);
+
+    // Sample memory periodically and publish metrics when config.json enables a file or port
+    const AppConfigSettings& settings = AppConfig::instance().settings();
+    MemoryProfiler::instance().start(settings.memorySampleSeconds);
+    MetricsExporter::instance().start({settings.metricsFile, settings.metricsPort, settings.metricsIntervalSeconds});
+#if ALBUM_TRACING
+    std::atexit([] { writeChromeTraceFile(AppConfig::instance().settings().traceFile); });
+#endif
+
     // Create repository instances
     auto artistRepo = std::make_unique<FileArtistRepository>(artistFilePath);
     auto albumRepo = std::make_unique<FileAlbumRepository>(albumFilePath);
@@ -38,6 +98,10 @@ int main()
     // Load data using managers
     if(!artistManager.load(ArtFile) || !albumManager.load(AlbFile))
         return 0;
+
+    if (!scrubDataFiles(false)) {
+        system("pause");
+    }
         
     // Convert to old format for compatibility with existing functions
     artistList artist = artistManager.getArtists();
@@ -18,18 +18,47 @@
 #include <algorithm>
 #include <functional>
 #include <stack>
+#include <deque>
 #include <cctype>
 #include <cstdio>
 #include <sstream>
 #include <chrono>
 #include <cerrno>
 #include <cstdint>
+#include <cmath>
+#include <numeric>
+#include <charconv>
 #include <array>
 #include <mutex>
+#include <thread>
+#include <unordered_set>
 #include <sys/stat.h>
 #ifdef _WIN32
 #include <direct.h>
 #include <Windows.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#endif
+#ifdef ALBUM_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <linux/fs.h>
+#endif
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#include <nmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#define ALBUM_HAVE_CRC32C_INSTRUCTION 1
+#define ALBUM_HAVE_SIMD_RECORD_DECODER 1
 #endif
 #include "manager.h"
 #include "version.h"
@@ -37,12 +66,12 @@
 using namespace std;
 
 int lastArtistID = 999, lastAlbumID = 1999;
-Logger* Logger::instance = nullptr;
 
 const ConfigValue artistFilePath(getArtistFilePath);
 const ConfigValue albumFilePath(getAlbumFilePath);
 const ConfigValue backupDirectory(getBackupDirectory);
 const ConfigValue backupIndexFile(getBackupIndexFile);
+const ConfigValue journalFile(getJournalFile);
 
 AppConfig::AppConfig() {
     resetToDefaults();
@@ -58,6 +87,20 @@ void AppConfig::resetToDefaults() {
     values.albumFile = "Album.bin";
     values.backupDirectory = "backups";
     values.backupIndexFile = "backups/index.csv";
+    values.journalFile = "backups/journal.bin";
+    values.logLevel = "info";
+    values.logFormat = "text";
+    values.logMaxSizeMB = 10;
+    values.logRotateHours = 24;
+    values.logRetention = 5;
+    values.logCompress = false;
+    values.metricsFile.clear();
+    values.metricsPort = 0;
+    values.metricsIntervalSeconds = 15;
+    values.memorySampleSeconds = 60;
+    values.traceFile = "album_trace.json";
+    values.pageRows = 20;
+    values.recordCacheEntries = 4096;
     applyDerivedDefaults();
 }
 
@@ -69,6 +112,13 @@ void AppConfig::applyDerivedDefaults() {
             values.backupIndexFile = values.backupDirectory + "/index.csv";
         }
     }
+    if (values.journalFile.empty()) {
+        if (values.backupDirectory.empty()) {
+            values.journalFile = "journal.bin";
+        } else {
+            values.journalFile = values.backupDirectory + "/journal.bin";
+        }
+    }
 }
 
 const AppConfigSettings& AppConfig::settings() const {
@@ -85,10 +135,18 @@ std::string AppConfig::extractValue(const std::string& content, const std::strin
     if (colonPos == std::string::npos) {
         return "";
     }
-    auto firstQuote = content.find('"', colonPos);
-    if (firstQuote == std::string::npos) {
+    auto valuePos = content.find_first_not_of(" \t\r\n", colonPos + 1);
+    if (valuePos == std::string::npos) {
         return "";
     }
+    if (content[valuePos] != '"') {
+        // Unquoted number or boolean: runs to the next separator.
+        auto valueEnd = content.find_first_of(",}\r\n", valuePos);
+        std::string value = content.substr(valuePos, valueEnd == std::string::npos ? std::string::npos : valueEnd - valuePos);
+        auto last = value.find_last_not_of(" \t");
+        return last == std::string::npos ? "" : value.substr(0, last + 1);
+    }
+    auto firstQuote = valuePos;
     auto secondQuote = content.find('"', firstQuote + 1);
     if (secondQuote == std::string::npos) {
         return "";
@@ -99,7 +157,7 @@ std::string AppConfig::extractValue(const std::string& content, const std::strin
 void AppConfig::loadFromFile(const std::string& path) {
     std::ifstream config(path);
     if (!config) {
-        Logger::getInstance()->log("Configuration file not found: " + path + ", using defaults");
+        ALBUM_LOG_WARN("Configuration file not found: {}, using defaults", path);
         return;
     }
 
@@ -120,12 +178,46 @@ void AppConfig::loadFromFile(const std::string& path) {
     assignIfPresent("albumFile", values.albumFile);
     bool directoryUpdated = assignIfPresent("backupDirectory", values.backupDirectory);
     bool indexUpdated = assignIfPresent("backupIndexFile", values.backupIndexFile);
+    bool journalUpdated = assignIfPresent("journalFile", values.journalFile);
+    assignIfPresent("logLevel", values.logLevel);
+    assignIfPresent("logFormat", values.logFormat);
+    auto assignNumberIfPresent = [&](const std::string& key, auto& target) {
+        std::string value = extractValue(content, key);
+        if (value.empty()) {
+            return;
+        }
+        try {
+            long long number = std::stoll(value);
+            if (number >= 0) {
+                target = static_cast<std::remove_reference_t<decltype(target)>>(number);
+            }
+        } catch (...) {
+            ALBUM_LOG_WARN("Ignoring invalid {} value in configuration: {}", key, value);
+        }
+    };
+    assignNumberIfPresent("logMaxSizeMB", values.logMaxSizeMB);
+    assignNumberIfPresent("logRotateHours", values.logRotateHours);
+    assignNumberIfPresent("logRetention", values.logRetention);
+    assignIfPresent("metricsFile", values.metricsFile);
+    assignNumberIfPresent("metricsPort", values.metricsPort);
+    assignNumberIfPresent("metricsIntervalSeconds", values.metricsIntervalSeconds);
+    assignNumberIfPresent("memorySampleSeconds", values.memorySampleSeconds);
+    assignIfPresent("traceFile", values.traceFile);
+    assignNumberIfPresent("pageRows", values.pageRows);
+    assignNumberIfPresent("recordCacheEntries", values.recordCacheEntries);
+    std::string compress = extractValue(content, "logCompress");
+    if (!compress.empty()) {
+        values.logCompress = compress == "true" || compress == "1";
+    }
     if (directoryUpdated && !indexUpdated) {
         values.backupIndexFile.clear();
     }
+    if (directoryUpdated && !journalUpdated) {
+        values.journalFile.clear();
+    }
 
     applyDerivedDefaults();
-    Logger::getInstance()->log("Configuration loaded from " + path);
+    ALBUM_LOG_INFO("Configuration loaded from {}", path);
 }
 
 const std::string& getArtistFilePath() {
@@ -144,1315 +236,7225 @@ const std::string& getBackupIndexFile() {
     return AppConfig::instance().settings().backupIndexFile;
 }
 
+const std::string& getJournalFile() {
+    return AppConfig::instance().settings().journalFile;
+}
+
 void loadApplicationConfig(const std::string& path) {
     AppConfig::instance().loadFromFile(path);
+    const AppConfigSettings& settings = AppConfig::instance().settings();
+    Logger* logger = Logger::getInstance();
+    logger->setLevel(parseLogLevel(settings.logLevel));
+    logger->setFormat(settings.logFormat == "binary" ? LogFormat::Binary : LogFormat::Text);
+    LogRotationSettings rotation;
+    rotation.maxBytes = settings.logMaxSizeMB * 1024 * 1024;
+    rotation.maxAgeSeconds = static_cast<std::int64_t>(settings.logRotateHours) * 3600;
+    rotation.retention = settings.logRetention;
+    rotation.compress = settings.logCompress;
+    logger->setRotation(rotation);
+    RecordCache::instance().setCapacity(static_cast<std::size_t>(settings.recordCacheEntries));
+#ifndef ALBUM_HAVE_ZLIB
+    if (settings.logCompress) {
+        ALBUM_LOG_WARN("logCompress ignored: built without zlib");
+    }
+#endif
 }
 
 namespace {
-std::recursive_mutex g_fileMutex;
 
-void reportMemoryUsage() {
-#ifdef _WIN32
-    MEMORYSTATUSEX status{};
-    status.dwLength = sizeof(status);
-    if (GlobalMemoryStatusEx(&status)) {
-        DWORDLONG used = status.ullTotalPhys - status.ullAvailPhys;
-        Logger::getInstance()->log("Memory stats - total: " + std::to_string(status.ullTotalPhys) +
-                                   ", available: " + std::to_string(status.ullAvailPhys) +
-                                   ", used: " + std::to_string(used));
-    }
-#else
-    std::ifstream statm("/proc/self/statm");
-    long pages = 0;
-    long resident = 0;
-    if (statm >> pages >> resident) {
-        long pageSize = sysconf(_SC_PAGESIZE);
-        long usedBytes = resident * pageSize;
-        Logger::getInstance()->log("Memory stats - resident bytes: " + std::to_string(usedBytes));
-    }
-#endif
+const char BINARY_LOG_MAGIC[4] = {'A', 'M', 'S', 'L'};
+const std::uint16_t BINARY_LOG_VERSION = 1;
+const std::uint8_t BINARY_LOG_TEMPLATE = 1;
+const std::uint8_t BINARY_LOG_MESSAGE = 2;
+
+template <typename T>
+void appendRaw(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
 }
 
-struct MemoryStatsReporter {
-    ~MemoryStatsReporter() {
-        reportMemoryUsage();
+template <typename T>
+bool readRaw(const char*& p, const char* end, T& value) {
+    if (static_cast<std::size_t>(end - p) < sizeof(T)) {
+        return false;
     }
-};
-
-MemoryStatsReporter g_memoryReporter;
+    std::memcpy(&value, p, sizeof(T));
+    p += sizeof(T);
+    return true;
 }
 
-struct CommandAction {
-    std::function<bool()> redo;
-    std::function<void()> undo;
-    std::string description;
-};
-
-class CommandManager {
-private:
-    std::stack<CommandAction> undoStack;
-    std::stack<CommandAction> redoStack;
-
-public:
-    bool execute(CommandAction action) {
-        if (action.redo && action.redo()) {
-            undoStack.push(action);
-            // Clear redo history after a new operation
-            while (!redoStack.empty()) {
-                redoStack.pop();
+// Decodes the argument at p and appends its text form.
+bool appendLogArg(std::string& out, const char*& p, const char* end) {
+    std::uint8_t type = 0;
+    if (!readRaw(p, end, type)) {
+        return false;
+    }
+    switch (static_cast<LogArgType>(type)) {
+        case LogArgType::Int: {
+            std::int64_t value = 0;
+            if (!readRaw(p, end, value)) {
+                return false;
             }
+            out += std::to_string(value);
             return true;
         }
-        return false;
-    }
-
-    bool undo() {
-        if (undoStack.empty()) {
-            return false;
+        case LogArgType::UInt: {
+            std::uint64_t value = 0;
+            if (!readRaw(p, end, value)) {
+                return false;
+            }
+            out += std::to_string(value);
+            return true;
         }
-        CommandAction action = undoStack.top();
-        undoStack.pop();
-        if (action.undo) {
-            action.undo();
+        case LogArgType::Double: {
+            double value = 0;
+            if (!readRaw(p, end, value)) {
+                return false;
+            }
+            char text[32];
+            std::snprintf(text, sizeof(text), "%g", value);
+            out += text;
+            return true;
         }
-        redoStack.push(action);
-        return true;
-    }
-
-    bool redo() {
-        if (redoStack.empty()) {
-            return false;
+        case LogArgType::String: {
+            std::uint32_t length = 0;
+            if (!readRaw(p, end, length) || static_cast<std::size_t>(end - p) < length) {
+                return false;
+            }
+            out.append(p, length);
+            p += length;
+            return true;
         }
-        CommandAction action = redoStack.top();
-        redoStack.pop();
-        if (action.redo && action.redo()) {
-            undoStack.push(action);
+        case LogArgType::Char: {
+            char value = 0;
+            if (!readRaw(p, end, value)) {
+                return false;
+            }
+            out.push_back(value);
+            return true;
+        }
+        case LogArgType::Bool: {
+            std::uint8_t value = 0;
+            if (!readRaw(p, end, value)) {
+                return false;
+            }
+            out += value ? "true" : "false";
             return true;
         }
-        return false;
     }
+    return false;
+}
 
-    bool canUndo() const {
-        return !undoStack.empty();
+// Formats "YYYY-MM-DD HH:MM:SS" for a second, reusing the previous result when unchanged.
+void formatLogStamp(std::int64_t timestampMs, std::int64_t& cachedSecond, char (&cachedStamp)[24], std::string& out) {
+    std::int64_t second = timestampMs / 1000;
+    if (second != cachedSecond) {
+        std::time_t tt = static_cast<std::time_t>(second);
+        std::tm tm{};
+#ifdef _WIN32
+        localtime_s(&tm, &tt);
+#else
+        localtime_r(&tt, &tm);
+#endif
+        std::strftime(cachedStamp, sizeof(cachedStamp), "%Y-%m-%d %H:%M:%S", &tm);
+        cachedSecond = second;
     }
+    char millis[8];
+    std::snprintf(millis, sizeof(millis), ".%03d", static_cast<int>(timestampMs % 1000));
+    out.append(cachedStamp);
+    out.append(millis);
+}
 
-    bool canRedo() const {
-        return !redoStack.empty();
+void appendTextLine(std::string& out, std::int64_t timestampMs, LogLevel level, const char* templ, std::size_t templLength,
+                    const char* args, std::size_t argsLength, std::int64_t& cachedSecond, char (&cachedStamp)[24]) {
+    formatLogStamp(timestampMs, cachedSecond, cachedStamp, out);
+    out.append(" : [");
+    out.append(logLevelName(level));
+    out.append("] ");
+    if (!formatLogMessage(out, templ, templLength, args, argsLength)) {
+        out.append(" <malformed arguments>");
     }
+    out.push_back('\n');
+}
 
-    std::string nextUndoDescription() const {
-        if (undoStack.empty()) {
-            return "";
-        }
-        return undoStack.top().description;
-    }
+} // namespace
 
-    std::string nextRedoDescription() const {
-        if (redoStack.empty()) {
-            return "";
-        }
-        return redoStack.top().description;
+LogLevel parseLogLevel(const std::string& text, LogLevel fallback) {
+    std::string name;
+    for (char c : text) {
+        name.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
     }
+    if (name == "trace") return LogLevel::Trace;
+    if (name == "debug") return LogLevel::Debug;
+    if (name == "info") return LogLevel::Info;
+    if (name == "warn" || name == "warning") return LogLevel::Warn;
+    if (name == "error") return LogLevel::Error;
+    if (name == "off") return LogLevel::Off;
+    return fallback;
+}
 
-    void clear() {
-        while (!undoStack.empty()) undoStack.pop();
-        while (!redoStack.empty()) redoStack.pop();
+const char* logLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace:
+            return "TRACE";
+        case LogLevel::Debug:
+            return "DEBUG";
+        case LogLevel::Info:
+            return "INFO";
+        case LogLevel::Warn:
+            return "WARN";
+        case LogLevel::Error:
+            return "ERROR";
+        case LogLevel::Off:
+            return "OFF";
     }
-};
+    return "?";
+}
 
-static CommandManager commandManager;
+void encodeLogArg(std::string& out, std::int64_t value) {
+    out.push_back(static_cast<char>(LogArgType::Int));
+    appendRaw(out, value);
+}
 
-namespace {
-#ifdef _WIN32
-const char PATH_SEPARATOR = '\\';
-#else
-const char PATH_SEPARATOR = '/';
-#endif
+void encodeLogArg(std::string& out, std::uint64_t value) {
+    out.push_back(static_cast<char>(LogArgType::UInt));
+    appendRaw(out, value);
+}
 
-struct BackupEntry {
-    std::string timestamp;
-    std::string artistFile;
-    std::string albumFile;
-    std::uint32_t artistChecksum = 0;
-    std::uint32_t albumChecksum = 0;
-};
+void encodeLogArg(std::string& out, double value) {
+    out.push_back(static_cast<char>(LogArgType::Double));
+    appendRaw(out, value);
+}
 
-std::string joinPath(const std::string& dir, const std::string& file) {
-    if (dir.empty()) {
-        return file;
-    }
-    if (dir.back() == '/' || dir.back() == '\\') {
-        return dir + file;
-    }
-    return dir + PATH_SEPARATOR + file;
+void encodeLogArg(std::string& out, const char* value, std::size_t length) {
+    out.push_back(static_cast<char>(LogArgType::String));
+    appendRaw(out, static_cast<std::uint32_t>(length));
+    out.append(value, length);
 }
 
-std::string sanitizeStringInput(const std::string& input, size_t maxLength) {
-    std::string result;
-    result.reserve(std::min(maxLength, input.size()));
-    for (char ch : input) {
-        unsigned char c = static_cast<unsigned char>(ch);
-        if (!std::isprint(c) && !std::isspace(c)) {
-            continue;
-        }
-        if (result.size() >= maxLength) {
-            break;
-        }
-        result.push_back(static_cast<char>(c));
-    }
-    auto first = result.find_first_not_of(" \t\r\n");
-    if (first == std::string::npos) {
-        return "";
-    }
-    auto last = result.find_last_not_of(" \t\r\n");
-    return result.substr(first, last - first + 1);
+void encodeLogArg(std::string& out, char value) {
+    out.push_back(static_cast<char>(LogArgType::Char));
+    out.push_back(value);
 }
 
-std::string sanitizeDigitInput(const std::string& input, size_t maxLength) {
-    std::string result;
-    result.reserve(std::min(maxLength, input.size()));
-    for (char ch : input) {
-        if (std::isdigit(static_cast<unsigned char>(ch))) {
-            result.push_back(ch);
-            if (result.size() >= maxLength) {
-                break;
-            }
-        }
-    }
-    return result;
+void encodeLogArg(std::string& out, bool value) {
+    out.push_back(static_cast<char>(LogArgType::Bool));
+    out.push_back(value ? 1 : 0);
 }
 
-bool bufferedCopy(std::istream& src, std::ostream& dst) {
-    std::array<char, 65536> buffer{};
-    while (src) {
-        src.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
-        std::streamsize count = src.gcount();
-        if (count <= 0) {
-            break;
+bool formatLogMessage(std::string& out, const char* templ, std::size_t templLength, const char* args, std::size_t length) {
+    const char* p = args;
+    const char* end = args + length;
+    for (std::size_t i = 0; i < templLength; ++i) {
+        if (templ[i] == '{' && i + 1 < templLength && templ[i + 1] == '}' && p < end) {
+            if (!appendLogArg(out, p, end)) {
+                return false;
+            }
+            ++i;
+        } else {
+            out.push_back(templ[i]);
         }
-        dst.write(buffer.data(), count);
-        if (!dst) {
+    }
+    while (p < end) {
+        out.push_back(' ');
+        if (!appendLogArg(out, p, end)) {
             return false;
         }
     }
-    dst.flush();
-    return dst.good();
+    return true;
 }
 
-std::uint32_t computeFileChecksum(const std::string& path) {
-    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
-    std::ifstream file(path, std::ios::binary);
-    if (!file) {
-        return 0;
+bool decodeBinaryLog(std::istream& in, std::ostream& out) {
+    char header[8];
+    if (!in.read(header, sizeof(header)) || std::memcmp(header, BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC)) != 0) {
+        return false;
     }
-    const std::uint32_t fnvOffset = 2166136261u;
-    const std::uint32_t fnvPrime = 16777619u;
-    std::uint32_t hash = fnvOffset;
-    std::array<char, 65536> buffer{};
-    while (file) {
-        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
-        std::streamsize count = file.gcount();
-        for (std::streamsize i = 0; i < count; ++i) {
-            hash ^= static_cast<unsigned char>(buffer[static_cast<size_t>(i)]);
-            hash *= fnvPrime;
+    std::uint16_t version = 0;
+    std::memcpy(&version, header + 4, sizeof(version));
+    if (version != BINARY_LOG_VERSION) {
+        return false;
+    }
+
+    std::unordered_map<std::uint32_t, std::string> templates;
+    std::int64_t cachedSecond = -1;
+    char cachedStamp[24] = {};
+    std::string line;
+    std::string args;
+    char tag = 0;
+    while (in.get(tag)) {
+        if (static_cast<std::uint8_t>(tag) == BINARY_LOG_TEMPLATE) {
+            std::uint32_t id = 0;
+            std::uint16_t length = 0;
+            std::string text;
+            if (!in.read(reinterpret_cast<char*>(&id), sizeof(id)) ||
+                !in.read(reinterpret_cast<char*>(&length), sizeof(length))) {
+                return false;
+            }
+            text.resize(length);
+            if (length > 0 && !in.read(&text[0], length)) {
+                return false;
+            }
+            templates[id] = std::move(text);
+        } else if (static_cast<std::uint8_t>(tag) == BINARY_LOG_MESSAGE) {
+            std::int64_t timestampMs = 0;
+            std::uint8_t level = 0;
+            std::uint32_t id = 0;
+            std::uint32_t length = 0;
+            if (!in.read(reinterpret_cast<char*>(&timestampMs), sizeof(timestampMs)) ||
+                !in.read(reinterpret_cast<char*>(&level), sizeof(level)) ||
+                !in.read(reinterpret_cast<char*>(&id), sizeof(id)) ||
+                !in.read(reinterpret_cast<char*>(&length), sizeof(length))) {
+                return false;
+            }
+            args.resize(length);
+            if (length > 0 && !in.read(&args[0], length)) {
+                return false;
+            }
+            auto templ = templates.find(id);
+            if (templ == templates.end()) {
+                return false;
+            }
+            line.clear();
+            appendTextLine(line, timestampMs, static_cast<LogLevel>(level), templ->second.data(), templ->second.size(),
+                           args.data(), args.size(), cachedSecond, cachedStamp);
+            out << line;
+        } else {
+            return false;
         }
     }
-    return hash;
+    return true;
 }
 
-bool ensureDirectoryExists(const std::string& dir) {
-    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
-#ifdef _WIN32
-    if (_mkdir(dir.c_str()) == 0) {
-        return true;
-    }
-#else
-    if (mkdir(dir.c_str(), 0755) == 0) {
-        return true;
-    }
-#endif
-    if (errno == EEXIST) {
-        return true;
-    }
-    return false;
+Logger* Logger::getInstance() {
+    // Never destroyed: shutdown() runs at exit and late messages fall back to direct writes.
+    static Logger* instance = new Logger();
+    return instance;
 }
 
-bool ensureIndexFileExists() {
-    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
-    if (!ensureDirectoryExists(backupDirectory)) {
-        return false;
+Logger::Logger() : slots(new Slot[QUEUE_CAPACITY]) {
+    for (std::size_t i = 0; i < QUEUE_CAPACITY; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
     }
-    std::ifstream check(backupIndexFile);
-    if (check.good()) {
-        return true;
+    openLogFile();
+    if (logFile.is_open()) {
+        running.store(true);
+        writer = std::thread(&Logger::run, this);
+        std::atexit([] { Logger::getInstance()->shutdown(); });
+        log("Logger initialized");
     }
-    check.close();
-    std::ofstream create(backupIndexFile, std::ios::app);
-    return create.good();
 }
 
-bool fileExists(const std::string& path) {
-    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
-    std::ifstream file(path, std::ios::binary);
-    return file.good();
+std::string& Logger::encodeBuffer() {
+    thread_local std::string buffer;
+    return buffer;
 }
 
-bool copyFile(const std::string& source, const std::string& destination) {
-    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
-    std::ifstream src(source, std::ios::binary);
-    if (!src) {
-        return false;
+// Caller holds fileMutex (or is the constructor).
+void Logger::openLogFile() {
+    if (logFile.is_open()) {
+        logFile.close();
     }
-    std::ofstream dst(destination, std::ios::binary);
-    if (!dst) {
-        return false;
+    templateIds.clear();
+    std::error_code ec;
+    std::uintmax_t size = std::filesystem::file_size(activeLogPath(), ec);
+    segmentBytes = ec ? 0 : static_cast<std::uint64_t>(size);
+    segmentOpenedMs = currentTimeMillis();
+    if (format == LogFormat::Text) {
+        logFile.open(TEXT_LOG_FILE, std::ios::app);
+        return;
+    }
+    logFile.open(BINARY_LOG_FILE, std::ios::app | std::ios::binary);
+    if (logFile.is_open() && segmentBytes == 0) {
+        std::string header(BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC));
+        appendRaw(header, BINARY_LOG_VERSION);
+        appendRaw(header, std::uint16_t{0});
+        logFile << header;
+        segmentBytes = header.size();
     }
-    return bufferedCopy(src, dst);
 }
 
-bool copyFileOverwrite(const std::string& source, const std::string& destination) {
-    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
-    auto* logger = Logger::getInstance();
+const char* Logger::activeLogPath() const {
+    return format == LogFormat::Text ? TEXT_LOG_FILE : BINARY_LOG_FILE;
+}
 
-    // Verify the source exists before we begin any overwrite attempts.
-    std::ifstream sourceCheck(source, std::ios::binary);
-    if (!sourceCheck) {
-        logger->log("copyFileOverwrite: Failed to open source file: " + source);
-        return false;
+// Caller holds fileMutex.
+bool Logger::rotationDue() const {
+    if (rotation.maxBytes > 0 && segmentBytes >= rotation.maxBytes) {
+        return true;
     }
-    sourceCheck.close();
-
-    const int directCopyRetries = 5;
-    const int fallbackRetries = 10;
-    const int retryDelayMs = 150;
-
-    // First try to overwrite in-place using truncation, which avoids deleting the file.
-    for (int attempt = 0; attempt < directCopyRetries; ++attempt) {
-        std::ifstream src(source, std::ios::binary);
-        if (!src) {
-            logger->log("copyFileOverwrite: Source became unavailable before attempt " + std::to_string(attempt + 1));
-            return false;
-        }
-
-        errno = 0;
-        std::ofstream dst(destination, std::ios::binary | std::ios::trunc);
-        int openErrno = errno;
-        if (!dst) {
-            logger->log("copyFileOverwrite: Failed to open destination for overwrite on attempt " +
-                        std::to_string(attempt + 1) + ", errno: " + std::to_string(openErrno));
-        } else {
-            errno = 0;
-            if (bufferedCopy(src, dst)) {
-                logger->log("copyFileOverwrite: Overwrote destination via truncation on attempt " + std::to_string(attempt + 1));
-                return true;
-            }
-
-            logger->log("copyFileOverwrite: Failed to stream data to destination on attempt " +
-                        std::to_string(attempt + 1) + ", errno: " + std::to_string(errno));
-        }
+    return rotation.maxAgeSeconds > 0 && segmentBytes > 0 &&
+           currentTimeMillis() - segmentOpenedMs >= rotation.maxAgeSeconds * 1000;
+}
 
+// Caller holds fileMutex. Renames the active file to a timestamped segment and starts a new one.
+void Logger::rotateLogFile() {
+    logFile.close();
+    std::string active = activeLogPath();
+    std::time_t now = std::time(nullptr);
+    std::tm tm{};
 #ifdef _WIN32
-        Sleep(retryDelayMs);
+    localtime_s(&tm, &now);
 #else
-        usleep(retryDelayMs * 1000);
+    localtime_r(&now, &tm);
+#endif
+    char stamp[16];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &tm);
+    // Segments rotated within one second get a fixed-width sequence that continues past
+    // the newest existing one, so pruning the oldest never frees a name that would sort
+    // ahead of the segments kept.
+    std::string stem = std::filesystem::path(active).filename().string() + "." + stamp + "_";
+    int sequence = 0;
+    for (const auto& existing : rotatedSegments()) {
+        std::string name = std::filesystem::path(existing).filename().string();
+        if (name.compare(0, stem.size(), stem) == 0) {
+            sequence = std::max(sequence, std::atoi(name.c_str() + stem.size()) + 1);
+        }
+    }
+    char suffix[8];
+    std::snprintf(suffix, sizeof(suffix), "%03d", sequence);
+    std::string segment = active + "." + stamp + "_" + suffix;
+    std::error_code ec;
+    std::filesystem::rename(active, segment, ec);
+    openLogFile();
+    if (ec) {
+        return;
+    }
+#ifdef ALBUM_HAVE_ZLIB
+    if (rotation.compress) {
+        std::lock_guard<std::mutex> lock(compressMutex);
+        compressQueue.push_back(segment);
+        if (!compressor.joinable()) {
+            compressorStop = false;
+            compressor = std::thread(&Logger::runCompressor, this);
+        }
+        compressWake.notify_one();
+        return;
+    }
 #endif
+    pruneSegments();
+}
+
+std::vector<std::string> Logger::rotatedSegments() const {
+    std::string active = activeLogPath();
+    std::string prefix = std::filesystem::path(active).filename().string() + ".";
+    std::filesystem::path dir = std::filesystem::path(active).parent_path();
+    std::vector<std::string> segments;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir.empty() ? "." : dir, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.compare(0, prefix.size(), prefix) == 0 && name.size() > prefix.size() &&
+            std::isdigit(static_cast<unsigned char>(name[prefix.size()])) &&
+            (name.size() < 5 || name.compare(name.size() - 5, 5, ".part") != 0)) {
+            segments.push_back((dir / name).string());
+        }
     }
+    // Timestamped names sort chronologically.
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
 
-    // Fallback to copy into a temporary file and then replace the destination.
-    std::ifstream src(source, std::ios::binary);
-    if (!src) {
-        logger->log("copyFileOverwrite: Failed to open source during fallback copy: " + source);
-        return false;
+void Logger::pruneSegments() {
+    if (rotation.retention <= 0) {
+        return;
     }
+    std::vector<std::string> segments = rotatedSegments();
+    std::size_t keep = static_cast<std::size_t>(rotation.retention);
+    for (std::size_t i = 0; i + keep < segments.size(); ++i) {
+        std::error_code ec;
+        std::filesystem::remove(segments[i], ec);
+    }
+}
 
-    std::string tempDest = destination + ".tmp";
-    std::ofstream dst(tempDest, std::ios::binary);
-    if (!dst) {
-        logger->log("copyFileOverwrite: Failed to create temp file: " + tempDest);
-        return false;
+void Logger::runCompressor() {
+    std::unique_lock<std::mutex> lock(compressMutex);
+    while (true) {
+        compressWake.wait(lock, [this] { return compressorStop || !compressQueue.empty(); });
+        if (compressQueue.empty()) {
+            break;
+        }
+        std::string segment = compressQueue.front();
+        compressQueue.erase(compressQueue.begin());
+        compressing = true;
+        lock.unlock();
+#ifdef ALBUM_HAVE_ZLIB
+        std::string part = segment + ".gz.part";
+        bool ok = false;
+        std::ifstream in(segment, std::ios::binary);
+        gzFile out = gzopen(part.c_str(), "wb6");
+        if (in && out != nullptr) {
+            std::array<char, 65536> buffer{};
+            ok = true;
+            while (ok) {
+                in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                int count = static_cast<int>(in.gcount());
+                if (count <= 0) {
+                    break;
+                }
+                ok = gzwrite(out, buffer.data(), static_cast<unsigned>(count)) == count;
+            }
+        }
+        if (out != nullptr && gzclose(out) != Z_OK) {
+            ok = false;
+        }
+        in.close();
+        std::error_code ec;
+        if (ok) {
+            std::filesystem::rename(part, segment + ".gz", ec);
+        }
+        if (ok && !ec) {
+            std::filesystem::remove(segment, ec);
+        } else {
+            std::filesystem::remove(part, ec);
+        }
+#endif
+        {
+            std::lock_guard<std::mutex> fileLock(fileMutex);
+            pruneSegments();
+        }
+        lock.lock();
+        compressing = false;
+        compressDone.notify_all();
     }
+}
 
-    errno = 0;
-    if (!bufferedCopy(src, dst)) {
-        dst.close();
-        std::remove(tempDest.c_str());
-        logger->log("copyFileOverwrite: Failed to write to temp file: " + tempDest);
-        return false;
+void Logger::stopCompressor() {
+    {
+        std::lock_guard<std::mutex> lock(compressMutex);
+        compressorStop = true;
+    }
+    compressWake.notify_one();
+    if (compressor.joinable()) {
+        compressor.join();
     }
-    dst.close();
-    src.close();
+}
 
-    for (int attempt = 0; attempt < fallbackRetries; ++attempt) {
-#ifdef _WIN32
-        SetFileAttributesA(destination.c_str(), FILE_ATTRIBUTE_NORMAL);
+void Logger::setRotation(const LogRotationSettings& settings) {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    rotation = settings;
+#ifndef ALBUM_HAVE_ZLIB
+    rotation.compress = false;
 #endif
+}
 
-        errno = 0;
-        if (std::remove(destination.c_str()) == 0 || errno == ENOENT) {
-            errno = 0;
-            if (std::rename(tempDest.c_str(), destination.c_str()) == 0) {
-                logger->log("copyFileOverwrite: Successfully copied " + source + " to " + destination +
-                            " on fallback attempt " + std::to_string(attempt + 1));
+// Bounded ring after Vyukov: each slot's sequence number tells producers and the writer
+// whose turn it is, so producers claim a slot with a single CAS and never take a lock.
+bool Logger::tryPush(std::int64_t timestampMs, LogLevel level, const char* templ, const std::string& args) {
+    std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+        Slot& slot = slots[pos & (QUEUE_CAPACITY - 1)];
+        std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.timestampMs = timestampMs;
+                slot.level = level;
+                slot.templ = templ;
+                slot.args = args;
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                accepted.fetch_add(1, std::memory_order_relaxed);
                 return true;
             }
-
-            int renameErrno = errno;
-#ifdef _WIN32
-            DWORD lastError = GetLastError();
-            logger->log("copyFileOverwrite: Failed to rename temp file on fallback attempt " +
-                        std::to_string(attempt + 1) + ", errno: " + std::to_string(renameErrno) +
-                        ", lastError: " + std::to_string(lastError));
-#else
-            logger->log("copyFileOverwrite: Failed to rename temp file on fallback attempt " +
-                        std::to_string(attempt + 1) + ", errno: " + std::to_string(renameErrno));
-#endif
+        } else if (diff < 0) {
+            return false;
         } else {
-            int removeErrno = errno;
-            logger->log("copyFileOverwrite: Failed to remove destination file on fallback attempt " +
-                        std::to_string(attempt + 1) + ", errno: " + std::to_string(removeErrno));
+            pos = enqueuePos.load(std::memory_order_relaxed);
         }
-
-#ifdef _WIN32
-        Sleep(retryDelayMs);
-#else
-        usleep(retryDelayMs * 1000);
-#endif
     }
+}
 
-    std::remove(tempDest.c_str());
-    logger->log("copyFileOverwrite: All retries failed for copying " + source + " to " + destination);
-    return false;
+bool Logger::hasPending() const {
+    const Slot& slot = slots[dequeuePos & (QUEUE_CAPACITY - 1)];
+    return slot.sequence.load(std::memory_order_acquire) == dequeuePos + 1;
 }
 
-std::string makeTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    std::time_t tt = std::chrono::system_clock::to_time_t(now);
-    std::tm tm{};
-#ifdef _WIN32
-    localtime_s(&tm, &tt);
-#else
-    localtime_r(&tt, &tm);
-#endif
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y%m%d_%H%M%S");
-    return oss.str();
+void Logger::wakeWriter() {
+    if (writerIdle.load(std::memory_order_acquire)) {
+        wake.notify_one();
+    }
 }
 
-bool appendBackupEntry(const BackupEntry& entry) {
-    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
-    if (!ensureIndexFileExists()) {
-        return false;
+void Logger::log(const std::string& message) {
+    write(LogLevel::Info, "{}", message);
+}
+
+void Logger::submit(LogLevel level, const char* templ, const std::string& args) {
+    std::int64_t now = currentTimeMillis();
+    if (!running.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        if (logFile.is_open()) {
+            std::string record;
+            appendRecord(record, now, level, templ, args);
+            logFile << record;
+            logFile.flush();
+        }
+        return;
     }
-    std::ofstream indexFile(backupIndexFile, std::ios::app);
-    if (!indexFile) {
-        return false;
+    while (!tryPush(now, level, templ, args)) {
+        if (policy.load(std::memory_order_relaxed) == LogOverflowPolicy::Drop) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        wakeWriter();
+        std::this_thread::yield();
     }
-    indexFile << entry.timestamp << ','
-              << entry.artistFile << ','
-              << entry.albumFile << ','
-              << entry.artistChecksum << ','
-              << entry.albumChecksum << '\n';
-    return indexFile.good();
+    wakeWriter();
 }
 
-std::vector<BackupEntry> loadBackupEntries() {
-    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
-    std::vector<BackupEntry> entries;
-    std::ifstream indexFile(backupIndexFile);
-    if (!indexFile) {
-        return entries;
+// Caller holds fileMutex. Text lines are formatted here; binary records copy the encoded
+// arguments as they are and name the template by an id defined once per file.
+void Logger::appendRecord(std::string& batch, std::int64_t timestampMs, LogLevel level, const char* templ, const std::string& args) {
+    if (format == LogFormat::Text) {
+        appendTextLine(batch, timestampMs, level, templ, std::strlen(templ), args.data(), args.size(), cachedSecond, cachedStamp);
+        return;
     }
-    std::string line;
-    while (std::getline(indexFile, line)) {
-        if (line.empty()) {
-            continue;
-        }
-        std::stringstream ss(line);
-        BackupEntry entry;
-        if (!std::getline(ss, entry.timestamp, ',')) {
-            continue;
-        }
-        if (!std::getline(ss, entry.artistFile, ',')) {
-            continue;
+    auto known = templateIds.find(templ);
+    std::uint32_t id = 0;
+    if (known == templateIds.end()) {
+        id = static_cast<std::uint32_t>(templateIds.size());
+        templateIds.emplace(templ, id);
+        std::size_t length = std::min<std::size_t>(std::strlen(templ), UINT16_MAX);
+        batch.push_back(static_cast<char>(BINARY_LOG_TEMPLATE));
+        appendRaw(batch, id);
+        appendRaw(batch, static_cast<std::uint16_t>(length));
+        batch.append(templ, length);
+    } else {
+        id = known->second;
+    }
+    batch.push_back(static_cast<char>(BINARY_LOG_MESSAGE));
+    appendRaw(batch, timestampMs);
+    appendRaw(batch, static_cast<std::uint8_t>(level));
+    appendRaw(batch, id);
+    appendRaw(batch, static_cast<std::uint32_t>(args.size()));
+    batch.append(args);
+}
+
+void Logger::run() {
+    std::string batch;
+    while (true) {
+        std::uint64_t count = 0;
+        {
+            std::lock_guard<std::mutex> lock(fileMutex);
+            batch.clear();
+            if (hasPending() && rotationDue()) {
+                rotateLogFile();
+            }
+            while (hasPending() && count < QUEUE_CAPACITY) {
+                Slot& slot = slots[dequeuePos & (QUEUE_CAPACITY - 1)];
+                appendRecord(batch, slot.timestampMs, slot.level, slot.templ, slot.args);
+                slot.sequence.store(dequeuePos + QUEUE_CAPACITY, std::memory_order_release);
+                ++dequeuePos;
+                ++count;
+            }
+            std::uint64_t droppedNow = dropped.load(std::memory_order_relaxed);
+            if (droppedNow != droppedReported) {
+                std::string args;
+                encodeLogArg(args, static_cast<std::uint64_t>(droppedNow - droppedReported));
+                appendRecord(batch, currentTimeMillis(), LogLevel::Warn, "Logger dropped {} message(s): queue full", args);
+                droppedReported = droppedNow;
+            }
+            if (!batch.empty()) {
+                logFile << batch;
+                logFile.flush();
+                segmentBytes += batch.size();
+            }
         }
-        if (!std::getline(ss, entry.albumFile, ',')) {
+        if (count > 0) {
+            written.fetch_add(count, std::memory_order_release);
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            drained.notify_all();
             continue;
         }
-        std::string artistChecksumStr;
-        std::string albumChecksumStr;
-        if (std::getline(ss, artistChecksumStr, ',')) {
-            try {
-                entry.artistChecksum = static_cast<std::uint32_t>(std::stoul(artistChecksumStr));
-            } catch (...) {
-                entry.artistChecksum = 0;
-            }
-            if (std::getline(ss, albumChecksumStr)) {
-                try {
-                    entry.albumChecksum = static_cast<std::uint32_t>(std::stoul(albumChecksumStr));
-                } catch (...) {
-                    entry.albumChecksum = 0;
-                }
-            }
+        if (!running.load(std::memory_order_acquire)) {
+            break;
         }
-        entries.push_back(entry);
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        writerIdle.store(true, std::memory_order_release);
+        // The timeout bounds the delay of a wakeup that raced with going idle.
+        wake.wait_for(lock, std::chrono::milliseconds(50), [this] {
+            return !running.load(std::memory_order_acquire) || hasPending();
+        });
+        writerIdle.store(false, std::memory_order_release);
     }
-    std::sort(entries.begin(), entries.end(), [](const BackupEntry& a, const BackupEntry& b) {
-        return a.timestamp > b.timestamp;
-    });
-    return entries;
 }
 
-void displayBackupEntries(const std::vector<BackupEntry>& entries) {
-    cout << "\nAvailable backups: \n";
-    cout << left << setw(6) << "[#]" << setw(25) << "Timestamp" << setw(40) << "Snapshot Files"
-         << setw(12) << "Artist CRC" << "Album CRC" << endl;
-    cout << setw(6) << "---" << setw(25) << "-----------------------" << setw(40) << "---------------------------------------"
-         << setw(12) << "----------" << "----------" << endl;
-    for (size_t i = 0; i < entries.size(); ++i) {
-        cout << setw(6) << (i + 1)
-             << setw(25) << entries[i].timestamp
-             << setw(40) << (entries[i].artistFile + " | " + entries[i].albumFile)
-             << setw(12) << entries[i].artistChecksum
-             << entries[i].albumChecksum << endl;
+void Logger::setLevel(LogLevel level) {
+    minLevel.store(level, std::memory_order_relaxed);
+}
+
+void Logger::setFormat(LogFormat newFormat) {
+    flush();
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (format == newFormat && logFile.is_open()) {
+        return;
     }
-    cout << endl;
+    logFile.flush();
+    format = newFormat;
+    openLogFile();
 }
 
-} // namespace
+void Logger::flush() {
+    if (!running.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        logFile.flush();
+        return;
+    }
+    std::uint64_t target = accepted.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    wake.notify_one();
+    while (written.load(std::memory_order_acquire) < target && running.load(std::memory_order_acquire)) {
+        drained.wait_for(lock, std::chrono::milliseconds(10));
+        wake.notify_one();
+    }
+    lock.unlock();
+    std::unique_lock<std::mutex> compressLock(compressMutex);
+    compressDone.wait(compressLock, [this] { return compressQueue.empty() && !compressing; });
+}
 
-static bool createBackupSnapshot(std::fstream& ArtFile, std::fstream& AlbFile) {
-    cout << "Creating backup snapshot..." << endl;
-    ArtFile.flush();
-    AlbFile.flush();
-    ArtFile.clear();
-    AlbFile.clear();
+void Logger::shutdown() {
+    if (!running.load(std::memory_order_acquire)) {
+        return;
+    }
+    // Runs from atexit after this thread's thread_local encode buffer may be gone.
+    submit(LogLevel::Info, "Logger shutting down", std::string());
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        running.store(false, std::memory_order_release);
+    }
+    wake.notify_one();
+    if (writer.joinable()) {
+        writer.join();
+    }
+    stopCompressor();
+    std::lock_guard<std::mutex> lock(fileMutex);
+    logFile.flush();
+}
 
-    std::string timestamp = makeTimestamp();
-    std::string artistFileName = "Artist_" + timestamp + ".bin";
-    std::string albumFileName = "Album_" + timestamp + ".bin";
-    std::string artistBackupPath = joinPath(backupDirectory, artistFileName);
-    std::string albumBackupPath = joinPath(backupDirectory, albumFileName);
+void Logger::setOverflowPolicy(LogOverflowPolicy newPolicy) {
+    policy.store(newPolicy, std::memory_order_relaxed);
+}
 
-    if (!ensureIndexFileExists()) {
-        cout << "Failed to prepare backup directory." << endl;
-        Logger::getInstance()->log("Backup failed: unable to prepare directory");
-        system("pause");
-        return false;
-    }
+std::uint64_t Logger::droppedCount() const {
+    return dropped.load(std::memory_order_relaxed);
+}
 
-    if (!fileExists(artistFilePath) || !fileExists(albumFilePath)) {
-        cout << "Cannot create backup: source data files missing." << endl;
-        Logger::getInstance()->log("Backup failed: source files missing");
-        system("pause");
-        return false;
+namespace {
+
+unsigned highestBit(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#else
+    unsigned bit = 0;
+    while (value >>= 1) {
+        ++bit;
     }
+    return bit;
+#endif
+}
 
-    if (!copyFile(artistFilePath, artistBackupPath)) {
-        cout << "Failed to backup artist data." << endl;
-        Logger::getInstance()->log("Backup failed: unable to copy artist file");
-        system("pause");
-        return false;
+template <typename Metric>
+Metric& findOrAdd(std::vector<std::pair<std::string, std::unique_ptr<Metric>>>& metrics, const std::string& name) {
+    for (auto& entry : metrics) {
+        if (entry.first == name) {
+            return *entry.second;
+        }
     }
+    metrics.emplace_back(name, std::make_unique<Metric>());
+    return *metrics.back().second;
+}
 
-    if (!copyFile(albumFilePath, albumBackupPath)) {
-        std::remove(artistBackupPath.c_str());
-        cout << "Failed to backup album data." << endl;
-        Logger::getInstance()->log("Backup failed: unable to copy album file");
-        system("pause");
-        return false;
+template <typename Metric>
+std::vector<std::pair<std::string, const Metric*>> sortedMetrics(const std::vector<std::pair<std::string, std::unique_ptr<Metric>>>& metrics) {
+    std::vector<std::pair<std::string, const Metric*>> sorted;
+    sorted.reserve(metrics.size());
+    for (const auto& entry : metrics) {
+        sorted.emplace_back(entry.first, entry.second.get());
     }
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    return sorted;
+}
 
-    BackupEntry entry{timestamp, artistFileName, albumFileName,
-                      computeFileChecksum(artistBackupPath),
-                      computeFileChecksum(albumBackupPath)};
-    if (!appendBackupEntry(entry)) {
-        cout << "Backup created, but failed to update index." << endl;
-        Logger::getInstance()->log("Backup warning: unable to append index entry");
-    } else {
-        Logger::getInstance()->log("Backup created: " + timestamp + " artistCRC=" +
-                                   std::to_string(entry.artistChecksum) + " albumCRC=" +
-                                   std::to_string(entry.albumChecksum));
+} // namespace
+
+std::size_t LatencyHistogram::bucketIndex(std::uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return static_cast<std::size_t>(value);
     }
+    unsigned shift = highestBit(value) - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKETS + static_cast<std::size_t>((value >> shift) - SUB_BUCKETS);
+}
 
-    cout << "Backup snapshot saved as:\n  " << artistBackupPath << "\n  " << albumBackupPath << endl;
-    system("pause");
-    return true;
+std::uint64_t LatencyHistogram::bucketUpperBound(std::size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    unsigned shift = static_cast<unsigned>(index / SUB_BUCKETS) - 1;
+    std::uint64_t lower = (static_cast<std::uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS)) << shift;
+    return lower + ((std::uint64_t{1} << shift) - 1);
 }
 
-static bool restoreFromBackup(std::fstream& ArtFile, std::fstream& AlbFile, artistList& artist, albumList& album, indexSet& delArtArray, indexSet& delAlbArray) {
-    cout << "Restoring from backup..." << endl;
-    auto entries = loadBackupEntries();
-    if (entries.empty()) {
-        cout << "No backups found. Create one first." << endl;
-        system("pause");
-        return false;
+void LatencyHistogram::record(std::uint64_t value) {
+    buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    samples.fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(value, std::memory_order_relaxed);
+    std::uint64_t seen = largest.load(std::memory_order_relaxed);
+    while (value > seen && !largest.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
     }
+}
 
-    displayBackupEntries(entries);
-    int selection = -1;
-    while (true) {
-        cout << "Select backup to restore (0 to cancel): ";
-        if (!(cin >> selection)) {
-            cin.clear();
-            cin.ignore(INT_MAX, '\n');
-            cout << "Invalid input. Please enter a number." << endl;
-            continue;
-        }
-        cin.ignore(INT_MAX, '\n');
-        if (selection == 0) {
-            cout << "Restore cancelled." << endl;
-            system("pause");
-            return false;
-        }
-        if (selection < 1 || selection > static_cast<int>(entries.size())) {
-            cout << "Invalid choice. Try again." << endl;
-            continue;
+std::uint64_t LatencyHistogram::percentile(double percent) const {
+    // Sum the buckets rather than trusting samples so a concurrent record cannot push the
+    // target past the last populated bucket.
+    std::uint64_t counted = 0;
+    for (const auto& bucket : buckets) {
+        counted += bucket.load(std::memory_order_relaxed);
+    }
+    if (counted == 0) {
+        return 0;
+    }
+    percent = std::min(100.0, std::max(0.0, percent));
+    auto target = static_cast<std::uint64_t>(std::ceil(percent / 100.0 * static_cast<double>(counted)));
+    target = std::max<std::uint64_t>(target, 1);
+    std::uint64_t running = 0;
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+        running += buckets[i].load(std::memory_order_relaxed);
+        if (running >= target) {
+            return std::min(bucketUpperBound(i), max());
         }
-        break;
     }
+    return max();
+}
 
-    const BackupEntry& chosen = entries[selection - 1];
-    std::string artistBackupPath = joinPath(backupDirectory, chosen.artistFile);
-    std::string albumBackupPath = joinPath(backupDirectory, chosen.albumFile);
-
-    if (!fileExists(artistBackupPath) || !fileExists(albumBackupPath)) {
-        cout << "Backup files missing on disk. Operation aborted." << endl;
-        Logger::getInstance()->log("Restore failed: missing backup files for " + chosen.timestamp);
-        system("pause");
-        return false;
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
     }
+    samples.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+    largest.store(0, std::memory_order_relaxed);
+}
 
-    auto verifyChecksum = [&](const std::string& path, std::uint32_t expected, const std::string& label) {
-        if (expected == 0) {
-            return true;
-        }
-        std::uint32_t actual = computeFileChecksum(path);
-        if (actual != expected) {
-            cout << label << " checksum mismatch. Expected " << expected << " but found " << actual << "." << endl;
-            Logger::getInstance()->log(label + " checksum mismatch for snapshot " + chosen.timestamp);
-            system("pause");
-            return false;
-        }
-        return true;
-    };
+MetricsRegistry& MetricsRegistry::instance() {
+    // Never destroyed so timers in static destructors can still record.
+    static MetricsRegistry* registry = new MetricsRegistry();
+    return *registry;
+}
 
-    char confirm;
-    cout << "Restoring will overwrite current data files. Continue? (Y/N): ";
-    if (!(cin >> confirm)) {
-        cin.clear();
-        cin.ignore(INT_MAX, '\n');
-        cout << "Restore cancelled." << endl;
-        system("pause");
-        return false;
+MetricCounter& MetricsRegistry::counter(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return findOrAdd(counters, name);
+}
+
+MetricGauge& MetricsRegistry::gauge(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return findOrAdd(gauges, name);
+}
+
+LatencyHistogram& MetricsRegistry::histogram(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return findOrAdd(histograms, name);
+}
+
+MetricsSnapshot MetricsRegistry::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    MetricsSnapshot snap;
+    for (const auto& entry : sortedMetrics(counters)) {
+        snap.counters.emplace_back(entry.first, entry.second->value());
     }
-    cin.ignore(INT_MAX, '\n');
-    if (confirm != 'y' && confirm != 'Y') {
-        cout << "Restore cancelled." << endl;
-        system("pause");
-        return false;
+    for (const auto& entry : sortedMetrics(gauges)) {
+        snap.gauges.emplace_back(entry.first, static_cast<double>(entry.second->value()));
     }
+    for (const auto& entry : sortedMetrics(histograms)) {
+        const LatencyHistogram& h = *entry.second;
+        snap.latencies.push_back({entry.first, h.count(), h.sum(), h.percentile(50.0), h.percentile(99.0),
+                                  h.percentile(99.9), h.max()});
+    }
+    return snap;
+}
 
-    if (!verifyChecksum(artistBackupPath, chosen.artistChecksum, "Artist backup") ||
-        !verifyChecksum(albumBackupPath, chosen.albumChecksum, "Album backup")) {
-        return false;
+void MetricsRegistry::dump(std::ostream& out) const {
+    MetricsSnapshot snap = snapshot();
+    auto micros = [](std::uint64_t nanos) { return static_cast<double>(nanos) / 1000.0; };
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+
+    out << std::left << std::setw(32) << "Latency (us)" << std::right << std::setw(8) << "count"
+        << std::setw(12) << "p50" << std::setw(12) << "p99" << std::setw(12) << "p999" << std::setw(12) << "max" << "\n";
+    for (const auto& h : snap.latencies) {
+        out << std::left << std::setw(32) << h.name << std::right << std::setw(8) << h.count
+            << std::setw(12) << micros(h.p50) << std::setw(12) << micros(h.p99)
+            << std::setw(12) << micros(h.p999) << std::setw(12) << micros(h.max) << "\n";
     }
+    out << "\n" << std::left << std::setw(32) << "Counters" << std::right << std::setw(8) << "value" << "\n";
+    for (const auto& entry : snap.counters) {
+        out << std::left << std::setw(32) << entry.first << std::right << std::setw(8) << entry.second << "\n";
+    }
+    out << "\n" << std::left << std::setw(32) << "Gauges" << std::right << std::setw(8) << "value" << "\n";
+    for (const auto& entry : snap.gauges) {
+        out << std::left << std::setw(32) << entry.first << std::right << std::setw(8)
+            << static_cast<std::int64_t>(entry.second) << "\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
 
-    ArtFile.flush();
-    AlbFile.flush();
-    ArtFile.close();
-    AlbFile.close();
+void MetricsRegistry::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : counters) {
+        entry.second->reset();
+    }
+    for (auto& entry : histograms) {
+        entry.second->reset();
+    }
+}
+
+namespace {
+std::recursive_mutex g_fileMutex;
 
-    // Add delay to ensure file handles are released on Windows
+void reportMemoryUsage() {
 #ifdef _WIN32
-    Sleep(500);  // 500ms delay
+    MEMORYSTATUSEX status{};
+    status.dwLength = sizeof(status);
+    if (GlobalMemoryStatusEx(&status)) {
+        DWORDLONG used = status.ullTotalPhys - status.ullAvailPhys;
+        ALBUM_LOG_DEBUG("Memory stats - total: {}, available: {}, used: {}", status.ullTotalPhys, status.ullAvailPhys, used);
+    }
 #else
-    usleep(500000);  // 500ms delay
+    std::int64_t usedBytes = residentMemoryBytes();
+    if (usedBytes >= 0) {
+        ALBUM_LOG_DEBUG("Memory stats - resident bytes: {}", usedBytes);
+    }
 #endif
-
-    if (!copyFileOverwrite(artistBackupPath, artistFilePath) || !copyFileOverwrite(albumBackupPath, albumFilePath)) {
-        cout << "Failed to restore backup." << endl;
-        Logger::getInstance()->log("Restore failed while copying backup snapshot " + chosen.timestamp);
-        try {
-            openFile(ArtFile, artistFilePath);
-            openFile(AlbFile, albumFilePath);
-        } catch (...) {
-            // Ignore: openFile already reports errors elsewhere.
-        }
-        system("pause");
-        return false;
+    for (std::size_t i = 0; i < static_cast<std::size_t>(MemoryCategory::Count); ++i) {
+        auto category = static_cast<MemoryCategory>(i);
+        const MemoryCategoryStats& stats = memoryCategoryStats(category);
+        ALBUM_LOG_DEBUG("Memory stats - {}: {} bytes live, {} bytes peak", memoryCategoryName(category),
+                        stats.liveBytes.load(std::memory_order_relaxed), stats.peakBytes.load(std::memory_order_relaxed));
     }
+}
 
-    artist.artList.clear();
-    album.albList.clear();
-    delArtArray.indexes.clear();
-    delAlbArray.indexes.clear();
-    lastArtistID = 999;
-    lastAlbumID = 1999;
-
-    if (!loadArtist(ArtFile, artist, delArtArray) || !loadAlbum(AlbFile, album, delAlbArray)) {
-        cout << "Backup restored, but failed to reload data into memory." << endl;
-        Logger::getInstance()->log("Restore warning: reload failed for snapshot " + chosen.timestamp);
-        system("pause");
-        return false;
+struct MemoryStatsReporter {
+    ~MemoryStatsReporter() {
+        reportMemoryUsage();
     }
+};
 
-    commandManager.clear();
-    Logger::getInstance()->log("Restore completed from snapshot " + chosen.timestamp);
-    cout << "Restore completed successfully." << endl;
-    system("pause");
-    return true;
-}
+MemoryStatsReporter g_memoryReporter;
 
-void backupAndRestoreMenu(std::fstream& ArtFile, std::fstream& AlbFile, artistList& artist, albumList& album, indexSet& delArtArray, indexSet& delAlbArray) {
-    bool exitMenu = false;
-    do {
-        int choice = MenuView::backupMenu();
-        switch (choice) {
-            case 1:
-                createBackupSnapshot(ArtFile, AlbFile);
-                break;
-            case 2:
-                restoreFromBackup(ArtFile, AlbFile, artist, album, delArtArray, delAlbArray);
-                break;
-            case 3:
-                exitMenu = true;
-                break;
-            default:
-                break;
-        }
-    } while (!exitMenu);
+// Published by the UI thread whenever the in-memory indexes may have changed; the
+// metrics exporter only ever reads these gauges.
+// Index sizes come from the counting allocators (memory_<category>_bytes).
+void publishIndexMetrics(const artistList& artists) {
+    static MetricGauge& records = MetricsRegistry::instance().gauge("artist_records");
+    records.set(static_cast<std::int64_t>(artists.artList.size()));
 }
 
-bool undoLastAction() {
-    return commandManager.undo();
+void publishIndexMetrics(const albumList& albums) {
+    static MetricGauge& records = MetricsRegistry::instance().gauge("album_records");
+    records.set(static_cast<std::int64_t>(albums.albList.size()));
 }
 
-bool redoLastAction() {
-    return commandManager.redo();
+std::string formatMetricValue(double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.9g", value);
+    return text;
 }
 
-bool canUndo() {
-    return commandManager.canUndo();
+std::string formatSeconds(std::uint64_t nanos) {
+    return formatMetricValue(static_cast<double>(nanos) / 1e9);
 }
 
-bool canRedo() {
-    return commandManager.canRedo();
+// Adds record slot and tombstone gauges derived from the data file size and the live
+// record count the UI thread last published.
+void sampleRecordFile(MetricsSnapshot& snapshot, const std::string& path, RecordKind kind, const std::string& prefix) {
+    std::error_code ec;
+    std::uintmax_t size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return;
+    }
+    double slots = size > static_cast<std::uintmax_t>(RECORD_HEADER_SIZE)
+        ? static_cast<double>((size - RECORD_HEADER_SIZE) / static_cast<std::uintmax_t>(recordSizeFor(kind)))
+        : 0.0;
+    snapshot.gauges.emplace_back(prefix + "_record_slots", slots);
+    for (const auto& gauge : snapshot.gauges) {
+        if (gauge.first == prefix + "_records") {
+            double tombstones = std::max(0.0, slots - gauge.second);
+            snapshot.gauges.emplace_back(prefix + "_tombstone_ratio", slots > 0 ? tombstones / slots : 0.0);
+            break;
+        }
+    }
 }
-
-std::string getNextUndoDescription() {
-    return commandManager.nextUndoDescription();
 }
 
-std::string getNextRedoDescription() {
-    return commandManager.nextRedoDescription();
+std::int64_t residentMemoryBytes() {
+#ifdef _WIN32
+    return -1;
+#else
+    std::ifstream statm("/proc/self/statm");
+    long pages = 0;
+    long resident = 0;
+    if (!(statm >> pages >> resident)) {
+        return -1;
+    }
+    return static_cast<std::int64_t>(resident) * sysconf(_SC_PAGESIZE);
+#endif
 }
 
-static bool executeCommand(CommandAction action) {
-    return commandManager.execute(std::move(action));
+std::string formatPrometheusText(const MetricsSnapshot& snapshot) {
+    std::string out;
+    for (const auto& counter : snapshot.counters) {
+        std::string name = "album_" + counter.first + "_total";
+        out += "# TYPE " + name + " counter\n";
+        out += name + " " + std::to_string(counter.second) + "\n";
+    }
+    for (const auto& gauge : snapshot.gauges) {
+        std::string name = "album_" + gauge.first;
+        out += "# TYPE " + name + " gauge\n";
+        out += name + " " + formatMetricValue(gauge.second) + "\n";
+    }
+    for (const auto& latency : snapshot.latencies) {
+        std::string name = "album_" + latency.name + "_seconds";
+        out += "# TYPE " + name + " summary\n";
+        out += name + "{quantile=\"0.5\"} " + formatSeconds(latency.p50) + "\n";
+        out += name + "{quantile=\"0.99\"} " + formatSeconds(latency.p99) + "\n";
+        out += name + "{quantile=\"0.999\"} " + formatSeconds(latency.p999) + "\n";
+        out += name + "_sum " + formatSeconds(latency.sum) + "\n";
+        out += name + "_count " + std::to_string(latency.count) + "\n";
+    }
+    return out;
 }
 
-struct ArtistCommandState {
-    Artist artist;
-    long pos = -1;
-};
-
-struct ArtistEditState {
-    Artist original;
-    Artist updated;
-    long pos = -1;
-    bool applied = false;
-};
-
-struct AlbumCommandState {
-    Album album;
-    long pos = -1;
-};
-
-struct AlbumEditState {
-    Album original;
-    Album updated;
-    long pos = -1;
-    bool applied = false;
-};
-
-struct AlbumSnapshot {
-    Album data;
-    long pos = -1;
-};
-
-struct ArtistRemovalState {
-    Artist artist;
-    long pos = -1;
-    int artistIndex = -1;
-    std::vector<AlbumSnapshot> associatedAlbums;
-};
-
-struct AlbumRemovalState {
-    Album album;
-    long pos = -1;
-    int index = -1;
-};
+MetricsExporter& MetricsExporter::instance() {
+    // Never destroyed: stop() runs from atexit while the thread is still joinable.
+    static MetricsExporter* exporter = new MetricsExporter();
+    return *exporter;
+}
 
-static bool ensureArtistStream(std::fstream& ArtFile) {
-    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
-    if (ArtFile.is_open()) {
-        return true;
+bool MetricsExporter::start(const MetricsExportSettings& newSettings) {
+    stop();
+    settings = newSettings;
+    settings.intervalSeconds = std::max(1, settings.intervalSeconds);
+    if (settings.port > 0) {
+#ifdef _WIN32
+        ALBUM_LOG_WARN("metricsPort is not supported on Windows; use metricsFile instead");
+#else
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<std::uint16_t>(settings.port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (fd < 0 || setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+            bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 8) != 0) {
+            ALBUM_LOG_ERROR("Cannot serve metrics on 127.0.0.1:{}: {}", settings.port, std::strerror(errno));
+            if (fd >= 0) {
+                close(fd);
+            }
+        } else {
+            listenSocket = fd;
+        }
+#endif
     }
-    try {
-        openFile(ArtFile, artistFilePath);
-        return true;
-    } catch (const FileException& e) {
-        cout << e.what() << endl;
-        system("pause");
+    if (settings.filePath.empty() && listenSocket < 0) {
         return false;
     }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopRequested = false;
+    }
+    worker = std::thread(&MetricsExporter::run, this);
+    static bool stopRegistered = false;
+    if (!stopRegistered) {
+        stopRegistered = true;
+        std::atexit([] { MetricsExporter::instance().stop(); });
+    }
+    ALBUM_LOG_INFO("Exporting metrics (file: {}, port: {}, every {}s)",
+                   settings.filePath.empty() ? "off" : settings.filePath, listenSocket >= 0 ? settings.port : 0,
+                   settings.intervalSeconds);
+    return true;
 }
 
-static bool ensureAlbumStream(std::fstream& AlbFile) {
-    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
-    if (AlbFile.is_open()) {
-        return true;
+void MetricsExporter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!worker.joinable()) {
+            return;
+        }
+        stopRequested = true;
     }
-    try {
-        openFile(AlbFile, albumFilePath);
-        return true;
-    } catch (const FileException& e) {
-        cout << e.what() << endl;
-        system("pause");
-        return false;
+    wake.notify_all();
+    worker.join();
+    if (!settings.filePath.empty()) {
+        writeFile();
+    }
+#ifndef _WIN32
+    if (listenSocket >= 0) {
+        close(listenSocket);
     }
+#endif
+    listenSocket = -1;
 }
 
-static ArtistFile toArtistFile(const Artist& artist) {
-    ArtistFile artFile{};
-    strncpy(artFile.artistIds, artist.getArtistId().c_str(), 7);
-    artFile.artistIds[7] = '\0';
-    strncpy(artFile.names, artist.getName().c_str(), 49);
-    artFile.names[49] = '\0';
-    artFile.genders = artist.getGender();
-    strncpy(artFile.phones, artist.getPhone().c_str(), 14);
-    artFile.phones[14] = '\0';
-    strncpy(artFile.emails, artist.getEmail().c_str(), 49);
-    artFile.emails[49] = '\0';
-    return artFile;
+bool MetricsExporter::running() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return worker.joinable() && !stopRequested;
 }
 
-static Artist fromArtistFile(const ArtistFile& artFile) {
-    Artist artist;
-    artist.setArtistId(std::string(artFile.artistIds));
-    artist.setName(std::string(artFile.names));
-    artist.setGender(artFile.genders);
-    artist.setPhone(std::string(artFile.phones));
-    artist.setEmail(std::string(artFile.emails));
-    return artist;
+std::string MetricsExporter::render() const {
+    MemoryProfiler::instance().sample();
+    MetricsSnapshot snapshot = MetricsRegistry::instance().snapshot();
+    sampleRecordFile(snapshot, artistFilePath, RecordKind::Artist, "artist");
+    sampleRecordFile(snapshot, albumFilePath, RecordKind::Album, "album");
+    std::sort(snapshot.gauges.begin(), snapshot.gauges.end());
+    return formatPrometheusText(snapshot);
 }
 
-static AlbumFile toAlbumFile(const Album& album) {
-    AlbumFile albFile{};
-    strncpy(albFile.albumIds, album.getAlbumId().c_str(), 7);
-    albFile.albumIds[7] = '\0';
-    strncpy(albFile.artistIdRefs, album.getArtistId().c_str(), 7);
-    albFile.artistIdRefs[7] = '\0';
-    strncpy(albFile.titles, album.getTitle().c_str(), 79);
-    albFile.titles[79] = '\0';
-    strncpy(albFile.recordFormats, album.getRecordFormat().c_str(), 11);
-    albFile.recordFormats[11] = '\0';
-    strncpy(albFile.datePublished, album.getDatePublished().c_str(), 10);
-    albFile.datePublished[10] = '\0';
-    strncpy(albFile.paths, album.getPath().c_str(), 99);
-    albFile.paths[99] = '\0';
-    return albFile;
+void MetricsExporter::run() {
+    using Clock = std::chrono::steady_clock;
+    const auto interval = std::chrono::seconds(settings.intervalSeconds);
+    // Poll in short slices while serving HTTP so stop() is noticed promptly.
+    const auto slice = std::chrono::milliseconds(200);
+    auto nextWrite = Clock::now();
+    while (true) {
+        if (!settings.filePath.empty() && Clock::now() >= nextWrite) {
+            writeFile();
+            nextWrite = Clock::now() + interval;
+        }
+        auto wait = settings.filePath.empty()
+            ? std::chrono::duration_cast<std::chrono::milliseconds>(interval)
+            : std::chrono::duration_cast<std::chrono::milliseconds>(nextWrite - Clock::now());
+#ifndef _WIN32
+        if (listenSocket >= 0) {
+            pollfd listener{listenSocket, POLLIN, 0};
+            int timeout = static_cast<int>(std::max<std::int64_t>(0, std::min(wait, slice).count()));
+            if (poll(&listener, 1, timeout) > 0 && (listener.revents & POLLIN)) {
+                int client = accept(listenSocket, nullptr, nullptr);
+                if (client >= 0) {
+                    serveClient(client);
+                    close(client);
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopRequested) {
+                break;
+            }
+            continue;
+        }
+#endif
+        std::unique_lock<std::mutex> lock(mutex);
+        if (wake.wait_for(lock, wait, [this] { return stopRequested; })) {
+            break;
+        }
+    }
 }
 
-static Album fromAlbumFile(const AlbumFile& albFile) {
-    Album album;
-    album.setAlbumId(std::string(albFile.albumIds));
-    album.setArtistId(std::string(albFile.artistIdRefs));
-    album.setTitle(std::string(albFile.titles));
-    album.setRecordFormat(std::string(albFile.recordFormats));
-    album.setDatePublished(std::string(albFile.datePublished));
-    album.setPath(std::string(albFile.paths));
-    return album;
+void MetricsExporter::writeFile() const {
+    // Rewrite through a temporary and rename so scrapers never read a partial file.
+    std::string tempPath = settings.filePath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        out << render();
+        if (!out) {
+            ALBUM_LOG_WARN("Failed to write metrics file {}", tempPath);
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tempPath, settings.filePath, ec);
+    if (ec) {
+        ALBUM_LOG_WARN("Failed to publish metrics file {}: {}", settings.filePath, ec.message());
+    }
 }
 
-static bool readArtistAtPosition(std::fstream& ArtFile, long pos, Artist& artist) {
-    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
-    if (!ensureArtistStream(ArtFile)) {
-        return false;
+void MetricsExporter::serveClient(int client) const {
+#ifdef _WIN32
+    (void)client;
+#else
+    std::string request;
+    char buffer[1024];
+    pollfd readable{client, POLLIN, 0};
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192 &&
+           poll(&readable, 1, 1000) > 0) {
+        ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            break;
+        }
+        request.append(buffer, static_cast<std::size_t>(received));
     }
-    ArtistFile artFile{};
-    ArtFile.clear();
-    ArtFile.seekg(pos, std::ios::beg);
-    if (!ArtFile.read(reinterpret_cast<char*>(&artFile), sizeof(ArtistFile))) {
-        return false;
+    bool found = request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 6, "GET / ") == 0;
+    std::string body = found ? render() : "Not Found\n";
+    std::string response = std::string(found ? "HTTP/1.1 200 OK\r\n" : "HTTP/1.1 404 Not Found\r\n") +
+        "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n" +
+        "Content-Length: " + std::to_string(body.size()) + "\r\n" +
+        "Connection: close\r\n\r\n" + body;
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+    std::size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t n = send(client, response.data() + sent, response.size() - sent, flags);
+        if (n <= 0) {
+            break;
+        }
+        sent += static_cast<std::size_t>(n);
     }
-    artist = fromArtistFile(artFile);
-    return true;
+#endif
 }
 
-static bool writeArtistAtPosition(std::fstream& ArtFile, long pos, const Artist& artist) {
-    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
-    if (!ensureArtistStream(ArtFile)) {
-        return false;
-    }
-    ArtistFile artFile = toArtistFile(artist);
-    ArtFile.clear();
-    ArtFile.seekp(pos, std::ios::beg);
-    ArtFile.write(reinterpret_cast<const char*>(&artFile), sizeof(ArtistFile));
-    ArtFile.flush();
-    return static_cast<bool>(ArtFile);
+namespace {
+
+// Heap held by a string beyond its inline buffer, including the terminator.
+std::size_t stringHeapBytes(const std::string& text) {
+    static const std::size_t inlineCapacity = std::string().capacity();
+    return text.capacity() > inlineCapacity ? text.capacity() + 1 : 0;
 }
 
-static bool appendArtistRecord(std::fstream& ArtFile, const Artist& artist, long& outPos) {
-    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
-    if (!ensureArtistStream(ArtFile)) {
-        return false;
+} // namespace
+
+const char* memoryCategoryName(MemoryCategory category) {
+    switch (category) {
+        case MemoryCategory::ArtistIndex: return "artist_index";
+        case MemoryCategory::AlbumIndex: return "album_index";
+        case MemoryCategory::UndoHistory: return "undo_history";
+        case MemoryCategory::RecordCache: return "record_cache";
+        case MemoryCategory::Count: break;
     }
-    ArtistFile artFile = toArtistFile(artist);
-    ArtFile.clear();
-    ArtFile.seekp(0, std::ios::end);
-    outPos = ArtFile.tellp();
-    ArtFile.write(reinterpret_cast<const char*>(&artFile), sizeof(ArtistFile));
-    ArtFile.flush();
-    return static_cast<bool>(ArtFile);
+    return "unknown";
 }
 
-static bool readAlbumAtPosition(std::fstream& AlbFile, long pos, Album& album) {
-    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
-    if (!ensureAlbumStream(AlbFile)) {
+MemoryProfiler& MemoryProfiler::instance() {
+    // Never destroyed: stop() runs from atexit while the thread is still joinable.
+    static MemoryProfiler* profiler = new MemoryProfiler();
+    return *profiler;
+}
+
+bool MemoryProfiler::start(int intervalSeconds) {
+    stop();
+    sample();
+    if (intervalSeconds <= 0) {
         return false;
     }
-    AlbumFile albFile{};
-    AlbFile.clear();
-    AlbFile.seekg(pos, std::ios::beg);
-    if (!AlbFile.read(reinterpret_cast<char*>(&albFile), sizeof(AlbumFile))) {
-        return false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopRequested = false;
+    }
+    worker = std::thread(&MemoryProfiler::run, this, intervalSeconds);
+    static bool stopRegistered = false;
+    if (!stopRegistered) {
+        stopRegistered = true;
+        std::atexit([] { MemoryProfiler::instance().stop(); });
     }
-    album = fromAlbumFile(albFile);
     return true;
 }
 
-static bool writeAlbumAtPosition(std::fstream& AlbFile, long pos, const Album& album) {
-    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
-    if (!ensureAlbumStream(AlbFile)) {
-        return false;
+void MemoryProfiler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!worker.joinable()) {
+            return;
+        }
+        stopRequested = true;
     }
-    AlbumFile albFile = toAlbumFile(album);
-    AlbFile.clear();
-    AlbFile.seekp(pos, std::ios::beg);
-    AlbFile.write(reinterpret_cast<const char*>(&albFile), sizeof(AlbumFile));
-    AlbFile.flush();
-    return static_cast<bool>(AlbFile);
+    wake.notify_all();
+    worker.join();
 }
 
-static bool appendAlbumRecord(std::fstream& AlbFile, const Album& album, long& outPos) {
-    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
-    if (!ensureAlbumStream(AlbFile)) {
-        return false;
+void MemoryProfiler::run(int intervalSeconds) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!wake.wait_for(lock, std::chrono::seconds(intervalSeconds), [this] { return stopRequested; })) {
+        lock.unlock();
+        sample();
+        lock.lock();
     }
-    AlbumFile albFile = toAlbumFile(album);
-    AlbFile.clear();
-    AlbFile.seekp(0, std::ios::end);
-    outPos = AlbFile.tellp();
-    AlbFile.write(reinterpret_cast<const char*>(&albFile), sizeof(AlbumFile));
-    AlbFile.flush();
-    return static_cast<bool>(AlbFile);
 }
 
-static int findArtistIndexById(const artistList& artists, const std::string& artistId) {
-    for (size_t i = 0; i < artists.artList.size(); ++i) {
-        if (artists.artList[i].artistId == artistId) {
-            return static_cast<int>(i);
+void MemoryProfiler::sample() {
+    static MetricGauge& residentGauge = MetricsRegistry::instance().gauge("resident_memory_bytes");
+    static MetricGauge& peakGauge = MetricsRegistry::instance().gauge("resident_memory_peak_bytes");
+    std::int64_t resident = residentMemoryBytes();
+    if (resident >= 0) {
+        std::int64_t peak = peakResident.load(std::memory_order_relaxed);
+        while (resident > peak && !peakResident.compare_exchange_weak(peak, resident, std::memory_order_relaxed)) {
         }
+        residentGauge.set(resident);
+        peakGauge.set(std::max(peak, resident));
     }
-    return -1;
+    std::int64_t accounted = 0;
+    for (std::size_t i = 0; i < static_cast<std::size_t>(MemoryCategory::Count); ++i) {
+        auto category = static_cast<MemoryCategory>(i);
+        std::int64_t live = memoryCategoryStats(category).liveBytes.load(std::memory_order_relaxed);
+        MetricsRegistry::instance().gauge(std::string("memory_") + memoryCategoryName(category) + "_bytes").set(live);
+        accounted += live;
+    }
+    ALBUM_LOG_TRACE("Memory sample - resident {} bytes, {} bytes in tracked containers", resident, accounted);
 }
 
-static int findAlbumIndexById(const albumList& albums, const std::string& albumId) {
-    for (size_t i = 0; i < albums.albList.size(); ++i) {
-        if (albums.albList[i].albumId == albumId) {
-            return static_cast<int>(i);
-        }
-    }
-    return -1;
+#if ALBUM_TRACING
+namespace {
+
+const std::size_t TRACE_EVENTS_PER_THREAD = std::size_t{1} << 20;
+
+struct TraceBuffer {
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+    std::uint32_t threadId = 0;
+    std::uint64_t dropped = 0;
+};
+
+struct TraceRegistry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<TraceBuffer>> buffers;
+    std::uint32_t nextThreadId = 1;
+};
+
+TraceRegistry& traceRegistry() {
+    // Never destroyed so spans closing during static destruction still have a home.
+    static TraceRegistry* registry = new TraceRegistry();
+    return *registry;
 }
 
-/**
- * @brief Displays the welcome message to the user.
- */
-void welcome()  //2
-{
-    system("COLOR 2F");
-	cout<<"\n\n";
-	cout<<setfill('~')<<setw(150)<<'~';
-	cout<<"\n";
-	cout<<"\n                          |o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o|     ";
-	cout<<"\n                          |                                                 |     ";
-	cout<<"\n                          |                                                 |     ";
-	cout<<"\n                          |                    WELCOME                      |     ";
-	cout<<"\n                          |                                                 |     ";
-	cout<<"\n                          |              o ALBUM MANAGEMENT o               |     ";
-	cout<<"\n                          |                                                 |     ";
-	cout<<"\n                          |                                                 |     ";
-	cout<<"\n                          |                                                 |     ";
-	cout<<"\n                          |             Enter ENTER to continue...          |     ";
-	cout<<"\n                          |                                                 |     ";
-	cout<<"\n                          |o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o|     ";
-	cout<<'\n'<<setw(150)<<'~'<<setfill(' ');
-	cout<<endl<<endl;
-    cout << "\tVersion: " << ALBUM_APP_VERSION << endl << endl;
-    system("pause");
+// The registry shares ownership, so a thread's spans survive the thread.
+TraceBuffer& localTraceBuffer() {
+    thread_local std::shared_ptr<TraceBuffer> buffer = [] {
+        auto created = std::make_shared<TraceBuffer>();
+        created->events.reserve(4096);
+        TraceRegistry& registry = traceRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        created->threadId = registry.nextThreadId++;
+        registry.buffers.push_back(created);
+        return created;
+    }();
+    return *buffer;
 }
 
-//
-void printError(int errId){
-    switch (errId){
-        case 1:
-            cout << "\t\n Error~ Artist file can not be opened!" << endl;
-            break;
-        case 2:
-            cout << "\t\n Error~ Album file can not be opened!" << endl;
-            break;
-        case 3:
-            cout << "\t\n Error~No sufficient memory. Program can not continue!" << endl;
-            break;
-        case 4:
-            cout << "\t\n Error~no search results found.\n" << endl;
-            break;
-        case 5:
-            cout << " \t\n Error~ No sufficient memory to create a space for the result array!" << endl;
-            break;
-    }
+std::uint64_t traceNowNs() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
 }
 
-//
-void intToCharArray(int last, char id[], char prefix[])
-{
-    int i=6;
-    strcpy(id, prefix);
-    while(i>2){
-        id[i--] = last%10 + '0';
-        last /= 10;
+void appendJsonString(std::string& out, const char* text) {
+    out += '"';
+    for (const char* p = text; *p; ++p) {
+        if (*p == '"' || *p == '\\') {
+            out += '\\';
+        }
+        out += *p;
     }
+    out += '"';
 }
 
-//
-int charArrayToInt(char *arr)
-{
-    int value, flag, r;
-    flag = 1;
-    value = 0;
-    for( size_t i=3; i<strlen(arr); i++){
-        if( i==0 && arr[i]=='-' ){
-            flag = -1;
-            continue;
-        }
-        r = arr[i] - '0';
-        value = value * 10 + r;
+} // namespace
+
+TraceSpan::TraceSpan(const char* spanName) : name(spanName), startNs(traceNowNs()) {}
+
+TraceSpan::~TraceSpan() {
+    std::uint64_t endNs = traceNowNs();
+    TraceBuffer& buffer = localTraceBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.events.size() < TRACE_EVENTS_PER_THREAD) {
+        buffer.events.push_back({name, startNs, endNs - startNs});
+    } else {
+        ++buffer.dropped;
     }
-    value = value * flag;
-    return value;
 }
 
-//
-void openFile(std::fstream& fstr, const std::string& path)
-{
-    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
-    cout<<'\n';
-    
-    // Try to open file for reading and writing
-    fstr.open(path, std::ios::in | std::ios::out | std::ios::binary);
-    if (!fstr) {
-        // File doesn't exist, create it
-        std::ofstream createFile(path, std::ios::binary);
-        if (!createFile) {
-            throw FileException("Failed to create file: " + path);
-        }
-        createFile.close();
-        
-        // Now open it for reading and writing
-        fstr.open(path, std::ios::in | std::ios::out | std::ios::binary);
-        if (!fstr) {
-            throw FileException("Failed to open file: " + path);
-        }
+bool writeChromeTrace(std::ostream& out) {
+    std::vector<std::shared_ptr<TraceBuffer>> buffers;
+    {
+        TraceRegistry& registry = traceRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        buffers = registry.buffers;
+    }
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    char number[64];
+    for (const auto& buffer : buffers) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        for (const TraceEvent& event : buffer->events) {
+            json += first ? "\n" : ",\n";
+            first = false;
+            json += "{\"name\":";
+            appendJsonString(json, event.name);
+            std::snprintf(number, sizeof(number), ",\"cat\":\"album\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f",
+                          static_cast<double>(event.startNs) / 1000.0, static_cast<double>(event.durationNs) / 1000.0);
+            json += number;
+            json += ",\"pid\":1,\"tid\":" + std::to_string(buffer->threadId) + "}";
+        }
+        if (buffer->dropped > 0) {
+            ALBUM_LOG_WARN("Trace buffer of thread {} dropped {} span(s)", buffer->threadId, buffer->dropped);
+        }
+    }
+    json += "\n]}\n";
+    out << json;
+    return static_cast<bool>(out);
+}
+
+bool writeChromeTraceFile(const std::string& path) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out || !writeChromeTrace(out)) {
+        ALBUM_LOG_ERROR("Failed to write trace file {}", path);
+        return false;
     }
+    ALBUM_LOG_INFO("Trace with {} span(s) written to {}", traceEventCount(), path);
+    return true;
 }
 
-std::string intToString(int last, const std::string& prefix) {
-    return prefix + std::to_string(last);
+std::size_t traceEventCount() {
+    TraceRegistry& registry = traceRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::size_t count = 0;
+    for (const auto& buffer : registry.buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        count += buffer->events.size();
+    }
+    return count;
 }
 
-int stringToInt(const std::string& arr) {
-    // Assuming format is prefix + number, extract the number part
-    size_t start = 0;
-    while (start < arr.size() && !isdigit(arr[start])) start++;
-    if (start == arr.size()) return 0;
-    return std::stoi(arr.substr(start));
+void clearTrace() {
+    TraceRegistry& registry = traceRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& buffer : registry.buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->events.clear();
+        buffer->dropped = 0;
+    }
 }
+#endif
 
-//3
-bool loading(fstream & ArtFile, fstream & AlbFile, artistList & artist, albumList & album, indexSet & delArtFile, indexSet & delAlbFile)
-{
-    int i = 0;
- 	char load[26];
- 	while(i < 25)
- 	{
- 		system("cls");
- 		load[i++] = '#';
- 		load[i] = '\0';
-        cout<<"\n\n\n\n\n\n\n\t\t\t\tLOADING: "<< load;
- 		usleep(199900);
- 	}
-    system("clear");
-    cout<<"\n";
-    system("cls");
+void MemoryProfiler::writeBreakdown(std::ostream& out, const artistList& artists, const albumList& albums) {
+    sample();
+    std::size_t artistStrings = 0;
+    for (const auto& entry : artists.artList) {
+        artistStrings += stringHeapBytes(entry.artistId) + stringHeapBytes(entry.name);
+    }
+    std::size_t albumStrings = 0;
+    for (const auto& entry : albums.albList) {
+        albumStrings += stringHeapBytes(entry.albumId) + stringHeapBytes(entry.artistId) + stringHeapBytes(entry.title);
+    }
 
-    // Check if files are empty and create sample data if needed
-    if (!loadArtist(ArtFile, artist, delArtFile) || artist.artList.empty()) {
-        // createSampleData(ArtFile, AlbFile, artist, album);
-        // Reload after creating sample data
-        // artist.artList.clear();
-        // album.albList.clear();
-        // loadArtist(ArtFile, artist, delArtFile);
+    out << std::left << std::setw(32) << "Memory (bytes)" << std::right << std::setw(14) << "live"
+        << std::setw(14) << "peak" << std::setw(14) << "allocations" << "\n";
+    std::int64_t accounted = 0;
+    for (std::size_t i = 0; i < static_cast<std::size_t>(MemoryCategory::Count); ++i) {
+        auto category = static_cast<MemoryCategory>(i);
+        const MemoryCategoryStats& stats = memoryCategoryStats(category);
+        std::int64_t live = stats.liveBytes.load(std::memory_order_relaxed);
+        accounted += live;
+        out << std::left << std::setw(32) << memoryCategoryName(category) << std::right << std::setw(14) << live
+            << std::setw(14) << stats.peakBytes.load(std::memory_order_relaxed)
+            << std::setw(14) << stats.allocations.load(std::memory_order_relaxed) << "\n";
     }
+    out << std::left << std::setw(32) << "artist_index_strings" << std::right << std::setw(14) << artistStrings << "\n";
+    out << std::left << std::setw(32) << "album_index_strings" << std::right << std::setw(14) << albumStrings << "\n";
+    accounted += static_cast<std::int64_t>(artistStrings + albumStrings);
 
-    if(!loadAlbum(AlbFile, album, delAlbFile))
-        return false;
+    std::int64_t resident = residentMemoryBytes();
+    if (resident >= 0) {
+        out << std::left << std::setw(32) << "resident_set" << std::right << std::setw(14) << resident
+            << std::setw(14) << peakResident.load(std::memory_order_relaxed) << "\n";
+        out << std::left << std::setw(32) << "unaccounted" << std::right << std::setw(14)
+            << std::max<std::int64_t>(0, resident - accounted) << "\n";
+    }
+}
 
-    return true;
+namespace {
+
+std::uint64_t readLE64(const unsigned char* p) {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
 }
 
-//5
-bool loadArtist(std::fstream& ArtFile, artistList& artist, indexSet& delArtFile)
-{
-    ArtistFile artFile;
-    int nRec, pos;
-    std::string id;
+std::uint32_t readLE32(const unsigned char* p) {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
 
-    try {
-        openFile(ArtFile, artistFilePath);
-    } catch(const FileException& e) {
-        printError(1);
-        system("pause");
-        return false;
-    }
-    ArtFile.seekg(0, ios::end);
-    nRec = ArtFile.tellg() / sizeof(artFile);
-    artist.artList.reserve(nRec + DEFAULT_SIZE);
-    ArtFile.seekg(0, ios::beg);
-    pos = 0;
-    for (int i = 0; i < nRec; i++){
-        ArtFile.read((char*)&artFile, sizeof(artFile));
-        artFile.artistIds[7] = '\0';
-        artFile.names[49] = '\0';
-        if(std::string(artFile.artistIds) != "-1"){
-            artist.artList.push_back({std::string(artFile.artistIds), std::string(artFile.names), pos});
-            int currentId = stringToInt(std::string(artFile.artistIds));
-            if(currentId > lastArtistID){
-                lastArtistID = currentId;
+// Slicing-by-8 tables for the portable CRC32C path.
+struct Crc32cTables {
+    std::uint32_t table[8][256];
+
+    Crc32cTables() {
+        const std::uint32_t poly = 0x82F63B78u;
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
             }
+            table[0][i] = crc;
         }
-        else{
-            delArtFile.indexes.push_back(pos);
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            for (int slice = 1; slice < 8; ++slice) {
+                std::uint32_t prev = table[slice - 1][i];
+                table[slice][i] = (prev >> 8) ^ table[0][prev & 0xFF];
+            }
         }
-        pos = ArtFile.tellg();
     }
-    sortArtist(artist);
-    return true;
+};
+
+const Crc32cTables& crc32cTables() {
+    static const Crc32cTables tables;
+    return tables;
 }
 
-//6
-bool loadAlbum(std::fstream& AlbFile, albumList& album, indexSet& delAlbFile)
-{
-    AlbumFile albFile;
-    int nRec, pos;
+std::uint32_t crc32cPortable(const unsigned char* p, std::size_t length, std::uint32_t crc) {
+    const auto& t = crc32cTables().table;
+    while (length >= 8) {
+        std::uint32_t lo = readLE32(p) ^ crc;
+        std::uint32_t hi = readLE32(p + 4);
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+        p += 8;
+        length -= 8;
+    }
+    while (length--) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    }
+    return crc;
+}
 
-    try {
-        openFile(AlbFile, albumFilePath);
-    } catch(const FileException& e) {
-        printError(2);
-        system("pause");
-        return false;
+#ifdef ALBUM_HAVE_CRC32C_INSTRUCTION
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("sse4.2")))
+#endif
+std::uint32_t crc32cHardware(const unsigned char* p, std::size_t length, std::uint32_t crc) {
+    std::uint64_t crc64 = crc;
+    while (length >= 8) {
+        crc64 = _mm_crc32_u64(crc64, readLE64(p));
+        p += 8;
+        length -= 8;
     }
-    AlbFile.seekg(0, ios::end);
-    nRec = AlbFile.tellg() / sizeof(albFile);
-    album.albList.reserve(nRec + DEFAULT_SIZE);
-    AlbFile.seekg(0, ios::beg);
-    pos = 0;
-    for (int i = 0; i < nRec; i++){
-        AlbFile.read((char*)&albFile, sizeof(albFile));
-        albFile.albumIds[7] = '\0';
-        albFile.artistIdRefs[7] = '\0';
-        albFile.titles[79] = '\0';
-        if (std::string(albFile.albumIds) != "-1"){
-            album.albList.push_back(albumIndex{std::string(albFile.albumIds), std::string(albFile.artistIdRefs), std::string(albFile.titles), pos});
-            int currentId = stringToInt(std::string(albFile.albumIds));
-            if (currentId > lastAlbumID){
-                lastAlbumID = currentId;
-            }
-        }
-        else{
-            delAlbFile.indexes.push_back(pos);
-        }
-        pos = AlbFile.tellg();
+    std::uint32_t crc32 = static_cast<std::uint32_t>(crc64);
+    while (length--) {
+        crc32 = _mm_crc32_u8(crc32, *p++);
     }
-    sortAlbum(album);
-    return true;
+    return crc32;
 }
 
-//7
-void sortArtist(artistList& artist)
-{
-    std::sort(artist.artList.begin(), artist.artList.end(), [](const artistIndex& a, const artistIndex& b) {
-        return a.name < b.name;
-    });
+bool cpuHasSse42() {
+#if defined(_MSC_VER)
+    int info[4] = {0, 0, 0, 0};
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.2");
+#endif
 }
+#endif
 
-//8
-void sortAlbum(albumList& album)
-{
-    std::sort(album.albList.begin(), album.albList.end(), [](const albumIndex& a, const albumIndex& b) {
-        return a.artistId < b.artistId;
-    });
+const std::uint64_t XXH_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+const std::uint64_t XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+const std::uint64_t XXH_PRIME64_3 = 0x165667B19E3779F9ULL;
+const std::uint64_t XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+const std::uint64_t XXH_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+inline std::uint64_t rotl64(std::uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
 }
 
-//9
-void mainH(fstream & ArtFile, fstream & AlbFile, artistList & artist, albumList & album, indexSet & result, indexSet & delArtArray, indexSet & delAlbArray)
-{
+inline std::uint64_t xxhRound(std::uint64_t acc, std::uint64_t input) {
+    acc += input * XXH_PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * XXH_PRIME64_1;
+}
+
+inline std::uint64_t xxhMergeRound(std::uint64_t acc, std::uint64_t val) {
+    acc ^= xxhRound(0, val);
+    return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+class Fnv1a32Engine : public ChecksumEngine {
+public:
+    ChecksumAlgorithm algorithm() const override { return ChecksumAlgorithm::Fnv1a32; }
+    const char* name() const override { return "fnv1a32"; }
+    std::uint64_t digest(const void* data, std::size_t length, std::uint64_t seed) const override {
+        const std::uint32_t fnvPrime = 16777619u;
+        std::uint32_t hash = seed == 0 ? 2166136261u : static_cast<std::uint32_t>(seed);
+        const auto* p = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < length; ++i) {
+            hash ^= p[i];
+            hash *= fnvPrime;
+        }
+        return hash;
+    }
+    bool sequential() const override { return true; }
+};
+
+class Crc32cEngine : public ChecksumEngine {
+public:
+    ChecksumAlgorithm algorithm() const override { return ChecksumAlgorithm::Crc32c; }
+    const char* name() const override { return "crc32c"; }
+    std::uint64_t digest(const void* data, std::size_t length, std::uint64_t seed) const override {
+        return crc32c(data, length, static_cast<std::uint32_t>(seed));
+    }
+};
+
+class XxHash64Engine : public ChecksumEngine {
+public:
+    ChecksumAlgorithm algorithm() const override { return ChecksumAlgorithm::XxHash64; }
+    const char* name() const override { return "xxh64"; }
+    std::uint64_t digest(const void* data, std::size_t length, std::uint64_t seed) const override {
+        return xxHash64(data, length, seed);
+    }
+};
+
+// Hashes chunks [first, first + stride, ...) of a file into digests.
+void hashFileChunks(const std::string& path, const ChecksumEngine& engine, std::size_t first, std::size_t stride,
+                    std::uint64_t fileSize, std::vector<std::uint64_t>& digests) {
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> buffer(CHECKSUM_CHUNK_SIZE);
+    for (std::size_t chunk = first; chunk < digests.size(); chunk += stride) {
+        std::uint64_t offset = static_cast<std::uint64_t>(chunk) * CHECKSUM_CHUNK_SIZE;
+        std::size_t length = static_cast<std::size_t>(std::min<std::uint64_t>(CHECKSUM_CHUNK_SIZE, fileSize - offset));
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+        file.read(buffer.data(), static_cast<std::streamsize>(length));
+        std::size_t count = static_cast<std::size_t>(std::max<std::streamsize>(file.gcount(), 0));
+        digests[chunk] = engine.digest(buffer.data(), count, 0);
+    }
+}
+
+} // namespace
+
+std::uint32_t crc32c(const void* data, std::size_t length, std::uint32_t crc) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+#ifdef ALBUM_HAVE_CRC32C_INSTRUCTION
+    static const bool hardware = cpuHasSse42();
+    if (hardware) {
+        return ~crc32cHardware(p, length, crc);
+    }
+#endif
+    return ~crc32cPortable(p, length, crc);
+}
+
+std::uint64_t xxHash64(const void* data, std::size_t length, std::uint64_t seed) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + length;
+    std::uint64_t h64;
+
+    if (length >= 32) {
+        const unsigned char* limit = end - 32;
+        std::uint64_t v1 = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+        std::uint64_t v2 = seed + XXH_PRIME64_2;
+        std::uint64_t v3 = seed;
+        std::uint64_t v4 = seed - XXH_PRIME64_1;
+        do {
+            v1 = xxhRound(v1, readLE64(p));
+            v2 = xxhRound(v2, readLE64(p + 8));
+            v3 = xxhRound(v3, readLE64(p + 16));
+            v4 = xxhRound(v4, readLE64(p + 24));
+            p += 32;
+        } while (p <= limit);
+        h64 = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h64 = xxhMergeRound(h64, v1);
+        h64 = xxhMergeRound(h64, v2);
+        h64 = xxhMergeRound(h64, v3);
+        h64 = xxhMergeRound(h64, v4);
+    } else {
+        h64 = seed + XXH_PRIME64_5;
+    }
+
+    h64 += static_cast<std::uint64_t>(length);
+
+    while (p + 8 <= end) {
+        h64 ^= xxhRound(0, readLE64(p));
+        h64 = rotl64(h64, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h64 ^= static_cast<std::uint64_t>(readLE32(p)) * XXH_PRIME64_1;
+        h64 = rotl64(h64, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        p += 4;
+    }
+    while (p < end) {
+        h64 ^= (*p++) * XXH_PRIME64_5;
+        h64 = rotl64(h64, 11) * XXH_PRIME64_1;
+    }
+
+    h64 ^= h64 >> 33;
+    h64 *= XXH_PRIME64_2;
+    h64 ^= h64 >> 29;
+    h64 *= XXH_PRIME64_3;
+    h64 ^= h64 >> 32;
+    return h64;
+}
+
+const ChecksumEngine& checksumEngine(ChecksumAlgorithm algorithm) {
+    static const Fnv1a32Engine fnv;
+    static const Crc32cEngine crc;
+    static const XxHash64Engine xxh;
+    switch (algorithm) {
+        case ChecksumAlgorithm::Fnv1a32:
+            return fnv;
+        case ChecksumAlgorithm::Crc32c:
+            return crc;
+        case ChecksumAlgorithm::XxHash64:
+        default:
+            return xxh;
+    }
+}
+
+std::string Checksum::toString() const {
+    if (algorithm == ChecksumAlgorithm::Fnv1a32) {
+        return std::to_string(value);
+    }
+    std::ostringstream oss;
+    oss << checksumEngine(algorithm).name() << ':' << std::hex << std::setw(algorithm == ChecksumAlgorithm::Crc32c ? 8 : 16)
+        << std::setfill('0') << value;
+    return oss.str();
+}
+
+bool Checksum::parse(const std::string& text, Checksum& out) {
+    auto colon = text.find(':');
+    try {
+        if (colon == std::string::npos) {
+            out.algorithm = ChecksumAlgorithm::Fnv1a32;
+            out.value = static_cast<std::uint32_t>(std::stoul(text));
+            return true;
+        }
+        std::string name = text.substr(0, colon);
+        for (ChecksumAlgorithm alg : {ChecksumAlgorithm::Crc32c, ChecksumAlgorithm::XxHash64}) {
+            if (name == checksumEngine(alg).name()) {
+                out.algorithm = alg;
+                out.value = std::stoull(text.substr(colon + 1), nullptr, 16);
+                return true;
+            }
+        }
+    } catch (...) {
+    }
+    out = Checksum{ChecksumAlgorithm::Fnv1a32, 0};
+    return false;
+}
+
+std::uint64_t combineChunkDigests(const ChecksumEngine& engine, const std::vector<std::uint64_t>& chunkDigests, std::uint64_t totalLength) {
+    std::vector<unsigned char> packed((chunkDigests.size() + 1) * sizeof(std::uint64_t));
+    for (std::size_t i = 0; i < chunkDigests.size(); ++i) {
+        std::memcpy(&packed[i * sizeof(std::uint64_t)], &chunkDigests[i], sizeof(std::uint64_t));
+    }
+    std::memcpy(&packed[chunkDigests.size() * sizeof(std::uint64_t)], &totalLength, sizeof(std::uint64_t));
+    return engine.digest(packed.data(), packed.size(), 0);
+}
+
+Checksum computeFileChecksum(const std::string& path, ChecksumAlgorithm algorithm) {
+    ALBUM_TRACE_SCOPE("computeFileChecksum");
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    const ChecksumEngine& engine = checksumEngine(algorithm);
+    Checksum result{algorithm, 0};
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return result;
+    }
+    std::uint64_t fileSize = static_cast<std::uint64_t>(file.tellg());
+
+    if (engine.sequential()) {
+        file.seekg(0, std::ios::beg);
+        std::vector<char> buffer(65536);
+        std::uint64_t state = 0;
+        while (file) {
+            file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            std::streamsize count = file.gcount();
+            if (count <= 0) {
+                break;
+            }
+            state = engine.digest(buffer.data(), static_cast<std::size_t>(count), state);
+        }
+        result.value = state == 0 ? engine.digest(nullptr, 0, 0) : state;
+        return result;
+    }
+    file.close();
+
+    std::size_t chunks = static_cast<std::size_t>((fileSize + CHECKSUM_CHUNK_SIZE - 1) / CHECKSUM_CHUNK_SIZE);
+    std::vector<std::uint64_t> digests(chunks, 0);
+    std::size_t workers = std::min<std::size_t>(chunks, std::max(1u, std::thread::hardware_concurrency()));
+    if (workers <= 1) {
+        hashFileChunks(path, engine, 0, 1, fileSize, digests);
+    } else {
+        std::vector<std::thread> pool;
+        pool.reserve(workers);
+        for (std::size_t w = 0; w < workers; ++w) {
+            pool.emplace_back(hashFileChunks, std::cref(path), std::cref(engine), w, workers, fileSize, std::ref(digests));
+        }
+        for (auto& t : pool) {
+            t.join();
+        }
+    }
+    result.value = combineChunkDigests(engine, digests, fileSize);
+    return result;
+}
+
+struct CommandAction {
+    std::function<bool()> redo;
+    std::function<void()> undo;
+    std::string description;
+};
+
+class CommandManager {
+private:
+    using ActionStack = std::stack<CommandAction, std::deque<CommandAction, CountingAllocator<CommandAction, MemoryCategory::UndoHistory>>>;
+
+    ActionStack undoStack;
+    ActionStack redoStack;
+
+public:
+    bool execute(CommandAction action) {
+        ALBUM_TIME_SCOPE("command_execute");
+        if (action.redo && action.redo()) {
+            undoStack.push(action);
+            // Clear redo history after a new operation
+            while (!redoStack.empty()) {
+                redoStack.pop();
+            }
+            publishDepth();
+            return true;
+        }
+        static MetricCounter& failed = MetricsRegistry::instance().counter("command_execute_failures");
+        failed.add();
+        return false;
+    }
+
+    bool undo() {
+        ALBUM_TIME_SCOPE("command_undo");
+        if (undoStack.empty()) {
+            return false;
+        }
+        CommandAction action = undoStack.top();
+        undoStack.pop();
+        if (action.undo) {
+            action.undo();
+        }
+        redoStack.push(action);
+        publishDepth();
+        return true;
+    }
+
+    bool redo() {
+        ALBUM_TIME_SCOPE("command_redo");
+        if (redoStack.empty()) {
+            return false;
+        }
+        CommandAction action = redoStack.top();
+        redoStack.pop();
+        bool redone = action.redo && action.redo();
+        if (redone) {
+            undoStack.push(action);
+        }
+        publishDepth();
+        return redone;
+    }
+
+    bool canUndo() const {
+        return !undoStack.empty();
+    }
+
+    bool canRedo() const {
+        return !redoStack.empty();
+    }
+
+    std::string nextUndoDescription() const {
+        if (undoStack.empty()) {
+            return "";
+        }
+        return undoStack.top().description;
+    }
+
+    std::string nextRedoDescription() const {
+        if (redoStack.empty()) {
+            return "";
+        }
+        return redoStack.top().description;
+    }
+
+    void clear() {
+        while (!undoStack.empty()) undoStack.pop();
+        while (!redoStack.empty()) redoStack.pop();
+        publishDepth();
+    }
+
+private:
+    void publishDepth() const {
+        static MetricGauge& undoDepth = MetricsRegistry::instance().gauge("undo_stack_depth");
+        static MetricGauge& redoDepth = MetricsRegistry::instance().gauge("redo_stack_depth");
+        undoDepth.set(static_cast<std::int64_t>(undoStack.size()));
+        redoDepth.set(static_cast<std::int64_t>(redoStack.size()));
+    }
+};
+
+static CommandManager commandManager;
+
+namespace {
+#ifdef _WIN32
+const char PATH_SEPARATOR = '\\';
+#else
+const char PATH_SEPARATOR = '/';
+#endif
+
+struct BackupEntry {
+    std::string timestamp;
+    std::string artistFile;
+    std::string albumFile;
+    Checksum artistChecksum;
+    Checksum albumChecksum;
+    std::int64_t journalOffset = -1; // Journal size when the snapshot was taken; -1 if unknown
+};
+
+std::string joinPath(const std::string& dir, const std::string& file) {
+    if (dir.empty()) {
+        return file;
+    }
+    if (dir.back() == '/' || dir.back() == '\\') {
+        return dir + file;
+    }
+    return dir + PATH_SEPARATOR + file;
+}
+
+std::string sanitizeStringInput(const std::string& input, size_t maxLength) {
+    std::string result;
+    result.reserve(std::min(maxLength, input.size()));
+    for (char ch : input) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        if (!std::isprint(c) && !std::isspace(c)) {
+            continue;
+        }
+        if (result.size() >= maxLength) {
+            break;
+        }
+        result.push_back(static_cast<char>(c));
+    }
+    auto first = result.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) {
+        return "";
+    }
+    auto last = result.find_last_not_of(" \t\r\n");
+    return result.substr(first, last - first + 1);
+}
+
+std::string sanitizeDigitInput(const std::string& input, size_t maxLength) {
+    std::string result;
+    result.reserve(std::min(maxLength, input.size()));
+    for (char ch : input) {
+        if (std::isdigit(static_cast<unsigned char>(ch))) {
+            result.push_back(ch);
+            if (result.size() >= maxLength) {
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+bool bufferedCopy(std::istream& src, std::ostream& dst) {
+    std::array<char, 65536> buffer{};
+    while (src) {
+        src.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        std::streamsize count = src.gcount();
+        if (count <= 0) {
+            break;
+        }
+        dst.write(buffer.data(), count);
+        if (!dst) {
+            return false;
+        }
+    }
+    dst.flush();
+    return dst.good();
+}
+
+bool ensureDirectoryExists(const std::string& dir) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+#ifdef _WIN32
+    if (_mkdir(dir.c_str()) == 0) {
+        return true;
+    }
+#else
+    if (mkdir(dir.c_str(), 0755) == 0) {
+        return true;
+    }
+#endif
+    if (errno == EEXIST) {
+        return true;
+    }
+    return false;
+}
+
+bool ensureIndexFileExists() {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    if (!ensureDirectoryExists(backupDirectory)) {
+        return false;
+    }
+    std::ifstream check(backupIndexFile);
+    if (check.good()) {
+        return true;
+    }
+    check.close();
+    std::ofstream create(backupIndexFile, std::ios::app);
+    return create.good();
+}
+
+bool fileExists(const std::string& path) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    std::ifstream file(path, std::ios::binary);
+    return file.good();
+}
+
+bool copyFile(const std::string& source, const std::string& destination) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    return copyFileContents(source, destination);
+}
+
+std::string makeTimestamp() {
+    auto now = std::chrono::system_clock::now();
+    std::time_t tt = std::chrono::system_clock::to_time_t(now);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &tt);
+#else
+    localtime_r(&tt, &tm);
+#endif
+    std::ostringstream oss;
+    oss << std::put_time(&tm, "%Y%m%d_%H%M%S");
+    return oss.str();
+}
+
+bool appendBackupEntry(const BackupEntry& entry) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    if (!ensureIndexFileExists()) {
+        return false;
+    }
+    std::ofstream indexFile(backupIndexFile, std::ios::app);
+    if (!indexFile) {
+        return false;
+    }
+    indexFile << entry.timestamp << ','
+              << entry.artistFile << ','
+              << entry.albumFile << ','
+              << entry.artistChecksum.toString() << ','
+              << entry.albumChecksum.toString() << ','
+              << entry.journalOffset << '\n';
+    return indexFile.good();
+}
+
+std::vector<BackupEntry> loadBackupEntries() {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    std::vector<BackupEntry> entries;
+    std::ifstream indexFile(backupIndexFile);
+    if (!indexFile) {
+        return entries;
+    }
+    std::string line;
+    while (std::getline(indexFile, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        std::stringstream ss(line);
+        BackupEntry entry;
+        if (!std::getline(ss, entry.timestamp, ',')) {
+            continue;
+        }
+        if (!std::getline(ss, entry.artistFile, ',')) {
+            continue;
+        }
+        if (!std::getline(ss, entry.albumFile, ',')) {
+            continue;
+        }
+        std::string artistChecksumStr;
+        std::string albumChecksumStr;
+        if (std::getline(ss, artistChecksumStr, ',')) {
+            Checksum::parse(artistChecksumStr, entry.artistChecksum);
+            if (std::getline(ss, albumChecksumStr, ',')) {
+                Checksum::parse(albumChecksumStr, entry.albumChecksum);
+            }
+            std::string journalOffsetStr;
+            if (std::getline(ss, journalOffsetStr) && !journalOffsetStr.empty()) {
+                try {
+                    entry.journalOffset = std::stoll(journalOffsetStr);
+                } catch (...) {
+                    entry.journalOffset = -1;
+                }
+            }
+        }
+        entries.push_back(entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](const BackupEntry& a, const BackupEntry& b) {
+        return a.timestamp > b.timestamp;
+    });
+    return entries;
+}
+
+void displayBackupEntries(const std::vector<BackupEntry>& entries) {
+    cout << "\nAvailable backups: \n";
+    cout << left << setw(6) << "[#]" << setw(25) << "Timestamp" << setw(40) << "Snapshot Files"
+         << setw(24) << "Artist Checksum" << "Album Checksum" << endl;
+    cout << setw(6) << "---" << setw(25) << "-----------------------" << setw(40) << "---------------------------------------"
+         << setw(24) << "----------------------" << "----------------------" << endl;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        cout << setw(6) << (i + 1)
+             << setw(25) << entries[i].timestamp
+             << setw(40) << (entries[i].artistFile + " | " + entries[i].albumFile)
+             << setw(24) << entries[i].artistChecksum.toString()
+             << entries[i].albumChecksum.toString() << endl;
+    }
+    cout << endl;
+}
+
+// Copies the live data files into a new snapshot and records it in the backup index.
+// The journal offset is captured under the file lock so replay starts exactly after the copy.
+bool writeSnapshot(BackupEntry& entry, std::string& error) {
+    ALBUM_TRACE_SCOPE("writeSnapshot");
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    entry.timestamp = makeTimestamp();
+    entry.artistFile = "Artist_" + entry.timestamp + ".bin";
+    entry.albumFile = "Album_" + entry.timestamp + ".bin";
+    std::string artistBackupPath = joinPath(backupDirectory, entry.artistFile);
+    std::string albumBackupPath = joinPath(backupDirectory, entry.albumFile);
+
+    if (!ensureIndexFileExists()) {
+        error = "Failed to prepare backup directory.";
+        ALBUM_LOG_ERROR("Backup failed: unable to prepare directory");
+        return false;
+    }
+    if (!fileExists(artistFilePath) || !fileExists(albumFilePath)) {
+        error = "Cannot create backup: source data files missing.";
+        ALBUM_LOG_ERROR("Backup failed: source files missing");
+        return false;
+    }
+    if (!copyFile(artistFilePath, artistBackupPath)) {
+        error = "Failed to backup artist data.";
+        ALBUM_LOG_ERROR("Backup failed: unable to copy artist file");
+        return false;
+    }
+    if (!copyFile(albumFilePath, albumBackupPath)) {
+        std::remove(artistBackupPath.c_str());
+        error = "Failed to backup album data.";
+        ALBUM_LOG_ERROR("Backup failed: unable to copy album file");
+        return false;
+    }
+
+    entry.journalOffset = ChangeJournal::instance().endOffset();
+    entry.artistChecksum = computeFileChecksum(artistBackupPath);
+    entry.albumChecksum = computeFileChecksum(albumBackupPath);
+    if (!appendBackupEntry(entry)) {
+        error = "Backup created, but failed to update index.";
+        ALBUM_LOG_WARN("Backup warning: unable to append index entry");
+        return false;
+    }
+    ALBUM_LOG_INFO("Backup created: {} artistChecksum={} albumChecksum={} journalOffset={}", entry.timestamp, entry.artistChecksum.toString(), entry.albumChecksum.toString(), entry.journalOffset);
+    return true;
+}
+
+// Checks both snapshot files against the checksums recorded in the index.
+bool verifySnapshotChecksums(const BackupEntry& entry) {
+    ALBUM_TRACE_SCOPE("verifySnapshotChecksums");
+    auto verify = [&](const std::string& path, const Checksum& expected, const std::string& label) {
+        if (expected.isEmpty()) {
+            return true;
+        }
+        Checksum actual = computeFileChecksum(path, expected.algorithm);
+        if (actual != expected) {
+            cout << label << " checksum mismatch. Expected " << expected.toString() << " but found " << actual.toString() << "." << endl;
+            ALBUM_LOG_WARN("{} checksum mismatch for snapshot {}", label, entry.timestamp);
+            return false;
+        }
+        return true;
+    };
+    return verify(joinPath(backupDirectory, entry.artistFile), entry.artistChecksum, "Artist backup") &&
+           verify(joinPath(backupDirectory, entry.albumFile), entry.albumChecksum, "Album backup");
+}
+
+bool confirmOverwrite() {
+    char confirm;
+    cout << "Restoring will overwrite current data files. Continue? (Y/N): ";
+    if (!(cin >> confirm)) {
+        cin.clear();
+        cin.ignore(INT_MAX, '\n');
+        return false;
+    }
+    cin.ignore(INT_MAX, '\n');
+    return confirm == 'y' || confirm == 'Y';
+}
+
+// Replaces the live data files with the given copies. Both files are staged and indexed
+// in a single pass, then swapped in as a pair: if either move fails the previous files
+// are put back and the in-memory state is left alone. A fresh snapshot is taken
+// afterwards so a later point-in-time restore never replays journal entries across
+// this restore.
+bool installRestoredFiles(std::fstream& ArtFile, std::fstream& AlbFile, const std::string& artistSource,
+                          const std::string& albumSource, const std::string& label, artistList& artist,
+                          albumList& album, indexSet& delArtArray, indexSet& delAlbArray) {
+    ALBUM_TRACE_SCOPE("installRestoredFiles");
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    std::string artistStaged = artistFilePath.str() + ".restore";
+    std::string albumStaged = albumFilePath.str() + ".restore";
+    int previousArtistID = lastArtistID;
+    int previousAlbumID = lastAlbumID;
+    lastArtistID = 999;
+    lastAlbumID = 1999;
+
+    artistList restoredArtists;
+    albumList restoredAlbums;
+    indexSet restoredDelArt;
+    indexSet restoredDelAlb;
+    if (!stageRestoredRecords(artistSource, artistStaged, restoredArtists, restoredDelArt) ||
+        !stageRestoredRecords(albumSource, albumStaged, restoredAlbums, restoredDelAlb)) {
+        std::remove(artistStaged.c_str());
+        std::remove(albumStaged.c_str());
+        lastArtistID = previousArtistID;
+        lastAlbumID = previousAlbumID;
+        cout << "Failed to restore backup." << endl;
+        ALBUM_LOG_ERROR("Restore failed while staging {}", label);
+        return false;
+    }
+
+    // Windows cannot rename over a file that still has an open handle.
+    ArtFile.flush();
+    AlbFile.flush();
+    ArtFile.close();
+    AlbFile.close();
+
+    std::string swapError;
+    bool swapped = swapInStagedFiles({{artistStaged, artistFilePath.str()}, {albumStaged, albumFilePath.str()}}, swapError);
+    RecordCache::instance().clear();
+    if (!swapped) {
+        std::remove(artistStaged.c_str());
+        std::remove(albumStaged.c_str());
+        lastArtistID = previousArtistID;
+        lastAlbumID = previousAlbumID;
+        cout << "Failed to restore backup." << endl;
+        ALBUM_LOG_ERROR("Restore failed while installing {}: {}", label, swapError);
+        try {
+            openRecordFile(ArtFile, artistFilePath, RecordKind::Artist);
+            openRecordFile(AlbFile, albumFilePath, RecordKind::Album);
+        } catch (const FileException& e) {
+            ALBUM_LOG_ERROR("Restore failed to reopen data files: {}", e.what());
+        }
+        return false;
+    }
+
+    try {
+        openRecordFile(ArtFile, artistFilePath, RecordKind::Artist);
+        openRecordFile(AlbFile, albumFilePath, RecordKind::Album);
+    } catch (const FileException& e) {
+        cout << "Backup restored, but failed to reopen data files." << endl;
+        ALBUM_LOG_WARN("Restore warning: reopen failed for {}: {}", label, e.what());
+        return false;
+    }
+
+    artist = std::move(restoredArtists);
+    album = std::move(restoredAlbums);
+    delArtArray = std::move(restoredDelArt);
+    delAlbArray = std::move(restoredDelAlb);
+    sortArtist(artist);
+    sortAlbum(album);
+    recountCatalogStatistics(album);
+
+    commandManager.clear();
+    BackupEntry checkpoint;
+    std::string error;
+    if (!writeSnapshot(checkpoint, error)) {
+        ALBUM_LOG_WARN("Restore warning: post-restore snapshot failed: {}", error);
+    }
+    return true;
+}
+
+// Parses "YYYY-MM-DD HH:MM:SS" in local time.
+bool parseLocalDateTime(const std::string& text, std::time_t& out) {
+    std::tm tm{};
+    std::istringstream iss(text);
+    iss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+    if (iss.fail()) {
+        return false;
+    }
+    tm.tm_isdst = -1;
+    out = std::mktime(&tm);
+    return out != static_cast<std::time_t>(-1);
+}
+
+std::string formatSnapshotTimestamp(std::time_t t) {
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+    std::ostringstream oss;
+    oss << std::put_time(&tm, "%Y%m%d_%H%M%S");
+    return oss.str();
+}
+
+} // namespace
+
+#ifdef __linux__
+namespace {
+
+// Outcome of one in-kernel copy attempt; Unsupported lets the caller try the next method.
+enum class KernelCopyResult { Done, Unsupported, Failed };
+
+bool copyUnsupported(int error) {
+    return error == ENOSYS || error == EXDEV || error == EINVAL || error == EOPNOTSUPP ||
+           error == ENOTSUP || error == ETXTBSY || error == EPERM || error == EBADF;
+}
+
+KernelCopyResult reflinkCopy(int in, int out) {
+#ifdef FICLONE
+    if (ioctl(out, FICLONE, in) == 0) {
+        return KernelCopyResult::Done;
+    }
+    return copyUnsupported(errno) ? KernelCopyResult::Unsupported : KernelCopyResult::Failed;
+#else
+    (void)in;
+    (void)out;
+    return KernelCopyResult::Unsupported;
+#endif
+}
+
+KernelCopyResult copyFileRangeCopy(int in, int out, off_t size) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+    loff_t inOffset = 0;
+    loff_t outOffset = 0;
+    while (inOffset < size) {
+        ssize_t copied = copy_file_range(in, &inOffset, out, &outOffset, static_cast<std::size_t>(size - inOffset), 0);
+        if (copied < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return inOffset == 0 && copyUnsupported(errno) ? KernelCopyResult::Unsupported : KernelCopyResult::Failed;
+        }
+        if (copied == 0) {
+            return KernelCopyResult::Failed;
+        }
+    }
+    return KernelCopyResult::Done;
+#else
+    (void)in;
+    (void)out;
+    (void)size;
+    return KernelCopyResult::Unsupported;
+#endif
+}
+
+KernelCopyResult sendfileCopy(int in, int out, off_t size) {
+    off_t offset = 0;
+    while (offset < size) {
+        ssize_t copied = sendfile(out, in, &offset, static_cast<std::size_t>(size - offset));
+        if (copied < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return offset == 0 && copyUnsupported(errno) ? KernelCopyResult::Unsupported : KernelCopyResult::Failed;
+        }
+        if (copied == 0) {
+            return KernelCopyResult::Failed;
+        }
+    }
+    return KernelCopyResult::Done;
+}
+
+// Runs the in-kernel methods in order. Returns true once one of them has copied the file
+// or has failed outright; false means none is supported and the buffered loop should run.
+bool kernelCopy(const std::string& source, const std::string& destination, CopyMethod& used, bool& ok) {
+    int in = ::open(source.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) {
+        ok = false;
+        return true;
+    }
+    struct stat info {};
+    if (fstat(in, &info) != 0) {
+        ::close(in);
+        ok = false;
+        return true;
+    }
+    int out = ::open(destination.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out < 0) {
+        ::close(in);
+        ok = false;
+        return true;
+    }
+
+    const std::pair<CopyMethod, std::function<KernelCopyResult()>> methods[] = {
+        {CopyMethod::Reflink, [&]() { return reflinkCopy(in, out); }},
+        {CopyMethod::CopyFileRange, [&]() { return copyFileRangeCopy(in, out, info.st_size); }},
+        {CopyMethod::Sendfile, [&]() { return sendfileCopy(in, out, info.st_size); }},
+    };
+    bool handled = false;
+    for (const auto& method : methods) {
+        KernelCopyResult result = method.second();
+        if (result == KernelCopyResult::Unsupported) {
+            continue;
+        }
+        used = method.first;
+        ok = result == KernelCopyResult::Done;
+        handled = true;
+        break;
+    }
+    ::close(in);
+    if (::close(out) != 0) {
+        ok = false;
+    }
+    return handled;
+}
+
+} // namespace
+#endif
+
+const char* copyMethodName(CopyMethod method) {
+    switch (method) {
+        case CopyMethod::Reflink:
+            return "reflink";
+        case CopyMethod::CopyFileRange:
+            return "copy_file_range";
+        case CopyMethod::Sendfile:
+            return "sendfile";
+        case CopyMethod::Buffered:
+            return "buffered";
+    }
+    return "unknown";
+}
+
+bool copyFileContents(const std::string& source, const std::string& destination, CopyMethod* used) {
+    ALBUM_TRACE_SCOPE("copyFileContents");
+    CopyMethod method = CopyMethod::Buffered;
+    bool ok = false;
+#ifdef __linux__
+    bool handled = kernelCopy(source, destination, method, ok);
+#else
+    bool handled = false;
+#endif
+    if (!handled) {
+        std::ifstream src(source, std::ios::binary);
+        std::ofstream dst(destination, std::ios::binary | std::ios::trunc);
+        ok = src && dst && bufferedCopy(src, dst);
+        method = CopyMethod::Buffered;
+    }
+    if (used != nullptr) {
+        *used = method;
+    }
+    if (ok) {
+        ALBUM_LOG_INFO("copyFile: {} -> {} via {}", source, destination, copyMethodName(method));
+    } else {
+        ALBUM_LOG_ERROR("copyFile: failed to copy {} to {}", source, destination);
+    }
+    return ok;
+}
+
+bool replaceFile(const std::string& source, const std::string& destination) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+#ifdef _WIN32
+    const int attempts = 10;
+    const int retryDelayMs = 150;
+#else
+    const int attempts = 1;
+#endif
+    std::error_code error;
+    for (int attempt = 0; attempt < attempts; ++attempt) {
+#ifdef _WIN32
+        if (attempt > 0) {
+            Sleep(retryDelayMs);
+        }
+        SetFileAttributesA(destination.c_str(), FILE_ATTRIBUTE_NORMAL);
+#endif
+        std::filesystem::rename(source, destination, error);
+        if (!error) {
+            return true;
+        }
+    }
+    ALBUM_LOG_WARN("Unable to move {} over {}: {}", source, destination, error.message());
+    return false;
+}
+
+bool swapInStagedFiles(const std::vector<std::pair<std::string, std::string>>& moves, std::string& error) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    struct Swap {
+        bool setAside = false;
+        bool installed = false;
+    };
+    std::vector<Swap> done;
+    done.reserve(moves.size());
+    auto rollBack = [&]() {
+        bool clean = true;
+        for (std::size_t i = done.size(); i-- > 0;) {
+            const std::string& live = moves[i].second;
+            const std::string aside = live + ".prev";
+            if (done[i].setAside) {
+                clean = replaceFile(aside, live) && clean;
+            } else if (done[i].installed) {
+                clean = std::remove(live.c_str()) == 0 && clean;
+            }
+        }
+        return clean;
+    };
+    for (const auto& move : moves) {
+        const std::string& live = move.second;
+        const std::string aside = live + ".prev";
+        done.emplace_back();
+        if (std::filesystem::exists(live)) {
+            if (!replaceFile(live, aside)) {
+                done.pop_back();
+                error = "unable to move " + live + " aside";
+                if (!rollBack()) {
+                    error += "; rollback incomplete, previous files are kept as *.prev";
+                }
+                return false;
+            }
+            done.back().setAside = true;
+        }
+        if (!replaceFile(move.first, live)) {
+            error = "unable to install " + move.first;
+            if (!rollBack()) {
+                error += "; rollback incomplete, previous files are kept as *.prev";
+            }
+            return false;
+        }
+        done.back().installed = true;
+    }
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        if (done[i].setAside) {
+            std::remove((moves[i].second + ".prev").c_str());
+        }
+    }
+    return true;
+}
+
+static bool createBackupSnapshot(std::fstream& ArtFile, std::fstream& AlbFile) {
+    cout << "Creating backup snapshot..." << endl;
+    BackupEntry entry;
+    std::string error;
+    bool written = false;
+    {
+        ALBUM_TIME_SCOPE("create_backup_snapshot");
+        ArtFile.flush();
+        AlbFile.flush();
+        ArtFile.clear();
+        AlbFile.clear();
+        written = writeSnapshot(entry, error);
+    }
+    if (!written) {
+        cout << error << endl;
+        system("pause");
+        return false;
+    }
+
+    cout << "Backup snapshot saved as:\n  " << joinPath(backupDirectory, entry.artistFile)
+         << "\n  " << joinPath(backupDirectory, entry.albumFile) << endl;
+    system("pause");
+    return true;
+}
+
+static bool restoreFromBackup(std::fstream& ArtFile, std::fstream& AlbFile, artistList& artist, albumList& album, indexSet& delArtArray, indexSet& delAlbArray) {
+    cout << "Restoring from backup..." << endl;
+    auto entries = loadBackupEntries();
+    if (entries.empty()) {
+        cout << "No backups found. Create one first." << endl;
+        system("pause");
+        return false;
+    }
+
+    displayBackupEntries(entries);
+    int selection = -1;
+    while (true) {
+        cout << "Select backup to restore (0 to cancel): ";
+        if (!(cin >> selection)) {
+            cin.clear();
+            cin.ignore(INT_MAX, '\n');
+            cout << "Invalid input. Please enter a number." << endl;
+            continue;
+        }
+        cin.ignore(INT_MAX, '\n');
+        if (selection == 0) {
+            cout << "Restore cancelled." << endl;
+            system("pause");
+            return false;
+        }
+        if (selection < 1 || selection > static_cast<int>(entries.size())) {
+            cout << "Invalid choice. Try again." << endl;
+            continue;
+        }
+        break;
+    }
+
+    const BackupEntry& chosen = entries[selection - 1];
+    std::string artistBackupPath = joinPath(backupDirectory, chosen.artistFile);
+    std::string albumBackupPath = joinPath(backupDirectory, chosen.albumFile);
+
+    if (!fileExists(artistBackupPath) || !fileExists(albumBackupPath)) {
+        cout << "Backup files missing on disk. Operation aborted." << endl;
+        ALBUM_LOG_ERROR("Restore failed: missing backup files for {}", chosen.timestamp);
+        system("pause");
+        return false;
+    }
+
+    if (!confirmOverwrite()) {
+        cout << "Restore cancelled." << endl;
+        system("pause");
+        return false;
+    }
+
+    bool restored = false;
+    {
+        // Time the verify and install work, not the prompts above.
+        ALBUM_TIME_SCOPE("restore_from_backup");
+        restored = verifySnapshotChecksums(chosen) &&
+                   installRestoredFiles(ArtFile, AlbFile, artistBackupPath, albumBackupPath, "snapshot " + chosen.timestamp,
+                                        artist, album, delArtArray, delAlbArray);
+    }
+    if (!restored) {
+        system("pause");
+        return false;
+    }
+
+    ALBUM_LOG_INFO("Restore completed from snapshot {}", chosen.timestamp);
+    cout << "Restore completed successfully." << endl;
+    system("pause");
+    return true;
+}
+
+static bool restoreToPointInTime(std::fstream& ArtFile, std::fstream& AlbFile, artistList& artist, albumList& album, indexSet& delArtArray, indexSet& delAlbArray) {
+    ALBUM_TRACE_SCOPE("restoreToPointInTime");
+    cout << "Point-in-time restore" << endl;
+    cout << "Enter target time (YYYY-MM-DD HH:MM:SS, blank for now): ";
+    std::string input;
+    std::getline(cin, input);
+    input = sanitizeStringInput(input, 32);
+
+    std::time_t target = std::time(nullptr);
+    if (!input.empty() && !parseLocalDateTime(input, target)) {
+        cout << "Invalid date/time. Use the format YYYY-MM-DD HH:MM:SS." << endl;
+        system("pause");
+        return false;
+    }
+    std::int64_t untilMs = static_cast<std::int64_t>(target) * 1000 + 999;
+    std::string targetStamp = formatSnapshotTimestamp(target);
+
+    // Entries are sorted newest first, so the first match is the nearest earlier snapshot.
+    auto entries = loadBackupEntries();
+    const BackupEntry* base = nullptr;
+    for (const auto& entry : entries) {
+        if (entry.timestamp <= targetStamp && entry.journalOffset >= 0) {
+            base = &entry;
+            break;
+        }
+    }
+    if (base == nullptr) {
+        cout << "No journaled snapshot exists at or before " << targetStamp << "." << endl;
+        ALBUM_LOG_ERROR("Point-in-time restore failed: no base snapshot before {}", targetStamp);
+        system("pause");
+        return false;
+    }
+
+    std::string artistBackupPath = joinPath(backupDirectory, base->artistFile);
+    std::string albumBackupPath = joinPath(backupDirectory, base->albumFile);
+    if (!fileExists(artistBackupPath) || !fileExists(albumBackupPath)) {
+        cout << "Backup files missing on disk. Operation aborted." << endl;
+        ALBUM_LOG_ERROR("Point-in-time restore failed: missing backup files for {}", base->timestamp);
+        system("pause");
+        return false;
+    }
+
+    cout << "Base snapshot: " << base->timestamp << ", replaying journal to " << targetStamp << "." << endl;
+    if (!confirmOverwrite()) {
+        cout << "Restore cancelled." << endl;
+        system("pause");
+        return false;
+    }
+    if (!verifySnapshotChecksums(*base)) {
+        system("pause");
+        return false;
+    }
+
+    std::string artistStaged = artistFilePath.str() + ".pitr";
+    std::string albumStaged = albumFilePath.str() + ".pitr";
+    auto removeStaged = [&]() {
+        std::remove(artistStaged.c_str());
+        std::remove(albumStaged.c_str());
+        std::remove((artistStaged + ".v1").c_str());
+        std::remove((albumStaged + ".v1").c_str());
+    };
+
+    std::size_t applied = 0;
+    bool staged = copyFile(artistBackupPath, artistStaged) && copyFile(albumBackupPath, albumStaged) &&
+                  migrateLegacyRecordFile(artistStaged, RecordKind::Artist) &&
+                  migrateLegacyRecordFile(albumStaged, RecordKind::Album);
+    if (!staged || !replayJournal(journalFile, base->journalOffset, untilMs, artistStaged, albumStaged, applied)) {
+        removeStaged();
+        cout << "Failed to rebuild data from snapshot and journal." << endl;
+        ALBUM_LOG_ERROR("Point-in-time restore failed while replaying journal from {}", base->timestamp);
+        system("pause");
+        return false;
+    }
+
+    bool installed = installRestoredFiles(ArtFile, AlbFile, artistStaged, albumStaged,
+                                          "point-in-time " + targetStamp, artist, album, delArtArray, delAlbArray);
+    removeStaged();
+    if (!installed) {
+        system("pause");
+        return false;
+    }
+
+    ALBUM_LOG_INFO("Point-in-time restore to {} completed from snapshot {}, replayed {} changes", targetStamp, base->timestamp, applied);
+    cout << "Restore completed: replayed " << applied << " changes on top of snapshot " << base->timestamp << "." << endl;
+    system("pause");
+    return true;
+}
+
+void backupAndRestoreMenu(std::fstream& ArtFile, std::fstream& AlbFile, artistList& artist, albumList& album, indexSet& delArtArray, indexSet& delAlbArray) {
+    bool exitMenu = false;
+    do {
+        int choice = MenuView::backupMenu();
+        switch (choice) {
+            case 1:
+                createBackupSnapshot(ArtFile, AlbFile);
+                break;
+            case 2:
+                restoreFromBackup(ArtFile, AlbFile, artist, album, delArtArray, delAlbArray);
+                break;
+            case 3:
+                restoreToPointInTime(ArtFile, AlbFile, artist, album, delArtArray, delAlbArray);
+                break;
+            case 4:
+                scrubDataFiles(true);
+                system("pause");
+                break;
+            case 5:
+                importDataMenu(ArtFile, AlbFile, artist, album);
+                break;
+            case 6:
+                exitMenu = true;
+                break;
+            default:
+                break;
+        }
+    } while (!exitMenu);
+}
+
+bool undoLastAction() {
+    return commandManager.undo();
+}
+
+bool redoLastAction() {
+    return commandManager.redo();
+}
+
+bool canUndo() {
+    return commandManager.canUndo();
+}
+
+bool canRedo() {
+    return commandManager.canRedo();
+}
+
+std::string getNextUndoDescription() {
+    return commandManager.nextUndoDescription();
+}
+
+std::string getNextRedoDescription() {
+    return commandManager.nextRedoDescription();
+}
+
+static bool executeCommand(CommandAction action) {
+    return commandManager.execute(std::move(action));
+}
+
+struct ArtistCommandState {
+    Artist artist;
+    long pos = -1;
+};
+
+struct ArtistEditState {
+    Artist original;
+    Artist updated;
+    long pos = -1;
+    bool applied = false;
+};
+
+struct AlbumCommandState {
+    Album album;
+    long pos = -1;
+};
+
+struct AlbumEditState {
+    Album original;
+    Album updated;
+    long pos = -1;
+    bool applied = false;
+};
+
+struct AlbumSnapshot {
+    Album data;
+    long pos = -1;
+};
+
+struct ArtistRemovalState {
+    Artist artist;
+    long pos = -1;
+    int artistIndex = -1;
+    std::vector<AlbumSnapshot> associatedAlbums;
+};
+
+struct ArtistMergeState {
+    Artist duplicate;
+    long duplicatePos = -1;
+    std::string canonicalId;
+    std::vector<long> albumPositions; // Sorted slot offsets of the re-parented albums
+};
+
+struct AlbumRemovalState {
+    Album album;
+    long pos = -1;
+    int index = -1;
+};
+
+static bool ensureArtistStream(std::fstream& ArtFile) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    if (ArtFile.is_open()) {
+        return true;
+    }
+    try {
+        openRecordFile(ArtFile, artistFilePath, RecordKind::Artist);
+        return true;
+    } catch (const FileException& e) {
+        cout << e.what() << endl;
+        system("pause");
+        return false;
+    }
+}
+
+static bool ensureAlbumStream(std::fstream& AlbFile) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    if (AlbFile.is_open()) {
+        return true;
+    }
+    try {
+        openRecordFile(AlbFile, albumFilePath, RecordKind::Album);
+        return true;
+    } catch (const FileException& e) {
+        cout << e.what() << endl;
+        system("pause");
+        return false;
+    }
+}
+
+static ArtistFile toArtistFile(const Artist& artist) {
+    ArtistFile artFile{};
+    char gender = artist.getGender();
+    setRecordField(artFile, ARTIST_FIELD_ID, artist.getArtistId());
+    setRecordField(artFile, ARTIST_FIELD_NAME, artist.getName());
+    setRecordField(artFile, ARTIST_FIELD_GENDER, &gender, 1);
+    setRecordField(artFile, ARTIST_FIELD_PHONE, artist.getPhone());
+    setRecordField(artFile, ARTIST_FIELD_EMAIL, artist.getEmail());
+    return artFile;
+}
+
+static Artist fromArtistFile(const ArtistFile& artFile) {
+    Artist artist;
+    forEachRecordField(artFile, [&](std::size_t field, const RecordFieldSpec&, const char* text, std::size_t length) {
+        switch (field) {
+            case ARTIST_FIELD_ID: artist.setArtistId(std::string(text, length)); break;
+            case ARTIST_FIELD_NAME: artist.setName(std::string(text, length)); break;
+            case ARTIST_FIELD_GENDER: artist.setGender(artFile.genders); break;
+            case ARTIST_FIELD_PHONE: artist.setPhone(std::string(text, length)); break;
+            case ARTIST_FIELD_EMAIL: artist.setEmail(std::string(text, length)); break;
+        }
+    });
+    return artist;
+}
+
+static AlbumFile toAlbumFile(const Album& album) {
+    AlbumFile albFile{};
+    setRecordField(albFile, ALBUM_FIELD_ID, album.getAlbumId());
+    setRecordField(albFile, ALBUM_FIELD_ARTIST_ID, album.getArtistId());
+    setRecordField(albFile, ALBUM_FIELD_TITLE, album.getTitle());
+    setRecordField(albFile, ALBUM_FIELD_RECORD_FORMAT, album.getRecordFormat());
+    setRecordField(albFile, ALBUM_FIELD_DATE_PUBLISHED, album.getDatePublished());
+    setRecordField(albFile, ALBUM_FIELD_PATH, album.getPath());
+    return albFile;
+}
+
+static Album fromAlbumFile(const AlbumFile& albFile) {
+    Album album;
+    forEachRecordField(albFile, [&](std::size_t field, const RecordFieldSpec&, const char* text, std::size_t length) {
+        switch (field) {
+            case ALBUM_FIELD_ID: album.setAlbumId(std::string(text, length)); break;
+            case ALBUM_FIELD_ARTIST_ID: album.setArtistId(std::string(text, length)); break;
+            case ALBUM_FIELD_TITLE: album.setTitle(std::string(text, length)); break;
+            case ALBUM_FIELD_RECORD_FORMAT: album.setRecordFormat(std::string(text, length)); break;
+            case ALBUM_FIELD_DATE_PUBLISHED: album.setDatePublished(std::string(text, length)); break;
+            case ALBUM_FIELD_PATH: album.setPath(std::string(text, length)); break;
+        }
+    });
+    return album;
+}
+
+static bool readArtistAtPosition(std::fstream& ArtFile, long pos, Artist& artist) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    if (!ensureArtistStream(ArtFile)) {
+        return false;
+    }
+    ArtistFile artFile{};
+    RecordStatus status = readRecordAt(ArtFile, pos, artFile);
+    if (status != RecordStatus::Ok) {
+        if (status == RecordStatus::Corrupt) {
+            ALBUM_LOG_WARN("Corrupt artist record at offset {}", pos);
+        }
+        return false;
+    }
+    artist = fromArtistFile(artFile);
+    return true;
+}
+
+static bool writeArtistAtPosition(std::fstream& ArtFile, long pos, const Artist& artist) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    if (!ensureArtistStream(ArtFile)) {
+        return false;
+    }
+    return writeRecordAt(ArtFile, pos, toArtistFile(artist));
+}
+
+static bool appendArtistRecord(std::fstream& ArtFile, const Artist& artist, long& outPos) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    if (!ensureArtistStream(ArtFile)) {
+        return false;
+    }
+    return appendRecord(ArtFile, toArtistFile(artist), outPos);
+}
+
+static bool readAlbumAtPosition(std::fstream& AlbFile, long pos, Album& album) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    if (!ensureAlbumStream(AlbFile)) {
+        return false;
+    }
+    AlbumFile albFile{};
+    RecordStatus status = readRecordAt(AlbFile, pos, albFile);
+    if (status != RecordStatus::Ok) {
+        if (status == RecordStatus::Corrupt) {
+            ALBUM_LOG_WARN("Corrupt album record at offset {}", pos);
+        }
+        return false;
+    }
+    album = fromAlbumFile(albFile);
+    return true;
+}
+
+static bool writeAlbumAtPosition(std::fstream& AlbFile, long pos, const Album& album) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    if (!ensureAlbumStream(AlbFile)) {
+        return false;
+    }
+    return writeRecordAt(AlbFile, pos, toAlbumFile(album));
+}
+
+static bool appendAlbumRecord(std::fstream& AlbFile, const Album& album, long& outPos) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    if (!ensureAlbumStream(AlbFile)) {
+        return false;
+    }
+    return appendRecord(AlbFile, toAlbumFile(album), outPos);
+}
+
+static int findArtistIndexById(const artistList& artists, const std::string& artistId) {
+    for (size_t i = 0; i < artists.artList.size(); ++i) {
+        if (artists.artList[i].artistId == artistId) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+static int findAlbumIndexById(const albumList& albums, const std::string& albumId) {
+    for (size_t i = 0; i < albums.albList.size(); ++i) {
+        if (albums.albList[i].albumId == albumId) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+// Deleted entries keep their slot but lose their ID, so undoing a delete finds them by slot.
+static int findArtistIndexByPos(const artistList& artists, long pos) {
+    for (size_t i = 0; i < artists.artList.size(); ++i) {
+        if (artists.artList[i].pos == pos) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+static int findAlbumIndexByPos(const albumList& albums, long pos) {
+    for (size_t i = 0; i < albums.albList.size(); ++i) {
+        if (albums.albList[i].pos == pos) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Displays the welcome message to the user.
+ */
+void welcome()  //2
+{
+    system("COLOR 2F");
+	cout<<"\n\n";
+	cout<<setfill('~')<<setw(150)<<'~';
+	cout<<"\n";
+	cout<<"\n                          |o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o|     ";
+	cout<<"\n                          |                                                 |     ";
+	cout<<"\n                          |                                                 |     ";
+	cout<<"\n                          |                    WELCOME                      |     ";
+	cout<<"\n                          |                                                 |     ";
+	cout<<"\n                          |              o ALBUM MANAGEMENT o               |     ";
+	cout<<"\n                          |                                                 |     ";
+	cout<<"\n                          |                                                 |     ";
+	cout<<"\n                          |                                                 |     ";
+	cout<<"\n                          |             Enter ENTER to continue...          |     ";
+	cout<<"\n                          |                                                 |     ";
+	cout<<"\n                          |o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o*o|     ";
+	cout<<'\n'<<setw(150)<<'~'<<setfill(' ');
+	cout<<endl<<endl;
+    cout << "\tVersion: " << ALBUM_APP_VERSION << endl << endl;
+    system("pause");
+}
+
+//
+void printError(int errId){
+    switch (errId){
+        case 1:
+            cout << "\t\n Error~ Artist file can not be opened!" << endl;
+            break;
+        case 2:
+            cout << "\t\n Error~ Album file can not be opened!" << endl;
+            break;
+        case 3:
+            cout << "\t\n Error~No sufficient memory. Program can not continue!" << endl;
+            break;
+        case 4:
+            cout << "\t\n Error~no search results found.\n" << endl;
+            break;
+        case 5:
+            cout << " \t\n Error~ No sufficient memory to create a space for the result array!" << endl;
+            break;
+    }
+}
+
+//
+void intToCharArray(int last, char id[], char prefix[])
+{
+    int i=6;
+    strcpy(id, prefix);
+    while(i>2){
+        id[i--] = last%10 + '0';
+        last /= 10;
+    }
+}
+
+//
+int charArrayToInt(char *arr)
+{
+    int value, flag, r;
+    flag = 1;
+    value = 0;
+    for( size_t i=3; i<strlen(arr); i++){
+        if( i==0 && arr[i]=='-' ){
+            flag = -1;
+            continue;
+        }
+        r = arr[i] - '0';
+        value = value * 10 + r;
+    }
+    value = value * flag;
+    return value;
+}
+
+//
+void openFile(std::fstream& fstr, const std::string& path)
+{
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    cout<<'\n';
+    
+    // Try to open file for reading and writing
+    fstr.open(path, std::ios::in | std::ios::out | std::ios::binary);
+    if (!fstr) {
+        // File doesn't exist, create it
+        std::ofstream createFile(path, std::ios::binary);
+        if (!createFile) {
+            throw FileException("Failed to create file: " + path);
+        }
+        createFile.close();
+        
+        // Now open it for reading and writing
+        fstr.open(path, std::ios::in | std::ios::out | std::ios::binary);
+        if (!fstr) {
+            throw FileException("Failed to open file: " + path);
+        }
+    }
+}
+
+namespace {
+
+const std::size_t SCRUB_BLOCK_RECORDS = 4096;
+
+void encodeRecordHeader(unsigned char* out, RecordKind kind) {
+    std::uint16_t version = RECORD_FORMAT_VERSION;
+    std::uint16_t kindValue = static_cast<std::uint16_t>(kind);
+    std::uint32_t recordSize = static_cast<std::uint32_t>(recordSizeFor(kind));
+    std::memcpy(out, RECORD_FILE_MAGIC, sizeof(RECORD_FILE_MAGIC));
+    std::memcpy(out + 4, &version, sizeof(version));
+    std::memcpy(out + 6, &kindValue, sizeof(kindValue));
+    std::memcpy(out + 8, &recordSize, sizeof(recordSize));
+    std::uint32_t crc = crc32c(out, 12);
+    std::memcpy(out + 12, &crc, sizeof(crc));
+}
+
+// Returns an empty string when the header is valid, otherwise the reason it is not.
+std::string checkRecordHeader(const unsigned char* header, RecordKind kind, bool verifyCrc) {
+    if (std::memcmp(header, RECORD_FILE_MAGIC, sizeof(RECORD_FILE_MAGIC)) != 0) {
+        return "missing data file header";
+    }
+    std::uint16_t version = 0;
+    std::uint16_t kindValue = 0;
+    std::uint32_t recordSize = 0;
+    std::uint32_t storedCrc = 0;
+    std::memcpy(&version, header + 4, sizeof(version));
+    std::memcpy(&kindValue, header + 6, sizeof(kindValue));
+    std::memcpy(&recordSize, header + 8, sizeof(recordSize));
+    std::memcpy(&storedCrc, header + 12, sizeof(storedCrc));
+    if (version != RECORD_FORMAT_VERSION) {
+        return "unsupported format version " + std::to_string(version);
+    }
+    if (kindValue != static_cast<std::uint16_t>(kind)) {
+        return "file holds a different record kind";
+    }
+    if (recordSize != static_cast<std::uint32_t>(recordSizeFor(kind))) {
+        return "unexpected record size " + std::to_string(recordSize);
+    }
+    if (verifyCrc && storedCrc != crc32c(header, 12)) {
+        return "header checksum mismatch";
+    }
+    return std::string();
+}
+
+template <typename Record>
+RecordStatus readRecordSlot(std::istream& in, long pos, Record& record) {
+    unsigned char slot[sizeof(Record) + RECORD_CRC_SIZE];
+    in.clear();
+    in.seekg(pos, std::ios::beg);
+    if (!in.read(reinterpret_cast<char*>(slot), sizeof(slot))) {
+        in.clear();
+        return RecordStatus::Missing;
+    }
+    std::memcpy(&record, slot, sizeof(Record));
+    std::uint32_t storedCrc = 0;
+    std::memcpy(&storedCrc, slot + sizeof(Record), sizeof(storedCrc));
+    return storedCrc == crc32c(slot, sizeof(Record)) ? RecordStatus::Ok : RecordStatus::Corrupt;
+}
+
+template <typename Record>
+bool writeRecordSlot(std::ostream& out, long pos, const Record& record) {
+    unsigned char slot[sizeof(Record) + RECORD_CRC_SIZE];
+    std::memcpy(slot, &record, sizeof(Record));
+    std::uint32_t crc = crc32c(slot, sizeof(Record));
+    std::memcpy(slot + sizeof(Record), &crc, sizeof(crc));
+    out.clear();
+    out.seekp(pos, std::ios::beg);
+    out.write(reinterpret_cast<const char*>(slot), sizeof(slot));
+    out.flush();
+    return static_cast<bool>(out);
+}
+
+RecordKind recordKindOf(const ArtistFile&) {
+    return RecordKind::Artist;
+}
+
+RecordKind recordKindOf(const AlbumFile&) {
+    return RecordKind::Album;
+}
+
+// Writes a slot and records it in the change journal.
+template <typename Record>
+bool writeJournaledSlot(std::ostream& out, long pos, const Record& record) {
+    if (!writeRecordSlot(out, pos, record)) {
+        return false;
+    }
+    ChangeJournal::instance().append(recordKindOf(record), JournalOp::Write, pos, &record, sizeof(Record));
+    RecordCache::instance().invalidate(recordKindOf(record), pos);
+    return true;
+}
+
+// Appends after the last complete slot so a torn tail never misaligns new records.
+template <typename Record>
+bool appendRecordSlot(std::fstream& io, const Record& record, long& outPos) {
+    RecordKind kind = recordKindOf(record);
+    outPos = RECORD_HEADER_SIZE + recordCount(io, kind) * recordSizeFor(kind);
+    return writeJournaledSlot(io, outPos, record);
+}
+
+bool writeHeaderBytes(std::ostream& out, RecordKind kind) {
+    unsigned char header[RECORD_HEADER_SIZE];
+    encodeRecordHeader(header, kind);
+    out.clear();
+    out.seekp(0, std::ios::beg);
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.flush();
+    return static_cast<bool>(out);
+}
+
+/**
+ * Reads every slot of a data file front to back in large blocks and hands each
+ * payload to the visitor as visit(pos, record, status). When copyTo is given each
+ * block is also written there unchanged, so a copy costs no extra read. Returns
+ * false if the file ended before the slot count its size promised.
+ */
+template <typename Record, typename Visitor>
+bool forEachRecord(std::istream& in, RecordKind kind, Visitor visit, std::ostream* copyTo = nullptr) {
+    const long slotSize = recordSizeFor(kind);
+    const long total = recordCount(in, kind);
+    std::vector<unsigned char> block(SCRUB_BLOCK_RECORDS * static_cast<std::size_t>(slotSize));
+    Record record;
+    in.clear();
+    in.seekg(RECORD_HEADER_SIZE, std::ios::beg);
+    for (long first = 0; first < total; first += static_cast<long>(SCRUB_BLOCK_RECORDS)) {
+        long count = std::min<long>(static_cast<long>(SCRUB_BLOCK_RECORDS), total - first);
+        if (!in.read(reinterpret_cast<char*>(block.data()), count * slotSize)) {
+            in.clear();
+            return false;
+        }
+        if (copyTo != nullptr) {
+            copyTo->write(reinterpret_cast<const char*>(block.data()), count * slotSize);
+        }
+        for (long i = 0; i < count; ++i) {
+            const unsigned char* slot = block.data() + i * slotSize;
+            std::memcpy(&record, slot, sizeof(Record));
+            std::uint32_t storedCrc = 0;
+            std::memcpy(&storedCrc, slot + sizeof(Record), sizeof(storedCrc));
+            RecordStatus status = storedCrc == crc32c(slot, sizeof(Record)) ? RecordStatus::Ok : RecordStatus::Corrupt;
+            visit(RECORD_HEADER_SIZE + (first + i) * slotSize, record, status);
+        }
+    }
+    return true;
+}
+
+void scrubRecordRange(const std::string& path, long slotSize, std::size_t payloadSize, long first, long last,
+                      std::vector<ScrubIssue>& issues) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        issues.push_back({RECORD_HEADER_SIZE + first * slotSize, "unable to read record range"});
+        return;
+    }
+    std::vector<unsigned char> block(SCRUB_BLOCK_RECORDS * static_cast<std::size_t>(slotSize));
+    in.seekg(RECORD_HEADER_SIZE + first * slotSize, std::ios::beg);
+    for (long start = first; start < last; start += static_cast<long>(SCRUB_BLOCK_RECORDS)) {
+        long count = std::min<long>(static_cast<long>(SCRUB_BLOCK_RECORDS), last - start);
+        if (!in.read(reinterpret_cast<char*>(block.data()), count * slotSize)) {
+            issues.push_back({RECORD_HEADER_SIZE + start * slotSize, "short read"});
+            return;
+        }
+        for (long i = 0; i < count; ++i) {
+            const unsigned char* slot = block.data() + i * slotSize;
+            std::uint32_t storedCrc = 0;
+            std::memcpy(&storedCrc, slot + payloadSize, sizeof(storedCrc));
+            if (storedCrc != crc32c(slot, payloadSize)) {
+                issues.push_back({RECORD_HEADER_SIZE + (start + i) * slotSize, "record checksum mismatch"});
+            }
+        }
+    }
+}
+
+const char* recordKindName(RecordKind kind) {
+    return kind == RecordKind::Artist ? "artist" : "album";
+}
+
+void printScrubReport(const ScrubReport& report) {
+    cout << "Scrub " << report.path << ": " << report.records << " records, "
+         << report.issues.size() << " problem(s)" << endl;
+    const std::size_t maxShown = 20;
+    for (std::size_t i = 0; i < report.issues.size() && i < maxShown; ++i) {
+        cout << "  offset " << report.issues[i].offset << ": " << report.issues[i].reason << endl;
+    }
+    if (report.issues.size() > maxShown) {
+        cout << "  ... " << (report.issues.size() - maxShown) << " more (see album_system.log)" << endl;
+    }
+}
+
+} // namespace
+
+long recordSizeFor(RecordKind kind) {
+    return kind == RecordKind::Artist ? ARTIST_RECORD_SIZE : ALBUM_RECORD_SIZE;
+}
+
+long recordCount(std::istream& in, RecordKind kind) {
+    in.clear();
+    in.seekg(0, std::ios::end);
+    long size = static_cast<long>(in.tellg());
+    if (size <= RECORD_HEADER_SIZE) {
+        return 0;
+    }
+    return (size - RECORD_HEADER_SIZE) / recordSizeFor(kind);
+}
+
+RecordStatus readRecordAt(std::istream& in, long pos, ArtistFile& record) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    return readRecordSlot(in, pos, record);
+}
+
+RecordStatus readRecordAt(std::istream& in, long pos, AlbumFile& record) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    return readRecordSlot(in, pos, record);
+}
+
+bool writeRecordAt(std::ostream& out, long pos, const ArtistFile& record) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    return writeJournaledSlot(out, pos, record);
+}
+
+bool writeRecordAt(std::ostream& out, long pos, const AlbumFile& record) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    return writeJournaledSlot(out, pos, record);
+}
+
+bool appendRecord(std::fstream& io, const ArtistFile& record, long& outPos) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    return appendRecordSlot(io, record, outPos);
+}
+
+bool appendRecord(std::fstream& io, const AlbumFile& record, long& outPos) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    return appendRecordSlot(io, record, outPos);
+}
+
+bool writeRecordFileHeader(std::ostream& out, RecordKind kind) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    if (!writeHeaderBytes(out, kind)) {
+        return false;
+    }
+    ChangeJournal::instance().append(kind, JournalOp::Reset, 0, nullptr, 0);
+    RecordCache::instance().clear(kind);
+    return true;
+}
+
+namespace {
+
+// Overwrites every byte of a record that is neither NUL nor printable ASCII with a space.
+template <std::size_t Size>
+void sanitizeRecordBytesScalar(unsigned char* bytes) {
+    for (std::size_t i = 0; i < Size; ++i) {
+        if (bytes[i] != 0 && (bytes[i] < 0x20 || bytes[i] > 0x7E)) {
+            bytes[i] = ' ';
+        }
+    }
+}
+
+// Field length policies: of<Record, Offset, Capacity>(record) is the offset of the field's
+// first NUL, or Capacity - 1 when it has none.
+struct ScalarFieldLength {
+    template <typename Record, std::size_t Offset, std::size_t Capacity>
+    static std::size_t of(const Record& record) {
+        return strnlen(reinterpret_cast<const char*>(&record) + Offset, Capacity - 1);
+    }
+};
+
+#ifdef ALBUM_HAVE_SIMD_RECORD_DECODER
+static_assert(sizeof(ArtistFile) >= 16 && sizeof(AlbumFile) >= 16, "vector decoder needs one full block");
+
+// Vector form of sanitizeRecordBytesScalar. The last block is moved back to end at the
+// record's last byte, overlapping the previous one, so nothing outside the record is touched;
+// rescanning bytes that were already sanitized leaves them unchanged.
+template <std::size_t Size>
+void sanitizeRecordBytesSse2(unsigned char* bytes) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lastControl = _mm_set1_epi8(0x1F);
+    const __m128i del = _mm_set1_epi8(0x7F);
+    const __m128i space = _mm_set1_epi8(' ');
+    for (std::size_t offset = 0; offset < Size; offset += 16) {
+        auto* at = reinterpret_cast<__m128i*>(bytes + std::min(offset, Size - 16));
+        __m128i block = _mm_loadu_si128(at);
+        // Signed compares: bytes from 0x80 up are negative and fail the first one.
+        __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(block, lastControl), _mm_cmplt_epi8(block, del));
+        __m128i keep = _mm_or_si128(printable, _mm_cmpeq_epi8(block, zero));
+        if (_mm_movemask_epi8(keep) != 0xFFFF) {
+            _mm_storeu_si128(at, _mm_or_si128(_mm_and_si128(keep, block), _mm_andnot_si128(keep, space)));
+        }
+    }
+}
+
+// Index of the lowest set bit of a non-zero mask.
+unsigned lowestBit(std::uint32_t value) {
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward(&index, value);
+    return static_cast<unsigned>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctz(value));
+#else
+    unsigned bit = 0;
+    while ((value & 1u) == 0) {
+        value >>= 1;
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+// Finds the NUL 16 bytes at a time, so the short fields of a typical record take one compare
+// each. Blocks may run into the next field; a block that would pass the end of the record is
+// loaded from the record's last 16 bytes and shifted instead.
+struct Sse2FieldLength {
+    template <typename Record, std::size_t Offset, std::size_t Capacity>
+    static std::size_t of(const Record& record) {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(&record);
+        const __m128i zero = _mm_setzero_si128();
+        for (std::size_t start = 0; start < Capacity - 1; start += 16) {
+            std::size_t at = Offset + start;
+            std::uint32_t nul;
+            if (at + 16 <= sizeof(Record)) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + at));
+                nul = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, zero)));
+            } else {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + sizeof(Record) - 16));
+                nul = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, zero)))
+                      >> (at + 16 - sizeof(Record));
+            }
+            if (nul != 0) {
+                return std::min(start + static_cast<std::size_t>(lowestBit(nul)), Capacity - 1);
+            }
+        }
+        return Capacity - 1;
+    }
+};
+#endif
+
+#define ALBUM_FIELD_LENGTH(Type, field) \
+    Length::template of<Type, offsetof(Type, field), sizeof(Type::field)>(record)
+
+template <typename Length>
+void measureFields(const ArtistFile& record, ArtistFieldLengths& lengths) {
+    lengths.artistId = ALBUM_FIELD_LENGTH(ArtistFile, artistIds);
+    lengths.name = ALBUM_FIELD_LENGTH(ArtistFile, names);
+    lengths.phone = ALBUM_FIELD_LENGTH(ArtistFile, phones);
+    lengths.email = ALBUM_FIELD_LENGTH(ArtistFile, emails);
+}
+
+template <typename Length>
+void measureFields(const AlbumFile& record, AlbumFieldLengths& lengths) {
+    lengths.albumId = ALBUM_FIELD_LENGTH(AlbumFile, albumIds);
+    lengths.artistIdRef = ALBUM_FIELD_LENGTH(AlbumFile, artistIdRefs);
+    lengths.title = ALBUM_FIELD_LENGTH(AlbumFile, titles);
+    lengths.recordFormat = ALBUM_FIELD_LENGTH(AlbumFile, recordFormats);
+    lengths.datePublished = ALBUM_FIELD_LENGTH(AlbumFile, datePublished);
+    lengths.path = ALBUM_FIELD_LENGTH(AlbumFile, paths);
+}
+
+// The loaders only keep the fields that go into the index.
+template <typename Length>
+void measureIndexFields(const ArtistFile& record, ArtistFieldLengths& lengths) {
+    lengths.artistId = ALBUM_FIELD_LENGTH(ArtistFile, artistIds);
+    lengths.name = ALBUM_FIELD_LENGTH(ArtistFile, names);
+}
+
+template <typename Length>
+void measureIndexFields(const AlbumFile& record, AlbumFieldLengths& lengths) {
+    lengths.albumId = ALBUM_FIELD_LENGTH(AlbumFile, albumIds);
+    lengths.artistIdRef = ALBUM_FIELD_LENGTH(AlbumFile, artistIdRefs);
+    lengths.title = ALBUM_FIELD_LENGTH(AlbumFile, titles);
+    lengths.recordFormat = ALBUM_FIELD_LENGTH(AlbumFile, recordFormats);
+}
+
+#undef ALBUM_FIELD_LENGTH
+
+template <typename Record>
+void sanitizeRecordBytes(Record& record, RecordDecoderPath path) {
+    auto* bytes = reinterpret_cast<unsigned char*>(&record);
+#ifdef ALBUM_HAVE_SIMD_RECORD_DECODER
+    if (path == RecordDecoderPath::Simd) {
+        sanitizeRecordBytesSse2<sizeof(Record)>(bytes);
+        return;
+    }
+#else
+    static_cast<void>(path);
+#endif
+    sanitizeRecordBytesScalar<sizeof(Record)>(bytes);
+}
+
+template <typename Record, typename Lengths>
+void measureFields(const Record& record, Lengths& lengths, RecordDecoderPath path) {
+#ifdef ALBUM_HAVE_SIMD_RECORD_DECODER
+    if (path == RecordDecoderPath::Simd) {
+        measureFields<Sse2FieldLength>(record, lengths);
+        return;
+    }
+#else
+    static_cast<void>(path);
+#endif
+    measureFields<ScalarFieldLength>(record, lengths);
+}
+
+template <typename Record, typename Lengths>
+void measureIndexFields(const Record& record, Lengths& lengths) {
+#ifdef ALBUM_HAVE_SIMD_RECORD_DECODER
+    measureIndexFields<Sse2FieldLength>(record, lengths);
+#else
+    measureIndexFields<ScalarFieldLength>(record, lengths);
+#endif
+}
+
+void decodeForDisplay(ArtistFile& record) {
+    ArtistFieldLengths lengths;
+    decodeRecord(record, lengths);
+}
+
+void decodeForDisplay(AlbumFile& record) {
+    AlbumFieldLengths lengths;
+    decodeRecord(record, lengths);
+}
+
+std::uint64_t recordCacheKey(RecordKind kind, long pos) {
+    return (static_cast<std::uint64_t>(kind) << 56) | static_cast<std::uint64_t>(pos);
+}
+
+ArtistFile& cachedPayload(ArtistFile& artist, AlbumFile&, const ArtistFile&) {
+    return artist;
+}
+
+AlbumFile& cachedPayload(ArtistFile&, AlbumFile& album, const AlbumFile&) {
+    return album;
+}
+
+} // namespace
+
+bool simdRecordDecoderAvailable() {
+#ifdef ALBUM_HAVE_SIMD_RECORD_DECODER
+    return true;
+#else
+    return false;
+#endif
+}
+
+void decodeRecord(ArtistFile& record, ArtistFieldLengths& lengths, RecordDecoderPath path) {
+    sanitizeRecordBytes(record, path);
+    record.artistIds[sizeof(record.artistIds) - 1] = '\0';
+    record.names[sizeof(record.names) - 1] = '\0';
+    record.phones[sizeof(record.phones) - 1] = '\0';
+    record.emails[sizeof(record.emails) - 1] = '\0';
+    if (record.genders == '\0') {
+        record.genders = ' ';
+    }
+    measureFields(record, lengths, path);
+}
+
+void decodeRecord(AlbumFile& record, AlbumFieldLengths& lengths, RecordDecoderPath path) {
+    sanitizeRecordBytes(record, path);
+    record.albumIds[sizeof(record.albumIds) - 1] = '\0';
+    record.artistIdRefs[sizeof(record.artistIdRefs) - 1] = '\0';
+    record.titles[sizeof(record.titles) - 1] = '\0';
+    record.recordFormats[sizeof(record.recordFormats) - 1] = '\0';
+    record.datePublished[sizeof(record.datePublished) - 1] = '\0';
+    record.paths[sizeof(record.paths) - 1] = '\0';
+    measureFields(record, lengths, path);
+}
+
+void measureRecord(const ArtistFile& record, ArtistFieldLengths& lengths, RecordDecoderPath path) {
+    measureFields(record, lengths, path);
+}
+
+void measureRecord(const AlbumFile& record, AlbumFieldLengths& lengths, RecordDecoderPath path) {
+    measureFields(record, lengths, path);
+}
+
+const RecordFieldSpec ARTIST_FIELDS[ARTIST_FIELD_COUNT] = {
+    {"ID", offsetof(ArtistFile, artistIds), sizeof(ArtistFile::artistIds), sizeof(ArtistFile::artistIds) - 1},
+    {"Name", offsetof(ArtistFile, names), sizeof(ArtistFile::names), sizeof(ArtistFile::names) - 1},
+    {"Gender", offsetof(ArtistFile, genders), sizeof(ArtistFile::genders), sizeof(ArtistFile::genders)},
+    {"Phone", offsetof(ArtistFile, phones), sizeof(ArtistFile::phones), sizeof(ArtistFile::phones) - 1},
+    {"Email", offsetof(ArtistFile, emails), sizeof(ArtistFile::emails), sizeof(ArtistFile::emails) - 1},
+};
+
+const RecordFieldSpec ALBUM_FIELDS[ALBUM_FIELD_COUNT] = {
+    {"AlbumID", offsetof(AlbumFile, albumIds), sizeof(AlbumFile::albumIds), sizeof(AlbumFile::albumIds) - 1},
+    {"ArtistID", offsetof(AlbumFile, artistIdRefs), sizeof(AlbumFile::artistIdRefs), sizeof(AlbumFile::artistIdRefs) - 1},
+    {"Title", offsetof(AlbumFile, titles), sizeof(AlbumFile::titles), sizeof(AlbumFile::titles) - 1},
+    {"RecordFormat", offsetof(AlbumFile, recordFormats), sizeof(AlbumFile::recordFormats), sizeof(AlbumFile::recordFormats) - 1},
+    {"DatePublished", offsetof(AlbumFile, datePublished), sizeof(AlbumFile::datePublished), sizeof(AlbumFile::datePublished) - 1},
+    {"Path", offsetof(AlbumFile, paths), sizeof(AlbumFile::paths), sizeof(AlbumFile::paths) - 1},
+};
+
+namespace {
+
+void storeRecordField(char* base, const RecordFieldSpec& spec, const char* text, std::size_t length) {
+    std::size_t copied = std::min(length, spec.capacity);
+    std::memcpy(base + spec.offset, text, copied);
+    std::memset(base + spec.offset + copied, 0, spec.size - copied);
+}
+
+} // namespace
+
+void setRecordField(ArtistFile& record, ArtistField field, const char* text, std::size_t length) {
+    storeRecordField(reinterpret_cast<char*>(&record), ARTIST_FIELDS[field], text, length);
+}
+
+void setRecordField(AlbumFile& record, AlbumField field, const char* text, std::size_t length) {
+    storeRecordField(reinterpret_cast<char*>(&record), ALBUM_FIELDS[field], text, length);
+}
+
+RecordCache& RecordCache::instance() {
+    static RecordCache cache;
+    return cache;
+}
+
+RecordStatus RecordCache::read(std::istream& in, long pos, ArtistFile& record) {
+    return readThrough(in, pos, record);
+}
+
+RecordStatus RecordCache::read(std::istream& in, long pos, AlbumFile& record) {
+    return readThrough(in, pos, record);
+}
+
+// The file lock is held across a miss so a write cannot slip in between reading a slot
+// and caching it; writers invalidate under the same lock.
+template <typename Record>
+RecordStatus RecordCache::readThrough(std::istream& in, long pos, Record& record) {
+    const std::uint64_t key = recordCacheKey(recordKindOf(record), pos);
+    std::lock_guard<std::recursive_mutex> fileLock(g_fileMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = slots.find(key);
+        if (found != slots.end()) {
+            Entry& entry = entries[found->second];
+            record = cachedPayload(entry.artist, entry.album, record);
+            if (head != found->second) {
+                unlink(found->second);
+                pushFront(found->second);
+            }
+            ++counters.hits;
+            return RecordStatus::Ok;
+        }
+        ++counters.misses;
+    }
+    RecordStatus status = readRecordAt(in, pos, record);
+    if (status != RecordStatus::Ok) {
+        return status;
+    }
+    decodeForDisplay(record);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (capacity == 0) {
+        return status;
+    }
+    std::uint32_t slot;
+    if (slots.size() >= capacity) {
+        slot = tail;
+        slots.erase(entries[slot].key);
+        unlink(slot);
+        ++counters.evictions;
+    } else if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = static_cast<std::uint32_t>(entries.size());
+        entries.emplace_back();
+    }
+    Entry& entry = entries[slot];
+    entry.key = key;
+    cachedPayload(entry.artist, entry.album, record) = record;
+    slots.emplace(key, slot);
+    pushFront(slot);
+    return status;
+}
+
+void RecordCache::unlink(std::uint32_t slot) {
+    Entry& entry = entries[slot];
+    (entry.prev == NONE ? head : entries[entry.prev].next) = entry.next;
+    (entry.next == NONE ? tail : entries[entry.next].prev) = entry.prev;
+}
+
+void RecordCache::pushFront(std::uint32_t slot) {
+    Entry& entry = entries[slot];
+    entry.prev = NONE;
+    entry.next = head;
+    (head == NONE ? tail : entries[head].prev) = slot;
+    head = slot;
+}
+
+void RecordCache::remove(std::uint32_t slot) {
+    slots.erase(entries[slot].key);
+    unlink(slot);
+    freeSlots.push_back(slot);
+    ++counters.invalidations;
+}
+
+// Large ranges (block appends, re-parenting) walk the cached entries instead of probing
+// every written offset.
+void RecordCache::invalidate(RecordKind kind, long firstPos, std::size_t count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (slots.empty()) {
+        return;
+    }
+    const long slotSize = recordSizeFor(kind);
+    if (count <= slots.size()) {
+        for (std::size_t i = 0; i < count; ++i) {
+            auto found = slots.find(recordCacheKey(kind, firstPos + static_cast<long>(i) * slotSize));
+            if (found != slots.end()) {
+                remove(found->second);
+            }
+        }
+        return;
+    }
+    const std::uint64_t first = recordCacheKey(kind, firstPos);
+    const std::uint64_t last = recordCacheKey(kind, firstPos + static_cast<long>(count) * slotSize);
+    for (std::uint32_t slot = head; slot != NONE;) {
+        std::uint32_t next = entries[slot].next;
+        if (entries[slot].key >= first && entries[slot].key < last) {
+            remove(slot);
+        }
+        slot = next;
+    }
+}
+
+void RecordCache::clear(RecordKind kind) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (std::uint32_t slot = head; slot != NONE;) {
+        std::uint32_t next = entries[slot].next;
+        if (entries[slot].key >> 56 == static_cast<std::uint64_t>(kind)) {
+            remove(slot);
+        }
+        slot = next;
+    }
+}
+
+void RecordCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    counters.invalidations += slots.size();
+    decltype(entries)().swap(entries);
+    decltype(freeSlots)().swap(freeSlots);
+    decltype(slots)().swap(slots);
+    head = NONE;
+    tail = NONE;
+}
+
+void RecordCache::setCapacity(std::size_t entryCount) {
+    clear();
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity = std::min<std::size_t>(entryCount, NONE);
+}
+
+RecordCacheStats RecordCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    RecordCacheStats copy = counters;
+    copy.entries = slots.size();
+    copy.capacity = capacity;
+    return copy;
+}
+
+bool isLegacyRecordFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(RECORD_FILE_MAGIC)] = {};
+    if (!in || !in.read(magic, sizeof(magic))) {
+        in.clear();
+        in.seekg(0, std::ios::end);
+        return in && in.tellg() > 0;
+    }
+    return std::memcmp(magic, RECORD_FILE_MAGIC, sizeof(magic)) != 0;
+}
+
+bool migrateLegacyRecordFile(const std::string& path, RecordKind kind) {
+    ALBUM_TRACE_SCOPE("migrateLegacyRecordFile");
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    if (!isLegacyRecordFile(path)) {
+        return true;
+    }
+    const std::size_t payloadSize = kind == RecordKind::Artist ? sizeof(ArtistFile) : sizeof(AlbumFile);
+    const std::string tempPath = path + ".migrating";
+    const std::string legacyPath = path + ".v1";
+    long migrated = 0;
+    std::streamoff trailing = 0;
+    {
+        std::ifstream src(path, std::ios::binary);
+        std::ofstream dst(tempPath, std::ios::binary | std::ios::trunc);
+        if (!src || !dst || !writeHeaderBytes(dst, kind)) {
+            ALBUM_LOG_ERROR("Migration failed: unable to open {}", path);
+            return false;
+        }
+        std::vector<unsigned char> slot(payloadSize + RECORD_CRC_SIZE);
+        while (src.read(reinterpret_cast<char*>(slot.data()), static_cast<std::streamsize>(payloadSize))) {
+            std::uint32_t crc = crc32c(slot.data(), payloadSize);
+            std::memcpy(slot.data() + payloadSize, &crc, sizeof(crc));
+            dst.write(reinterpret_cast<const char*>(slot.data()), static_cast<std::streamsize>(slot.size()));
+            ++migrated;
+        }
+        trailing = src.gcount();
+        dst.flush();
+        if (!dst) {
+            dst.close();
+            std::remove(tempPath.c_str());
+            ALBUM_LOG_ERROR("Migration failed: unable to write {}", tempPath);
+            return false;
+        }
+    }
+    std::remove(legacyPath.c_str());
+    if (std::rename(path.c_str(), legacyPath.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        ALBUM_LOG_ERROR("Migration failed: unable to move {} aside", path);
+        return false;
+    }
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        // Put the original back before dropping the converted copy, otherwise the
+        // next open would find no data file and start an empty one.
+        if (std::rename(legacyPath.c_str(), path.c_str()) != 0) {
+            ALBUM_LOG_ERROR("Migration failed: {} could not be restored; original data is in {} and {}", path, legacyPath, tempPath);
+            return false;
+        }
+        std::remove(tempPath.c_str());
+        ALBUM_LOG_ERROR("Migration failed: unable to replace {}", path);
+        return false;
+    }
+    RecordCache::instance().clear(kind);
+    ALBUM_LOG_INFO("Migrated {} {} records in {} to format v{}; original kept as {}", migrated, recordKindName(kind), path, RECORD_FORMAT_VERSION, legacyPath);
+    if (trailing > 0) {
+        ALBUM_LOG_WARN("Migration of {} dropped {} trailing bytes", path, trailing);
+    }
+    return true;
+}
+
+void openRecordFile(std::fstream& fstr, const std::string& path, RecordKind kind) {
+    ALBUM_TRACE_SCOPE("openRecordFile");
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    if (!migrateLegacyRecordFile(path, kind)) {
+        throw FileException("Failed to migrate legacy data file: " + path);
+    }
+    openFile(fstr, path);
+    fstr.clear();
+    fstr.seekg(0, std::ios::end);
+    if (fstr.tellg() < RECORD_HEADER_SIZE) {
+        if (!writeRecordFileHeader(fstr, kind)) {
+            throw FileException("Failed to initialise data file: " + path);
+        }
+        return;
+    }
+    unsigned char header[RECORD_HEADER_SIZE];
+    fstr.seekg(0, std::ios::beg);
+    fstr.read(reinterpret_cast<char*>(header), sizeof(header));
+    std::string problem = checkRecordHeader(header, kind, false);
+    if (!problem.empty()) {
+        fstr.close();
+        throw FileException("Unsupported data file " + path + ": " + problem);
+    }
+    // Cache keys carry only the kind and offset, so records cached from another file of
+    // this kind must not outlive the open.
+    RecordCache::instance().clear(kind);
+}
+
+ScrubReport scrubRecordFile(const std::string& path, RecordKind kind, unsigned threads) {
+    ALBUM_TRACE_SCOPE("scrubRecordFile");
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    ScrubReport report;
+    report.path = path;
+    report.kind = kind;
+
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return report;
+    }
+    long size = static_cast<long>(in.tellg());
+    if (size == 0) {
+        return report;
+    }
+    unsigned char header[RECORD_HEADER_SIZE] = {};
+    in.seekg(0, std::ios::beg);
+    if (size < RECORD_HEADER_SIZE || !in.read(reinterpret_cast<char*>(header), sizeof(header))) {
+        report.issues.push_back({0, "truncated data file header"});
+        return report;
+    }
+    std::string problem = checkRecordHeader(header, kind, true);
+    if (!problem.empty()) {
+        report.issues.push_back({0, problem});
+        if (problem != "header checksum mismatch") {
+            return report;
+        }
+    }
+    in.close();
+
+    const long slotSize = recordSizeFor(kind);
+    const std::size_t payloadSize = static_cast<std::size_t>(slotSize - RECORD_CRC_SIZE);
+    report.records = (size - RECORD_HEADER_SIZE) / slotSize;
+    long trailing = (size - RECORD_HEADER_SIZE) % slotSize;
+
+    std::size_t workers = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    long minPerWorker = static_cast<long>(SCRUB_BLOCK_RECORDS);
+    workers = std::max<std::size_t>(1, std::min<std::size_t>(workers, static_cast<std::size_t>((report.records + minPerWorker - 1) / minPerWorker)));
+    std::vector<std::vector<ScrubIssue>> found(workers);
+    long perWorker = (report.records + static_cast<long>(workers) - 1) / static_cast<long>(workers);
+    if (workers == 1) {
+        scrubRecordRange(path, slotSize, payloadSize, 0, report.records, found[0]);
+    } else {
+        std::vector<std::thread> pool;
+        pool.reserve(workers);
+        for (std::size_t w = 0; w < workers; ++w) {
+            long first = static_cast<long>(w) * perWorker;
+            long last = std::min(report.records, first + perWorker);
+            pool.emplace_back(scrubRecordRange, std::cref(path), slotSize, payloadSize, first, last, std::ref(found[w]));
+        }
+        for (auto& t : pool) {
+            t.join();
+        }
+    }
+    for (auto& part : found) {
+        report.issues.insert(report.issues.end(), part.begin(), part.end());
+    }
+    if (trailing != 0) {
+        report.issues.push_back({size - trailing, "truncated record (" + std::to_string(trailing) + " trailing bytes)"});
+    }
+    return report;
+}
+
+bool scrubDataFiles(bool verbose) {
+    ALBUM_TRACE_SCOPE("scrubDataFiles");
+    auto start = std::chrono::steady_clock::now();
+    ScrubReport reports[] = {scrubRecordFile(artistFilePath, RecordKind::Artist),
+                             scrubRecordFile(albumFilePath, RecordKind::Album)};
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    bool clean = true;
+    for (const auto& report : reports) {
+        for (const auto& issue : report.issues) {
+            ALBUM_LOG_WARN("Scrub {}: offset {} {}", report.path, issue.offset, issue.reason);
+        }
+        if (!report.clean() || verbose) {
+            printScrubReport(report);
+        }
+        clean = clean && report.clean();
+    }
+    ALBUM_LOG_INFO("Scrub finished in {} ms: {}", elapsedMs, (clean ? "no problems found" : "problems found"));
+    return clean;
+}
+
+namespace {
+
+const std::uint32_t JOURNAL_ENTRY_MAGIC = 0x4C4E524Au; // "JRNL"
+const std::uint32_t JOURNAL_BODY_FIXED = 8 + 1 + 1 + 2 + 8;
+const std::uint32_t JOURNAL_MAX_BODY = JOURNAL_BODY_FIXED + 4096;
+
+// Skips forward to the next entry marker after a torn or corrupt entry.
+bool resyncJournal(std::istream& in, std::streamoff from) {
+    in.clear();
+    in.seekg(from, std::ios::beg);
+    std::uint32_t window = 0;
+    char c;
+    std::streamoff pos = from;
+    while (in.get(c)) {
+        window = (window >> 8) | (static_cast<std::uint32_t>(static_cast<unsigned char>(c)) << 24);
+        ++pos;
+        if (pos - from >= 4 && window == JOURNAL_ENTRY_MAGIC) {
+            in.seekg(pos - 4, std::ios::beg);
+            return true;
+        }
+    }
+    in.clear();
+    return false;
+}
+
+// Applies one journaled record write to an open data file without journaling it again.
+bool applyJournalWrite(std::fstream& file, const JournalEntry& entry) {
+    if (entry.kind == RecordKind::Artist && entry.payload.size() == sizeof(ArtistFile)) {
+        ArtistFile record;
+        std::memcpy(&record, entry.payload.data(), sizeof(record));
+        return writeRecordSlot(file, entry.pos, record);
+    }
+    if (entry.kind == RecordKind::Album && entry.payload.size() == sizeof(AlbumFile)) {
+        AlbumFile record;
+        std::memcpy(&record, entry.payload.data(), sizeof(record));
+        return writeRecordSlot(file, entry.pos, record);
+    }
+    return false;
+}
+
+// Replays a journaled full rewrite: the file is cut back to a bare header.
+bool applyJournalReset(std::fstream& file, const std::string& path, RecordKind kind) {
+    file.close();
+    std::error_code ec;
+    std::filesystem::resize_file(path, 0, ec);
+    if (ec) {
+        return false;
+    }
+    file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+    return file && writeHeaderBytes(file, kind);
+}
+
+} // namespace
+
+ChangeJournal& ChangeJournal::instance() {
+    static ChangeJournal journal;
+    return journal;
+}
+
+bool ChangeJournal::open(const std::string& path) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    close();
+    std::error_code ec;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, ec);
+    }
+    file.open(path, std::ios::binary | std::ios::app);
+    if (!file) {
+        ALBUM_LOG_WARN("Change journal unavailable: unable to open {}", path);
+        return false;
+    }
+    std::uintmax_t size = std::filesystem::file_size(path, ec);
+    offset = ec ? 0 : static_cast<std::int64_t>(size);
+    filePath = path;
+    ALBUM_LOG_INFO("Change journal opened: {} ({} bytes)", path, offset);
+    return true;
+}
+
+void ChangeJournal::close() {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    if (file.is_open()) {
+        file.close();
+    }
+    offset = -1;
+}
+
+bool ChangeJournal::isOpen() const {
+    return file.is_open();
+}
+
+std::int64_t ChangeJournal::endOffset() const {
+    return file.is_open() ? offset : -1;
+}
+
+void ChangeJournal::append(RecordKind kind, JournalOp op, long pos, const void* payload, std::size_t length) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    if (!file.is_open()) {
+        return;
+    }
+    std::uint32_t bodyLength = JOURNAL_BODY_FIXED + static_cast<std::uint32_t>(length);
+    std::vector<unsigned char> buffer(8 + bodyLength + RECORD_CRC_SIZE);
+    unsigned char* p = buffer.data();
+    std::int64_t timestamp = currentTimeMillis();
+    std::int64_t position = pos;
+    std::uint16_t reserved = 0;
+    std::memcpy(p, &JOURNAL_ENTRY_MAGIC, 4);
+    std::memcpy(p + 4, &bodyLength, 4);
+    unsigned char* body = p + 8;
+    std::memcpy(body, &timestamp, 8);
+    body[8] = static_cast<unsigned char>(kind);
+    body[9] = static_cast<unsigned char>(op);
+    std::memcpy(body + 10, &reserved, 2);
+    std::memcpy(body + 12, &position, 8);
+    if (length > 0) {
+        std::memcpy(body + JOURNAL_BODY_FIXED, payload, length);
+    }
+    std::uint32_t crc = crc32c(body, bodyLength);
+    std::memcpy(body + bodyLength, &crc, sizeof(crc));
+    file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    file.flush();
+    if (!file) {
+        ALBUM_LOG_ERROR("Change journal write failed; point-in-time restore will stop at this change");
+        file.clear();
+        return;
+    }
+    offset += static_cast<std::int64_t>(buffer.size());
+}
+
+void ChangeJournal::appendWrites(RecordKind kind, long firstPos, const unsigned char* slots, std::size_t count) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    if (!file.is_open() || count == 0) {
+        return;
+    }
+    const std::size_t slotSize = static_cast<std::size_t>(recordSizeFor(kind));
+    const std::size_t payloadSize = slotSize - RECORD_CRC_SIZE;
+    const std::uint32_t bodyLength = JOURNAL_BODY_FIXED + static_cast<std::uint32_t>(payloadSize);
+    const std::size_t entrySize = 8 + bodyLength + RECORD_CRC_SIZE;
+    std::vector<unsigned char> buffer(entrySize * count);
+    std::int64_t timestamp = currentTimeMillis();
+    std::uint16_t reserved = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        unsigned char* p = buffer.data() + i * entrySize;
+        std::int64_t position = firstPos + static_cast<std::int64_t>(i * slotSize);
+        std::memcpy(p, &JOURNAL_ENTRY_MAGIC, 4);
+        std::memcpy(p + 4, &bodyLength, 4);
+        unsigned char* body = p + 8;
+        std::memcpy(body, &timestamp, 8);
+        body[8] = static_cast<unsigned char>(kind);
+        body[9] = static_cast<unsigned char>(JournalOp::Write);
+        std::memcpy(body + 10, &reserved, 2);
+        std::memcpy(body + 12, &position, 8);
+        std::memcpy(body + JOURNAL_BODY_FIXED, slots + i * slotSize, payloadSize);
+        std::uint32_t crc = crc32c(body, bodyLength);
+        std::memcpy(body + bodyLength, &crc, sizeof(crc));
+    }
+    file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    file.flush();
+    if (!file) {
+        ALBUM_LOG_ERROR("Change journal write failed; point-in-time restore will stop at this change");
+        file.clear();
+        return;
+    }
+    offset += static_cast<std::int64_t>(buffer.size());
+}
+
+bool ChangeJournal::readEntry(std::istream& in, JournalEntry& entry) {
+    unsigned char prefix[8];
+    if (!in.read(reinterpret_cast<char*>(prefix), sizeof(prefix))) {
+        return false;
+    }
+    std::uint32_t magic = 0;
+    std::uint32_t bodyLength = 0;
+    std::memcpy(&magic, prefix, 4);
+    std::memcpy(&bodyLength, prefix + 4, 4);
+    if (magic != JOURNAL_ENTRY_MAGIC || bodyLength < JOURNAL_BODY_FIXED || bodyLength > JOURNAL_MAX_BODY) {
+        return false;
+    }
+    std::vector<unsigned char> body(bodyLength + RECORD_CRC_SIZE);
+    if (!in.read(reinterpret_cast<char*>(body.data()), static_cast<std::streamsize>(body.size()))) {
+        return false;
+    }
+    std::uint32_t storedCrc = 0;
+    std::memcpy(&storedCrc, body.data() + bodyLength, sizeof(storedCrc));
+    if (storedCrc != crc32c(body.data(), bodyLength)) {
+        return false;
+    }
+    std::int64_t position = 0;
+    std::memcpy(&entry.timestampMs, body.data(), 8);
+    entry.kind = static_cast<RecordKind>(body[8]);
+    entry.op = static_cast<JournalOp>(body[9]);
+    std::memcpy(&position, body.data() + 12, 8);
+    entry.pos = static_cast<long>(position);
+    entry.payload.assign(body.begin() + JOURNAL_BODY_FIXED, body.begin() + bodyLength);
+    return true;
+}
+
+std::int64_t currentTimeMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool replayJournal(const std::string& journalPath, std::int64_t fromOffset, std::int64_t untilMs,
+                   const std::string& artistPath, const std::string& albumPath, std::size_t& applied) {
+    ALBUM_TRACE_SCOPE("replayJournal");
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    applied = 0;
+    std::ifstream journal(journalPath, std::ios::binary);
+    if (!journal) {
+        // No journal yet means nothing changed since the snapshot.
+        return true;
+    }
+    std::fstream artistStream(artistPath, std::ios::in | std::ios::out | std::ios::binary);
+    std::fstream albumStream(albumPath, std::ios::in | std::ios::out | std::ios::binary);
+    if (!artistStream || !albumStream) {
+        return false;
+    }
+    journal.seekg(fromOffset, std::ios::beg);
+    JournalEntry entry;
+    while (true) {
+        std::streamoff entryStart = journal.tellg();
+        if (!ChangeJournal::readEntry(journal, entry)) {
+            if (journal.eof() || !resyncJournal(journal, entryStart + 1)) {
+                break;
+            }
+            ALBUM_LOG_WARN("Journal replay skipped damaged bytes at offset {}", entryStart);
+            continue;
+        }
+        if (entry.timestampMs > untilMs) {
+            break;
+        }
+        bool isArtist = entry.kind == RecordKind::Artist;
+        std::fstream& target = isArtist ? artistStream : albumStream;
+        bool ok = entry.op == JournalOp::Reset
+                      ? applyJournalReset(target, isArtist ? artistPath : albumPath, entry.kind)
+                      : applyJournalWrite(target, entry);
+        if (!ok) {
+            ALBUM_LOG_ERROR("Journal replay failed at offset {}", entryStart);
+            return false;
+        }
+        ++applied;
+    }
+    return true;
+}
+
+namespace {
+
+// Record formats accepted by validateAlbumFormat. recordFormatCode() is index + 1 and keeps
+// 0 for anything else; the columnar RecordFormat enum stores the same codes.
+const char* const ALBUM_RECORD_FORMATS[] = {"m4a", "flac", "mp3", "mp4", "wav", "wma", "aac", "dsd", "alac", "aiff"};
+const std::size_t ALBUM_RECORD_FORMAT_COUNT = sizeof(ALBUM_RECORD_FORMATS) / sizeof(ALBUM_RECORD_FORMATS[0]);
+static_assert(ALBUM_RECORD_FORMAT_COUNT + 1 == RECORD_FORMAT_CODES, "RECORD_FORMAT_CODES is out of date");
+
+// "DD/MM/YYYY" -> YYYYMMDD, 0 when the field has another shape.
+std::uint32_t columnarDate(const char* text) {
+    static const int digitAt[] = {0, 1, 3, 4, 6, 7, 8, 9};
+    for (int i : digitAt) {
+        if (text[i] < '0' || text[i] > '9') {
+            return 0;
+        }
+    }
+    if (text[2] != '/' || text[5] != '/') {
+        return 0;
+    }
+    auto digits = [text](int at, int count) {
+        std::uint32_t value = 0;
+        for (int i = 0; i < count; ++i) {
+            value = value * 10 + static_cast<std::uint32_t>(text[at + i] - '0');
+        }
+        return value;
+    };
+    return digits(6, 4) * 10000 + digits(3, 2) * 100 + digits(0, 2);
+}
+
+std::uint8_t recordFormatCodeOf(const char* text, std::size_t length) {
+    for (std::size_t i = 0; i < ALBUM_RECORD_FORMAT_COUNT; ++i) {
+        const char* label = ALBUM_RECORD_FORMATS[i];
+        if (std::strlen(label) == length &&
+            std::equal(text, text + length, label, [](char a, char b) { return tolower(static_cast<unsigned char>(a)) == b; })) {
+            return static_cast<std::uint8_t>(i + 1);
+        }
+    }
+    return 0;
+}
+
+std::uint16_t recordYear(const char* date) {
+    return static_cast<std::uint16_t>(columnarDate(date) / 10000);
+}
+
+// Index entry for a record whose fields are terminated.
+albumIndex albumEntryFor(const AlbumFile& record, long pos) {
+    return albumIndex{record.albumIds, record.artistIdRefs, record.titles, pos, recordYear(record.datePublished),
+                      recordFormatCodeOf(record.recordFormats, strlen(record.recordFormats))};
+}
+
+// Points an index entry at an album, moving its statistics from the old values to the new.
+void assignAlbumEntry(albumList& album, albumIndex& entry, const Album& data, long pos) {
+    album.stats.remove(entry);
+    entry.albumId = data.getAlbumId();
+    entry.artistId = data.getArtistId();
+    entry.title = data.getTitle();
+    entry.pos = pos;
+    entry.year = publicationYear(data.getDatePublished());
+    entry.format = recordFormatCode(data.getRecordFormat());
+    album.stats.add(entry);
+}
+
+// Restores the index entries of album snapshots after their slots were rewritten. The
+// entries are found by slot with one pass over the index and the restored indexes leave
+// delAlbArray in one pass, so restoring k albums costs O(n + k) rather than O(k * n).
+void restoreAlbumEntries(albumList& albums, indexSet& delAlbArray, const std::vector<AlbumSnapshot>& snapshots,
+                         const std::vector<bool>& written) {
+    std::unordered_map<long, std::size_t> wanted;
+    wanted.reserve(snapshots.size());
+    for (std::size_t s = 0; s < snapshots.size(); ++s) {
+        if (written[s]) {
+            wanted.emplace(snapshots[s].pos, s);
+        }
+    }
+    std::unordered_set<int> restored;
+    restored.reserve(wanted.size());
+    for (std::size_t i = 0; i < albums.albList.size() && restored.size() < wanted.size(); ++i) {
+        auto found = wanted.find(albums.albList[i].pos);
+        if (found == wanted.end()) {
+            continue;
+        }
+        const AlbumSnapshot& snapshot = snapshots[found->second];
+        assignAlbumEntry(albums, albums.albList[i], snapshot.data, snapshot.pos);
+        restored.insert(static_cast<int>(i));
+    }
+    delAlbArray.indexes.erase(std::remove_if(delAlbArray.indexes.begin(), delAlbArray.indexes.end(),
+                                             [&](int idx) { return restored.count(idx) != 0; }),
+                              delAlbArray.indexes.end());
+}
+
+// Turns an index entry into a tombstone for its slot and uncounts it.
+void blankAlbumEntry(albumList& album, albumIndex& entry) {
+    album.stats.remove(entry);
+    entry.albumId = "-1";
+    entry.artistId = "-1";
+    entry.title.clear();
+    entry.year = 0;
+    entry.format = 0;
+}
+
+} // namespace
+
+std::uint8_t recordFormatCode(const std::string& format) {
+    return recordFormatCodeOf(format.data(), format.size());
+}
+
+const char* recordFormatLabel(std::uint8_t code) {
+    return code >= 1 && code <= ALBUM_RECORD_FORMAT_COUNT ? ALBUM_RECORD_FORMATS[code - 1] : "unknown";
+}
+
+std::uint16_t publicationYear(const std::string& date) {
+    return date.size() >= 10 ? recordYear(date.c_str()) : 0;
+}
+
+void CatalogStatistics::add(const albumIndex& entry) {
+    if (entry.albumId == "-1") {
+        return;
+    }
+    ++albums;
+    ++albumsPerArtist[entry.artistId];
+    ++albumsPerFormat[entry.format < RECORD_FORMAT_CODES ? entry.format : 0];
+    ++albumsPerYear[entry.year];
+}
+
+void CatalogStatistics::remove(const albumIndex& entry) {
+    if (entry.albumId == "-1" || albums == 0) {
+        return;
+    }
+    --albums;
+    auto artistIt = albumsPerArtist.find(entry.artistId);
+    if (artistIt != albumsPerArtist.end() && --artistIt->second == 0) {
+        albumsPerArtist.erase(artistIt);
+    }
+    std::size_t& formatCount = albumsPerFormat[entry.format < RECORD_FORMAT_CODES ? entry.format : 0];
+    if (formatCount > 0) {
+        --formatCount;
+    }
+    auto yearIt = albumsPerYear.find(entry.year);
+    if (yearIt != albumsPerYear.end() && --yearIt->second == 0) {
+        albumsPerYear.erase(yearIt);
+    }
+}
+
+void CatalogStatistics::clear() {
+    albums = 0;
+    albumsPerArtist.clear();
+    albumsPerFormat.fill(0);
+    albumsPerYear.clear();
+}
+
+std::size_t CatalogStatistics::albumsBy(const std::string& artistId) const {
+    auto it = albumsPerArtist.find(artistId);
+    return it == albumsPerArtist.end() ? 0 : it->second;
+}
+
+void recountCatalogStatistics(albumList& album) {
+    ALBUM_TRACE_SCOPE("recountCatalogStatistics");
+    CatalogStatistics& stats = album.stats;
+    stats.clear();
+    std::vector<std::size_t> years(std::size_t{UINT16_MAX} + 1);
+    const std::string* runArtist = nullptr;
+    std::size_t runLength = 0;
+    for (const auto& entry : album.albList) {
+        if (entry.albumId == "-1") {
+            continue;
+        }
+        ++stats.albums;
+        ++stats.albumsPerFormat[entry.format < RECORD_FORMAT_CODES ? entry.format : 0];
+        ++years[entry.year];
+        if (runArtist == nullptr || entry.artistId != *runArtist) {
+            if (runLength > 0) {
+                stats.albumsPerArtist[*runArtist] += runLength;
+            }
+            runArtist = &entry.artistId;
+            runLength = 0;
+        }
+        ++runLength;
+    }
+    if (runLength > 0) {
+        stats.albumsPerArtist[*runArtist] += runLength;
+    }
+    for (std::size_t year = 0; year < years.size(); ++year) {
+        if (years[year] > 0) {
+            stats.albumsPerYear.emplace_hint(stats.albumsPerYear.end(), static_cast<std::uint16_t>(year), years[year]);
+        }
+    }
+}
+
+namespace {
+
+// Builds the artist index from a data file. Slots whose CRC fails are logged and left
+// out of both the index and the free list so their bytes stay available for recovery.
+// Returns false if the file could not be read to its end.
+bool indexArtistRecords(std::istream& in, artistList& artists, indexSet& deleted, std::ostream* copyTo = nullptr) {
+    ALBUM_TRACE_SCOPE("indexArtistRecords");
+    long corrupt = 0;
+    artists.artList.reserve(recordCount(in, RecordKind::Artist) + DEFAULT_SIZE);
+    ArtistFieldLengths lengths;
+    bool complete = forEachRecord<ArtistFile>(in, RecordKind::Artist, [&](long pos, ArtistFile& artFile, RecordStatus status) {
+        if (status != RecordStatus::Ok) {
+            ++corrupt;
+            ALBUM_LOG_WARN("Skipping corrupt artist record at offset {}", pos);
+            return;
+        }
+        measureIndexFields(artFile, lengths);
+        std::string id(artFile.artistIds, lengths.artistId);
+        if (id != "-1") {
+            int currentId = stringToInt(id);
+            artists.artList.push_back({std::move(id), std::string(artFile.names, lengths.name), pos});
+            ++artists.live;
+            if (currentId > lastArtistID) {
+                lastArtistID = currentId;
+            }
+        } else {
+            deleted.indexes.push_back(pos);
+        }
+    }, copyTo);
+    if (corrupt > 0) {
+        cout << corrupt << " corrupt artist record(s) skipped. Run the scrub from the Backup & Restore menu for details." << endl;
+    }
+    if (!complete) {
+        ALBUM_LOG_WARN("Short read while indexing artist records; {} indexed", artists.artList.size());
+    }
+    return complete;
+}
+
+// Album counterpart of indexArtistRecords.
+bool indexAlbumRecords(std::istream& in, albumList& albums, indexSet& deleted, std::ostream* copyTo = nullptr) {
+    ALBUM_TRACE_SCOPE("indexAlbumRecords");
+    long corrupt = 0;
+    albums.albList.reserve(recordCount(in, RecordKind::Album) + DEFAULT_SIZE);
+    AlbumFieldLengths lengths;
+    bool complete = forEachRecord<AlbumFile>(in, RecordKind::Album, [&](long pos, AlbumFile& albFile, RecordStatus status) {
+        if (status != RecordStatus::Ok) {
+            ++corrupt;
+            ALBUM_LOG_WARN("Skipping corrupt album record at offset {}", pos);
+            return;
+        }
+        measureIndexFields(albFile, lengths);
+        std::string id(albFile.albumIds, lengths.albumId);
+        if (id != "-1") {
+            int currentId = stringToInt(id);
+            albums.albList.push_back(albumIndex{std::move(id), std::string(albFile.artistIdRefs, lengths.artistIdRef),
+                                                std::string(albFile.titles, lengths.title), pos, recordYear(albFile.datePublished),
+                                                recordFormatCodeOf(albFile.recordFormats, lengths.recordFormat)});
+            if (currentId > lastAlbumID) {
+                lastAlbumID = currentId;
+            }
+        } else {
+            deleted.indexes.push_back(pos);
+        }
+    }, copyTo);
+    if (corrupt > 0) {
+        cout << corrupt << " corrupt album record(s) skipped. Run the scrub from the Backup & Restore menu for details." << endl;
+    }
+    if (!complete) {
+        ALBUM_LOG_WARN("Short read while indexing album records; {} indexed", albums.albList.size());
+    }
+    return complete;
+}
+
+// Streams source into stagedPath through the given indexer. Legacy snapshots are
+// migrated in a scratch copy first because their slots have no CRC to carry over.
+template <typename Indexer>
+bool stageRecordFile(const std::string& source, const std::string& stagedPath, RecordKind kind, Indexer index) {
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    std::string input = source;
+    std::string scratch = stagedPath + ".legacy";
+    auto removeScratch = [&]() {
+        std::remove(scratch.c_str());
+        std::remove((scratch + ".v1").c_str());
+    };
+    if (isLegacyRecordFile(source)) {
+        if (!copyFile(source, scratch) || !migrateLegacyRecordFile(scratch, kind)) {
+            removeScratch();
+            return false;
+        }
+        input = scratch;
+    }
+
+    bool ok = false;
+    {
+        std::ifstream in(input, std::ios::binary);
+        std::ofstream out(stagedPath, std::ios::binary | std::ios::trunc);
+        unsigned char header[RECORD_HEADER_SIZE];
+        if (in && out && in.read(reinterpret_cast<char*>(header), sizeof(header)) &&
+            checkRecordHeader(header, kind, true).empty()) {
+            out.write(reinterpret_cast<const char*>(header), sizeof(header));
+            bool complete = index(in, out);
+            out.flush();
+            ok = complete && static_cast<bool>(out);
+        }
+    }
+    removeScratch();
+    if (!ok) {
+        std::remove(stagedPath.c_str());
+    }
+    return ok;
+}
+
+} // namespace
+
+bool stageRestoredRecords(const std::string& source, const std::string& stagedPath, artistList& artists, indexSet& deleted) {
+    ALBUM_TRACE_SCOPE("stageRestoredRecords");
+    return stageRecordFile(source, stagedPath, RecordKind::Artist, [&](std::istream& in, std::ostream& out) {
+        return indexArtistRecords(in, artists, deleted, &out);
+    });
+}
+
+bool stageRestoredRecords(const std::string& source, const std::string& stagedPath, albumList& albums, indexSet& deleted) {
+    ALBUM_TRACE_SCOPE("stageRestoredRecords");
+    return stageRecordFile(source, stagedPath, RecordKind::Album, [&](std::istream& in, std::ostream& out) {
+        return indexAlbumRecords(in, albums, deleted, &out);
+    });
+}
+
+namespace {
+
+// splitmix64. The <random> distributions differ between standard libraries, so the
+// generator draws everything from this to keep catalogs identical across platforms.
+class SyntheticRng {
+public:
+    explicit SyntheticRng(std::uint64_t seed) : state_(seed) {}
+
+    std::uint64_t next() {
+        std::uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    std::uint64_t below(std::uint64_t bound) {
+        return bound == 0 ? 0 : next() % bound;
+    }
+
+    double unit() {
+        return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+// Inverse-CDF sampler over ranks 0..n-1 with P(k) proportional to 1/(k+1)^exponent.
+class ZipfSampler {
+public:
+    ZipfSampler(std::int64_t n, double exponent) : cdf_(static_cast<std::size_t>(n)) {
+        double total = 0.0;
+        for (std::size_t k = 0; k < cdf_.size(); ++k) {
+            total += std::pow(static_cast<double>(k + 1), -exponent);
+            cdf_[k] = total;
+        }
+    }
+
+    std::int64_t sample(SyntheticRng& rng) const {
+        double target = rng.unit() * cdf_.back();
+        auto it = std::upper_bound(cdf_.begin(), cdf_.end(), target);
+        return std::min<std::int64_t>(it - cdf_.begin(), static_cast<std::int64_t>(cdf_.size()) - 1);
+    }
+
+private:
+    std::vector<double> cdf_;
+};
+
+const std::size_t GENERATOR_BLOCK_BYTES = 4 << 20;
+
+// Encodes slots (payload plus CRC) into one large block and writes it whenever it fills.
+class SlotBlockWriter {
+public:
+    SlotBlockWriter(std::ostream& out, RecordKind kind)
+        : out_(out), slotSize_(static_cast<std::size_t>(recordSizeFor(kind))),
+          block_(GENERATOR_BLOCK_BYTES / slotSize_ * slotSize_) {}
+
+    template <typename Record>
+    void add(const Record& record) {
+        unsigned char* slot = block_.data() + used_;
+        std::memcpy(slot, &record, sizeof(Record));
+        std::uint32_t crc = crc32c(slot, sizeof(Record));
+        std::memcpy(slot + sizeof(Record), &crc, sizeof(crc));
+        used_ += slotSize_;
+        if (used_ == block_.size()) {
+            flush();
+        }
+    }
+
+    bool flush() {
+        out_.write(reinterpret_cast<const char*>(block_.data()), static_cast<std::streamsize>(used_));
+        used_ = 0;
+        return static_cast<bool>(out_);
+    }
+
+private:
+    std::ostream& out_;
+    std::size_t slotSize_;
+    std::vector<unsigned char> block_;
+    std::size_t used_ = 0;
+};
+
+const char* const SYNTHETIC_FIRST_NAMES[] = {
+    "Abebe", "Almaz", "Dawit", "Hana", "Yonas", "Selam", "Kebede", "Liya",
+    "John", "Sarah", "Mike", "Emma", "David", "Grace", "Samuel", "Ruth",
+    "Lucas", "Maya", "Omar", "Nina", "Tariq", "Zoe", "Kenji", "Aiko",
+    "Mateo", "Sofia", "Ivan", "Elena", "Kwame", "Amara", "Leo", "Iris"};
+
+const char* const SYNTHETIC_LAST_NAMES[] = {
+    "Tesfaye", "Bekele", "Haile", "Girma", "Alemu", "Tadesse", "Wolde", "Mengistu",
+    "Smith", "Johnson", "Davis", "Wilson", "Brown", "Miller", "Moore", "Taylor",
+    "Garcia", "Rossi", "Novak", "Kim", "Sato", "Okafor", "Mensah", "Silva",
+    "Dubois", "Jensen", "Larsen", "Costa", "Haddad", "Nakamura", "Petrov", "Walker"};
+
+const char* const SYNTHETIC_TITLE_WORDS[] = {
+    "Love", "Night", "City", "River", "Gold", "Echoes", "Dreams", "Fire",
+    "Blue", "Road", "Home", "Light", "Shadow", "Rain", "Heart", "Stone",
+    "Summer", "Winter", "Songs", "Stories", "Live", "Sessions", "Greatest", "Hits",
+    "Midnight", "Morning", "Wild", "Silent", "Golden", "Electric", "Broken", "Sacred",
+    "Ocean", "Desert", "Mountain", "Garden", "Journey", "Return", "Voices", "Letters",
+    "Northern", "Southern", "Lost", "Found", "Distant", "Open", "Secret", "Simple",
+    "Rhythm", "Melody", "Harmony", "Groove", "Soul", "Blues", "Jazz", "Anthems",
+    "Collection", "Chapter", "Volume", "Edition", "Tapes", "Years", "Nights", "Days"};
+
+// Weighted towards lossy formats the way real libraries are.
+const char* const SYNTHETIC_FORMATS[] = {"mp3", "mp3", "mp3", "m4a", "m4a", "aac", "flac", "flac", "wav", "alac", "wma", "aiff"};
+
+// Appends text and numbers to a fixed-width record field, truncating the way the
+// application's strncpy copies do. The record is zeroed first, so no terminator is written.
+class FieldBuilder {
+public:
+    template <std::size_t N>
+    explicit FieldBuilder(char (&field)[N]) : field_(field), capacity_(N - 1) {}
+
+    FieldBuilder& text(const char* value) {
+        while (*value != '\0' && length_ < capacity_) {
+            field_[length_++] = *value++;
+        }
+        return *this;
+    }
+
+    FieldBuilder& number(unsigned long long value, int width = 0) {
+        char digits[24];
+        char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+        for (int pad = width - static_cast<int>(end - digits); pad > 0 && length_ < capacity_; --pad) {
+            field_[length_++] = '0';
+        }
+        *end = '\0';
+        return text(digits);
+    }
+
+private:
+    char* field_;
+    std::size_t capacity_;
+    std::size_t length_ = 0;
+};
+
+template <typename T, std::size_t N>
+const T& pickFrom(const T (&values)[N], SyntheticRng& rng) {
+    return values[rng.below(N)];
+}
+
+unsigned daysInMonth(unsigned month, unsigned year) {
+    static const unsigned DAYS[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : DAYS[month - 1];
+}
+
+// Writes one data file of `live` records with tombstones spread among them by selection
+// sampling, so the file holds exactly the requested number of each.
+template <typename Record, typename Fill>
+bool writeSyntheticRecordFile(const std::string& path, RecordKind kind, std::int64_t live, double tombstoneRatio,
+                              const Record& tombstone, SyntheticRng& rng, Fill fill, std::int64_t& slots) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        ALBUM_LOG_ERROR("Cannot create synthetic data file {}", path);
+        return false;
+    }
+    unsigned char header[RECORD_HEADER_SIZE];
+    encodeRecordHeader(header, kind);
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    slots = tombstoneRatio > 0.0 ? static_cast<std::int64_t>(std::llround(static_cast<double>(live) / (1.0 - tombstoneRatio))) : live;
+    SlotBlockWriter writer(out, kind);
+    Record record;
+    std::int64_t written = 0;
+    for (std::int64_t slot = 0; slot < slots; ++slot) {
+        if (static_cast<std::int64_t>(rng.below(static_cast<std::uint64_t>(slots - slot))) < live - written) {
+            fill(written++, record);
+            writer.add(record);
+        } else {
+            writer.add(tombstone);
+        }
+    }
+    return writer.flush() && out.flush();
+}
+
+} // namespace
+
+bool generateSyntheticCatalog(const std::string& artistPath, const std::string& albumPath,
+                              const CatalogGeneratorSettings& settings, CatalogGeneratorReport* report) {
+    ALBUM_TRACE_SCOPE("generateSyntheticCatalog");
+    if (settings.artists < 0 || settings.albums < 0 || (settings.albums > 0 && settings.artists == 0)
+        || settings.firstYear > settings.lastYear) {
+        ALBUM_LOG_ERROR("Invalid synthetic catalog settings: {} artists, {} albums, years {}-{}",
+                        settings.artists, settings.albums, settings.firstYear, settings.lastYear);
+        return false;
+    }
+    if (settings.artists > MAX_RECORD_ID_NUMBER - 999 || settings.albums > MAX_RECORD_ID_NUMBER - 1999) {
+        ALBUM_LOG_ERROR("Synthetic catalog of {} artists and {} albums exceeds the record ID space (up to ID number {})",
+                        settings.artists, settings.albums, MAX_RECORD_ID_NUMBER);
+        return false;
+    }
+    auto started = std::chrono::steady_clock::now();
+    double tombstoneRatio = std::min(std::max(settings.tombstoneRatio, 0.0), 0.99);
+    unsigned maxTitleWords = std::max(settings.maxTitleWords, 1u);
+    SyntheticRng rng(settings.seed);
+    CatalogGeneratorReport result;
+
+    ArtistFile blankArtist = {"-1", "", 'N', "", ""};
+    bool ok = writeSyntheticRecordFile<ArtistFile>(artistPath, RecordKind::Artist, settings.artists, tombstoneRatio, blankArtist, rng,
+        [&](std::int64_t n, ArtistFile& rec) {
+            std::memset(&rec, 0, sizeof(rec));
+            const char* first = pickFrom(SYNTHETIC_FIRST_NAMES, rng);
+            const char* last = pickFrom(SYNTHETIC_LAST_NAMES, rng);
+            unsigned long long id = 1000ULL + static_cast<unsigned long long>(n);
+            char code[16];
+            formatRecordIdNumber(static_cast<int>(id), code);
+            FieldBuilder(rec.artistIds).text("art").text(code);
+            FieldBuilder(rec.names).text(first).text(" ").text(last);
+            rec.genders = rng.below(2) == 0 ? 'M' : 'F';
+            FieldBuilder(rec.phones).text("09").number(rng.below(100000000), 8);
+            FieldBuilder(rec.emails).text(first).text(".").text(last).number(id).text("@example.com");
+            for (char* c = rec.emails; *c != '\0'; ++c) {
+                *c = static_cast<char>(std::tolower(static_cast<unsigned char>(*c)));
+            }
+        }, result.artistSlots);
+    result.artistTombstones = result.artistSlots - settings.artists;
+
+    if (ok) {
+        // Popular ranks are scattered over the artist IDs with a stride coprime to the count.
+        ZipfSampler zipf(std::max<std::int64_t>(settings.artists, 1), settings.zipfExponent);
+        std::int64_t stride = 1;
+        if (settings.artists > 1) {
+            do {
+                stride = 1 + static_cast<std::int64_t>(rng.below(static_cast<std::uint64_t>(settings.artists - 1)));
+            } while (std::gcd(stride, settings.artists) != 1);
+        }
+        unsigned yearSpan = static_cast<unsigned>(settings.lastYear - settings.firstYear) + 1;
+
+        AlbumFile blankAlbum = {"-1", "-1", "", "", "", ""};
+        ok = writeSyntheticRecordFile<AlbumFile>(albumPath, RecordKind::Album, settings.albums, tombstoneRatio, blankAlbum, rng,
+            [&](std::int64_t n, AlbumFile& rec) {
+                std::memset(&rec, 0, sizeof(rec));
+                unsigned long long artistId = 1000ULL + static_cast<unsigned long long>(zipf.sample(rng) * stride % settings.artists);
+                unsigned long long albumId = 2000ULL + static_cast<unsigned long long>(n);
+                char code[16];
+                formatRecordIdNumber(static_cast<int>(albumId), code);
+                FieldBuilder(rec.albumIds).text("alb").text(code);
+                formatRecordIdNumber(static_cast<int>(artistId), code);
+                FieldBuilder(rec.artistIdRefs).text("art").text(code);
+
+                // Word count is geometric: most titles are one to three words, a few run long.
+                FieldBuilder title(rec.titles);
+                title.text(pickFrom(SYNTHETIC_TITLE_WORDS, rng));
+                for (unsigned words = 1; words < maxTitleWords && rng.unit() < 0.55; ++words) {
+                    title.text(" ").text(pickFrom(SYNTHETIC_TITLE_WORDS, rng));
+                }
+
+                FieldBuilder(rec.recordFormats).text(pickFrom(SYNTHETIC_FORMATS, rng));
+                unsigned year = static_cast<unsigned>(settings.firstYear) + static_cast<unsigned>(rng.below(yearSpan));
+                unsigned month = 1 + static_cast<unsigned>(rng.below(12));
+                unsigned day = 1 + static_cast<unsigned>(rng.below(daysInMonth(month, year)));
+                FieldBuilder(rec.datePublished).number(day, 2).text("/").number(month, 2).text("/").number(year, 4);
+                FieldBuilder(rec.paths).text("music/art").number(artistId).text("/alb").number(albumId);
+            }, result.albumSlots);
+        result.albumTombstones = result.albumSlots - settings.albums;
+    }
+
+    RecordCache::instance().clear();
+    result.bytesWritten = static_cast<std::uint64_t>(2 * RECORD_HEADER_SIZE + result.artistSlots * ARTIST_RECORD_SIZE
+                                                     + result.albumSlots * ALBUM_RECORD_SIZE);
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    if (report != nullptr) {
+        *report = result;
+    }
+    if (ok) {
+        ALBUM_LOG_INFO("Generated synthetic catalog: {} artist slots, {} album slots, {} bytes in {} s",
+                       result.artistSlots, result.albumSlots, result.bytesWritten, result.seconds);
+    }
+    return ok;
+}
+
+std::string prepareSyntheticCatalogDirectory(const std::string& directory, std::int64_t records, std::ostream* progress) {
+    ALBUM_TRACE_SCOPE("prepareSyntheticCatalogDirectory");
+    std::filesystem::create_directories(directory + "/backups");
+    std::string artistPath = directory + "/Artist.bin";
+    std::string albumPath = directory + "/Album.bin";
+
+    CatalogGeneratorSettings settings;
+    settings.seed = 42;
+    settings.artists = records / 4;
+    settings.albums = records;
+    settings.tombstoneRatio = 0.02;
+    std::string stamp = "seed=42 artists=" + std::to_string(settings.artists) + " albums=" + std::to_string(records)
+                        + " tombstones=0.02 format=" + std::to_string(RECORD_FORMAT_VERSION)
+                        + " generator=" + std::to_string(SYNTHETIC_CATALOG_VERSION);
+
+    std::string stampPath = directory + "/catalog.stamp";
+    std::string existing;
+    std::getline(std::ifstream(stampPath), existing);
+    if (existing != stamp) {
+        if (progress != nullptr) {
+            *progress << "Generating " << records << "-album catalog in " << directory << std::endl;
+        }
+        std::filesystem::remove(stampPath);
+        if (!generateSyntheticCatalog(artistPath, albumPath, settings)) {
+            return std::string();
+        }
+        std::ofstream(stampPath) << stamp << "\n";
+    }
+
+    std::string configPath = directory + "/config.json";
+    std::ofstream(configPath, std::ios::trunc)
+        << "{\n"
+        << "  \"artistFile\": \"" << artistPath << "\",\n"
+        << "  \"albumFile\": \"" << albumPath << "\",\n"
+        << "  \"backupDirectory\": \"" << directory << "/backups\",\n"
+        << "  \"backupIndexFile\": \"" << directory << "/backups/index.csv\",\n"
+        << "  \"journalFile\": \"" << directory << "/backups/journal.bin\",\n"
+        << "  \"logLevel\": \"warn\"\n"
+        << "}\n";
+    return configPath;
+}
+
+namespace {
+
+void appendPerfJsonString(std::string& out, const std::string& text) {
+    out += '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+// Reads the perf run document. Only objects, arrays, strings and numbers occur in it;
+// unknown keys are skipped so later versions can add fields.
+class PerfJsonReader {
+public:
+    explicit PerfJsonReader(std::string text) : text_(std::move(text)) {}
+
+    bool readRun(PerfRun& run) {
+        return readObject([&](const std::string& key) {
+            if (key == "label") return readString(run.label);
+            if (key == "timestamp") return readString(run.timestamp);
+            if (key == "version") return readString(run.version);
+            if (key == "records") {
+                double value = 0.0;
+                bool ok = readNumber(value);
+                run.records = static_cast<std::int64_t>(value);
+                return ok;
+            }
+            if (key == "series") {
+                return readArray([&] {
+                    PerfSeries series;
+                    bool ok = readObject([&](const std::string& field) {
+                        if (field == "name") return readString(series.name);
+                        if (field == "samples_ns") {
+                            return readArray([&] {
+                                double value = 0.0;
+                                bool ok = readNumber(value);
+                                series.samplesNs.push_back(value);
+                                return ok;
+                            });
+                        }
+                        return skipValue();
+                    });
+                    run.series.push_back(std::move(series));
+                    return ok;
+                });
+            }
+            return skipValue();
+        });
+    }
+
+private:
+    void skipSpace() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+            ++pos_;
+        }
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    bool peek(char c) {
+        skipSpace();
+        return pos_ < text_.size() && text_[pos_] == c;
+    }
+
+    bool readString(std::string& out) {
+        if (!consume('"')) {
+            return false;
+        }
+        out.clear();
+        while (pos_ < text_.size() && text_[pos_] != '"') {
+            if (text_[pos_] == '\\' && pos_ + 1 < text_.size()) {
+                ++pos_;
+            }
+            out += text_[pos_++];
+        }
+        return consume('"');
+    }
+
+    bool readNumber(double& out) {
+        skipSpace();
+        const char* begin = text_.c_str() + pos_;
+        char* end = nullptr;
+        out = std::strtod(begin, &end);
+        if (end == begin) {
+            return false;
+        }
+        pos_ += static_cast<std::size_t>(end - begin);
+        return true;
+    }
+
+    template <typename Member>
+    bool readObject(Member member) {
+        if (!consume('{')) {
+            return false;
+        }
+        if (consume('}')) {
+            return true;
+        }
+        do {
+            std::string key;
+            if (!readString(key) || !consume(':') || !member(key)) {
+                return false;
+            }
+        } while (consume(','));
+        return consume('}');
+    }
+
+    template <typename Element>
+    bool readArray(Element element) {
+        if (!consume('[')) {
+            return false;
+        }
+        if (consume(']')) {
+            return true;
+        }
+        do {
+            if (!element()) {
+                return false;
+            }
+        } while (consume(','));
+        return consume(']');
+    }
+
+    bool skipValue() {
+        std::string ignored;
+        double number = 0.0;
+        if (peek('"')) return readString(ignored);
+        if (peek('{')) return readObject([&](const std::string&) { return skipValue(); });
+        if (peek('[')) return readArray([&] { return skipValue(); });
+        return readNumber(number);
+    }
+
+    std::string text_;
+    std::size_t pos_ = 0;
+};
+
+double perfMean(const std::vector<double>& samples) {
+    double sum = 0.0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    return samples.empty() ? 0.0 : sum / static_cast<double>(samples.size());
+}
+
+double perfVariance(const std::vector<double>& samples, double mean) {
+    if (samples.size() < 2) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (double sample : samples) {
+        sum += (sample - mean) * (sample - mean);
+    }
+    return sum / static_cast<double>(samples.size() - 1);
+}
+
+// Two-sided Student t quantile from the normal quantile by the Cornish-Fisher expansion;
+// within 1% of the exact value from three degrees of freedom up.
+double studentTQuantile(double confidence, double degreesOfFreedom) {
+    double z = confidence >= 0.99 ? 2.5758293 : confidence >= 0.95 ? 1.9599640 : 1.6448536;
+    double df = std::max(degreesOfFreedom, 1.0);
+    double z3 = z * z * z;
+    double z5 = z3 * z * z;
+    double z7 = z5 * z * z;
+    return z + (z3 + z) / (4.0 * df) + (5.0 * z5 + 16.0 * z3 + 3.0 * z) / (96.0 * df * df)
+           + (3.0 * z7 + 19.0 * z5 + 17.0 * z3 - 15.0 * z) / (384.0 * df * df * df);
+}
+
+} // namespace
+
+bool writePerfRun(std::ostream& out, const PerfRun& run) {
+    std::string json = "{\n  \"label\": ";
+    appendPerfJsonString(json, run.label);
+    json += ",\n  \"timestamp\": ";
+    appendPerfJsonString(json, run.timestamp);
+    json += ",\n  \"version\": ";
+    appendPerfJsonString(json, run.version);
+    json += ",\n  \"records\": " + std::to_string(run.records) + ",\n  \"series\": [";
+    char number[32];
+    for (std::size_t i = 0; i < run.series.size(); ++i) {
+        json += i == 0 ? "\n    {\"name\": " : ",\n    {\"name\": ";
+        appendPerfJsonString(json, run.series[i].name);
+        json += ", \"samples_ns\": [";
+        for (std::size_t s = 0; s < run.series[i].samplesNs.size(); ++s) {
+            std::snprintf(number, sizeof(number), s == 0 ? "%.1f" : ", %.1f", run.series[i].samplesNs[s]);
+            json += number;
+        }
+        json += "]}";
+    }
+    json += "\n  ]\n}\n";
+    out << json;
+    return static_cast<bool>(out);
+}
+
+bool readPerfRun(std::istream& in, PerfRun& run) {
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    run = PerfRun();
+    return PerfJsonReader(buffer.str()).readRun(run);
+}
+
+PerfComparison comparePerfSeries(const PerfSeries& baseline, const PerfSeries& candidate,
+                                 double thresholdPercent, double confidence) {
+    PerfComparison result;
+    result.name = candidate.name.empty() ? baseline.name : candidate.name;
+    result.baselineMeanNs = perfMean(baseline.samplesNs);
+    result.candidateMeanNs = perfMean(candidate.samplesNs);
+    std::size_t nb = baseline.samplesNs.size();
+    std::size_t nc = candidate.samplesNs.size();
+    if (nb < 2 || nc < 2 || result.baselineMeanNs <= 0.0) {
+        return result;
+    }
+
+    // Welch's t-test: no equal-variance assumption, degrees of freedom by Welch-Satterthwaite.
+    double vb = perfVariance(baseline.samplesNs, result.baselineMeanNs) / static_cast<double>(nb);
+    double vc = perfVariance(candidate.samplesNs, result.candidateMeanNs) / static_cast<double>(nc);
+    double standardError = std::sqrt(vb + vc);
+    double df = standardError > 0.0
+        ? (vb + vc) * (vb + vc) / (vb * vb / static_cast<double>(nb - 1) + vc * vc / static_cast<double>(nc - 1))
+        : static_cast<double>(nb + nc - 2);
+    double margin = studentTQuantile(confidence, df) * standardError;
+    double difference = result.candidateMeanNs - result.baselineMeanNs;
+
+    result.deltaPercent = 100.0 * difference / result.baselineMeanNs;
+    result.ciLowPercent = 100.0 * (difference - margin) / result.baselineMeanNs;
+    result.ciHighPercent = 100.0 * (difference + margin) / result.baselineMeanNs;
+    if (result.ciLowPercent > thresholdPercent) {
+        result.verdict = PerfVerdict::Regression;
+    } else if (result.ciHighPercent < -thresholdPercent) {
+        result.verdict = PerfVerdict::Improvement;
+    } else {
+        result.verdict = PerfVerdict::Unchanged;
+    }
+    return result;
+}
+
+std::vector<PerfComparison> comparePerfRuns(const PerfRun& baseline, const PerfRun& candidate,
+                                            double thresholdPercent, double confidence) {
+    static const PerfSeries EMPTY;
+    auto find = [](const PerfRun& run, const std::string& name) -> const PerfSeries& {
+        for (const auto& series : run.series) {
+            if (series.name == name) {
+                return series;
+            }
+        }
+        return EMPTY;
+    };
+    std::vector<PerfComparison> results;
+    for (const auto& series : candidate.series) {
+        results.push_back(comparePerfSeries(find(baseline, series.name), series, thresholdPercent, confidence));
+    }
+    for (const auto& series : baseline.series) {
+        if (find(candidate, series.name).name.empty()) {
+            results.push_back(comparePerfSeries(series, EMPTY, thresholdPercent, confidence));
+        }
+    }
+    return results;
+}
+
+const char* perfVerdictName(PerfVerdict verdict) {
+    switch (verdict) {
+        case PerfVerdict::Unchanged: return "ok";
+        case PerfVerdict::Regression: return "REGRESSION";
+        case PerfVerdict::Improvement: return "faster";
+        default: return "n/a";
+    }
+}
+
+namespace {
+
+const std::size_t RECORD_ID_PREFIX_LENGTH = 3;
+const std::size_t RECORD_ID_LENGTH = RECORD_ID_PREFIX_LENGTH + 4;
+const char RECORD_ID_DIGITS[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+const int RECORD_ID_BASE = 62;
+const int FIRST_EXTENDED_ID = 10000;
+// Extended IDs count up from "A000" so their first character is always a letter.
+const int EXTENDED_ID_OFFSET = 10 * RECORD_ID_BASE * RECORD_ID_BASE * RECORD_ID_BASE;
+
+int recordIdDigit(char c) {
+    const char* found = std::strchr(RECORD_ID_DIGITS, c);
+    return c != '\0' && found != nullptr ? static_cast<int>(found - RECORD_ID_DIGITS) : -1;
+}
+
+} // namespace
+
+std::size_t formatRecordIdNumber(int number, char* out) {
+    if (number < FIRST_EXTENDED_ID) {
+        char* end = std::to_chars(out, out + 12, number).ptr;
+        *end = '\0';
+        return static_cast<std::size_t>(end - out);
+    }
+    int value = number - FIRST_EXTENDED_ID + EXTENDED_ID_OFFSET;
+    for (int i = 3; i >= 0; --i) {
+        out[i] = RECORD_ID_DIGITS[value % RECORD_ID_BASE];
+        value /= RECORD_ID_BASE;
+    }
+    out[4] = '\0';
+    return 4;
+}
+
+std::string intToString(int last, const std::string& prefix) {
+    char code[16];
+    std::size_t length = formatRecordIdNumber(last, code);
+    return prefix + std::string(code, length);
+}
+
+int stringToInt(const std::string& arr) {
+    if (arr.size() == RECORD_ID_LENGTH && std::isalpha(static_cast<unsigned char>(arr[RECORD_ID_PREFIX_LENGTH]))) {
+        int value = 0;
+        for (std::size_t i = RECORD_ID_PREFIX_LENGTH; i < arr.size(); ++i) {
+            int digit = recordIdDigit(arr[i]);
+            if (digit < 0) {
+                return 0;
+            }
+            value = value * RECORD_ID_BASE + digit;
+        }
+        return value - EXTENDED_ID_OFFSET + FIRST_EXTENDED_ID;
+    }
+    // Assuming format is prefix + number, extract the number part
+    size_t start = 0;
+    while (start < arr.size() && !isdigit(arr[start])) start++;
+    if (start == arr.size()) return 0;
+    return std::stoi(arr.substr(start));
+}
+
+//3
+bool loading(fstream & ArtFile, fstream & AlbFile, artistList & artist, albumList & album, indexSet & delArtFile, indexSet & delAlbFile)
+{
+    int i = 0;
+ 	char load[26];
+ 	while(i < 25)
+ 	{
+ 		system("cls");
+ 		load[i++] = '#';
+ 		load[i] = '\0';
+        cout<<"\n\n\n\n\n\n\n\t\t\t\tLOADING: "<< load;
+ 		usleep(199900);
+ 	}
+    system("clear");
+    cout<<"\n";
+    system("cls");
+
+    // Check if files are empty and create sample data if needed
+    if (!loadArtist(ArtFile, artist, delArtFile) || artist.artList.empty()) {
+        // createSampleData(ArtFile, AlbFile, artist, album);
+        // Reload after creating sample data
+        // artist.artList.clear();
+        // album.albList.clear();
+        // loadArtist(ArtFile, artist, delArtFile);
+    }
+
+    if(!loadAlbum(AlbFile, album, delAlbFile))
+        return false;
+
+    return true;
+}
+
+//5
+bool loadArtist(std::fstream& ArtFile, artistList& artist, indexSet& delArtFile)
+{
+    ALBUM_TIME_SCOPE("load_artists");
+    try {
+        openRecordFile(ArtFile, artistFilePath, RecordKind::Artist);
+    } catch(const FileException& e) {
+        printError(1);
+        system("pause");
+        return false;
+    }
+    indexArtistRecords(ArtFile, artist, delArtFile);
+    sortArtist(artist);
+    publishIndexMetrics(artist);
+    return true;
+}
+
+//6
+bool loadAlbum(std::fstream& AlbFile, albumList& album, indexSet& delAlbFile)
+{
+    ALBUM_TIME_SCOPE("load_albums");
+    try {
+        openRecordFile(AlbFile, albumFilePath, RecordKind::Album);
+    } catch(const FileException& e) {
+        printError(2);
+        system("pause");
+        return false;
+    }
+    indexAlbumRecords(AlbFile, album, delAlbFile);
+    sortAlbum(album);
+    recountCatalogStatistics(album);
+    publishIndexMetrics(album);
+    return true;
+}
+
+//7
+void sortArtist(artistList& artist)
+{
+    ALBUM_TRACE_SCOPE("sortArtist");
+    std::sort(artist.artList.begin(), artist.artList.end(), [](const artistIndex& a, const artistIndex& b) {
+        return a.name < b.name;
+    });
+}
+
+//8
+void sortAlbum(albumList& album)
+{
+    ALBUM_TRACE_SCOPE("sortAlbum");
+    std::sort(album.albList.begin(), album.albList.end(), [](const albumIndex& a, const albumIndex& b) {
+        return a.artistId < b.artistId;
+    });
+}
+
+//9
+void mainH(fstream & ArtFile, fstream & AlbFile, artistList & artist, albumList & album, indexSet & result, indexSet & delArtArray, indexSet & delAlbArray)
+{
     bool exit=false;
     do
     {
-        int choice=MenuView::mainMenu();
-        switch (choice) {
-            case 1:
-                exit = artistManager(ArtFile,AlbFile,artist,album,result,delArtArray,delAlbArray);
-                break;
-            case 2:
-                exit = albumManager(ArtFile,AlbFile,artist,album,result,delArtArray,delAlbArray);
-                break;
-            case 3:
-                backupAndRestoreMenu(ArtFile, AlbFile, artist, album, delArtArray, delAlbArray);
-                exit = false;
-                break;
-            case 4:
-                displayStatistics(artist, album);
-                exit = false;
-                break;
-            case 5: {
-                std::string desc = getNextUndoDescription();
-                if (undoLastAction()) {
-                    cout << "Undid: " << (desc.empty() ? "last action" : desc) << endl;
+        publishIndexMetrics(artist);
+        publishIndexMetrics(album);
+        int choice=MenuView::mainMenu();
+        switch (choice) {
+            case 1:
+                exit = artistManager(ArtFile,AlbFile,artist,album,result,delArtArray,delAlbArray);
+                break;
+            case 2:
+                exit = albumManager(ArtFile,AlbFile,artist,album,result,delArtArray,delAlbArray);
+                break;
+            case 3:
+                backupAndRestoreMenu(ArtFile, AlbFile, artist, album, delArtArray, delAlbArray);
+                exit = false;
+                break;
+            case 4:
+                statisticsMenu(artist, album);
+                exit = false;
+                break;
+            case 5: {
+                std::string desc = getNextUndoDescription();
+                if (undoLastAction()) {
+                    cout << "Undid: " << (desc.empty() ? "last action" : desc) << endl;
+                } else {
+                    cout << "Nothing to undo." << endl;
+                }
+                system("pause");
+                exit = false;
+                break;
+            }
+            case 6: {
+                std::string desc = getNextRedoDescription();
+                if (redoLastAction()) {
+                    cout << "Redid: " << (desc.empty() ? "last action" : desc) << endl;
+                } else {
+                    cout << "Nothing to redo." << endl;
+                }
+                system("pause");
+                exit = false;
+                break;
+            }
+            case 7:
+                displayMetrics(artist, album);
+                exit = false;
+                break;
+            case 8:
+                displayStatistics(artist, album);
+                exit = true;
+                break;
+            default:
+                exit = false;
+                break;
+        }
+    }while (!exit);
+}
+
+//10
+int mainMenu()
+{
+    return MenuView::mainMenu();
+}
+
+void displayStatistics(const artistList& artist, const albumList& album)
+{
+    ALBUM_TRACE_SCOPE("displayStatistics");
+    system("cls");
+    cout << "\n\n\t\t\tSTATISTICS\n\n";
+    // Counts come from album.stats, which the commands keep current, so this is one pass
+    // over the artists rather than artists x albums.
+    const CatalogStatistics& stats = album.stats;
+    std::ostringstream perArtist;
+    std::size_t liveArtists = 0;
+    for (const auto& art : artist.artList) {
+        if (art.artistId == "-1") {
+            continue;
+        }
+        ++liveArtists;
+        perArtist << art.name << ": " << stats.albumsBy(art.artistId) << " albums\n";
+    }
+    cout << "Total Artists: " << liveArtists << endl;
+    cout << "Total Albums: " << stats.albums << endl;
+    cout << "\nAlbums per Artist:\n" << perArtist.str();
+    cout << "\nAlbums per Format:\n";
+    for (std::size_t code = 0; code < RECORD_FORMAT_CODES; ++code) {
+        if (stats.albumsPerFormat[code] > 0) {
+            cout << recordFormatLabel(static_cast<std::uint8_t>(code)) << ": " << stats.albumsPerFormat[code] << endl;
+        }
+    }
+    cout << "\nAlbums per Year:\n";
+    for (const auto& [year, count] : stats.albumsPerYear) {
+        if (year == 0) {
+            cout << "unknown";
+        } else {
+            cout << year;
+        }
+        cout << ": " << count << endl;
+    }
+    cout << endl << endl;
+    system("pause");
+}
+
+void displayMetrics(const artistList& artist, const albumList& album)
+{
+    system("cls");
+    cout << "\n\n\t\t\tPERFORMANCE METRICS\n\n";
+    MemoryProfiler::instance().sample();
+    MetricsRegistry::instance().dump(cout);
+    cout << "\n";
+    MemoryProfiler::instance().writeBreakdown(cout, artist, album);
+#if ALBUM_TRACING
+    const std::string& tracePath = AppConfig::instance().settings().traceFile;
+    if (writeChromeTraceFile(tracePath)) {
+        cout << "\nTrace (" << traceEventCount() << " spans) written to " << tracePath << endl;
+    }
+#endif
+    cout << endl << endl;
+    system("pause");
+}
+
+namespace {
+
+// Group of one album. The artist view points into the index, which outlives the query.
+struct AggregateKey {
+    std::string_view artist;
+    std::uint32_t yearFormat = 0; // year bucket << 8 | format code
+
+    bool operator==(const AggregateKey& other) const {
+        return yearFormat == other.yearFormat && artist == other.artist;
+    }
+    bool operator<(const AggregateKey& other) const {
+        return artist != other.artist ? artist < other.artist : yearFormat < other.yearFormat;
+    }
+};
+
+struct AggregateKeyHash {
+    std::size_t operator()(const AggregateKey& key) const {
+        return std::hash<std::string_view>()(key.artist) ^
+               static_cast<std::size_t>(key.yearFormat * 0x9E3779B97F4A7C15ull);
+    }
+};
+
+struct AggregateCell {
+    std::size_t count = 0;
+    std::uint16_t minYear = 0;
+    std::uint16_t maxYear = 0;
+
+    void add(std::size_t albums, std::uint16_t first, std::uint16_t last) {
+        count += albums;
+        if (first != 0 && (minYear == 0 || first < minYear)) {
+            minYear = first;
+        }
+        maxYear = std::max(maxYear, last);
+    }
+};
+
+using AggregateTable = std::unordered_map<AggregateKey, AggregateCell, AggregateKeyHash>;
+using AggregateGroup = AggregateTable::value_type;
+
+// Aggregates albList[first, last). Neighbouring entries usually share a key because the
+// index is sorted by artist, so the previous cell is reused without a hash lookup.
+void aggregateIndexRange(const albumList& album, std::size_t first, std::size_t last, const AggregateQuery& query,
+                         AggregateTable& table) {
+    const std::uint16_t bucket = std::max<std::uint16_t>(1, query.yearBucket);
+    AggregateKey previous;
+    AggregateCell* cell = nullptr;
+    for (std::size_t i = first; i < last; ++i) {
+        const albumIndex& entry = album.albList[i];
+        if (entry.albumId == "-1") {
+            continue;
+        }
+        AggregateKey key;
+        if (query.byArtist) {
+            key.artist = entry.artistId;
+        }
+        if (query.byYear) {
+            key.yearFormat = static_cast<std::uint32_t>(entry.year - entry.year % bucket) << 8;
+        }
+        if (query.byFormat) {
+            key.yearFormat |= entry.format;
+        }
+        if (cell == nullptr || !(key == previous)) {
+            cell = &table[key];
+            previous = key;
+        }
+        cell->add(1, entry.year, entry.year);
+    }
+}
+
+// Ranking order: more albums first, then by key.
+bool ranksAbove(const AggregateGroup* a, const AggregateGroup* b) {
+    if (a->second.count != b->second.count) {
+        return a->second.count > b->second.count;
+    }
+    return a->first < b->first;
+}
+
+} // namespace
+
+std::vector<AggregateRow> runAggregateQuery(const albumList& album, const AggregateQuery& query)
+{
+    ALBUM_TIME_SCOPE("aggregate_query");
+    const std::size_t entries = album.albList.size();
+    std::size_t workers = query.threads != 0 ? query.threads : std::max(1u, std::thread::hardware_concurrency());
+    workers = std::max<std::size_t>(1, std::min(workers, entries / AGGREGATE_PARALLEL_MIN_ENTRIES));
+    std::vector<AggregateTable> tables(workers);
+    if (workers == 1) {
+        aggregateIndexRange(album, 0, entries, query, tables[0]);
+    } else {
+        std::size_t perWorker = (entries + workers - 1) / workers;
+        std::vector<std::thread> pool;
+        pool.reserve(workers);
+        for (std::size_t w = 0; w < workers; ++w) {
+            std::size_t first = std::min(entries, w * perWorker);
+            std::size_t last = std::min(entries, first + perWorker);
+            pool.emplace_back(aggregateIndexRange, std::cref(album), first, last, std::cref(query), std::ref(tables[w]));
+        }
+        for (auto& t : pool) {
+            t.join();
+        }
+    }
+    AggregateTable& merged = tables[0];
+    for (std::size_t w = 1; w < workers; ++w) {
+        for (const auto& [key, cell] : tables[w]) {
+            merged[key].add(cell.count, cell.minYear, cell.maxYear);
+        }
+    }
+
+    // With K set, a heap of the K best groups seen so far keeps its worst group on top.
+    std::vector<const AggregateGroup*> ranked;
+    if (query.topK > 0) {
+        ranked.reserve(std::min(query.topK, merged.size()));
+        for (const auto& group : merged) {
+            if (ranked.size() < query.topK) {
+                ranked.push_back(&group);
+                std::push_heap(ranked.begin(), ranked.end(), ranksAbove);
+            } else if (ranksAbove(&group, ranked.front())) {
+                std::pop_heap(ranked.begin(), ranked.end(), ranksAbove);
+                ranked.back() = &group;
+                std::push_heap(ranked.begin(), ranked.end(), ranksAbove);
+            }
+        }
+        std::sort_heap(ranked.begin(), ranked.end(), ranksAbove);
+    } else {
+        ranked.reserve(merged.size());
+        for (const auto& group : merged) {
+            ranked.push_back(&group);
+        }
+        std::sort(ranked.begin(), ranked.end(), [](const AggregateGroup* a, const AggregateGroup* b) {
+            return a->first < b->first;
+        });
+    }
+
+    std::vector<AggregateRow> rows;
+    rows.reserve(ranked.size());
+    for (const AggregateGroup* group : ranked) {
+        AggregateRow row;
+        row.artistId = std::string(group->first.artist);
+        row.year = static_cast<std::uint16_t>(group->first.yearFormat >> 8);
+        row.format = static_cast<std::uint8_t>(group->first.yearFormat & 0xFF);
+        row.count = group->second.count;
+        row.minYear = group->second.minYear;
+        row.maxYear = group->second.maxYear;
+        rows.push_back(std::move(row));
+    }
+    return rows;
+}
+
+namespace {
+
+void displayTopArtists(const artistList& artist, const albumList& album)
+{
+    system("cls");
+    cout << "\n\n\t\t\tTOP ARTISTS BY ALBUM COUNT\n\n";
+    cout << "How many artists? (0 for 20): ";
+    long k = 0;
+    cin >> k;
+    cin.clear();
+    cin.ignore(INT_MAX, '\n');
+    AggregateQuery query;
+    query.byArtist = true;
+    query.topK = k > 0 ? static_cast<std::size_t>(k) : 20;
+    std::vector<AggregateRow> rows = runAggregateQuery(album, query);
+
+    std::unordered_map<std::string_view, const std::string*> names;
+    for (const auto& row : rows) {
+        names.emplace(row.artistId, nullptr);
+    }
+    for (const auto& art : artist.artList) {
+        auto it = names.find(art.artistId);
+        if (it != names.end()) {
+            it->second = &art.name;
+        }
+    }
+    cout << "\n" << left << setw(5) << "#" << setw(32) << "Artist" << setw(10) << "ID" << setw(8) << "Albums" << "Years\n";
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        const std::string* name = names[rows[i].artistId];
+        cout << left << setw(5) << i + 1 << setw(32) << (name != nullptr ? *name : std::string("(unknown)"))
+             << setw(10) << rows[i].artistId << setw(8) << rows[i].count;
+        if (rows[i].minYear != 0) {
+            cout << rows[i].minYear << "-" << rows[i].maxYear;
+        }
+        cout << "\n";
+    }
+    cout << right << endl << endl;
+    system("pause");
+}
+
+void displayAlbumsPerDecade(const albumList& album)
+{
+    system("cls");
+    cout << "\n\n\t\t\tALBUMS PER DECADE\n\n";
+    AggregateQuery query;
+    query.byYear = true;
+    query.yearBucket = 10;
+    for (const auto& row : runAggregateQuery(album, query)) {
+        if (row.year == 0) {
+            cout << "unknown";
+        } else {
+            cout << row.year << "s";
+        }
+        cout << ": " << row.count << " albums\n";
+    }
+    cout << endl << endl;
+    system("pause");
+}
+
+void displayFormatShareByYear(const albumList& album)
+{
+    system("cls");
+    cout << "\n\n\t\t\tFORMAT SHARE BY YEAR\n\n";
+    AggregateQuery query;
+    query.byYear = true;
+    query.byFormat = true;
+    std::vector<AggregateRow> rows = runAggregateQuery(album, query);
+    // Rows come ordered by year, then format, so each year is one contiguous run.
+    for (std::size_t first = 0; first < rows.size();) {
+        std::size_t last = first;
+        std::size_t total = 0;
+        while (last < rows.size() && rows[last].year == rows[first].year) {
+            total += rows[last++].count;
+        }
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(1);
+        if (rows[first].year == 0) {
+            line << "unknown";
+        } else {
+            line << rows[first].year;
+        }
+        line << " (" << total << "):";
+        for (std::size_t i = first; i < last; ++i) {
+            line << " " << recordFormatLabel(rows[i].format) << " " << 100.0 * static_cast<double>(rows[i].count) / static_cast<double>(total) << "%";
+        }
+        cout << line.str() << "\n";
+        first = last;
+    }
+    cout << endl << endl;
+    system("pause");
+}
+
+} // namespace
+
+void statisticsMenu(const artistList& artist, const albumList& album)
+{
+    bool exitMenu = false;
+    do {
+        int choice = MenuView::statisticsMenu();
+        switch (choice) {
+            case 1:
+                displayStatistics(artist, album);
+                break;
+            case 2:
+                displayTopArtists(artist, album);
+                break;
+            case 3:
+                displayAlbumsPerDecade(album);
+                break;
+            case 4:
+                displayFormatShareByYear(album);
+                break;
+            case 5:
+                exitMenu = true;
+                break;
+            default:
+                break;
+        }
+    } while (!exitMenu);
+}
+
+namespace {
+
+const std::size_t EXPORT_WRITE_BUFFER_BYTES = 4 << 20;
+
+// Where one formatted row lives; length 0 marks an index entry that produced no row.
+struct CsvRowRef {
+    std::uint64_t offset = 0;
+    std::uint32_t length = 0;
+    std::uint32_t worker = 0;
+};
+
+// Appends one RFC 4180 field, quoted only when it holds a comma, quote or line break.
+// Lengths come from measureRecord, so the stored bytes are exported unchanged.
+void appendCsvField(std::string& out, const char* text, std::size_t length) {
+    const char* end = text + length;
+    const char* special = std::find_if(text, end, [](char c) {
+        return c == ',' || c == '"' || c == '\r' || c == '\n';
+    });
+    if (special == end) {
+        out.append(text, length);
+        return;
+    }
+    out += '"';
+    for (const char* c = text; c != end; ++c) {
+        if (*c == '"') {
+            out += '"';
+        }
+        out += *c;
+    }
+    out += '"';
+}
+
+template <typename Record>
+void appendCsvRow(std::string& out, const Record& record) {
+    forEachRecordField(record, [&](std::size_t field, const RecordFieldSpec&, const char* text, std::size_t length) {
+        if (field != 0) {
+            out += ',';
+        }
+        appendCsvField(out, text, length);
+    });
+    out += "\r\n";
+}
+
+// The header row is the field names of the record's table.
+std::string csvHeader(const RecordFieldSpec* fields, std::size_t count) {
+    std::string header;
+    for (std::size_t field = 0; field < count; ++field) {
+        if (field != 0) {
+            header += ',';
+        }
+        header += fields[field].name;
+    }
+    return header + "\r\n";
+}
+
+const char* recordIdOf(const ArtistFile& record) {
+    return record.artistIds;
+}
+
+const char* recordIdOf(const AlbumFile& record) {
+    return record.albumIds;
+}
+
+struct CsvWorkerResult {
+    std::string rows;
+    std::size_t deleted = 0;
+    std::size_t unreadable = 0;
+};
+
+// Reads slots at ascending positions through a block buffer, so a run of nearby slots costs
+// one seek and one large read.
+template <typename Record>
+class SequentialSlotReader {
+public:
+    explicit SequentialSlotReader(const std::string& dataPath)
+        : in(dataPath, std::ios::binary), block(static_cast<std::size_t>(BLOCK_BYTES)) {
+        in.seekg(0, std::ios::end);
+        fileSize = in ? static_cast<long>(in.tellg()) : 0;
+    }
+
+    RecordStatus read(long pos, Record& record) {
+        if (pos < blockStart || pos + SLOT_SIZE > blockEnd) {
+            blockStart = pos;
+            blockEnd = std::min(fileSize, pos + BLOCK_BYTES);
+            in.clear();
+            in.seekg(blockStart, std::ios::beg);
+            if (blockEnd <= blockStart || !in.read(reinterpret_cast<char*>(block.data()), blockEnd - blockStart)) {
+                blockEnd = blockStart;
+            }
+        }
+        if (pos + SLOT_SIZE > blockEnd) {
+            return RecordStatus::Missing;
+        }
+        const unsigned char* slot = block.data() + (pos - blockStart);
+        std::uint32_t storedCrc = 0;
+        std::memcpy(&storedCrc, slot + sizeof(Record), sizeof(storedCrc));
+        if (storedCrc != crc32c(slot, sizeof(Record))) {
+            return RecordStatus::Corrupt;
+        }
+        std::memcpy(&record, slot, sizeof(Record));
+        return RecordStatus::Ok;
+    }
+
+private:
+    static constexpr long SLOT_SIZE = static_cast<long>(sizeof(Record) + RECORD_CRC_SIZE);
+    static constexpr long BLOCK_BYTES = static_cast<long>(SCRUB_BLOCK_RECORDS) * SLOT_SIZE;
+
+    std::ifstream in;
+    long fileSize = 0;
+    std::vector<unsigned char> block;
+    long blockStart = 0;
+    long blockEnd = 0;
+};
+
+// Formats the rows for order[first, last), which is sorted by file position, reading the
+// covered slots sequentially in blocks. Each window row owns one refs element, so workers
+// never write the same element.
+template <typename Record>
+void formatCsvRange(const std::string& dataPath, const std::vector<std::pair<long, std::uint32_t>>& order,
+                    std::size_t first, std::size_t last, std::uint32_t worker,
+                    std::vector<CsvRowRef>& refs, CsvWorkerResult& result) {
+    SequentialSlotReader<Record> reader(dataPath);
+    result.rows.clear();
+    result.rows.reserve((last - first) * sizeof(Record) / 2);
+    Record record;
+    for (std::size_t i = first; i < last; ++i) {
+        if (reader.read(order[i].first, record) != RecordStatus::Ok) {
+            ++result.unreadable;
+            continue;
+        }
+        if (std::strncmp(recordIdOf(record), "-1", 8) == 0) {
+            ++result.deleted;
+            continue;
+        }
+        std::size_t offset = result.rows.size();
+        appendCsvRow(result.rows, record);
+        refs[order[i].second] = {offset, static_cast<std::uint32_t>(result.rows.size() - offset), worker};
+    }
+}
+
+template <typename Record, typename IndexVector>
+bool writeRecordsCsv(const IndexVector& entries, const std::string& dataPath, const std::string& filename,
+                     const std::string& header, CsvExportReport* report, unsigned threads, std::size_t windowRows) {
+    auto start = std::chrono::steady_clock::now();
+    CsvExportReport counts;
+    // Check the source before truncating the destination, so a missing data file never
+    // wipes an earlier export.
+    if (!std::filesystem::exists(dataPath) || !std::ifstream(dataPath, std::ios::binary)) {
+        return false;
+    }
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+
+    windowRows = std::max<std::size_t>(1, std::min(windowRows, entries.size()));
+    std::size_t maxWorkers = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::pair<long, std::uint32_t>> order;
+    order.reserve(windowRows);
+    std::vector<CsvRowRef> refs;
+    std::vector<CsvWorkerResult> results(maxWorkers);
+
+    std::string buffer;
+    buffer.reserve(EXPORT_WRITE_BUFFER_BYTES);
+    buffer += header;
+    // Each window of index entries is read in file order, formatted in parallel and then
+    // written in index order, so only one window of rows is ever held in memory.
+    for (std::size_t windowStart = 0; windowStart < entries.size(); windowStart += windowRows) {
+        std::size_t windowEnd = std::min(entries.size(), windowStart + windowRows);
+        order.clear();
+        for (std::size_t i = windowStart; i < windowEnd; ++i) {
+            if (entries[i].pos >= RECORD_HEADER_SIZE) {
+                order.emplace_back(entries[i].pos, static_cast<std::uint32_t>(i - windowStart));
+            } else {
+                ++counts.unreadable;
+            }
+        }
+        std::sort(order.begin(), order.end());
+        refs.assign(windowEnd - windowStart, CsvRowRef{});
+
+        std::size_t workers = std::max<std::size_t>(1, std::min(maxWorkers, (order.size() + SCRUB_BLOCK_RECORDS - 1) / SCRUB_BLOCK_RECORDS));
+        std::size_t perWorker = (order.size() + workers - 1) / workers;
+        {
+            std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+            if (workers == 1) {
+                formatCsvRange<Record>(dataPath, order, 0, order.size(), 0, refs, results[0]);
+            } else {
+                std::vector<std::thread> pool;
+                pool.reserve(workers);
+                for (std::size_t w = 0; w < workers; ++w) {
+                    std::size_t first = std::min(order.size(), w * perWorker);
+                    std::size_t last = std::min(order.size(), first + perWorker);
+                    pool.emplace_back(formatCsvRange<Record>, std::cref(dataPath), std::cref(order), first, last,
+                                      static_cast<std::uint32_t>(w), std::ref(refs), std::ref(results[w]));
+                }
+                for (auto& t : pool) {
+                    t.join();
+                }
+            }
+        }
+
+        for (const CsvRowRef& ref : refs) {
+            if (ref.length == 0) {
+                continue;
+            }
+            if (buffer.size() + ref.length > EXPORT_WRITE_BUFFER_BYTES) {
+                out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                counts.bytesWritten += buffer.size();
+                buffer.clear();
+            }
+            buffer.append(results[ref.worker].rows, ref.offset, ref.length);
+            ++counts.rows;
+        }
+    }
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    counts.bytesWritten += buffer.size();
+    out.close();
+
+    for (const auto& result : results) {
+        counts.deleted += result.deleted;
+        counts.unreadable += result.unreadable;
+    }
+    counts.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (report != nullptr) {
+        *report = counts;
+    }
+    return static_cast<bool>(out);
+}
+
+} // namespace
+
+bool writeArtistsCsv(const artistList& artist, const std::string& dataPath, const std::string& filename,
+                     CsvExportReport* report, unsigned threads, std::size_t windowRows) {
+    ALBUM_TIME_SCOPE("export_artists_csv");
+    return writeRecordsCsv<ArtistFile>(artist.artList, dataPath, filename, csvHeader(ARTIST_FIELDS, ARTIST_FIELD_COUNT), report, threads, windowRows);
+}
+
+bool writeAlbumsCsv(const albumList& album, const std::string& dataPath, const std::string& filename,
+                    CsvExportReport* report, unsigned threads, std::size_t windowRows) {
+    ALBUM_TIME_SCOPE("export_albums_csv");
+    return writeRecordsCsv<AlbumFile>(album.albList, dataPath, filename, csvHeader(ALBUM_FIELDS, ALBUM_FIELD_COUNT), report, threads, windowRows);
+}
+
+void exportArtistsToCSV(const artistList& artist, const std::string& filename) {
+    ALBUM_TRACE_SCOPE("exportArtistsToCSV");
+    cout << "Exporting artists..." << endl;
+    CsvExportReport report;
+    if (!writeArtistsCsv(artist, artistFilePath, filename, &report)) {
+        std::cout << "Error exporting artists to " << filename << "." << std::endl;
+        ALBUM_LOG_ERROR("Artist CSV export to {} failed", filename);
+        return;
+    }
+    ALBUM_LOG_INFO("Exported {} artists to {} in {} s ({} unreadable)", report.rows, filename, report.seconds, report.unreadable);
+    std::cout << report.rows << " artists exported to " << filename << std::endl;
+}
+
+void exportAlbumsToCSV(const albumList& album, const std::string& filename) {
+    ALBUM_TRACE_SCOPE("exportAlbumsToCSV");
+    cout << "Exporting albums..." << endl;
+    CsvExportReport report;
+    if (!writeAlbumsCsv(album, albumFilePath, filename, &report)) {
+        std::cout << "Error exporting albums to " << filename << "." << std::endl;
+        ALBUM_LOG_ERROR("Album CSV export to {} failed", filename);
+        return;
+    }
+    ALBUM_LOG_INFO("Exported {} albums to {} in {} s ({} unreadable)", report.rows, filename, report.seconds, report.unreadable);
+    std::cout << report.rows << " albums exported to " << filename << std::endl;
+}
+
+namespace {
+
+// Index entry positions that point at a slot, in file order; entries without one are counted.
+template <typename IndexVector>
+std::vector<long> sortedSlotPositions(const IndexVector& entries, std::size_t& unreadable) {
+    std::vector<long> positions;
+    positions.reserve(entries.size());
+    for (const auto& entry : entries) {
+        if (entry.pos >= RECORD_HEADER_SIZE) {
+            positions.push_back(entry.pos);
+        }
+    }
+    unreadable = entries.size() - positions.size();
+    std::sort(positions.begin(), positions.end());
+    return positions;
+}
+
+// Appends the body of a JSON string. Runs of characters that need no escaping are copied
+// with one append each.
+void appendJsonEscaped(std::string& out, const char* text, std::size_t length) {
+    static const char hexDigits[] = "0123456789abcdef";
+    const char* run = text;
+    const char* end = text + length;
+    for (const char* c = text; c != end; ++c) {
+        unsigned char u = static_cast<unsigned char>(*c);
+        if (u >= 0x20 && u != '"' && u != '\\') {
+            continue;
+        }
+        out.append(run, static_cast<std::size_t>(c - run));
+        switch (u) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default: {
+                const char escaped[] = {'\\', 'u', '0', '0', hexDigits[u >> 4], hexDigits[u & 0xF]};
+                out.append(escaped, sizeof(escaped));
+                break;
+            }
+        }
+        run = c + 1;
+    }
+    out.append(run, static_cast<std::size_t>(end - run));
+}
+
+// Keys are the field names, so the objects read back through the import's column matching.
+template <typename Record>
+void appendJsonRow(std::string& out, const Record& record) {
+    forEachRecordField(record, [&](std::size_t field, const RecordFieldSpec& spec, const char* text, std::size_t length) {
+        out += field == 0 ? "{\"" : ",\"";
+        out += spec.name;
+        out += "\":\"";
+        appendJsonEscaped(out, text, length);
+        out += '"';
+    });
+    out += "}\n";
+}
+
+template <typename Record, typename IndexVector>
+bool writeRecordsJsonl(const IndexVector& entries, const std::string& dataPath, const std::string& filename,
+                       CsvExportReport* report) {
+    auto start = std::chrono::steady_clock::now();
+    CsvExportReport counts;
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out || !std::filesystem::exists(dataPath)) {
+        return false;
+    }
+    std::vector<long> positions = sortedSlotPositions(entries, counts.unreadable);
+
+    // A row escapes to at most six bytes per payload byte plus its keys, so the buffer is
+    // flushed before it would have to grow.
+    std::string buffer;
+    buffer.reserve(EXPORT_WRITE_BUFFER_BYTES + 8 * sizeof(Record));
+    auto flush = [&]() {
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        counts.bytesWritten += buffer.size();
+        buffer.clear();
+    };
+    {
+        std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+        SequentialSlotReader<Record> reader(dataPath);
+        Record record;
+        for (long pos : positions) {
+            if (reader.read(pos, record) != RecordStatus::Ok) {
+                ++counts.unreadable;
+                continue;
+            }
+            if (std::strncmp(recordIdOf(record), "-1", 8) == 0) {
+                ++counts.deleted;
+                continue;
+            }
+            appendJsonRow(buffer, record);
+            ++counts.rows;
+            if (buffer.size() >= EXPORT_WRITE_BUFFER_BYTES) {
+                flush();
+            }
+        }
+    }
+    flush();
+    out.close();
+
+    counts.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (report != nullptr) {
+        *report = counts;
+    }
+    return static_cast<bool>(out);
+}
+
+} // namespace
+
+bool writeArtistsJsonl(const artistList& artist, const std::string& dataPath, const std::string& filename,
+                       CsvExportReport* report) {
+    ALBUM_TIME_SCOPE("export_artists_jsonl");
+    return writeRecordsJsonl<ArtistFile>(artist.artList, dataPath, filename, report);
+}
+
+bool writeAlbumsJsonl(const albumList& album, const std::string& dataPath, const std::string& filename,
+                      CsvExportReport* report) {
+    ALBUM_TIME_SCOPE("export_albums_jsonl");
+    return writeRecordsJsonl<AlbumFile>(album.albList, dataPath, filename, report);
+}
+
+void exportArtistsToJsonl(const artistList& artist, const std::string& filename) {
+    ALBUM_TRACE_SCOPE("exportArtistsToJsonl");
+    cout << "Exporting artists..." << endl;
+    CsvExportReport report;
+    if (!writeArtistsJsonl(artist, artistFilePath, filename, &report)) {
+        std::cout << "Error exporting artists to " << filename << "." << std::endl;
+        ALBUM_LOG_ERROR("Artist JSONL export to {} failed", filename);
+        return;
+    }
+    ALBUM_LOG_INFO("Exported {} artists to {} in {} s ({} unreadable)", report.rows, filename, report.seconds, report.unreadable);
+    std::cout << report.rows << " artists exported to " << filename << std::endl;
+}
+
+void exportAlbumsToJsonl(const albumList& album, const std::string& filename) {
+    ALBUM_TRACE_SCOPE("exportAlbumsToJsonl");
+    cout << "Exporting albums..." << endl;
+    CsvExportReport report;
+    if (!writeAlbumsJsonl(album, albumFilePath, filename, &report)) {
+        std::cout << "Error exporting albums to " << filename << "." << std::endl;
+        ALBUM_LOG_ERROR("Album JSONL export to {} failed", filename);
+        return;
+    }
+    ALBUM_LOG_INFO("Exported {} albums to {} in {} s ({} unreadable)", report.rows, filename, report.seconds, report.unreadable);
+    std::cout << report.rows << " albums exported to " << filename << std::endl;
+}
+
+namespace {
+
+const char* const COLUMNAR_UNKNOWN_LABEL = "unknown";
+
+const std::size_t COLUMNAR_ALIGNMENT = 8;
+const std::size_t COLUMNAR_HEADER_BYTES = 24;
+const std::size_t COLUMNAR_NAME_BYTES = 16;
+const std::size_t COLUMNAR_PREFIX_BYTES = 7;
+const std::size_t COLUMNAR_DESCRIPTOR_BYTES = COLUMNAR_NAME_BYTES + 1 + COLUMNAR_PREFIX_BYTES;
+const std::size_t COLUMNAR_TRAILER_BYTES = 32;
+const std::size_t COLUMNAR_COLUMNS = static_cast<std::size_t>(AlbumColumn::Count);
+
+struct ColumnarColumnSpec {
+    const char* name;
+    ColumnType type;
+    const char* prefix;
+};
+
+const ColumnarColumnSpec ALBUM_COLUMN_SPECS[COLUMNAR_COLUMNS] = {
+    {"album_id", ColumnType::UInt32, "alb"},
+    {"artist_id", ColumnType::UInt32, "art"},
+    {"date_published", ColumnType::UInt32, ""},
+    {"record_format", ColumnType::Enum8, ""},
+    {"title", ColumnType::Dictionary, ""},
+    {"path", ColumnType::Dictionary, ""},
+};
+
+template <typename T>
+void appendPod(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+void appendPodArray(std::string& out, const std::vector<T>& values) {
+    out.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+void padColumnar(std::string& out) {
+    out.append((COLUMNAR_ALIGNMENT - out.size() % COLUMNAR_ALIGNMENT) % COLUMNAR_ALIGNMENT, '\0');
+}
+
+// "alb1234" -> 1234. Anything that would not print back identically (other prefix, no
+// digits, leading zero, overflow) maps to 0, which generated IDs never use.
+std::uint32_t columnarIdNumber(const char* text, std::size_t length, const char* prefix) {
+    std::size_t prefixLength = std::strlen(prefix);
+    if (length <= prefixLength || std::strncmp(text, prefix, prefixLength) != 0 || text[prefixLength] == '0') {
+        return 0;
+    }
+    if (std::isalpha(static_cast<unsigned char>(text[prefixLength]))) {
+        // Extended IDs are kept only if they re-encode to the same text.
+        std::string id(text, length);
+        int number = stringToInt(id);
+        return number > 0 && intToString(number, prefix) == id ? static_cast<std::uint32_t>(number) : 0;
+    }
+    std::uint32_t value = 0;
+    auto parsed = std::from_chars(text + prefixLength, text + length, value);
+    return parsed.ec == std::errc() && parsed.ptr == text + length ? value : 0;
+}
+
+// Per-row-group string dictionary: codes in first-seen order, entries stored back to back.
+// Lookups go through an open-addressing table of codes that compares against the stored
+// bytes, so adding a row never allocates once the group's buffers have grown.
+class ColumnarDictionary {
+public:
+    void add(const char* text, std::size_t length) {
+        std::string_view value(text, length);
+        if (offsets.size() * 2 > slots.size()) {
+            rehash(std::max<std::size_t>(64, slots.size() * 2));
+        }
+        std::size_t mask = slots.size() - 1;
+        for (std::size_t i = std::hash<std::string_view>()(value) & mask;; i = (i + 1) & mask) {
+            std::uint32_t code = slots[i];
+            if (code == EMPTY_SLOT) {
+                code = static_cast<std::uint32_t>(offsets.size() - 1);
+                slots[i] = code;
+                bytes.append(value.data(), value.size());
+                offsets.push_back(static_cast<std::uint32_t>(bytes.size()));
+                rowCodes.push_back(code);
+                return;
+            }
+            if (entry(code) == value) {
+                rowCodes.push_back(code);
+                return;
+            }
+        }
+    }
+
+    // Layout: entry count, count + 1 offsets, one code per row, then the entry bytes.
+    void encode(std::string& out) const {
+        appendPod(out, static_cast<std::uint32_t>(offsets.size() - 1));
+        appendPodArray(out, offsets);
+        appendPodArray(out, rowCodes);
+        out += bytes;
+    }
+
+    void clear() {
+        std::fill(slots.begin(), slots.end(), EMPTY_SLOT);
+        bytes.clear();
+        offsets.assign(1, 0);
+        rowCodes.clear();
+    }
+
+private:
+    static constexpr std::uint32_t EMPTY_SLOT = UINT32_MAX;
+
+    std::string_view entry(std::uint32_t code) const {
+        return std::string_view(bytes).substr(offsets[code], offsets[code + 1] - offsets[code]);
+    }
+
+    void rehash(std::size_t size) {
+        slots.assign(size, EMPTY_SLOT);
+        for (std::uint32_t code = 0; code + 1 < offsets.size(); ++code) {
+            std::size_t i = std::hash<std::string_view>()(entry(code)) & (size - 1);
+            while (slots[i] != EMPTY_SLOT) {
+                i = (i + 1) & (size - 1);
+            }
+            slots[i] = code;
+        }
+    }
+
+    std::vector<std::uint32_t> slots;
+    std::string bytes;
+    std::vector<std::uint32_t> offsets{0};
+    std::vector<std::uint32_t> rowCodes;
+};
+
+struct ColumnarAlbumGroup {
+    std::vector<std::uint32_t> albumIds;
+    std::vector<std::uint32_t> artistIds;
+    std::vector<std::uint32_t> dates;
+    std::vector<std::uint8_t> formats;
+    ColumnarDictionary titles;
+    ColumnarDictionary paths;
+
+    std::size_t size() const { return albumIds.size(); }
+
+    void add(const AlbumFile& record) {
+        AlbumFieldLengths lengths;
+        measureRecord(record, lengths);
+        albumIds.push_back(columnarIdNumber(record.albumIds, lengths.albumId, "alb"));
+        artistIds.push_back(columnarIdNumber(record.artistIdRefs, lengths.artistIdRef, "art"));
+        dates.push_back(columnarDate(record.datePublished));
+        formats.push_back(recordFormatCodeOf(record.recordFormats, lengths.recordFormat));
+        titles.add(record.titles, lengths.title);
+        paths.add(record.paths, lengths.path);
+    }
+
+    void clear() {
+        albumIds.clear();
+        artistIds.clear();
+        dates.clear();
+        formats.clear();
+        titles.clear();
+        paths.clear();
+    }
+};
+
+std::string encodeColumnarHeader() {
+    std::string out(COLUMNAR_FILE_MAGIC, sizeof(COLUMNAR_FILE_MAGIC));
+    appendPod(out, COLUMNAR_FORMAT_VERSION);
+    appendPod(out, static_cast<std::uint32_t>(COLUMNAR_COLUMNS));
+    appendPod(out, static_cast<std::uint32_t>(ALBUM_RECORD_FORMAT_COUNT + 1));
+    appendPod(out, std::uint32_t{0});
+    for (const ColumnarColumnSpec& spec : ALBUM_COLUMN_SPECS) {
+        char descriptor[COLUMNAR_DESCRIPTOR_BYTES] = {};
+        std::strncpy(descriptor, spec.name, COLUMNAR_NAME_BYTES - 1);
+        descriptor[COLUMNAR_NAME_BYTES] = static_cast<char>(spec.type);
+        std::strncpy(descriptor + COLUMNAR_NAME_BYTES + 1, spec.prefix, COLUMNAR_PREFIX_BYTES - 1);
+        out.append(descriptor, sizeof(descriptor));
+    }
+    for (std::size_t i = 0; i <= ALBUM_RECORD_FORMAT_COUNT; ++i) {
+        const char* label = i == 0 ? COLUMNAR_UNKNOWN_LABEL : ALBUM_RECORD_FORMATS[i - 1];
+        out += static_cast<char>(std::strlen(label));
+        out += label;
+    }
+    padColumnar(out);
+    return out;
+}
+
+// Row group layout: row count, column count, padded byte length of each chunk, then the chunks.
+std::string encodeColumnarGroup(const ColumnarAlbumGroup& group) {
+    std::string chunks[COLUMNAR_COLUMNS];
+    appendPodArray(chunks[static_cast<std::size_t>(AlbumColumn::AlbumId)], group.albumIds);
+    appendPodArray(chunks[static_cast<std::size_t>(AlbumColumn::ArtistId)], group.artistIds);
+    appendPodArray(chunks[static_cast<std::size_t>(AlbumColumn::DatePublished)], group.dates);
+    appendPodArray(chunks[static_cast<std::size_t>(AlbumColumn::RecordFormat)], group.formats);
+    group.titles.encode(chunks[static_cast<std::size_t>(AlbumColumn::Title)]);
+    group.paths.encode(chunks[static_cast<std::size_t>(AlbumColumn::Path)]);
+
+    std::string out;
+    appendPod(out, static_cast<std::uint32_t>(group.size()));
+    appendPod(out, static_cast<std::uint32_t>(COLUMNAR_COLUMNS));
+    std::size_t total = 0;
+    for (std::string& chunk : chunks) {
+        padColumnar(chunk);
+        appendPod(out, static_cast<std::uint64_t>(chunk.size()));
+        total += chunk.size();
+    }
+    out.reserve(out.size() + total);
+    for (const std::string& chunk : chunks) {
+        out += chunk;
+    }
+    return out;
+}
+
+template <typename T>
+bool readPodArray(const std::string& chunk, std::size_t& offset, std::size_t count, std::vector<T>& values) {
+    if (count > (chunk.size() - offset) / sizeof(T)) {
+        return false;
+    }
+    values.resize(count);
+    std::memcpy(values.data(), chunk.data() + offset, count * sizeof(T));
+    offset += count * sizeof(T);
+    return true;
+}
+
+template <typename T>
+bool decodeColumnarValues(const std::string& chunk, std::size_t rows, std::vector<T>& values) {
+    std::size_t offset = 0;
+    return readPodArray(chunk, offset, rows, values);
+}
+
+bool decodeColumnarDictionary(const std::string& chunk, std::size_t rows, std::vector<std::uint32_t>& codes,
+                              std::vector<std::string>& entries) {
+    std::size_t offset = 0;
+    std::vector<std::uint32_t> count;
+    std::vector<std::uint32_t> offsets;
+    if (!readPodArray(chunk, offset, 1, count) || !readPodArray(chunk, offset, std::size_t{count[0]} + 1, offsets) ||
+        !readPodArray(chunk, offset, rows, codes)) {
+        return false;
+    }
+    entries.clear();
+    entries.reserve(count[0]);
+    for (std::uint32_t i = 0; i < count[0]; ++i) {
+        if (offsets[i] > offsets[i + 1] || offsets[i + 1] > chunk.size() - offset) {
+            return false;
+        }
+        entries.emplace_back(chunk, offset + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+    return std::all_of(codes.begin(), codes.end(), [&entries](std::uint32_t code) { return code < entries.size(); });
+}
+
+} // namespace
+
+bool writeAlbumsColumnar(const albumList& album, const std::string& dataPath, const std::string& filename,
+                         ColumnarExportReport* report, std::size_t rowGroupRows) {
+    ALBUM_TIME_SCOPE("export_albums_columnar");
+    auto start = std::chrono::steady_clock::now();
+    ColumnarExportReport counts;
+    if (rowGroupRows == 0) {
+        rowGroupRows = COLUMNAR_ROW_GROUP_ROWS;
+    }
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out || !std::filesystem::exists(dataPath)) {
+        return false;
+    }
+
+    std::vector<long> positions = sortedSlotPositions(album.albList, counts.unreadable);
+
+    std::string header = encodeColumnarHeader();
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    counts.bytesWritten = header.size();
+    std::vector<std::uint64_t> groupOffsets;
+    ColumnarAlbumGroup group;
+    auto flushGroup = [&] {
+        std::string encoded = encodeColumnarGroup(group);
+        groupOffsets.push_back(counts.bytesWritten);
+        out.write(encoded.data(), static_cast<std::streamsize>(encoded.size()));
+        counts.bytesWritten += encoded.size();
+        counts.rows += group.size();
+        group.clear();
+    };
+    {
+        std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+        SequentialSlotReader<AlbumFile> reader(dataPath);
+        AlbumFile record;
+        for (long pos : positions) {
+            if (reader.read(pos, record) != RecordStatus::Ok) {
+                ++counts.unreadable;
+                continue;
+            }
+            if (std::strncmp(record.albumIds, "-1", sizeof(record.albumIds)) == 0) {
+                ++counts.deleted;
+                continue;
+            }
+            group.add(record);
+            if (group.size() == rowGroupRows) {
+                flushGroup();
+            }
+        }
+    }
+    if (group.size() > 0) {
+        flushGroup();
+    }
+
+    // Footer: group offsets, then a fixed trailer of total rows, group count, footer offset, magic.
+    std::string footer;
+    std::uint64_t footerOffset = counts.bytesWritten;
+    appendPodArray(footer, groupOffsets);
+    appendPod(footer, static_cast<std::uint64_t>(counts.rows));
+    appendPod(footer, static_cast<std::uint64_t>(groupOffsets.size()));
+    appendPod(footer, footerOffset);
+    footer.append(COLUMNAR_FILE_MAGIC, sizeof(COLUMNAR_FILE_MAGIC));
+    out.write(footer.data(), static_cast<std::streamsize>(footer.size()));
+    counts.bytesWritten += footer.size();
+    out.close();
+
+    counts.rowGroups = groupOffsets.size();
+    counts.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (report != nullptr) {
+        *report = counts;
+    }
+    return static_cast<bool>(out);
+}
+
+void exportAlbumsColumnar(const albumList& album, const std::string& filename) {
+    ALBUM_TRACE_SCOPE("exportAlbumsColumnar");
+    cout << "Exporting albums..." << endl;
+    ColumnarExportReport report;
+    if (!writeAlbumsColumnar(album, albumFilePath, filename, &report)) {
+        std::cout << "Error exporting albums to " << filename << "." << std::endl;
+        ALBUM_LOG_ERROR("Columnar album export to {} failed", filename);
+        return;
+    }
+    ALBUM_LOG_INFO("Exported {} albums in {} row groups to {} in {} s ({} unreadable)", report.rows, report.rowGroups,
+                   filename, report.seconds, report.unreadable);
+    std::cout << report.rows << " albums exported to " << filename << std::endl;
+}
+
+bool exportColumnarDataFile(const std::string& filename) {
+    ALBUM_TRACE_SCOPE("exportColumnarDataFile");
+    std::fstream AlbFile;
+    albumList album;
+    indexSet deletedAlbums;
+    if (!loadAlbum(AlbFile, album, deletedAlbums)) {
+        return false;
+    }
+    ColumnarExportReport report;
+    if (!writeAlbumsColumnar(album, albumFilePath, filename, &report)) {
+        std::cout << "Error exporting albums to " << filename << "." << std::endl;
+        return false;
+    }
+    std::cout << report.rows << " albums in " << report.rowGroups << " row groups written to " << filename << " ("
+              << report.bytesWritten << " bytes, " << report.unreadable << " unreadable, " << report.seconds << " s)"
+              << std::endl;
+    return true;
+}
+
+bool ColumnarAlbumReader::open(const std::string& path) {
+    in.close();
+    in.clear();
+    rows = 0;
+    fileSize = 0;
+    groupOffsets.clear();
+    labels.clear();
+    in.open(path, std::ios::binary);
+    std::string header(COLUMNAR_HEADER_BYTES + COLUMNAR_COLUMNS * COLUMNAR_DESCRIPTOR_BYTES, '\0');
+    if (!in || !in.read(&header[0], static_cast<std::streamsize>(header.size())) ||
+        header.compare(0, sizeof(COLUMNAR_FILE_MAGIC), COLUMNAR_FILE_MAGIC, sizeof(COLUMNAR_FILE_MAGIC)) != 0) {
+        return false;
+    }
+    std::uint32_t fields[4];
+    std::memcpy(fields, header.data() + sizeof(COLUMNAR_FILE_MAGIC), sizeof(fields));
+    if (fields[0] != COLUMNAR_FORMAT_VERSION || fields[1] != COLUMNAR_COLUMNS) {
+        return false;
+    }
+    for (std::size_t c = 0; c < COLUMNAR_COLUMNS; ++c) {
+        const char* descriptor = header.data() + COLUMNAR_HEADER_BYTES + c * COLUMNAR_DESCRIPTOR_BYTES;
+        if (std::strncmp(descriptor, ALBUM_COLUMN_SPECS[c].name, COLUMNAR_NAME_BYTES) != 0 ||
+            descriptor[COLUMNAR_NAME_BYTES] != static_cast<char>(ALBUM_COLUMN_SPECS[c].type)) {
+            return false;
+        }
+    }
+    for (std::uint32_t i = 0; i < fields[2]; ++i) {
+        char length = 0;
+        std::string label;
+        if (!in.get(length)) {
+            return false;
+        }
+        label.resize(static_cast<unsigned char>(length));
+        if (!in.read(&label[0], static_cast<std::streamsize>(label.size()))) {
+            return false;
+        }
+        labels.push_back(std::move(label));
+    }
+
+    char trailer[COLUMNAR_TRAILER_BYTES];
+    in.seekg(0, std::ios::end);
+    fileSize = static_cast<std::uint64_t>(in.tellg());
+    if (fileSize < COLUMNAR_TRAILER_BYTES) {
+        return false;
+    }
+    in.seekg(static_cast<std::streamoff>(fileSize - COLUMNAR_TRAILER_BYTES), std::ios::beg);
+    if (!in.read(trailer, sizeof(trailer)) ||
+        std::memcmp(trailer + 24, COLUMNAR_FILE_MAGIC, sizeof(COLUMNAR_FILE_MAGIC)) != 0) {
+        return false;
+    }
+    std::uint64_t groupCount = 0;
+    std::uint64_t footerOffset = 0;
+    std::memcpy(&rows, trailer, sizeof(rows));
+    std::memcpy(&groupCount, trailer + 8, sizeof(groupCount));
+    std::memcpy(&footerOffset, trailer + 16, sizeof(footerOffset));
+    if (footerOffset > fileSize || groupCount != (fileSize - COLUMNAR_TRAILER_BYTES - footerOffset) / sizeof(std::uint64_t)) {
+        rows = 0;
+        return false;
+    }
+    groupOffsets.resize(static_cast<std::size_t>(groupCount));
+    in.seekg(static_cast<std::streamoff>(footerOffset), std::ios::beg);
+    if (!in.read(reinterpret_cast<char*>(groupOffsets.data()), static_cast<std::streamsize>(groupCount * sizeof(std::uint64_t))) ||
+        !std::all_of(groupOffsets.begin(), groupOffsets.end(), [footerOffset](std::uint64_t offset) { return offset < footerOffset; })) {
+        rows = 0;
+        groupOffsets.clear();
+        return false;
+    }
+    return true;
+}
+
+bool ColumnarAlbumReader::readRowGroup(std::size_t group, ColumnarAlbumBatch& batch) {
+    if (group >= groupOffsets.size()) {
+        return false;
+    }
+    std::uint32_t counts[2];
+    std::uint64_t chunkBytes[COLUMNAR_COLUMNS];
+    in.clear();
+    in.seekg(static_cast<std::streamoff>(groupOffsets[group]), std::ios::beg);
+    if (!in.read(reinterpret_cast<char*>(counts), sizeof(counts)) || counts[1] != COLUMNAR_COLUMNS ||
+        !in.read(reinterpret_cast<char*>(chunkBytes), sizeof(chunkBytes))) {
+        return false;
+    }
+    std::size_t rowsInGroup = counts[0];
+    std::string chunks[COLUMNAR_COLUMNS];
+    for (std::size_t c = 0; c < COLUMNAR_COLUMNS; ++c) {
+        if (chunkBytes[c] > fileSize - groupOffsets[group]) {
+            return false;
+        }
+        chunks[c].resize(static_cast<std::size_t>(chunkBytes[c]));
+        if (!in.read(&chunks[c][0], static_cast<std::streamsize>(chunks[c].size()))) {
+            return false;
+        }
+    }
+    auto chunk = [&chunks](AlbumColumn column) -> const std::string& { return chunks[static_cast<std::size_t>(column)]; };
+    bool ok = decodeColumnarValues(chunk(AlbumColumn::AlbumId), rowsInGroup, batch.albumIds) &&
+              decodeColumnarValues(chunk(AlbumColumn::ArtistId), rowsInGroup, batch.artistIds) &&
+              decodeColumnarValues(chunk(AlbumColumn::DatePublished), rowsInGroup, batch.dates) &&
+              decodeColumnarValues(chunk(AlbumColumn::RecordFormat), rowsInGroup, batch.formats) &&
+              decodeColumnarDictionary(chunk(AlbumColumn::Title), rowsInGroup, batch.titleCodes, batch.titles) &&
+              decodeColumnarDictionary(chunk(AlbumColumn::Path), rowsInGroup, batch.pathCodes, batch.paths);
+    return ok && std::all_of(batch.formats.begin(), batch.formats.end(),
+                             [this](std::uint8_t code) { return code < labels.size(); });
+}
+
+Album ColumnarAlbumReader::album(const ColumnarAlbumBatch& batch, std::size_t row) const {
+    auto id = [](const char* prefix, std::uint32_t number) {
+        return number == 0 ? std::string() : intToString(static_cast<int>(number), prefix);
+    };
+    std::string date;
+    if (std::uint32_t packed = batch.dates[row]) {
+        char text[16];
+        std::snprintf(text, sizeof(text), "%02u/%02u/%04u", packed % 100, packed / 100 % 100, packed / 10000);
+        date = text;
+    }
+    return Album(id("alb", batch.albumIds[row]), id("art", batch.artistIds[row]), batch.titles[batch.titleCodes[row]],
+                 labels[batch.formats[row]], date, batch.paths[batch.pathCodes[row]]);
+}
+
+namespace {
+
+const std::size_t IMPORT_READ_BUFFER_BYTES = 1 << 20;
+const std::size_t IMPORT_ISSUES_SHOWN = 20;
+
+// Buffered byte source shared by the CSV and JSON readers; returns -1 at end of input.
+class ImportByteSource {
+public:
+    explicit ImportByteSource(std::istream& in) : in(in), buffer(IMPORT_READ_BUFFER_BYTES) {}
+
+    int peek() {
+        return (pos < end || refill()) ? static_cast<unsigned char>(buffer[pos]) : -1;
+    }
+
+    int get() {
+        return (pos < end || refill()) ? static_cast<unsigned char>(buffer[pos++]) : -1;
+    }
+
+private:
+    bool refill() {
+        if (!in) {
+            return false;
+        }
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        end = static_cast<std::size_t>(in.gcount());
+        pos = 0;
+        return end > 0;
+    }
+
+    std::istream& in;
+    std::vector<char> buffer;
+    std::size_t pos = 0;
+    std::size_t end = 0;
+};
+
+// "Record_Format", "recordFormat" and "RecordFormat" all become "recordformat".
+std::string normalizeImportKey(const std::string& key) {
+    std::string normalized;
+    normalized.reserve(key.size());
+    for (char c : key) {
+        if (c != '_' && c != ' ') {
+            normalized.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+        }
+    }
+    return normalized;
+}
+
+// Import columns are the normalized field names from first on; an album's own ID is
+// assigned on import, so album rows start at the artist reference.
+std::vector<std::string> importColumns(const RecordFieldSpec* fields, std::size_t first, std::size_t count) {
+    std::vector<std::string> columns;
+    for (std::size_t field = first; field < count; ++field) {
+        columns.push_back(normalizeImportKey(fields[field].name));
+    }
+    return columns;
+}
+
+const std::vector<std::string> ARTIST_IMPORT_COLUMNS = importColumns(ARTIST_FIELDS, ARTIST_FIELD_ID, ARTIST_FIELD_COUNT);
+const std::vector<std::string> ALBUM_IMPORT_COLUMNS = importColumns(ALBUM_FIELDS, ALBUM_FIELD_ARTIST_ID, ALBUM_FIELD_COUNT);
+
+int importColumnIndex(const std::vector<std::string>& columns, const std::string& key) {
+    std::string normalized = normalizeImportKey(key);
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        if (columns[i] == normalized) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+// Yields one row at a time as values aligned with a fixed list of column names.
+class ImportRowReader {
+public:
+    virtual ~ImportRowReader() = default;
+
+    // Returns false at the end of input or on a syntax error, which error() then describes.
+    // A row that parsed but cannot be used sets rowError instead.
+    virtual bool next(std::vector<std::string>& values, std::string& rowError) = 0;
+
+    const std::string& error() const {
+        return failure;
+    }
+
+protected:
+    std::string failure;
+};
+
+class CsvRowReader : public ImportRowReader {
+public:
+    CsvRowReader(std::istream& in, const std::vector<std::string>& columns) : source(in), mapping(columns.size(), -1) {
+        std::vector<std::string> header;
+        if (!readRecord(header)) {
+            failure = "missing CSV header row";
+            return;
+        }
+        if (header[0].compare(0, 3, "\xEF\xBB\xBF") == 0) {
+            header[0].erase(0, 3);
+        }
+        for (std::size_t i = 0; i < header.size(); ++i) {
+            int column = importColumnIndex(columns, header[i]);
+            if (column >= 0) {
+                mapping[static_cast<std::size_t>(column)] = static_cast<int>(i);
+            }
+        }
+        headerFields = header.size();
+        ready = true;
+    }
+
+    bool next(std::vector<std::string>& values, std::string& rowError) override {
+        if (!ready) {
+            return false;
+        }
+        do {
+            if (!readRecord(fields)) {
+                return false;
+            }
+        } while (fields.size() == 1 && fields[0].empty());
+        rowError.clear();
+        if (fields.size() != headerFields) {
+            rowError = "expected " + std::to_string(headerFields) + " fields, found " + std::to_string(fields.size());
+        }
+        values.resize(mapping.size());
+        for (std::size_t i = 0; i < mapping.size(); ++i) {
+            std::size_t field = static_cast<std::size_t>(mapping[i]);
+            if (mapping[i] >= 0 && field < fields.size()) {
+                values[i].swap(fields[field]);
+            } else {
+                values[i].clear();
+            }
+        }
+        return true;
+    }
+
+private:
+    // Reads one RFC 4180 record. Quoted fields may hold commas, doubled quotes and line
+    // breaks; lines may end in CRLF or LF. A quote inside an unquoted field is kept as is.
+    bool readRecord(std::vector<std::string>& out) {
+        int c = source.get();
+        if (c < 0) {
+            return false;
+        }
+        out.clear();
+        std::string field;
+        bool quoted = false;
+        bool fieldStart = true;
+        while (true) {
+            if (quoted) {
+                if (c < 0) {
+                    break;
+                }
+                if (c == '"') {
+                    if (source.peek() == '"') {
+                        source.get();
+                        field.push_back('"');
+                    } else {
+                        quoted = false;
+                    }
                 } else {
-                    cout << "Nothing to undo." << endl;
+                    field.push_back(static_cast<char>(c));
+                }
+            } else if (c == '"' && fieldStart) {
+                quoted = true;
+                fieldStart = false;
+            } else if (c == ',') {
+                out.push_back(std::move(field));
+                field.clear();
+                fieldStart = true;
+            } else if (c == '\n' || c == '\r' || c < 0) {
+                if (c == '\r' && source.peek() == '\n') {
+                    source.get();
                 }
-                system("pause");
-                exit = false;
                 break;
+            } else {
+                field.push_back(static_cast<char>(c));
+                fieldStart = false;
             }
-            case 6: {
-                std::string desc = getNextRedoDescription();
-                if (redoLastAction()) {
-                    cout << "Redid: " << (desc.empty() ? "last action" : desc) << endl;
+            c = source.get();
+        }
+        out.push_back(std::move(field));
+        return true;
+    }
+
+    ImportByteSource source;
+    std::vector<int> mapping;
+    std::vector<std::string> fields;
+    std::size_t headerFields = 0;
+    bool ready = false;
+};
+
+// Streams a JSON array of flat objects, or JSON Lines (one object per line) when the input
+// starts with '{'. Strings, numbers, booleans and null are accepted as field values (null
+// reads as empty); unknown keys may hold anything. Memory does not grow with the input.
+class JsonRowReader : public ImportRowReader {
+public:
+    JsonRowReader(std::istream& in, const std::vector<std::string>& columns) : source(in), columns(columns) {
+        skipSpace();
+        int c = source.peek();
+        if (c == '[') {
+            source.get();
+        } else if (c == '{' || c < 0) {
+            lines = true;
+        } else {
+            failure = "JSON input must be an array of objects or one object per line";
+            return;
+        }
+        ready = true;
+    }
+
+    bool next(std::vector<std::string>& values, std::string& rowError) override {
+        if (!ready) {
+            return false;
+        }
+        skipSpace();
+        if (lines ? source.peek() < 0 : source.peek() == ']') {
+            source.get();
+            ready = false;
+            return false;
+        }
+        if (element > 0 && !lines) {
+            if (source.get() != ',') {
+                return fail("expected ',' between array elements");
+            }
+            skipSpace();
+        }
+        ++element;
+        if (source.get() != '{') {
+            return fail(lines ? "each line must hold an object" : "array elements must be objects");
+        }
+        values.assign(columns.size(), std::string());
+        rowError.clear();
+        skipSpace();
+        if (source.peek() == '}') {
+            source.get();
+            return true;
+        }
+        std::string key;
+        std::string value;
+        while (true) {
+            skipSpace();
+            if (source.get() != '"' || !readString(key)) {
+                return fail("expected a quoted key");
+            }
+            skipSpace();
+            if (source.get() != ':') {
+                return fail("expected ':' after a key");
+            }
+            skipSpace();
+            bool scalar = false;
+            if (!readValue(value, scalar)) {
+                return fail("malformed value");
+            }
+            int column = importColumnIndex(columns, key);
+            if (column >= 0) {
+                if (scalar) {
+                    values[static_cast<std::size_t>(column)].swap(value);
                 } else {
-                    cout << "Nothing to redo." << endl;
+                    rowError = "field \"" + key + "\" must be a string or number";
                 }
-                system("pause");
-                exit = false;
-                break;
             }
-            case 7:
-                displayStatistics(artist, album);
-                exit = true;
-                break;
-            default:
-                exit = false;
+            skipSpace();
+            int c = source.get();
+            if (c == '}') {
+                return true;
+            }
+            if (c != ',') {
+                return fail("expected ',' or '}' in an object");
+            }
+        }
+    }
+
+private:
+    bool fail(const char* message) {
+        failure = std::string(message) + (lines ? " (record " : " (element ") + std::to_string(element) + ")";
+        ready = false;
+        return false;
+    }
+
+    void skipSpace() {
+        int c = source.peek();
+        while (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            source.get();
+            c = source.peek();
+        }
+    }
+
+    static void appendUtf8(std::string& out, std::uint32_t code) {
+        if (code < 0x80) {
+            out.push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+    }
+
+    bool readHex4(std::uint32_t& code) {
+        code = 0;
+        for (int i = 0; i < 4; ++i) {
+            int c = source.get();
+            int digit = std::isxdigit(c) ? (std::isdigit(c) ? c - '0' : (std::tolower(c) - 'a' + 10)) : -1;
+            if (digit < 0) {
+                return false;
+            }
+            code = (code << 4) | static_cast<std::uint32_t>(digit);
+        }
+        return true;
+    }
+
+    // Reads the rest of a string whose opening quote was consumed.
+    bool readString(std::string& out) {
+        out.clear();
+        while (true) {
+            int c = source.get();
+            if (c < 0) {
+                return false;
+            }
+            if (c == '"') {
+                return true;
+            }
+            if (c != '\\') {
+                out.push_back(static_cast<char>(c));
+                continue;
+            }
+            c = source.get();
+            switch (c) {
+                case '"': case '\\': case '/': out.push_back(static_cast<char>(c)); break;
+                case 'b': out.push_back('\b'); break;
+                case 'f': out.push_back('\f'); break;
+                case 'n': out.push_back('\n'); break;
+                case 'r': out.push_back('\r'); break;
+                case 't': out.push_back('\t'); break;
+                case 'u': {
+                    std::uint32_t code = 0;
+                    if (!readHex4(code)) {
+                        return false;
+                    }
+                    if (code >= 0xD800 && code < 0xDC00 && source.peek() == '\\') {
+                        std::uint32_t low = 0;
+                        source.get();
+                        if (source.get() != 'u' || !readHex4(low)) {
+                            return false;
+                        }
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, code);
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+    }
+
+    // Skips an object or array whose opening bracket was consumed.
+    bool skipNested() {
+        int depth = 1;
+        std::string ignored;
+        while (depth > 0) {
+            int c = source.get();
+            if (c < 0) {
+                return false;
+            }
+            if (c == '"' && !readString(ignored)) {
+                return false;
+            }
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                --depth;
+            }
+        }
+        return true;
+    }
+
+    bool readValue(std::string& out, bool& scalar) {
+        out.clear();
+        int c = source.get();
+        if (c == '"') {
+            scalar = true;
+            return readString(out);
+        }
+        if (c == '{' || c == '[') {
+            scalar = false;
+            return skipNested();
+        }
+        scalar = true;
+        while (c >= 0 && c != ',' && c != '}' && c != ']' && c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            out.push_back(static_cast<char>(c));
+            if (source.peek() == ',' || source.peek() == '}' || source.peek() == ']') {
                 break;
+            }
+            c = source.get();
         }
-    }while (!exit);
+        if (out.empty()) {
+            return false;
+        }
+        if (out == "null") {
+            out.clear();
+        }
+        return true;
+    }
+
+    ImportByteSource source;
+    const std::vector<std::string>& columns;
+    std::size_t element = 0;
+    bool lines = false;
+    bool ready = false;
+};
+
+std::unique_ptr<ImportRowReader> makeImportReader(std::istream& in, ImportFormat format,
+                                                  const std::vector<std::string>& columns) {
+    if (format == ImportFormat::Json) {
+        return std::make_unique<JsonRowReader>(in, columns);
+    }
+    return std::make_unique<CsvRowReader>(in, columns);
+}
+
+// Applies the artist prompts' sanitising, validation and formatting to one row.
+void buildImportedArtist(const std::vector<std::string>& values, ArtistFile& record) {
+    std::string name = sanitizeStringInput(values[ARTIST_FIELD_NAME], 49);
+    validateName(name);
+    name = formatName(name);
+    std::string genderText = sanitizeStringInput(values[ARTIST_FIELD_GENDER], 8);
+    char gender = genderText.size() == 1 ? static_cast<char>(std::toupper(static_cast<unsigned char>(genderText[0]))) : '\0';
+    validateGender(gender);
+    std::string phone = sanitizeDigitInput(values[ARTIST_FIELD_PHONE], 14);
+    validatePhone(phone);
+    std::string email = sanitizeStringInput(values[ARTIST_FIELD_EMAIL], 49);
+    validateEmail(email);
+    email = formatEmail(email);
+
+    record = ArtistFile{};
+    setRecordField(record, ARTIST_FIELD_NAME, name);
+    setRecordField(record, ARTIST_FIELD_GENDER, &gender, 1);
+    setRecordField(record, ARTIST_FIELD_PHONE, phone);
+    setRecordField(record, ARTIST_FIELD_EMAIL, email);
 }
 
-//10
-int mainMenu()
-{
-    return MenuView::mainMenu();
+// Album counterpart of buildImportedArtist; artistId is the already resolved reference.
+// Album rows start at ALBUM_FIELD_ARTIST_ID (see ALBUM_IMPORT_COLUMNS).
+void buildImportedAlbum(const std::vector<std::string>& values, const std::string& artistId, AlbumFile& record) {
+    auto value = [&](AlbumField field) -> const std::string& { return values[field - ALBUM_FIELD_ARTIST_ID]; };
+    std::string title = sanitizeStringInput(value(ALBUM_FIELD_TITLE), 79);
+    validateAlbumTitle(title);
+    title = formatAlbumTitle(title);
+    std::string recordFormat = sanitizeStringInput(value(ALBUM_FIELD_RECORD_FORMAT), 11);
+    validateAlbumFormat(recordFormat);
+    recordFormat = formatAlbumFormat(recordFormat);
+    std::string dateText = sanitizeStringInput(value(ALBUM_FIELD_DATE_PUBLISHED), 16);
+    unsigned int day = 0, month = 0, year = 0;
+    char extra = '\0';
+    if (std::sscanf(dateText.c_str(), "%u/%u/%u%c", &day, &month, &year, &extra) != 3) {
+        throw ValidationException("Invalid date format. Please enter in DD/MM/YYYY format.");
+    }
+    validateAlbumDate(day, month, year);
+    std::string date = formatAlbumDate(day, month, year);
+    std::string path = sanitizeStringInput(value(ALBUM_FIELD_PATH), 99);
+    validateAlbumPath(path);
+    path = formatAlbumPath(path);
+
+    record = AlbumFile{};
+    setRecordField(record, ALBUM_FIELD_ARTIST_ID, artistId);
+    setRecordField(record, ALBUM_FIELD_TITLE, title);
+    setRecordField(record, ALBUM_FIELD_RECORD_FORMAT, recordFormat);
+    setRecordField(record, ALBUM_FIELD_DATE_PUBLISHED, date);
+    setRecordField(record, ALBUM_FIELD_PATH, path);
+}
+
+void setRecordId(ArtistFile& record, const std::string& id) {
+    setRecordField(record, ARTIST_FIELD_ID, id);
+}
+
+void setRecordId(AlbumFile& record, const std::string& id) {
+    setRecordField(record, ALBUM_FIELD_ID, id);
+}
+
+// Appends a block of records after the last complete slot in one write and journals it.
+template <typename Record>
+bool appendRecordBlock(std::fstream& io, const std::vector<Record>& records, long& firstPos) {
+    const std::size_t slotSize = sizeof(Record) + RECORD_CRC_SIZE;
+    std::vector<unsigned char> slots(records.size() * slotSize);
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        unsigned char* slot = slots.data() + i * slotSize;
+        std::memcpy(slot, &records[i], sizeof(Record));
+        std::uint32_t crc = crc32c(slot, sizeof(Record));
+        std::memcpy(slot + sizeof(Record), &crc, sizeof(crc));
+    }
+    RecordKind kind = recordKindOf(records.front());
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    firstPos = RECORD_HEADER_SIZE + recordCount(io, kind) * recordSizeFor(kind);
+    io.clear();
+    io.seekp(firstPos, std::ios::beg);
+    io.write(reinterpret_cast<const char*>(slots.data()), static_cast<std::streamsize>(slots.size()));
+    io.flush();
+    if (!io) {
+        io.clear();
+        return false;
+    }
+    ChangeJournal::instance().appendWrites(kind, firstPos, slots.data(), records.size());
+    RecordCache::instance().invalidate(kind, firstPos, records.size());
+    return true;
 }
 
-void displayStatistics(const artistList& artist, const albumList& album)
-{
-    system("cls");
-    cout << "\n\n\t\t\tSTATISTICS\n\n";
-    cout << "Total Artists: " << artist.artList.size() << endl;
-    cout << "Total Albums: " << album.albList.size() << endl;
-    cout << "\nAlbums per Artist:\n";
-    for (const auto& art : artist.artList) {
-        int count = 0;
-        for (const auto& alb : album.albList) {
-            if (alb.artistId == art.artistId) {
-                count++;
-            }
+void recordImportIssue(ImportReport& report, const ImportSettings& settings, std::string reason) {
+    ++report.rejected;
+    if (report.issues.size() < settings.maxIssues) {
+        report.issues.push_back({report.rowsRead, std::move(reason)});
+    }
+}
+
+/**
+ * Shared import loop: build(values, record) validates a row (throwing ValidationException),
+ * and index(record, pos, key) adds an appended record to the in-memory index, where key is
+ * the row's first column. IDs for a batch are reserved in one step just before it is written.
+ */
+template <typename Record, typename Build, typename Index>
+bool runRecordImport(std::istream& in, ImportFormat format, const std::vector<std::string>& columns,
+                     std::fstream& io, int& lastId, const char* idPrefix, ImportReport& report,
+                     const ImportSettings& settings, Build build, Index index) {
+    auto start = std::chrono::steady_clock::now();
+    report = ImportReport();
+    std::unique_ptr<ImportRowReader> reader = makeImportReader(in, format, columns);
+    const std::size_t batchLimit = std::max<std::size_t>(1, settings.batchRecords);
+    std::vector<Record> batch;
+    std::vector<std::string> keys;
+    batch.reserve(batchLimit);
+    keys.reserve(batchLimit);
+
+    auto flush = [&]() {
+        if (batch.empty()) {
+            return true;
+        }
+        // Refuse a batch whose IDs would not fit the 7-character ID field rather than let
+        // them truncate into duplicates.
+        if (static_cast<long long>(lastId) + static_cast<long long>(batch.size()) > MAX_RECORD_ID_NUMBER) {
+            std::string reason = std::string("no IDs left for \"") + idPrefix + "\" records: "
+                + std::to_string(batch.size()) + " more would pass " + intToString(MAX_RECORD_ID_NUMBER, idPrefix);
+            report.rejected += batch.size();
+            report.issues.push_back({report.rowsRead, reason});
+            ALBUM_LOG_ERROR("Import stopped: {}", reason);
+            batch.clear();
+            keys.clear();
+            return false;
+        }
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            setRecordId(batch[i], intToString(lastId + 1 + static_cast<int>(i), idPrefix));
+        }
+        long firstPos = 0;
+        if (!appendRecordBlock(io, batch, firstPos)) {
+            return false;
+        }
+        lastId += static_cast<int>(batch.size());
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            index(batch[i], firstPos + static_cast<long>(i * (sizeof(Record) + RECORD_CRC_SIZE)), keys[i]);
+        }
+        report.imported += batch.size();
+        batch.clear();
+        keys.clear();
+        return true;
+    };
+
+    bool written = true;
+    std::vector<std::string> values;
+    std::string rowError;
+    Record record;
+    while (reader->next(values, rowError)) {
+        ++report.rowsRead;
+        if (!rowError.empty()) {
+            recordImportIssue(report, settings, rowError);
+            continue;
+        }
+        try {
+            build(values, record);
+        } catch (const ValidationException& e) {
+            recordImportIssue(report, settings, e.what());
+            continue;
+        }
+        batch.push_back(record);
+        keys.push_back(values[0]);
+        if (batch.size() == batchLimit && !flush()) {
+            written = false;
+            break;
         }
-        cout << art.name << ": " << count << " albums" << endl;
     }
-    cout << endl << endl;
-    system("pause");
+    // Rows parsed before a syntax error are still written.
+    written = written && flush();
+    bool parsed = reader->error().empty();
+    if (!parsed) {
+        report.issues.push_back({report.rowsRead + 1, reader->error()});
+    }
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return written && parsed;
 }
 
-void exportArtistsToCSV(const artistList& artist, const std::string& filename) {
-    cout << "Exporting artists..." << endl;
-    std::ofstream file(filename);
-    if (!file) {
-        std::cout << "Error opening file for export." << std::endl;
-        return;
+void printImportReport(const char* what, const std::string& path, const ImportReport& report) {
+    cout << "Imported " << report.imported << " of " << report.rowsRead << " " << what << " from " << path
+         << " in " << std::fixed << std::setprecision(2) << report.seconds << " s";
+    cout.unsetf(std::ios::floatfield);
+    cout << (report.rejected > 0 ? " (" + std::to_string(report.rejected) + " rejected)" : std::string()) << endl;
+    for (std::size_t i = 0; i < report.issues.size() && i < IMPORT_ISSUES_SHOWN; ++i) {
+        cout << "  row " << report.issues[i].row << ": " << report.issues[i].reason << endl;
     }
-    file << "ID,Name,Gender,Phone,Email\n";
-    std::fstream ArtFile;
-    try {
-        openFile(ArtFile, artistFilePath);
-    } catch(const FileException& e) {
-        std::cout << "Error opening artist file." << std::endl;
-        return;
+    if (report.issues.size() > IMPORT_ISSUES_SHOWN) {
+        cout << "  ... " << (report.issues.size() - IMPORT_ISSUES_SHOWN) << " more (see album_system.log)" << endl;
     }
-    ArtistFile artFile;
-    for (const auto& art : artist.artList) {
-        ArtFile.seekg(art.pos, ios::beg);
-        ArtFile.read((char*)&artFile, sizeof(artFile));
-        artFile.phones[14] = '\0';
-        artFile.emails[49] = '\0';
-        file << art.artistId << "," << art.name << "," << artFile.genders << "," << artFile.phones << "," << artFile.emails << "\n";
+}
+
+// Imports whichever of the two files are given; artists first so albums can refer to them.
+bool importCatalogFiles(std::fstream& ArtFile, std::fstream& AlbFile, artistList& artist, albumList& album,
+                        const std::string& artistSource, const std::string& albumSource) {
+    std::unordered_map<std::string, std::string> idMap;
+    bool clean = true;
+    if (!artistSource.empty()) {
+        std::ifstream in(artistSource, std::ios::binary);
+        if (!in) {
+            cout << "Unable to open " << artistSource << endl;
+            return false;
+        }
+        ImportReport report;
+        clean = importArtists(in, importFormatForPath(artistSource), ArtFile, artist, report, &idMap) && report.rejected == 0;
+        printImportReport("artists", artistSource, report);
     }
-    ArtFile.close();
-    file.close();
-    std::cout << "Artists exported to " << filename << std::endl;
+    if (!albumSource.empty()) {
+        std::ifstream in(albumSource, std::ios::binary);
+        if (!in) {
+            cout << "Unable to open " << albumSource << endl;
+            return false;
+        }
+        ImportReport report;
+        bool albumsClean = importAlbums(in, importFormatForPath(albumSource), AlbFile, artist, album, report, &idMap) && report.rejected == 0;
+        printImportReport("albums", albumSource, report);
+        clean = clean && albumsClean;
+    }
+    return clean;
 }
 
-void exportAlbumsToCSV(const albumList& album, const std::string& filename) {
-    cout << "Exporting albums..." << endl;
-    std::ofstream file(filename);
-    if (!file) {
-        std::cout << "Error opening file for export." << std::endl;
-        return;
+} // namespace
+
+ImportFormat importFormatForPath(const std::string& path) {
+    std::string extension = normalizeImportKey(std::filesystem::path(path).extension().string());
+    return extension == ".json" || extension == ".jsonl" || extension == ".ndjson" ? ImportFormat::Json : ImportFormat::Csv;
+}
+
+bool importArtists(std::istream& in, ImportFormat format, std::fstream& ArtFile, artistList& artist,
+                   ImportReport& report, std::unordered_map<std::string, std::string>* idMap,
+                   const ImportSettings& settings) {
+    ALBUM_TIME_SCOPE("import_artists");
+    if (!ensureArtistStream(ArtFile)) {
+        return false;
+    }
+    bool ok = runRecordImport<ArtistFile>(in, format, ARTIST_IMPORT_COLUMNS, ArtFile, lastArtistID, "art", report, settings,
+        buildImportedArtist,
+        [&](const ArtistFile& record, long pos, const std::string& sourceId) {
+            artist.artList.push_back({std::string(record.artistIds), std::string(record.names), pos});
+            ++artist.live;
+            if (idMap != nullptr && !sourceId.empty()) {
+                (*idMap)[sanitizeStringInput(sourceId, 16)] = record.artistIds;
+            }
+        });
+    sortArtist(artist);
+    publishIndexMetrics(artist);
+    ALBUM_LOG_INFO("Imported {} artists ({} rejected) in {} s", report.imported, report.rejected, report.seconds);
+    for (const auto& issue : report.issues) {
+        ALBUM_LOG_WARN("Artist import row {}: {}", issue.row, issue.reason);
+    }
+    return ok;
+}
+
+bool importAlbums(std::istream& in, ImportFormat format, std::fstream& AlbFile, const artistList& artist,
+                  albumList& album, ImportReport& report,
+                  const std::unordered_map<std::string, std::string>* artistIdMap,
+                  const ImportSettings& settings) {
+    ALBUM_TIME_SCOPE("import_albums");
+    if (!ensureAlbumStream(AlbFile)) {
+        return false;
+    }
+    std::unordered_set<std::string> knownArtists;
+    knownArtists.reserve(artist.artList.size());
+    for (const auto& entry : artist.artList) {
+        knownArtists.insert(entry.artistId);
+    }
+    auto build = [&](const std::vector<std::string>& values, AlbumFile& record) {
+        std::string reference = sanitizeStringInput(values[0], 16);
+        if (artistIdMap != nullptr) {
+            auto mapped = artistIdMap->find(reference);
+            if (mapped != artistIdMap->end()) {
+                reference = mapped->second;
+            }
+        }
+        if (knownArtists.count(reference) == 0) {
+            throw ValidationException("Unknown artist ID \"" + reference + "\"!");
+        }
+        buildImportedAlbum(values, reference, record);
+    };
+    bool ok = runRecordImport<AlbumFile>(in, format, ALBUM_IMPORT_COLUMNS, AlbFile, lastAlbumID, "alb", report, settings,
+        build,
+        [&](const AlbumFile& record, long pos, const std::string&) {
+            album.albList.push_back(albumEntryFor(record, pos));
+        });
+    sortAlbum(album);
+    recountCatalogStatistics(album);
+    publishIndexMetrics(album);
+    ALBUM_LOG_INFO("Imported {} albums ({} rejected) in {} s", report.imported, report.rejected, report.seconds);
+    for (const auto& issue : report.issues) {
+        ALBUM_LOG_WARN("Album import row {}: {}", issue.row, issue.reason);
     }
-    file << "AlbumID,ArtistID,Title,RecordFormat,DatePublished,Path\n";
+    return ok;
+}
+
+bool importDataFiles(const std::string& artistSource, const std::string& albumSource) {
+    ALBUM_TRACE_SCOPE("importDataFiles");
+    std::fstream ArtFile;
     std::fstream AlbFile;
-    try {
-        openFile(AlbFile, albumFilePath);
-    } catch(const FileException& e) {
-        std::cout << "Error opening album file." << std::endl;
-        return;
+    artistList artist;
+    albumList album;
+    indexSet deletedArtists;
+    indexSet deletedAlbums;
+    if (!loadArtist(ArtFile, artist, deletedArtists) || !loadAlbum(AlbFile, album, deletedAlbums)) {
+        return false;
     }
-    AlbumFile albFile;
-    for (const auto& alb : album.albList) {
-        AlbFile.seekg(alb.pos, ios::beg);
-        AlbFile.read((char*)&albFile, sizeof(albFile));
-        albFile.titles[79] = '\0';
-        albFile.recordFormats[11] = '\0';
-        albFile.datePublished[10] = '\0';
-        albFile.paths[99] = '\0';
-        file << alb.albumId << "," << alb.artistId << "," << albFile.titles << "," << albFile.recordFormats << "," << albFile.datePublished << "," << albFile.paths << "\n";
+    return importCatalogFiles(ArtFile, AlbFile, artist, album, artistSource, albumSource);
+}
+
+void importDataMenu(std::fstream& ArtFile, std::fstream& AlbFile, artistList& artist, albumList& album) {
+    system("cls");
+    cout << "\n\n\t\t\tIMPORT DATA\n\n";
+    cout << "Files ending in .json, .jsonl or .ndjson are read as a JSON array or one object per line,\n"
+            "anything else as CSV with a header row.\n";
+    cout << "Imported records get new IDs; an album's ArtistID may name an artist from the same import.\n";
+    cout << "Imports cannot be undone - create a backup snapshot first if unsure.\n\n";
+    std::string artistSource;
+    std::string albumSource;
+    cout << "Artist file (blank to skip): ";
+    getline(cin, artistSource);
+    cout << "Album file (blank to skip): ";
+    getline(cin, albumSource);
+    artistSource = sanitizeStringInput(artistSource, 4096);
+    albumSource = sanitizeStringInput(albumSource, 4096);
+    if (artistSource.empty() && albumSource.empty()) {
+        cout << "Nothing to import." << endl;
+    } else {
+        importCatalogFiles(ArtFile, AlbFile, artist, album, artistSource, albumSource);
     }
-    AlbFile.close();
-    file.close();
-    std::cout << "Albums exported to " << filename << std::endl;
+    cout << endl;
+    system("pause");
 }
 
 //11
@@ -1468,7 +7470,16 @@ bool artistManager(fstream & ArtFile, fstream & AlbFile, artistList &artist, alb
         if (choice ==2)
             exit=artistEditor(ArtFile,AlbFile,artist,album,result,delArtArray,delAlbArray);
         if (choice ==3) {
-            exportArtistsToCSV(artist, "artists.csv");
+            int format = 0;
+            cout << "\n1. CSV (artists.csv)\n2. JSON Lines (artists.jsonl)\nChoice: ";
+            cin >> format;
+            cin.clear();
+            cin.ignore(INT_MAX, '\n');
+            if (format == 2) {
+                exportArtistsToJsonl(artist, "artists.jsonl");
+            } else {
+                exportArtistsToCSV(artist, "artists.csv");
+            }
             cout << endl << endl;
             system("pause");
             exit = true;
@@ -1494,7 +7505,7 @@ int artistMenu()
         cout<<"\n                                 *ArtistMenu*               ";
         cout<<"\n\n                       Enter  1 :  >> Artist Viewer                           ";
         cout<<"\n\n                       Enter  2 :  >> Artist Editor                            ";
-        cout<<"\n\n                       Enter  3 :  >> Export Artists to CSV                              ";
+        cout<<"\n\n                       Enter  3 :  >> Export Artists (CSV/JSONL)                        ";
         cout<<"\n\n                       Enter  4 :  >> Go To Main Menu                              ";
         cout<<"\n\n                       Enter  5 :  >> EXIT.                              \n\n ";
         cout<<"\n choice:    ";
@@ -1557,6 +7568,7 @@ int viewArtistMenu()
 //15
 void displayAllArtist(std::fstream& ArtFile, const artistList& artist)
 {
+    ALBUM_TRACE_SCOPE("displayAllArtist");
     ArtistView::displayAll(artist);
 }
 
@@ -1610,6 +7622,7 @@ bool searchArtist(std::fstream& ArtFile, const artistList& artist, indexSet& res
 //18
 bool searchArtistById(const artistList& artist, indexSet& result, const std::string& targetId)
 {
+    ALBUM_TIME_SCOPE("search_artist_by_id");
     result.indexes.clear();
     for(size_t i = 0; i < artist.artList.size(); i++){
         if(artist.artList[i].artistId != "-1" && artist.artList[i].artistId.find(targetId) == 0){
@@ -1622,6 +7635,7 @@ bool searchArtistById(const artistList& artist, indexSet& result, const std::str
 //19
 bool searchArtistByName(const artistList& artist, indexSet& result, const std::string& targetName)
 {
+    ALBUM_TIME_SCOPE("search_artist_by_name");
     result.indexes.clear();
     std::string lowerTarget = targetName;
     std::transform(lowerTarget.begin(), lowerTarget.end(), lowerTarget.begin(), ::tolower);
@@ -1664,6 +7678,8 @@ bool artistEditor(fstream & ArtFile, fstream & AlbFile, artistList &artist, albu
         if (choice ==3)
             deleteArtist(ArtFile,AlbFile,artist,album,result,delArtArray,delAlbArray);
         if (choice ==4)
+            mergeArtistsMenu(ArtFile,AlbFile,artist,album,result,delArtArray);
+        if (choice ==5)
             exit=true;
     }while(!exit);
     return true;
@@ -1681,18 +7697,19 @@ int editArtistMenu()
         cout<<"\n\n                       Enter  1 :  >> ADD Artist    ";
         cout<<"\n\n                       Enter  2 :  >> Edit Artist  ";
         cout<<"\n\n                       Enter  3 :  >> Delete Artist  ";
-        cout<<"\n\n                       Enter  4 :  >> GO BACK.          \n\n ";
+        cout<<"\n\n                       Enter  4 :  >> Merge Duplicate Artists  ";
+        cout<<"\n\n                       Enter  5 :  >> GO BACK.          \n\n ";
         cout<<"\n choice:    ";
         cin>>c;
         cin.clear();
         cin.ignore(INT_MAX,'\n');
-        if (c>4 || c<1){
+        if (c>5 || c<1){
             cout<<"Wrong Choice!"<<endl;
             cout<<endl<<endl;
             system ("pause");
             system ("cls");
             }
-    }while(c>4 || c<1);
+    }while(c>5 || c<1);
     return c;
 }
 
@@ -1737,13 +7754,14 @@ CommandAction createAddArtistCommand(Artist art, std::fstream& ArtFile, artistLi
         int idx = findArtistIndexById(artist, state->artist.getArtistId());
         if (idx == -1) {
             artist.artList.push_back({state->artist.getArtistId(), state->artist.getName(), state->pos});
+            ++artist.live;
         } else {
             artist.artList[idx].artistId = state->artist.getArtistId();
             artist.artList[idx].name = state->artist.getName();
             artist.artList[idx].pos = state->pos;
         }
         sortArtist(artist);
-        Logger::getInstance()->log("Redo add artist: " + state->artist.getName());
+        ALBUM_LOG_INFO("Redo add artist: {}", state->artist.getName());
         return true;
     };
     action.undo = [&, state]() {
@@ -1754,13 +7772,11 @@ CommandAction createAddArtistCommand(Artist art, std::fstream& ArtFile, artistLi
         std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
         if (ensureArtistStream(ArtFile)) {
             ArtistFile blank = {"-1", "", 'N', "", ""};
-            ArtFile.clear();
-            ArtFile.seekp(state->pos, ios::beg);
-            ArtFile.write(reinterpret_cast<const char*>(&blank), sizeof(ArtistFile));
-            ArtFile.flush();
+            writeRecordAt(ArtFile, state->pos, blank);
         }
         artist.artList.erase(artist.artList.begin() + idx);
-        Logger::getInstance()->log("Undo add artist: " + state->artist.getName());
+        --artist.live;
+        ALBUM_LOG_INFO("Undo add artist: {}", state->artist.getName());
     };
 
     return action;
@@ -1769,18 +7785,22 @@ CommandAction createAddArtistCommand(Artist art, std::fstream& ArtFile, artistLi
 //24
 bool addArtist(std::fstream& ArtFile, artistList& artist)
 {
+    ALBUM_TRACE_SCOPE("addArtist");
     if (!getAddConfirmation("artist"))
         return false;
 
-    Artist art = getArtistInfo();
-    std::string id = intToString(++lastArtistID, "art");
-    art.setArtistId(id);
+    return addArtistRecord(ArtFile, artist, getArtistInfo());
+}
+
+bool addArtistRecord(std::fstream& ArtFile, artistList& artist, Artist art)
+{
+    art.setArtistId(intToString(++lastArtistID, "art"));
 
     CommandAction action = createAddArtistCommand(art, ArtFile, artist);
 
     if (!executeCommand(std::move(action))) {
         --lastArtistID;
-        Logger::getInstance()->log("Failed to add artist via command");
+        ALBUM_LOG_ERROR("Failed to add artist via command");
         return false;
     }
     return true;
@@ -1975,9 +7995,12 @@ void validateEmail(const std::string& email)
         if (!std::all_of(domainPart.begin(), domainPart.end(), isValidChar))
             throw ValidationException("Email domain contains invalid characters!");
 
+        // A single-label domain such as "example" is a host name on its own.
         size_t lastDot = domainPart.rfind('.');
-        if (lastDot == std::string::npos || lastDot == 0 || lastDot == domainPart.length() - 1)
-            throw ValidationException("Email domain must contain a '.' followed by a valid extension!");
+        if (lastDot == std::string::npos)
+            return;
+        if (lastDot == 0 || lastDot == domainPart.length() - 1)
+            throw ValidationException("Email domain must have a host name before and an extension after its last '.'!");
 
         std::string hostPart = domainPart.substr(0, lastDot);
         std::string tldPart = domainPart.substr(lastDot + 1);
@@ -2008,6 +8031,7 @@ std::string formatEmail(std::string email)
 //35
 void editArtist(std::fstream& ArtFile, artistList& artist, indexSet& result)
 {
+    ALBUM_TRACE_SCOPE("editArtist");
     system("cls");
     cout << setw(30) << "Edit Artist " << endl;
     do{
@@ -2054,21 +8078,8 @@ int selectArtist(std::fstream& ArtFile, const artistList& artist, indexSet& resu
 }
 
 //37
-bool editArtistInfo(std::fstream& ArtFile, artistList& artist, int idx)
+CommandAction createEditArtistCommand(Artist original, Artist updated, long pos, std::fstream& ArtFile, artistList& artist)
 {
-    displayOneArtist(ArtFile, artist, idx);
-    long pos = artist.artList[idx].pos;
-    Artist original;
-    if (!readArtistAtPosition(ArtFile, pos, original)) {
-        cout << "Failed to read artist data." << endl;
-        system("pause");
-        Logger::getInstance()->log("Failed to read artist for editing at position: " + std::to_string(pos));
-        return false;
-    }
-
-    Artist updated = getArtistInfo();
-    updated.setArtistId(original.getArtistId());
-
     auto state = std::make_shared<ArtistEditState>();
     state->original = original;
     state->updated = updated;
@@ -2078,7 +8089,7 @@ bool editArtistInfo(std::fstream& ArtFile, artistList& artist, int idx)
     action.description = "Edit artist " + original.getName();
     action.redo = [&, state]() -> bool {
         if (!writeArtistAtPosition(ArtFile, state->pos, state->updated)) {
-            Logger::getInstance()->log("Failed to apply artist edit during redo");
+            ALBUM_LOG_ERROR("Failed to apply artist edit during redo");
             return false;
         }
         int targetIdx = findArtistIndexById(artist, state->updated.getArtistId());
@@ -2088,12 +8099,12 @@ bool editArtistInfo(std::fstream& ArtFile, artistList& artist, int idx)
         }
         sortArtist(artist);
         state->applied = true;
-        Logger::getInstance()->log("Redo edit artist: " + state->updated.getName());
+        ALBUM_LOG_INFO("Redo edit artist: {}", state->updated.getName());
         return true;
     };
     action.undo = [&, state]() {
         if (!writeArtistAtPosition(ArtFile, state->pos, state->original)) {
-            Logger::getInstance()->log("Failed to revert artist edit during undo");
+            ALBUM_LOG_ERROR("Failed to revert artist edit during undo");
             return;
         }
         int targetIdx = findArtistIndexById(artist, state->original.getArtistId());
@@ -2103,10 +8114,37 @@ bool editArtistInfo(std::fstream& ArtFile, artistList& artist, int idx)
         }
         sortArtist(artist);
         state->applied = false;
-        Logger::getInstance()->log("Undo edit artist: " + state->original.getName());
+        ALBUM_LOG_INFO("Undo edit artist: {}", state->original.getName());
     };
 
-    if (!executeCommand(std::move(action))) {
+    return action;
+}
+
+bool editArtistRecord(std::fstream& ArtFile, artistList& artist, int idx, Artist updated)
+{
+    long pos = artist.artList[idx].pos;
+    Artist original;
+    if (!readArtistAtPosition(ArtFile, pos, original)) {
+        ALBUM_LOG_ERROR("Failed to read artist for editing at position: {}", pos);
+        return false;
+    }
+    updated.setArtistId(original.getArtistId());
+    return executeCommand(createEditArtistCommand(original, updated, pos, ArtFile, artist));
+}
+
+bool editArtistInfo(std::fstream& ArtFile, artistList& artist, int idx)
+{
+    displayOneArtist(ArtFile, artist, idx);
+    long pos = artist.artList[idx].pos;
+    Artist original;
+    if (!readArtistAtPosition(ArtFile, pos, original)) {
+        cout << "Failed to read artist data." << endl;
+        system("pause");
+        ALBUM_LOG_ERROR("Failed to read artist for editing at position: {}", pos);
+        return false;
+    }
+
+    if (!editArtistRecord(ArtFile, artist, idx, getArtistInfo())) {
         cout << "Failed to edit artist." << endl;
         system("pause");
         return false;
@@ -2126,6 +8164,7 @@ void displayOneArtist(std::fstream& ArtFile, const artistList& artist, int idx)
 //39
 void deleteArtist(std::fstream& ArtFile, std::fstream& AlbFile, artistList& artist, albumList& album, indexSet& result, indexSet& delArtArray, indexSet& delAlbArray)
 {
+    ALBUM_TRACE_SCOPE("deleteArtist");
     system("cls");
     cout << setw(30) << "Delete Artist " << endl;
     result.indexes.clear();
@@ -2150,12 +8189,12 @@ ArtistRemovalState prepareArtistRemovalState(std::fstream& ArtFile, std::fstream
     if (!readArtistAtPosition(ArtFile, artist.artList[idx].pos, original)) {
         cout << "Failed to load artist details." << endl;
         system("pause");
-        Logger::getInstance()->log("Failed to read artist during removal");
+        ALBUM_LOG_ERROR("Failed to read artist during removal");
         throw std::runtime_error("Failed to read artist");
     }
 
     if (!ensureAlbumStream(AlbFile)) {
-        Logger::getInstance()->log("Failed to ready album file for artist removal");
+        ALBUM_LOG_ERROR("Failed to ready album file for artist removal");
         throw std::runtime_error("Failed to ready album file");
     }
 
@@ -2190,7 +8229,7 @@ bool getRemovalConfirmation()
         } else if (remv == 'n' || remv == 'N') {
             cout << "Artist not removed. \n" << endl;
             system("pause");
-            Logger::getInstance()->log("Artist removal cancelled by user");
+            ALBUM_LOG_INFO("Artist removal cancelled by user");
             return false;
         } else {
             cout << "Wrong entry. Try again!" << endl;
@@ -2220,14 +8259,8 @@ CommandAction createRemoveArtistCommand(ArtistRemovalState state, std::fstream&
             if (albumIdx == -1) {
                 continue;
             }
-            AlbFile.clear();
-            AlbFile.seekp(snapshot.pos, ios::beg);
-            AlbFile.write(reinterpret_cast<const char*>(&blankAlbum), sizeof(AlbumFile));
-            AlbFile.flush();
-            album.albList[albumIdx].albumId = "-1";
-            album.albList[albumIdx].artistId = "-1";
-            album.albList[albumIdx].title = "";
-            album.albList[albumIdx].pos = snapshot.pos;
+            writeRecordAt(AlbFile, snapshot.pos, blankAlbum);
+            blankAlbumEntry(album, album.albList[albumIdx]);
             if (std::find(delAlbArray.indexes.begin(), delAlbArray.indexes.end(), albumIdx) == delAlbArray.indexes.end()) {
                 delAlbArray.indexes.push_back(albumIdx);
             }
@@ -2236,29 +8269,30 @@ CommandAction createRemoveArtistCommand(ArtistRemovalState state, std::fstream&
         int artistIdx = findArtistIndexById(artist, statePtr->artist.getArtistId());
         statePtr->artistIndex = artistIdx;
         if (artistIdx != -1) {
-            ArtFile.clear();
-            ArtFile.seekp(statePtr->pos, ios::beg);
-            ArtFile.write(reinterpret_cast<const char*>(&blankArtist), sizeof(ArtistFile));
-            ArtFile.flush();
+            writeRecordAt(ArtFile, statePtr->pos, blankArtist);
             artist.artList[artistIdx].artistId = "-1";
             artist.artList[artistIdx].name = "";
             artist.artList[artistIdx].pos = statePtr->pos;
+            --artist.live;
             if (std::find(delArtArray.indexes.begin(), delArtArray.indexes.end(), artistIdx) == delArtArray.indexes.end()) {
                 delArtArray.indexes.push_back(artistIdx);
             }
         }
 
-        Logger::getInstance()->log("Redo artist removal: " + statePtr->artist.getName());
+        ALBUM_LOG_INFO("Redo artist removal: {}", statePtr->artist.getName());
         return true;
     };
 
     action.undo = [&, statePtr]() {
         if (!writeArtistAtPosition(ArtFile, statePtr->pos, statePtr->artist)) {
-            Logger::getInstance()->log("Failed to restore artist during undo");
+            ALBUM_LOG_ERROR("Failed to restore artist during undo");
             return;
         }
-        int artistIdx = findArtistIndexById(artist, statePtr->artist.getArtistId());
+        int artistIdx = findArtistIndexByPos(artist, statePtr->pos);
         if (artistIdx != -1) {
+            if (artist.artList[artistIdx].artistId == "-1") {
+                ++artist.live;
+            }
             artist.artList[artistIdx].artistId = statePtr->artist.getArtistId();
             artist.artList[artistIdx].name = statePtr->artist.getName();
             artist.artList[artistIdx].pos = statePtr->pos;
@@ -2268,24 +8302,14 @@ CommandAction createRemoveArtistCommand(ArtistRemovalState state, std::fstream&
             }
         }
 
-        for (auto& snapshot : statePtr->associatedAlbums) {
-            if (!writeAlbumAtPosition(AlbFile, snapshot.pos, snapshot.data)) {
-                continue;
-            }
-            int albumIdx = findAlbumIndexById(album, snapshot.data.getAlbumId());
-            if (albumIdx != -1) {
-                album.albList[albumIdx].albumId = snapshot.data.getAlbumId();
-                album.albList[albumIdx].artistId = snapshot.data.getArtistId();
-                album.albList[albumIdx].title = snapshot.data.getTitle();
-                album.albList[albumIdx].pos = snapshot.pos;
-                auto itAlb = std::find(delAlbArray.indexes.begin(), delAlbArray.indexes.end(), albumIdx);
-                if (itAlb != delAlbArray.indexes.end()) {
-                    delAlbArray.indexes.erase(itAlb);
-                }
-            }
+        std::vector<bool> written(statePtr->associatedAlbums.size());
+        for (std::size_t s = 0; s < written.size(); ++s) {
+            const AlbumSnapshot& snapshot = statePtr->associatedAlbums[s];
+            written[s] = writeAlbumAtPosition(AlbFile, snapshot.pos, snapshot.data);
         }
+        restoreAlbumEntries(album, delAlbArray, statePtr->associatedAlbums, written);
 
-        Logger::getInstance()->log("Undo artist removal: " + statePtr->artist.getName());
+        ALBUM_LOG_INFO("Undo artist removal: {}", statePtr->artist.getName());
     };
 
     return action;
@@ -2294,62 +8318,334 @@ CommandAction createRemoveArtistCommand(ArtistRemovalState state, std::fstream&
 //42
 void removeArtist(std::fstream& ArtFile, std::fstream& AlbFile, artistList& artist, albumList& album, indexSet& delArtArray, indexSet& delAlbArray, int idx)
 {
-    Logger::getInstance()->log("Removing artist: " + artist.artList[idx].name + " with ID: " + artist.artList[idx].artistId);
+    ALBUM_TRACE_SCOPE("removeArtist");
+    ALBUM_LOG_INFO("Removing artist: {} with ID: {}", artist.artList[idx].name, artist.artList[idx].artistId);
+
+    if (!getRemovalConfirmation()) {
+        return;
+    }
+    if (!removeArtistRecord(ArtFile, AlbFile, artist, album, delArtArray, delAlbArray, idx)) {
+        cout << "Failed to remove artist." << endl;
+        system("pause");
+        return;
+    }
+    cout << "\n\t Artist removed successfully! \n" << endl;
+    system("pause");
+}
 
+bool removeArtistRecord(std::fstream& ArtFile, std::fstream& AlbFile, artistList& artist, albumList& album, indexSet& delArtArray, indexSet& delAlbArray, int idx)
+{
+    ALBUM_TRACE_SCOPE("removeArtistRecord");
     try {
         ArtistRemovalState state = prepareArtistRemovalState(ArtFile, AlbFile, artist, album, idx);
+        return executeCommand(createRemoveArtistCommand(state, ArtFile, AlbFile, artist, album, delArtArray, delAlbArray, idx));
+    } catch (const std::runtime_error& e) {
+        // Error already logged in prepareArtistRemovalState
+        return false;
+    }
+}
+
+namespace {
+
+// Writes and journals runs[0, count) of slots, one write per run of adjacent slots. Returns
+// the number of runs written; on a failed write that run may be partly on disk.
+std::size_t writeAlbumSlotRuns(std::fstream& AlbFile, const std::vector<long>& positions,
+                               const std::vector<std::pair<std::size_t, std::size_t>>& runs,
+                               const std::vector<unsigned char>& slots, std::size_t count) {
+    const std::size_t slotSize = static_cast<std::size_t>(ALBUM_RECORD_SIZE);
+    for (std::size_t r = 0; r < count; ++r) {
+        const auto& run = runs[r];
+        const unsigned char* first = slots.data() + run.first * slotSize;
+        std::size_t slotsInRun = run.second - run.first;
+        AlbFile.clear();
+        AlbFile.seekp(positions[run.first], std::ios::beg);
+        AlbFile.write(reinterpret_cast<const char*>(first), static_cast<std::streamsize>(slotsInRun * slotSize));
+        AlbFile.flush();
+        if (!AlbFile) {
+            AlbFile.clear();
+            RecordCache::instance().invalidate(RecordKind::Album, positions[run.first], slotsInRun);
+            return r;
+        }
+        ChangeJournal::instance().appendWrites(RecordKind::Album, positions[run.first], first, slotsInRun);
+        RecordCache::instance().invalidate(RecordKind::Album, positions[run.first], slotsInRun);
+    }
+    return count;
+}
+
+// Re-points the albums at the given sorted slot offsets to artistId. Every slot is read and
+// its CRC checked before anything is written; runs of adjacent slots are then rewritten and
+// journaled with one write each. If a write fails, the runs already written (and the one
+// that failed) are put back from the slots as read, so the file is left as it was.
+bool rewriteAlbumArtistRefs(std::fstream& AlbFile, const std::vector<long>& positions, const std::string& artistId) {
+    const std::size_t slotSize = static_cast<std::size_t>(ALBUM_RECORD_SIZE);
+    std::vector<unsigned char> slots(positions.size() * slotSize);
+    std::vector<std::pair<std::size_t, std::size_t>> runs;
+    for (std::size_t first = 0; first < positions.size();) {
+        std::size_t last = first + 1;
+        while (last < positions.size() && positions[last] == positions[last - 1] + ALBUM_RECORD_SIZE) {
+            ++last;
+        }
+        runs.emplace_back(first, last);
+        first = last;
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+    for (const auto& run : runs) {
+        AlbFile.clear();
+        AlbFile.seekg(positions[run.first], std::ios::beg);
+        if (!AlbFile.read(reinterpret_cast<char*>(slots.data() + run.first * slotSize),
+                          static_cast<std::streamsize>((run.second - run.first) * slotSize))) {
+            AlbFile.clear();
+            ALBUM_LOG_ERROR("Short read at album offset {} while re-parenting albums", positions[run.first]);
+            return false;
+        }
+    }
+    std::vector<unsigned char> snapshot = slots;
+    AlbumFile record;
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        unsigned char* slot = slots.data() + i * slotSize;
+        std::uint32_t storedCrc = 0;
+        std::memcpy(&storedCrc, slot + sizeof(AlbumFile), sizeof(storedCrc));
+        if (storedCrc != crc32c(slot, sizeof(AlbumFile))) {
+            ALBUM_LOG_ERROR("Corrupt album record at offset {}; nothing re-parented", positions[i]);
+            return false;
+        }
+        std::memcpy(&record, slot, sizeof(AlbumFile));
+        std::memset(record.artistIdRefs, 0, sizeof(record.artistIdRefs));
+        strncpy(record.artistIdRefs, artistId.c_str(), 7);
+        std::memcpy(slot, &record, sizeof(AlbumFile));
+        std::uint32_t crc = crc32c(slot, sizeof(AlbumFile));
+        std::memcpy(slot + sizeof(AlbumFile), &crc, sizeof(crc));
+    }
+    std::size_t written = writeAlbumSlotRuns(AlbFile, positions, runs, slots, runs.size());
+    if (written == runs.size()) {
+        return true;
+    }
+    ALBUM_LOG_ERROR("Write failed at album offset {} while re-parenting albums; rolling back {} runs",
+                    positions[runs[written].first], written + 1);
+    if (writeAlbumSlotRuns(AlbFile, positions, runs, snapshot, written + 1) != written + 1) {
+        ALBUM_LOG_ERROR("Rollback of re-parented albums failed at offset {}; run the integrity check",
+                        positions[runs[written].first]);
+    }
+    return false;
+}
+
+// Relabels the index entries at the given sorted slot offsets and moves them, in their
+// current order, to where artistId sorts; the other entries keep their order.
+void reparentAlbumIndex(albumList& album, const std::vector<long>& positions, const std::string& artistId) {
+    auto moved = std::stable_partition(album.albList.begin(), album.albList.end(), [&](const albumIndex& entry) {
+        return !std::binary_search(positions.begin(), positions.end(), entry.pos);
+    });
+    for (auto it = moved; it != album.albList.end(); ++it) {
+        album.stats.remove(*it);
+        it->artistId = artistId;
+        album.stats.add(*it);
+    }
+    auto insertAt = std::upper_bound(album.albList.begin(), moved, artistId, [](const std::string& id, const albumIndex& entry) {
+        return id < entry.artistId;
+    });
+    std::rotate(insertAt, moved, album.albList.end());
+}
+
+CommandAction createMergeArtistsCommand(ArtistMergeState state, std::fstream& ArtFile, std::fstream& AlbFile,
+                                        artistList& artist, albumList& album, indexSet& delArtArray)
+{
+    auto statePtr = std::make_shared<ArtistMergeState>(std::move(state));
+
+    CommandAction action;
+    action.description = "Merge artist " + statePtr->duplicate.getName() + " into " + statePtr->canonicalId;
+    action.redo = [&, statePtr]() -> bool {
+        std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+        if (!ensureArtistStream(ArtFile) || !ensureAlbumStream(AlbFile)) {
+            return false;
+        }
+        if (!rewriteAlbumArtistRefs(AlbFile, statePtr->albumPositions, statePtr->canonicalId)) {
+            return false;
+        }
+        ArtistFile blankArtist = {"-1", "", 'N', "", ""};
+        if (!writeRecordAt(ArtFile, statePtr->duplicatePos, blankArtist)) {
+            ArtFile.clear();
+            ALBUM_LOG_ERROR("Failed to tombstone artist {} during merge; restoring its albums",
+                            statePtr->duplicate.getArtistId());
+            rewriteAlbumArtistRefs(AlbFile, statePtr->albumPositions, statePtr->duplicate.getArtistId());
+            return false;
+        }
+        int artistIdx = findArtistIndexById(artist, statePtr->duplicate.getArtistId());
+        if (artistIdx != -1) {
+            artist.artList[artistIdx].artistId = "-1";
+            artist.artList[artistIdx].name = "";
+            --artist.live;
+            if (std::find(delArtArray.indexes.begin(), delArtArray.indexes.end(), artistIdx) == delArtArray.indexes.end()) {
+                delArtArray.indexes.push_back(artistIdx);
+            }
+        }
+        reparentAlbumIndex(album, statePtr->albumPositions, statePtr->canonicalId);
+        ALBUM_LOG_INFO("Merged artist {} into {} ({} albums)", statePtr->duplicate.getArtistId(),
+                       statePtr->canonicalId, statePtr->albumPositions.size());
+        return true;
+    };
+
+    // Both file changes are made before the indexes are touched, and a failure of the second
+    // puts the first back, so a failed undo leaves the merge in place on disk and in memory.
+    action.undo = [&, statePtr]() {
+        std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
+        if (!rewriteAlbumArtistRefs(AlbFile, statePtr->albumPositions, statePtr->duplicate.getArtistId())) {
+            ALBUM_LOG_ERROR("Failed to restore album artist references during merge undo");
+            return;
+        }
+        if (!writeArtistAtPosition(ArtFile, statePtr->duplicatePos, statePtr->duplicate)) {
+            ArtFile.clear();
+            ALBUM_LOG_ERROR("Failed to restore artist during merge undo; keeping the merge");
+            rewriteAlbumArtistRefs(AlbFile, statePtr->albumPositions, statePtr->canonicalId);
+            return;
+        }
+        for (std::size_t i = 0; i < artist.artList.size(); ++i) {
+            if (artist.artList[i].pos == statePtr->duplicatePos) {
+                if (artist.artList[i].artistId == "-1") {
+                    ++artist.live;
+                }
+                artist.artList[i].artistId = statePtr->duplicate.getArtistId();
+                artist.artList[i].name = statePtr->duplicate.getName();
+                auto it = std::find(delArtArray.indexes.begin(), delArtArray.indexes.end(), static_cast<int>(i));
+                if (it != delArtArray.indexes.end()) {
+                    delArtArray.indexes.erase(it);
+                }
+                break;
+            }
+        }
+        reparentAlbumIndex(album, statePtr->albumPositions, statePtr->duplicate.getArtistId());
+        ALBUM_LOG_INFO("Undo merge of artist {}", statePtr->duplicate.getArtistId());
+    };
+
+    return action;
+}
+
+} // namespace
+
+bool mergeArtists(std::fstream& ArtFile, std::fstream& AlbFile, artistList& artist, albumList& album,
+                  indexSet& delArtArray, int duplicateIdx, int canonicalIdx, std::size_t* movedAlbums)
+{
+    ALBUM_TIME_SCOPE("merge_artists");
+    int count = static_cast<int>(artist.artList.size());
+    if (duplicateIdx < 0 || canonicalIdx < 0 || duplicateIdx >= count || canonicalIdx >= count || duplicateIdx == canonicalIdx) {
+        return false;
+    }
+    const artistIndex& duplicateEntry = artist.artList[duplicateIdx];
+    const artistIndex& canonicalEntry = artist.artList[canonicalIdx];
+    if (duplicateEntry.artistId == "-1" || canonicalEntry.artistId == "-1" || duplicateEntry.artistId == canonicalEntry.artistId) {
+        return false;
+    }
+    if (!ensureAlbumStream(AlbFile)) {
+        return false;
+    }
 
-        if (!getRemovalConfirmation()) {
-            return;
+    ArtistMergeState state;
+    if (!readArtistAtPosition(ArtFile, duplicateEntry.pos, state.duplicate)) {
+        ALBUM_LOG_ERROR("Failed to read artist {} for merge", duplicateEntry.artistId);
+        return false;
+    }
+    state.duplicatePos = duplicateEntry.pos;
+    state.canonicalId = canonicalEntry.artistId;
+    for (const auto& entry : album.albList) {
+        if (entry.artistId == duplicateEntry.artistId) {
+            state.albumPositions.push_back(entry.pos);
         }
+    }
+    std::sort(state.albumPositions.begin(), state.albumPositions.end());
+    std::size_t moved = state.albumPositions.size();
 
-        CommandAction action = createRemoveArtistCommand(state, ArtFile, AlbFile, artist, album, delArtArray, delAlbArray, idx);
+    if (!executeCommand(createMergeArtistsCommand(std::move(state), ArtFile, AlbFile, artist, album, delArtArray))) {
+        return false;
+    }
+    if (movedAlbums != nullptr) {
+        *movedAlbums = moved;
+    }
+    return true;
+}
 
-        if (!executeCommand(std::move(action))) {
-            cout << "Failed to remove artist." << endl;
-            system("pause");
-            return;
-        }
+void mergeArtistsMenu(std::fstream& ArtFile, std::fstream& AlbFile, artistList& artist, albumList& album,
+                      indexSet& result, indexSet& delArtArray)
+{
+    ALBUM_TRACE_SCOPE("mergeArtistsMenu");
+    system("cls");
+    cout << setw(30) << "Merge Duplicate Artists " << endl;
+    cout << "\nFind the duplicate artist (its albums move to the artist you pick next)." << endl;
+    result.indexes.clear();
+    if (!searchArtist(ArtFile, artist, result)) {
+        printError(4);
+        system("pause");
+        return;
+    }
+    int duplicateIdx = selectArtist(ArtFile, artist, result, "merge away");
+    if (duplicateIdx < 0) {
+        return;
+    }
+    std::string duplicateId = artist.artList[duplicateIdx].artistId;
 
-        cout << "\n\t Artist removed successfully! \n" << endl;
+    cout << "\nFind the artist to keep." << endl;
+    result.indexes.clear();
+    if (!searchArtist(ArtFile, artist, result)) {
+        printError(4);
+        system("pause");
+        return;
+    }
+    int canonicalIdx = selectArtist(ArtFile, artist, result, "keep");
+    if (canonicalIdx < 0) {
+        return;
+    }
+    result.indexes.clear();
+    if (canonicalIdx == duplicateIdx) {
+        cout << "\nPick two different artists." << endl;
         system("pause");
-    } catch (const std::runtime_error& e) {
-        // Error already logged in prepareArtistRemovalState
         return;
     }
+
+    std::size_t moved = 0;
+    if (!mergeArtists(ArtFile, AlbFile, artist, album, delArtArray, duplicateIdx, canonicalIdx, &moved)) {
+        cout << "\nFailed to merge artists." << endl;
+    } else {
+        cout << "\n\t Artist " << duplicateId << " merged; " << moved << " album(s) moved. Undo reverts the whole merge.\n" << endl;
+    }
+    system("pause");
 }
 
 //43
 void removeArtistAllAlbums(std::fstream& ArtFile, std::fstream& AlbFile, const artistList& artist, albumList& album, indexSet& delAlbArray, int i)
 {
-    int pos;
+    ALBUM_TRACE_SCOPE("removeArtistAllAlbums");
+    long pos;
     AlbumFile BLANK_ALBUM_FILE = {"-1", "-1", "", "", "", ""};
     if (!AlbFile.is_open()) {
         try {
-            openFile(AlbFile, albumFilePath);
+            openRecordFile(AlbFile, albumFilePath, RecordKind::Album);
         } catch (const FileException& e) {
             cout << e.what() << endl;
             system("pause");
-            Logger::getInstance()->log("Failed to open album file for bulk artist removal");
+            ALBUM_LOG_ERROR("Failed to open album file for bulk artist removal");
             return;
         }
     }
-    AlbFile.clear();
-    AlbFile.seekp(album.albList[i].pos, ios::beg);
-    pos = AlbFile.tellp();
-    AlbFile.write((char*)&BLANK_ALBUM_FILE, sizeof(AlbumFile));
-    AlbFile.flush();
-    album.albList[i].albumId = BLANK_ALBUM_FILE.albumIds;
-    album.albList[i].artistId = BLANK_ALBUM_FILE.artistIdRefs;
-    album.albList[i].title = BLANK_ALBUM_FILE.titles;
-    album.albList[i].pos = pos;
+    pos = album.albList[i].pos;
+    writeRecordAt(AlbFile, pos, BLANK_ALBUM_FILE);
+    blankAlbumEntry(album, album.albList[i]);
     delAlbArray.indexes.push_back(i);
 }
 
 namespace {
 
 void pauseAfterExport(const albumList& album) {
-    exportAlbumsToCSV(album, "albums.csv");
+    int format = 0;
+    cout << "\n1. CSV (albums.csv)\n2. JSON Lines (albums.jsonl)\n3. Columnar for analytics (albums.alcol)\nChoice: ";
+    cin >> format;
+    cin.clear();
+    cin.ignore(INT_MAX, '\n');
+    if (format == 2) {
+        exportAlbumsToJsonl(album, "albums.jsonl");
+    } else if (format == 3) {
+        exportAlbumsColumnar(album, "albums.alcol");
+    } else {
+        exportAlbumsToCSV(album, "albums.csv");
+    }
     cout << endl << endl;
     system("pause");
 }
@@ -2503,7 +8799,7 @@ int albumMenu()
         cout<<"\n                                 *Album Menu*               ";
         cout<<"\n\n                       Enter  1 :  >> Album Viewer                           ";
         cout<<"\n\n                       Enter  2 :  >> Album Editor                            ";
-        cout<<"\n\n                       Enter  3 :  >> Export Albums to CSV                              ";
+        cout<<"\n\n                       Enter  3 :  >> Export Albums (CSV/JSONL/Columnar)                ";
         cout<<"\n\n                       Enter  4 :  >> Go To Main Menu                              ";
         cout<<"\n\n                       Enter  5 :  >> EXIT.                              \n\n ";
         cout<<"\n choice:    ";
@@ -2562,12 +8858,14 @@ int viewAlbumMenu()
 //46
 void displayAllAlbums(std::fstream& AlbFile, const albumList& album)
 {
+    ALBUM_TRACE_SCOPE("displayAllAlbums");
     AlbumView::displayAll(AlbFile, album);
 }
 
 //47
 bool searchAlbumByArtistId(std::fstream& AlbFile, const albumList& album, indexSet& result, const std::string& targetId)
 {
+    ALBUM_TIME_SCOPE("search_album_by_artist_id");
     result.indexes.clear();
     for(size_t i = 0; i < album.albList.size(); i++){
         if(album.albList[i].artistId != "-1"){
@@ -2658,15 +8956,12 @@ CommandAction createAddAlbumCommand(Album album, std::fstream& AlbFile, albumLis
 
         int idx = findAlbumIndexById(albumList, state->album.getAlbumId());
         if (idx == -1) {
-            albumList.albList.push_back(albumIndex{state->album.getAlbumId(), state->album.getArtistId(), state->album.getTitle(), state->pos});
-        } else {
-            albumList.albList[idx].albumId = state->album.getAlbumId();
-            albumList.albList[idx].artistId = state->album.getArtistId();
-            albumList.albList[idx].title = state->album.getTitle();
-            albumList.albList[idx].pos = state->pos;
+            albumList.albList.push_back(albumIndex{"-1", "-1", "", state->pos});
+            idx = static_cast<int>(albumList.albList.size()) - 1;
         }
+        assignAlbumEntry(albumList, albumList.albList[idx], state->album, state->pos);
         sortAlbum(albumList);
-        Logger::getInstance()->log("Redo add album: " + state->album.getTitle());
+        ALBUM_LOG_INFO("Redo add album: {}", state->album.getTitle());
         return true;
     };
     action.undo = [&, state]() {
@@ -2677,13 +8972,11 @@ CommandAction createAddAlbumCommand(Album album, std::fstream& AlbFile, albumLis
         std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
         if (ensureAlbumStream(AlbFile)) {
             AlbumFile blank = {"-1", "-1", "", "", "", ""};
-            AlbFile.clear();
-            AlbFile.seekp(state->pos, ios::beg);
-            AlbFile.write(reinterpret_cast<const char*>(&blank), sizeof(AlbumFile));
-            AlbFile.flush();
+            writeRecordAt(AlbFile, state->pos, blank);
         }
+        albumList.stats.remove(albumList.albList[idx]);
         albumList.albList.erase(albumList.albList.begin() + idx);
-        Logger::getInstance()->log("Undo add album: " + state->album.getTitle());
+        ALBUM_LOG_INFO("Undo add album: {}", state->album.getTitle());
     };
 
     return action;
@@ -2692,6 +8985,7 @@ CommandAction createAddAlbumCommand(Album album, std::fstream& AlbFile, albumLis
 //52
 bool addAlbum(std::fstream& ArtFile, std::fstream& AlbFile, const artistList& artist, albumList& album, indexSet& result)
 {
+    ALBUM_TRACE_SCOPE("addAlbum");
     if (!getAddConfirmation("album"))
         return false;
 
@@ -2715,7 +9009,7 @@ bool addAlbum(std::fstream& ArtFile, std::fstream& AlbFile, const artistList& ar
 
     if (!executeCommand(std::move(action))) {
         --lastAlbumID;
-        Logger::getInstance()->log("Failed to add album via command");
+        ALBUM_LOG_ERROR("Failed to add album via command");
         return false;
     }
 
@@ -2862,8 +9156,7 @@ void validateAlbumFormat(const std::string& albumFormat)
 {
     std::string lowerFormat = albumFormat;
     for(char& c : lowerFormat) c = tolower(c);
-    std::vector<std::string> validFormats = {"m4a", "flac", "mp3", "mp4", "wav", "wma", "aac", "dsd", "alac", "aiff"};
-    for(const auto& fmt : validFormats){
+    for(const char* fmt : ALBUM_RECORD_FORMATS){
         if(lowerFormat == fmt) return;
     }
     throw ValidationException("Invalid album record format!");
@@ -2952,6 +9245,7 @@ std::string formatAlbumPath(std::string albumPath)
 //65
 void editAlbum(std::fstream& ArtFile, std::fstream& AlbFile, const artistList& artist, albumList& album, indexSet& result)
 {
+    ALBUM_TRACE_SCOPE("editAlbum");
     system("cls");
     cout << setw(30) << "Edit Album " << endl;
     int select;
@@ -3017,7 +9311,7 @@ bool editAlbumInfo(std::fstream& AlbFile, albumList& album, int idx)
     if (!readAlbumAtPosition(AlbFile, album.albList[idx].pos, original)) {
         cout << "Failed to load album details." << endl;
         system("pause");
-        Logger::getInstance()->log("Failed to read album during edit");
+        ALBUM_LOG_ERROR("Failed to read album during edit");
         return false;
     }
 
@@ -3044,36 +9338,30 @@ bool editAlbumInfo(std::fstream& AlbFile, albumList& album, int idx)
     action.description = "Edit album " + original.getTitle();
     action.redo = [&, state]() -> bool {
         if (!writeAlbumAtPosition(AlbFile, state->pos, state->updated)) {
-            Logger::getInstance()->log("Failed to apply album edit during redo");
+            ALBUM_LOG_ERROR("Failed to apply album edit during redo");
             return false;
         }
         int albumIdx = findAlbumIndexById(album, state->updated.getAlbumId());
         if (albumIdx != -1) {
-            album.albList[albumIdx].albumId = state->updated.getAlbumId();
-            album.albList[albumIdx].artistId = state->updated.getArtistId();
-            album.albList[albumIdx].title = state->updated.getTitle();
-            album.albList[albumIdx].pos = state->pos;
+            assignAlbumEntry(album, album.albList[albumIdx], state->updated, state->pos);
         }
         sortAlbum(album);
         state->applied = true;
-        Logger::getInstance()->log("Redo edit album: " + state->updated.getTitle());
+        ALBUM_LOG_INFO("Redo edit album: {}", state->updated.getTitle());
         return true;
     };
     action.undo = [&, state]() {
         if (!writeAlbumAtPosition(AlbFile, state->pos, state->original)) {
-            Logger::getInstance()->log("Failed to restore album during undo");
+            ALBUM_LOG_ERROR("Failed to restore album during undo");
             return;
         }
         int albumIdx = findAlbumIndexById(album, state->original.getAlbumId());
         if (albumIdx != -1) {
-            album.albList[albumIdx].albumId = state->original.getAlbumId();
-            album.albList[albumIdx].artistId = state->original.getArtistId();
-            album.albList[albumIdx].title = state->original.getTitle();
-            album.albList[albumIdx].pos = state->pos;
+            assignAlbumEntry(album, album.albList[albumIdx], state->original, state->pos);
         }
         sortAlbum(album);
         state->applied = false;
-        Logger::getInstance()->log("Undo edit album: " + state->original.getTitle());
+        ALBUM_LOG_INFO("Undo edit album: {}", state->original.getTitle());
     };
 
     if (!executeCommand(std::move(action))) {
@@ -3215,40 +9503,23 @@ CommandAction createDeleteAllAlbumsCommand(std::shared_ptr<std::vector<AlbumSnap
             if (albumIdx == -1) {
                 continue;
             }
-            AlbFile.clear();
-            AlbFile.seekp(snapshot.pos, ios::beg);
-            AlbFile.write(reinterpret_cast<const char*>(&blank), sizeof(AlbumFile));
-            AlbFile.flush();
-            album.albList[albumIdx].albumId = "-1";
-            album.albList[albumIdx].artistId = "-1";
-            album.albList[albumIdx].title = "";
-            album.albList[albumIdx].pos = snapshot.pos;
+            writeRecordAt(AlbFile, snapshot.pos, blank);
+            blankAlbumEntry(album, album.albList[albumIdx]);
             if (std::find(delAlbArray.indexes.begin(), delAlbArray.indexes.end(), albumIdx) == delAlbArray.indexes.end()) {
                 delAlbArray.indexes.push_back(albumIdx);
             }
         }
-        Logger::getInstance()->log("Redo delete all albums for artist");
+        ALBUM_LOG_INFO("Redo delete all albums for artist");
         return true;
     };
     action.undo = [&, state]() {
         std::fstream AlbFile;
-        for (const auto& snapshot : *state) {
-            if (!writeAlbumAtPosition(AlbFile, snapshot.pos, snapshot.data)) {
-                continue;
-            }
-            int albumIdx = findAlbumIndexById(album, snapshot.data.getAlbumId());
-            if (albumIdx != -1) {
-                album.albList[albumIdx].albumId = snapshot.data.getAlbumId();
-                album.albList[albumIdx].artistId = snapshot.data.getArtistId();
-                album.albList[albumIdx].title = snapshot.data.getTitle();
-                album.albList[albumIdx].pos = snapshot.pos;
-                auto itAlb = std::find(delAlbArray.indexes.begin(), delAlbArray.indexes.end(), albumIdx);
-                if (itAlb != delAlbArray.indexes.end()) {
-                    delAlbArray.indexes.erase(itAlb);
-                }
-            }
+        std::vector<bool> written(state->size());
+        for (std::size_t s = 0; s < written.size(); ++s) {
+            written[s] = writeAlbumAtPosition(AlbFile, (*state)[s].pos, (*state)[s].data);
         }
-        Logger::getInstance()->log("Undo delete all albums for artist");
+        restoreAlbumEntries(album, delAlbArray, *state, written);
+        ALBUM_LOG_INFO("Undo delete all albums for artist");
     };
     return action;
 }
@@ -3271,41 +9542,32 @@ CommandAction createDeleteSingleAlbumCommand(std::shared_ptr<AlbumRemovalState>
             return false;
         }
         AlbumFile blank = {"-1", "-1", "", "", "", ""};
-        AlbFile.clear();
-        AlbFile.seekp(state->pos, ios::beg);
-        AlbFile.write(reinterpret_cast<const char*>(&blank), sizeof(AlbumFile));
-        AlbFile.flush();
+        writeRecordAt(AlbFile, state->pos, blank);
         int albumIdx = findAlbumIndexById(album, state->album.getAlbumId());
         if (albumIdx != -1) {
-            album.albList[albumIdx].albumId = "-1";
-            album.albList[albumIdx].artistId = "-1";
-            album.albList[albumIdx].title = "";
-            album.albList[albumIdx].pos = state->pos;
+            blankAlbumEntry(album, album.albList[albumIdx]);
             if (std::find(delAlbArray.indexes.begin(), delAlbArray.indexes.end(), albumIdx) == delAlbArray.indexes.end()) {
                 delAlbArray.indexes.push_back(albumIdx);
             }
         }
-        Logger::getInstance()->log("Redo delete album: " + state->album.getTitle());
+        ALBUM_LOG_INFO("Redo delete album: {}", state->album.getTitle());
         return true;
     };
     action.undo = [&, state]() {
         std::fstream AlbFile;
         if (!writeAlbumAtPosition(AlbFile, state->pos, state->album)) {
-            Logger::getInstance()->log("Failed to restore album during undo");
+            ALBUM_LOG_ERROR("Failed to restore album during undo");
             return;
         }
-        int albumIdx = findAlbumIndexById(album, state->album.getAlbumId());
+        int albumIdx = findAlbumIndexByPos(album, state->pos);
         if (albumIdx != -1) {
-            album.albList[albumIdx].albumId = state->album.getAlbumId();
-            album.albList[albumIdx].artistId = state->album.getArtistId();
-            album.albList[albumIdx].title = state->album.getTitle();
-            album.albList[albumIdx].pos = state->pos;
+            assignAlbumEntry(album, album.albList[albumIdx], state->album, state->pos);
             auto itAlb = std::find(delAlbArray.indexes.begin(), delAlbArray.indexes.end(), albumIdx);
             if (itAlb != delAlbArray.indexes.end()) {
                 delAlbArray.indexes.erase(itAlb);
             }
         }
-        Logger::getInstance()->log("Undo delete album: " + state->album.getTitle());
+        ALBUM_LOG_INFO("Undo delete album: {}", state->album.getTitle());
     };
     return action;
 }
@@ -3313,6 +9575,7 @@ CommandAction createDeleteSingleAlbumCommand(std::shared_ptr<AlbumRemovalState>
 //69
 void deleteAlbum(std::fstream& ArtFile, std::fstream& AlbFile, const artistList& artist, albumList& album, indexSet& result, indexSet& delAlbArray)
 {
+    ALBUM_TRACE_SCOPE("deleteAlbum");
     system("cls");
     cout << setw(30) << "Delete Album " << endl;
 
@@ -3364,27 +9627,22 @@ void deleteAlbum(std::fstream& ArtFile, std::fstream& AlbFile, const artistList&
 //70
 void removeAlbum(std::fstream& AlbFile, albumList& album, indexSet& delAlbArray, int idx)
 {
-    int pos;
+    ALBUM_TRACE_SCOPE("removeAlbum");
+    long pos;
     AlbumFile BLANK_ALBUM_FILE = {"-1", "-1", "", "", "", ""};
     if (!AlbFile.is_open()) {
         try {
-            openFile(AlbFile, albumFilePath);
+            openRecordFile(AlbFile, albumFilePath, RecordKind::Album);
         } catch (const FileException& e) {
             cout << e.what() << endl;
             system("pause");
-            Logger::getInstance()->log("Failed to open album file for deletion");
+            ALBUM_LOG_ERROR("Failed to open album file for deletion");
             return;
         }
     }
-    AlbFile.clear();
-    AlbFile.seekp(album.albList[idx].pos, ios::beg);
-    pos = AlbFile.tellp();
-    AlbFile.write((char*)&BLANK_ALBUM_FILE, sizeof(AlbumFile));
-    AlbFile.flush();
-    album.albList[idx].albumId = BLANK_ALBUM_FILE.albumIds;
-    album.albList[idx].artistId = BLANK_ALBUM_FILE.artistIdRefs;
-    album.albList[idx].title = BLANK_ALBUM_FILE.titles;
-    album.albList[idx].pos = pos;
+    pos = album.albList[idx].pos;
+    writeRecordAt(AlbFile, pos, BLANK_ALBUM_FILE);
+    blankAlbumEntry(album, album.albList[idx]);
     delAlbArray.indexes.push_back(idx);
     cout << "\n\t Successfully Removed.\n\n";
     system("pause");
@@ -3393,11 +9651,13 @@ void removeAlbum(std::fstream& AlbFile, albumList& album, indexSet& delAlbArray,
 //71
 bool searchAlbumByTitle(std::fstream& AlbFile, const albumList& album, indexSet& result, const std::string& title)
 {
+    ALBUM_TIME_SCOPE("search_album_by_title");
     result.indexes.clear();
     AlbumFile albFile;
     for (size_t i = 0; i < album.albList.size(); i++) {
-        AlbFile.seekg(album.albList[i].pos, ios::beg);
-        AlbFile.read((char*)&albFile, sizeof(albFile));
+        if (readRecordAt(AlbFile, album.albList[i].pos, albFile) != RecordStatus::Ok) {
+            continue;
+        }
         std::string albTitle(albFile.titles);
         if (albTitle.find(title) == 0) {
             result.indexes.push_back(i);
@@ -3408,11 +9668,13 @@ bool searchAlbumByTitle(std::fstream& AlbFile, const albumList& album, indexSet&
 
 bool searchAlbumByDateRange(std::fstream& AlbFile, const albumList& album, indexSet& result, unsigned int startDay, unsigned int startMonth, unsigned int startYear, unsigned int endDay, unsigned int endMonth, unsigned int endYear)
 {
+    ALBUM_TIME_SCOPE("search_album_by_date_range");
     result.indexes.clear();
     AlbumFile albFile;
     for (size_t i = 0; i < album.albList.size(); i++) {
-        AlbFile.seekg(album.albList[i].pos, ios::beg);
-        AlbFile.read((char*)&albFile, sizeof(albFile));
+        if (readRecordAt(AlbFile, album.albList[i].pos, albFile) != RecordStatus::Ok) {
+            continue;
+        }
         std::string dateStr(albFile.datePublished);
         // Parse date DD/MM/YYYY
         unsigned int day = (dateStr[0] - '0') * 10 + (dateStr[1] - '0');
@@ -3453,38 +9715,20 @@ bool ArtistManager::load(std::fstream& ArtFile) {
     }
     
     // Fallback to original implementation if no repository
-    Logger::getInstance()->log("Loading artists from file");
-    ArtistFile artFile;
-    int nRec, pos;
+    ALBUM_TIME_SCOPE("load_artists");
+    ALBUM_LOG_DEBUG("Loading artists from file");
     try {
-        openFile(ArtFile, artistFilePath);
+        openRecordFile(ArtFile, artistFilePath, RecordKind::Artist);
     } catch(const FileException& e) {
         printError(1);
         system("pause");
-        Logger::getInstance()->log("Failed to load artists: " + std::string(e.what()));
+        ALBUM_LOG_ERROR("Failed to load artists: {}", e.what());
         return false;
     }
-    ArtFile.seekg(0, ios::end);
-    nRec = ArtFile.tellg() / sizeof(artFile);
-    artists.artList.reserve(nRec + DEFAULT_SIZE);
-    ArtFile.seekg(0, ios::beg);
-    pos = 0;
-    for (int i = 0; i < nRec; i++){
-        ArtFile.read((char*)&artFile, sizeof(artFile));
-        if(std::string(artFile.artistIds) != "-1"){
-            artists.artList.push_back({std::string(artFile.artistIds), std::string(artFile.names), pos});
-            int currentId = stringToInt(std::string(artFile.artistIds));
-            if(currentId > lastArtistID){
-                lastArtistID = currentId;
-            }
-        }
-        else{
-            deletedArtists.indexes.push_back(pos);
-        }
-        pos = ArtFile.tellg();
-    }
+    indexArtistRecords(ArtFile, artists, deletedArtists);
     sortArtists();
-    Logger::getInstance()->log("Loaded " + std::to_string(artists.artList.size()) + " artists");
+    publishIndexMetrics(artists);
+    ALBUM_LOG_INFO("Loaded {} artists", artists.artList.size());
     return true;
 }
 
@@ -3495,7 +9739,7 @@ void ArtistManager::sortArtists() {
 }
 
 bool ArtistManager::add(std::fstream& ArtFile) {
-    Logger::getInstance()->log("Adding new artist");
+    ALBUM_LOG_DEBUG("Adding new artist");
     char addA;
     system("cls");
     cout << "Do you want to add an artist? (Y/N) : ";
@@ -3505,7 +9749,7 @@ bool ArtistManager::add(std::fstream& ArtFile) {
     {
         if (!ArtFile.is_open()) {
             try {
-                openFile(ArtFile, artistFilePath);
+                openRecordFile(ArtFile, artistFilePath, RecordKind::Artist);
             } catch (const FileException& e) {
                 cout << e.what() << endl;
                 system("pause");
@@ -3513,10 +9757,7 @@ bool ArtistManager::add(std::fstream& ArtFile) {
             }
         }
 
-        ArtFile.clear();
-        ArtFile.seekp(0, ios::end);
-
-        int pos;
+        long pos;
         Artist art = getArtistInfo();
         std::string id = intToString(++lastArtistID, "art");
         art.setArtistId(id);
@@ -3530,12 +9771,14 @@ bool ArtistManager::add(std::fstream& ArtFile) {
         artFile.phones[14] = '\0';
         strncpy(artFile.emails, art.getEmail().c_str(), 49);
         artFile.emails[49] = '\0';
-        pos = ArtFile.tellp();
-        ArtFile.write((char*)&artFile, sizeof(ArtistFile));
-        ArtFile.flush();
+        if (!appendRecord(ArtFile, artFile, pos)) {
+            ALBUM_LOG_ERROR("Failed to append artist record");
+            return false;
+        }
         artists.artList.push_back({art.getArtistId(), art.getName(), pos});
+        ++artists.live;
         sortArtists();
-        Logger::getInstance()->log("Added artist: " + art.getName() + " with ID: " + art.getArtistId());
+        ALBUM_LOG_INFO("Added artist: {} with ID: {}", art.getName(), art.getArtistId());
         return true;
     }else
         return false;
@@ -3607,7 +9850,7 @@ void ArtistManager::displayOne(std::fstream& ArtFile, int idx) const {
 }
 
 void ArtistManager::edit(std::fstream& ArtFile, indexSet& result) {
-    Logger::getInstance()->log("Editing artist");
+    ALBUM_LOG_DEBUG("Editing artist");
     system("cls");
     cout << setw(30) << "Edit Artist " << endl;
     do{
@@ -3615,14 +9858,14 @@ void ArtistManager::edit(std::fstream& ArtFile, indexSet& result) {
         if (result.indexes.empty()){
             printError(4);
             system("pause");
-            Logger::getInstance()->log("No artists found for editing");
+            ALBUM_LOG_INFO("No artists found for editing");
             return;
         }
     }while(result.indexes.empty());
     size_t idx = selectArtist(ArtFile, result, "edit");
     editArtistInfo(ArtFile, artists, idx);
     sortArtists();
-    Logger::getInstance()->log("Artist edited successfully");
+    ALBUM_LOG_INFO("Artist edited successfully");
 }
 
 void ArtistManager::remove(std::fstream& ArtFile, std::fstream& AlbFile, AlbumManager& albumManager, indexSet& result) {
@@ -3644,61 +9887,43 @@ bool ArtistManager::save(std::fstream& ArtFile) {
     }
     
     // Fallback to original implementation if no repository
-    Logger::getInstance()->log("Saving artists to file");
+    ALBUM_LOG_DEBUG("Saving artists to file");
     try {
-        openFile(ArtFile, artistFilePath);
+        openRecordFile(ArtFile, artistFilePath, RecordKind::Artist);
     } catch(const FileException& e) {
         printError(1);
         system("pause");
-        Logger::getInstance()->log("Failed to save artists: " + std::string(e.what()));
+        ALBUM_LOG_ERROR("Failed to save artists: {}", e.what());
         return false;
     }
-    ArtFile.seekp(0, ios::end);
     for (auto& artist : artists.artList) {
         ArtistFile artFile;
+        long pos;
         strcpy(artFile.artistIds, artist.artistId.c_str());
         strcpy(artFile.names, artist.name.c_str());
-        ArtFile.write((char*)&artFile, sizeof(artFile));
+        appendRecord(ArtFile, artFile, pos);
     }
-    Logger::getInstance()->log("Saved " + std::to_string(artists.artList.size()) + " artists");
+    ALBUM_LOG_INFO("Saved {} artists", artists.artList.size());
     return true;
 }
 
 // AlbumManager implementations
 bool AlbumManager::load(std::fstream& AlbFile) {
-    Logger::getInstance()->log("Loading albums from file");
-    AlbumFile albFile;
-    int nRec, pos;
-
+    ALBUM_TIME_SCOPE("load_albums");
+    ALBUM_LOG_DEBUG("Loading albums from file");
     try {
-        openFile(AlbFile, albumFilePath);
+        openRecordFile(AlbFile, albumFilePath, RecordKind::Album);
     } catch(const FileException& e) {
         printError(2);
         system("pause");
-        Logger::getInstance()->log("Failed to load albums: " + std::string(e.what()));
+        ALBUM_LOG_ERROR("Failed to load albums: {}", e.what());
         return false;
     }
-    AlbFile.seekg(0, ios::end);
-    nRec = AlbFile.tellg() / sizeof(albFile);
-    albums.albList.reserve(nRec + DEFAULT_SIZE);
-    AlbFile.seekg(0, ios::beg);
-    pos = 0;
-    for (int i = 0; i < nRec; i++){
-        AlbFile.read((char*)&albFile, sizeof(albFile));
-        if (std::string(albFile.albumIds) != "-1"){
-            albums.albList.push_back(albumIndex{std::string(albFile.albumIds), std::string(albFile.artistIdRefs), std::string(albFile.titles), pos});
-            int currentId = stringToInt(std::string(albFile.albumIds));
-            if (currentId > lastAlbumID){
-                lastAlbumID = currentId;
-            }
-        }
-        else{
-            deletedAlbums.indexes.push_back(pos);
-        }
-        pos = AlbFile.tellg();
-    }
+    indexAlbumRecords(AlbFile, albums, deletedAlbums);
     sortAlbums();
-    Logger::getInstance()->log("Successfully loaded " + std::to_string(albums.albList.size()) + " albums");
+    recountCatalogStatistics(albums);
+    publishIndexMetrics(albums);
+    ALBUM_LOG_INFO("Successfully loaded {} albums", albums.albList.size());
     return true;
 }
 
@@ -3709,7 +9934,7 @@ void AlbumManager::sortAlbums() {
 }
 
 bool AlbumManager::add(std::fstream& ArtFile, std::fstream& AlbFile, const ArtistManager& artistManager, indexSet& result) {
-    Logger::getInstance()->log("Adding new album");
+    ALBUM_LOG_DEBUG("Adding new album");
     char addA;
     do{
         system("cls");
@@ -3719,7 +9944,8 @@ bool AlbumManager::add(std::fstream& ArtFile, std::fstream& AlbFile, const Artis
         cin.ignore(INT_MAX, '\n');
         if (addA == 'y' || addA == 'Y')
         {
-            int pos, select;
+            long pos;
+            int select;
             AlbumFile albFile{};
             while(result.indexes.empty()){
                 artistManager.search(ArtFile, result);
@@ -3737,26 +9963,26 @@ bool AlbumManager::add(std::fstream& ArtFile, std::fstream& AlbFile, const Artis
             albFile.artistIdRefs[7] = '\0';
             if (!AlbFile.is_open()) {
                 try {
-                    openFile(AlbFile, albumFilePath);
+                    openRecordFile(AlbFile, albumFilePath, RecordKind::Album);
                 } catch (const FileException& e) {
                     cout << e.what() << endl;
                     system("pause");
-                    Logger::getInstance()->log("Failed to open album file for adding");
+                    ALBUM_LOG_ERROR("Failed to open album file for adding");
                     return false;
                 }
             }
-            AlbFile.clear();
-            AlbFile.seekp(0, ios::end);
-            pos = AlbFile.tellp();
-            AlbFile.write((char*)&albFile, sizeof(albFile));
-            AlbFile.flush();
-            albums.albList.push_back(albumIndex{std::string(albFile.albumIds), std::string(albFile.artistIdRefs), std::string(albFile.titles), pos});
+            if (!appendRecord(AlbFile, albFile, pos)) {
+                ALBUM_LOG_ERROR("Failed to append album record");
+                return false;
+            }
+            albums.albList.push_back(albumEntryFor(albFile, pos));
+            albums.stats.add(albums.albList.back());
             sortAlbums();
             cout << endl;
             cout << " Album ID: " << albFile.albumIds << endl;
             cout << endl << endl;
             result.indexes.clear();
-            Logger::getInstance()->log("Added album: " + std::string(albFile.titles) + " with ID: " + std::string(albFile.albumIds));
+            ALBUM_LOG_INFO("Added album: {} with ID: {}", albFile.titles, albFile.albumIds);
             return true;
         }else if (addA == 'n' || addA == 'N')
             return false;
@@ -3772,6 +9998,7 @@ void AlbumManager::displayAll(std::fstream& AlbFile) const {
 }
 
 bool AlbumManager::searchByArtistId(std::fstream& AlbFile, indexSet& result, const std::string& targetId) {
+    ALBUM_TIME_SCOPE("search_album_by_artist_id");
     result.indexes.clear();
     for(size_t i = 0; i < albums.albList.size(); i++){
         if(albums.albList[i].artistId != "-1"){
@@ -3840,7 +10067,7 @@ int AlbumManager::selectAlbum(std::fstream& AlbFile, const ArtistManager& artist
 }
 
 void AlbumManager::edit(std::fstream& ArtFile, std::fstream& AlbFile, const ArtistManager& artistManager, indexSet& result) {
-    Logger::getInstance()->log("Editing album");
+    ALBUM_LOG_DEBUG("Editing album");
     system("cls");
     cout << setw(30) << "Edit Album " << endl;
     int select;
@@ -3851,50 +10078,46 @@ void AlbumManager::edit(std::fstream& ArtFile, std::fstream& AlbFile, const Arti
    }
     select = selectAlbum(AlbFile, artistManager, result, select, "edit");
     if(select == -1 ) {
-        Logger::getInstance()->log("Album edit cancelled - no album selected");
+        ALBUM_LOG_INFO("Album edit cancelled - no album selected");
         return;
     }
     while (finish == false && !result.indexes.empty())
         finish = editAlbumInfo(AlbFile, albums, select);
     sortAlbums();
-    Logger::getInstance()->log("Album edited successfully");
+    ALBUM_LOG_INFO("Album edited successfully");
 }
 
 void AlbumManager::remove(std::fstream& AlbFile, indexSet& result, int idx) {
-    Logger::getInstance()->log("Removing album: " + albums.albList[idx].title + " with ID: " + albums.albList[idx].albumId);
-    int pos;
+    ALBUM_LOG_INFO("Removing album: {} with ID: {}", albums.albList[idx].title, albums.albList[idx].albumId);
+    long pos;
     AlbumFile BLANK_ALBUM_FILE = {"-1", "-1", "", "", "", ""};
     if (!AlbFile.is_open()) {
         try {
-            openFile(AlbFile, albumFilePath);
+            openRecordFile(AlbFile, albumFilePath, RecordKind::Album);
         } catch (const FileException& e) {
             cout << e.what() << endl;
             system("pause");
-            Logger::getInstance()->log("Failed to open album file for removal");
+            ALBUM_LOG_ERROR("Failed to open album file for removal");
             return;
         }
     }
-    AlbFile.clear();
-    AlbFile.seekp(albums.albList[idx].pos, ios::beg);
-    pos = AlbFile.tellp();
-    AlbFile.write((char*)&BLANK_ALBUM_FILE, sizeof(AlbumFile));
-    AlbFile.flush();
-    albums.albList[idx].albumId = BLANK_ALBUM_FILE.albumIds;
-    albums.albList[idx].artistId = BLANK_ALBUM_FILE.artistIdRefs;
-    albums.albList[idx].title = BLANK_ALBUM_FILE.titles;
-    albums.albList[idx].pos = pos;
+    pos = albums.albList[idx].pos;
+    writeRecordAt(AlbFile, pos, BLANK_ALBUM_FILE);
+    blankAlbumEntry(albums, albums.albList[idx]);
     deletedAlbums.indexes.push_back(idx);
     cout << "\n\t Successfully Removed.\n\n";
     system("pause");
-    Logger::getInstance()->log("Album removed successfully");
+    ALBUM_LOG_INFO("Album removed successfully");
 }
 
 bool AlbumManager::searchByTitle(std::fstream& AlbFile, indexSet& result, const std::string& title) {
+    ALBUM_TIME_SCOPE("search_album_by_title");
     result.indexes.clear();
     AlbumFile albFile;
     for (size_t i = 0; i < albums.albList.size(); i++) {
-        AlbFile.seekg(albums.albList[i].pos, ios::beg);
-        AlbFile.read((char*)&albFile, sizeof(albFile));
+        if (readRecordAt(AlbFile, albums.albList[i].pos, albFile) != RecordStatus::Ok) {
+            continue;
+        }
         std::string albTitle(albFile.titles);
         if (albTitle.find(title) == 0) {
             result.indexes.push_back(i);
@@ -3904,11 +10127,13 @@ bool AlbumManager::searchByTitle(std::fstream& AlbFile, indexSet& result, const
 }
 
 bool AlbumManager::searchByDateRange(std::fstream& AlbFile, indexSet& result, unsigned int startDay, unsigned int startMonth, unsigned int startYear, unsigned int endDay, unsigned int endMonth, unsigned int endYear) {
+    ALBUM_TIME_SCOPE("search_album_by_date_range");
     result.indexes.clear();
     AlbumFile albFile;
     for (size_t i = 0; i < albums.albList.size(); i++) {
-        AlbFile.seekg(albums.albList[i].pos, ios::beg);
-        AlbFile.read((char*)&albFile, sizeof(albFile));
+        if (readRecordAt(AlbFile, albums.albList[i].pos, albFile) != RecordStatus::Ok) {
+            continue;
+        }
         std::string dateStr(albFile.datePublished);
         // Parse date DD/MM/YYYY
         unsigned int day = (dateStr[0] - '0') * 10 + (dateStr[1] - '0');
@@ -3929,24 +10154,24 @@ bool AlbumManager::save(std::fstream& AlbFile) {
     }
     
     // Fallback to original implementation if no repository
-    Logger::getInstance()->log("Saving albums to file");
+    ALBUM_LOG_DEBUG("Saving albums to file");
     try {
-        openFile(AlbFile, albumFilePath);
+        openRecordFile(AlbFile, albumFilePath, RecordKind::Album);
     } catch(const FileException& e) {
         printError(2);
         system("pause");
-        Logger::getInstance()->log("Failed to save albums: " + std::string(e.what()));
+        ALBUM_LOG_ERROR("Failed to save albums: {}", e.what());
         return false;
     }
-    AlbFile.seekp(0, ios::end);
     for (auto& album : albums.albList) {
         AlbumFile albFile;
+        long pos;
         strcpy(albFile.albumIds, album.albumId.c_str());
         strcpy(albFile.artistIdRefs, album.artistId.c_str());
         strcpy(albFile.titles, album.title.c_str());
-        AlbFile.write((char*)&albFile, sizeof(albFile));
+        appendRecord(AlbFile, albFile, pos);
     }
-    Logger::getInstance()->log("Saved " + std::to_string(albums.albList.size()) + " albums");
+    ALBUM_LOG_INFO("Saved {} albums", albums.albList.size());
     return true;
 }
 
@@ -3974,42 +10199,24 @@ void FileHandler::openFile(std::fstream& fstr, const std::string& path) {
 
 // Repository Implementations
 bool FileArtistRepository::loadArtists(artistList& artists, indexSet& deletedArtists) {
-    Logger::getInstance()->log("Loading artists from file via repository");
+    ALBUM_TIME_SCOPE("load_artists");
+    ALBUM_LOG_DEBUG("Loading artists from file via repository");
     cout << "Loading artists..." << endl;
     std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
     
     fileStream = std::make_unique<std::fstream>();
     try {
-        openFile(*fileStream, filePath);
+        openRecordFile(*fileStream, filePath, RecordKind::Artist);
     } catch(const FileException& e) {
-        Logger::getInstance()->log("Failed to open artist file: " + std::string(e.what()));
+        ALBUM_LOG_ERROR("Failed to open artist file: {}", e.what());
         return false;
     }
     
-    ArtistFile artFile;
-    int nRec, pos;
-    fileStream->seekg(0, std::ios::end);
-    nRec = fileStream->tellg() / sizeof(artFile);
-    artists.artList.reserve(nRec + DEFAULT_SIZE);
-    fileStream->seekg(0, std::ios::beg);
-    pos = 0;
-    
-    for (int i = 0; i < nRec; i++) {
-        fileStream->read((char*)&artFile, sizeof(artFile));
-        if (std::string(artFile.artistIds) != "-1") {
-            artists.artList.push_back({std::string(artFile.artistIds), std::string(artFile.names), pos});
-            int currentId = stringToInt(std::string(artFile.artistIds));
-            if (currentId > lastArtistID) {
-                lastArtistID = currentId;
-            }
-        } else {
-            deletedArtists.indexes.push_back(pos);
-        }
-        pos = fileStream->tellg();
-    }
+    indexArtistRecords(*fileStream, artists, deletedArtists);
     
     sortArtist(artists);
-    Logger::getInstance()->log("Loaded " + std::to_string(artists.artList.size()) + " artists");
+    publishIndexMetrics(artists);
+    ALBUM_LOG_INFO("Loaded {} artists", artists.artList.size());
     return true;
 }
 
@@ -4018,9 +10225,9 @@ bool FileArtistRepository::saveArtist(const Artist& artist) {
     if (!fileStream || !fileStream->is_open()) {
         fileStream = std::make_unique<std::fstream>();
         try {
-            openFile(*fileStream, filePath);
+            openRecordFile(*fileStream, filePath, RecordKind::Artist);
         } catch(const FileException& e) {
-            Logger::getInstance()->log("Failed to open artist file for saving: " + std::string(e.what()));
+            ALBUM_LOG_ERROR("Failed to open artist file for saving: {}", e.what());
             return false;
         }
     }
@@ -4036,12 +10243,13 @@ bool FileArtistRepository::saveArtist(const Artist& artist) {
     strncpy(artFile.emails, artist.getEmail().c_str(), 49);
     artFile.emails[49] = '\0';
     
-    fileStream->clear();
-    fileStream->seekp(0, std::ios::end);
-    fileStream->write((char*)&artFile, sizeof(ArtistFile));
-    fileStream->flush();
+    long pos = 0;
+    if (!appendRecord(*fileStream, artFile, pos)) {
+        ALBUM_LOG_ERROR("Failed to append artist record to {}", filePath);
+        return false;
+    }
     
-    Logger::getInstance()->log("Saved artist: " + artist.getName());
+    ALBUM_LOG_DEBUG("Saved artist: {}", artist.getName());
     return true;
 }
 
@@ -4050,9 +10258,9 @@ bool FileArtistRepository::updateArtist(const Artist& artist, int position) {
     if (!fileStream || !fileStream->is_open()) {
         fileStream = std::make_unique<std::fstream>();
         try {
-            openFile(*fileStream, filePath);
+            openRecordFile(*fileStream, filePath, RecordKind::Artist);
         } catch(const FileException& e) {
-            Logger::getInstance()->log("Failed to open artist file for updating: " + std::string(e.what()));
+            ALBUM_LOG_ERROR("Failed to open artist file for updating: {}", e.what());
             return false;
         }
     }
@@ -4068,12 +10276,12 @@ bool FileArtistRepository::updateArtist(const Artist& artist, int position) {
     strncpy(artFile.emails, artist.getEmail().c_str(), 49);
     artFile.emails[49] = '\0';
     
-    fileStream->clear();
-    fileStream->seekp(position, std::ios::beg);
-    fileStream->write((char*)&artFile, sizeof(ArtistFile));
-    fileStream->flush();
+    if (!writeRecordAt(*fileStream, position, artFile)) {
+        ALBUM_LOG_ERROR("Failed to write artist record at position {}", position);
+        return false;
+    }
     
-    Logger::getInstance()->log("Updated artist: " + artist.getName());
+    ALBUM_LOG_DEBUG("Updated artist: {}", artist.getName());
     return true;
 }
 
@@ -4082,38 +10290,41 @@ bool FileArtistRepository::deleteArtist(int position) {
     if (!fileStream || !fileStream->is_open()) {
         fileStream = std::make_unique<std::fstream>();
         try {
-            openFile(*fileStream, filePath);
+            openRecordFile(*fileStream, filePath, RecordKind::Artist);
         } catch(const FileException& e) {
-            Logger::getInstance()->log("Failed to open artist file for deletion: " + std::string(e.what()));
+            ALBUM_LOG_ERROR("Failed to open artist file for deletion: {}", e.what());
             return false;
         }
     }
     
     ArtistFile BLANK_ARTIST_FILE = {"-1", "", 'N', "", ""};
-    fileStream->clear();
-    fileStream->seekp(position, std::ios::beg);
-    fileStream->write((char*)&BLANK_ARTIST_FILE, sizeof(ArtistFile));
-    fileStream->flush();
+    if (!writeRecordAt(*fileStream, position, BLANK_ARTIST_FILE)) {
+        ALBUM_LOG_ERROR("Failed to write artist record at position {}", position);
+        return false;
+    }
     
-    Logger::getInstance()->log("Deleted artist at position: " + std::to_string(position));
+    ALBUM_LOG_DEBUG("Deleted artist at position: {}", position);
     return true;
 }
 
 bool FileArtistRepository::saveArtists(const artistList& artists, const indexSet& deletedArtists) {
-    Logger::getInstance()->log("Saving all artists to file via repository");
+    ALBUM_TRACE_SCOPE("FileArtistRepository::saveArtists");
+    ALBUM_LOG_DEBUG("Saving all artists to file via repository");
     std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
     
     fileStream = std::make_unique<std::fstream>();
     try {
-        openFile(*fileStream, filePath);
+        openRecordFile(*fileStream, filePath, RecordKind::Artist);
     } catch(const FileException& e) {
-        Logger::getInstance()->log("Failed to open artist file for saving: " + std::string(e.what()));
+        ALBUM_LOG_ERROR("Failed to open artist file for saving: {}", e.what());
         return false;
     }
     
     // Clear the file and rewrite all artists
     fileStream->close();
     fileStream = std::make_unique<std::fstream>(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    writeRecordFileHeader(*fileStream, RecordKind::Artist);
+    long pos = RECORD_HEADER_SIZE;
     
     for (const auto& artist : artists.artList) {
         ArtistFile artFile;
@@ -4126,57 +10337,41 @@ bool FileArtistRepository::saveArtists(const artistList& artists, const indexSet
         strcpy(artFile.phones, "");
         strcpy(artFile.emails, "");
         
-        fileStream->write((char*)&artFile, sizeof(ArtistFile));
+        writeRecordAt(*fileStream, pos, artFile);
+        pos += ARTIST_RECORD_SIZE;
     }
     
     fileStream->close();
-    Logger::getInstance()->log("Saved " + std::to_string(artists.artList.size()) + " artists");
+    ALBUM_LOG_INFO("Saved {} artists", artists.artList.size());
     return true;
 }
 
 bool FileArtistRepository::searchArtists(const std::string& query, indexSet& results, bool byId) {
     // This would require access to the artist list, so for now we'll return false
-    Logger::getInstance()->log("Artist search not implemented in repository yet");
+    ALBUM_LOG_WARN("Artist search not implemented in repository yet");
     return false;
 }
 
 bool FileAlbumRepository::loadAlbums(albumList& albums, indexSet& deletedAlbums) {
-    Logger::getInstance()->log("Loading albums from file via repository");
+    ALBUM_TIME_SCOPE("load_albums");
+    ALBUM_LOG_DEBUG("Loading albums from file via repository");
     cout << "Loading albums..." << endl;
     std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
     
     fileStream = std::make_unique<std::fstream>();
     try {
-        openFile(*fileStream, filePath);
+        openRecordFile(*fileStream, filePath, RecordKind::Album);
     } catch(const FileException& e) {
-        Logger::getInstance()->log("Failed to open album file: " + std::string(e.what()));
+        ALBUM_LOG_ERROR("Failed to open album file: {}", e.what());
         return false;
     }
     
-    AlbumFile albFile;
-    int nRec, pos;
-    fileStream->seekg(0, std::ios::end);
-    nRec = fileStream->tellg() / sizeof(albFile);
-    albums.albList.reserve(nRec + DEFAULT_SIZE);
-    fileStream->seekg(0, std::ios::beg);
-    pos = 0;
-    
-    for (int i = 0; i < nRec; i++) {
-        fileStream->read((char*)&albFile, sizeof(albFile));
-        if (std::string(albFile.albumIds) != "-1") {
-            albums.albList.push_back(albumIndex{std::string(albFile.albumIds), std::string(albFile.artistIdRefs), std::string(albFile.titles), pos});
-            int currentAlbumId = stringToInt(std::string(albFile.albumIds));
-            if (currentAlbumId > lastAlbumID) {
-                lastAlbumID = currentAlbumId;
-            }
-        } else {
-            deletedAlbums.indexes.push_back(pos);
-        }
-        pos = fileStream->tellg();
-    }
+    indexAlbumRecords(*fileStream, albums, deletedAlbums);
     
     sortAlbum(albums);
-    Logger::getInstance()->log("Loaded " + std::to_string(albums.albList.size()) + " albums");
+    recountCatalogStatistics(albums);
+    publishIndexMetrics(albums);
+    ALBUM_LOG_INFO("Loaded {} albums", albums.albList.size());
     return true;
 }
 
@@ -4185,9 +10380,9 @@ bool FileAlbumRepository::saveAlbum(const Album& album) {
     if (!fileStream || !fileStream->is_open()) {
         fileStream = std::make_unique<std::fstream>();
         try {
-            openFile(*fileStream, filePath);
+            openRecordFile(*fileStream, filePath, RecordKind::Album);
         } catch(const FileException& e) {
-            Logger::getInstance()->log("Failed to open album file for saving: " + std::string(e.what()));
+            ALBUM_LOG_ERROR("Failed to open album file for saving: {}", e.what());
             return false;
         }
     }
@@ -4204,12 +10399,13 @@ bool FileAlbumRepository::saveAlbum(const Album& album) {
     albFile.datePublished[10] = '\0';
     strcpy(albFile.paths, album.getPath().c_str());
     
-    fileStream->clear();
-    fileStream->seekp(0, std::ios::end);
-    fileStream->write((char*)&albFile, sizeof(AlbumFile));
-    fileStream->flush();
+    long pos = 0;
+    if (!appendRecord(*fileStream, albFile, pos)) {
+        ALBUM_LOG_ERROR("Failed to append album record to {}", filePath);
+        return false;
+    }
     
-    Logger::getInstance()->log("Saved album: " + album.getTitle());
+    ALBUM_LOG_DEBUG("Saved album: {}", album.getTitle());
     return true;
 }
 
@@ -4218,9 +10414,9 @@ bool FileAlbumRepository::updateAlbum(const Album& album, int position) {
     if (!fileStream || !fileStream->is_open()) {
         fileStream = std::make_unique<std::fstream>();
         try {
-            openFile(*fileStream, filePath);
+            openRecordFile(*fileStream, filePath, RecordKind::Album);
         } catch(const FileException& e) {
-            Logger::getInstance()->log("Failed to open album file for updating: " + std::string(e.what()));
+            ALBUM_LOG_ERROR("Failed to open album file for updating: {}", e.what());
             return false;
         }
     }
@@ -4237,12 +10433,12 @@ bool FileAlbumRepository::updateAlbum(const Album& album, int position) {
     albFile.datePublished[10] = '\0';
     strcpy(albFile.paths, album.getPath().c_str());
     
-    fileStream->clear();
-    fileStream->seekp(position, std::ios::beg);
-    fileStream->write((char*)&albFile, sizeof(AlbumFile));
-    fileStream->flush();
+    if (!writeRecordAt(*fileStream, position, albFile)) {
+        ALBUM_LOG_ERROR("Failed to write album record at position {}", position);
+        return false;
+    }
     
-    Logger::getInstance()->log("Updated album: " + album.getTitle());
+    ALBUM_LOG_DEBUG("Updated album: {}", album.getTitle());
     return true;
 }
 
@@ -4251,57 +10447,60 @@ bool FileAlbumRepository::deleteAlbum(int position) {
     if (!fileStream || !fileStream->is_open()) {
         fileStream = std::make_unique<std::fstream>();
         try {
-            openFile(*fileStream, filePath);
+            openRecordFile(*fileStream, filePath, RecordKind::Album);
         } catch(const FileException& e) {
-            Logger::getInstance()->log("Failed to open album file for deletion: " + std::string(e.what()));
+            ALBUM_LOG_ERROR("Failed to open album file for deletion: {}", e.what());
             return false;
         }
     }
     
     AlbumFile BLANK_ALBUM_FILE = {"-1", "-1", "", "", "", ""};
-    fileStream->clear();
-    fileStream->seekp(position, std::ios::beg);
-    fileStream->write((char*)&BLANK_ALBUM_FILE, sizeof(AlbumFile));
-    fileStream->flush();
+    if (!writeRecordAt(*fileStream, position, BLANK_ALBUM_FILE)) {
+        ALBUM_LOG_ERROR("Failed to write album record at position {}", position);
+        return false;
+    }
     
-    Logger::getInstance()->log("Deleted album at position: " + std::to_string(position));
+    ALBUM_LOG_DEBUG("Deleted album at position: {}", position);
     return true;
 }
 
 bool FileAlbumRepository::searchAlbumsByArtist(const std::string& artistId, indexSet& results) {
     // This would require access to the album list, so for now we'll return false
-    Logger::getInstance()->log("Album search by artist not implemented in repository yet");
+    ALBUM_LOG_WARN("Album search by artist not implemented in repository yet");
     return false;
 }
 
 bool FileAlbumRepository::searchAlbumsByTitle(const std::string& title, indexSet& results) {
     // This would require access to the album list, so for now we'll return false
-    Logger::getInstance()->log("Album search by title not implemented in repository yet");
+    ALBUM_LOG_WARN("Album search by title not implemented in repository yet");
     return false;
 }
 
 bool FileAlbumRepository::searchAlbumsByDateRange(unsigned int startDay, unsigned int startMonth, unsigned int startYear,
                                                 unsigned int endDay, unsigned int endMonth, unsigned int endYear, indexSet& results) {
     // This would require access to the album list, so for now we'll return false
-    Logger::getInstance()->log("Album search by date range not implemented in repository yet");
+    ALBUM_LOG_WARN("Album search by date range not implemented in repository yet");
     return false;
 }
 
 bool FileAlbumRepository::saveAlbums(const albumList& albums, const indexSet& deletedAlbums) {
-    Logger::getInstance()->log("Saving all albums to file via repository");
+    ALBUM_TRACE_SCOPE("FileAlbumRepository::saveAlbums");
+    ALBUM_LOG_DEBUG("Saving all albums to file via repository");
     std::lock_guard<std::recursive_mutex> lock(g_fileMutex);
     
     fileStream = std::make_unique<std::fstream>();
     try {
-        openFile(*fileStream, filePath);
+        openRecordFile(*fileStream, filePath, RecordKind::Album);
     } catch(const FileException& e) {
-        Logger::getInstance()->log("Failed to open album file for saving: " + std::string(e.what()));
+        ALBUM_LOG_ERROR("Failed to open album file for saving: {}", e.what());
         return false;
     }
     
     // Clear the file and rewrite all albums
     fileStream->close();
     fileStream = std::make_unique<std::fstream>(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    writeRecordFileHeader(*fileStream, RecordKind::Album);
+    long pos = RECORD_HEADER_SIZE;
     
     for (const auto& album : albums.albList) {
         AlbumFile albFile;
@@ -4316,60 +10515,206 @@ bool FileAlbumRepository::saveAlbums(const albumList& albums, const indexSet& de
         strcpy(albFile.datePublished, "01/01/2023");
         strcpy(albFile.paths, "C:\\Music");
         
-        fileStream->write((char*)&albFile, sizeof(AlbumFile));
+        writeRecordAt(*fileStream, pos, albFile);
+        pos += ALBUM_RECORD_SIZE;
     }
     
     fileStream->close();
-    Logger::getInstance()->log("Saved " + std::to_string(albums.albList.size()) + " albums");
+    ALBUM_LOG_INFO("Saved {} albums", albums.albList.size());
     return true;
 }
 
 // ArtistView implementations
-void ArtistView::displayAll(const artistList& artists) {
+namespace {
+
+const std::size_t DISPLAY_NUMBER_WIDTH = 8;
+
+// Copies a sanitized record field into a table cell, padding like setw(width) << left.
+void appendDisplayCell(std::string& out, const char* text, std::size_t capacity, std::size_t width) {
+    std::size_t length = strnlen(text, capacity - 1);
+    out.append(text, length);
+    if (length < width) {
+        out.append(width - length, ' ');
+    }
+}
+
+void appendDisplayNumber(std::string& out, std::size_t number) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    appendDisplayCell(out, digits, static_cast<std::size_t>(result.ptr - digits) + 1, DISPLAY_NUMBER_WIDTH);
+}
+
+void appendCorruptRow(std::string& out, std::size_t number, long pos) {
+    appendDisplayNumber(out, number);
+    out += "[corrupt record at offset ";
+    out += std::to_string(pos);
+    out += "]\n";
+}
+
+// Index position reached by moving count live entries forward from position from: the first
+// live entry at or after it when count is 0, entries.size() when there are not enough.
+template <typename Entries, typename IsLive>
+std::size_t skipLiveForward(const Entries& entries, std::size_t from, std::size_t count, IsLive isLive) {
+    for (std::size_t i = from; i < entries.size(); ++i) {
+        if (isLive(entries[i]) && count-- == 0) {
+            return i;
+        }
+    }
+    return entries.size();
+}
+
+// Index position of the count-th live entry before position from, or 0 if there are fewer.
+template <typename Entries, typename IsLive>
+std::size_t skipLiveBackward(const Entries& entries, std::size_t from, std::size_t count, IsLive isLive) {
+    std::size_t i = std::min(from, entries.size());
+    while (count > 0 && i > 0) {
+        if (isLive(entries[--i])) {
+            --count;
+        }
+    }
+    return i;
+}
+
+// Start of page target given that page current starts at index position first. Walks from
+// whichever of the index start, the current page and the index end is fewest live entries
+// away; live is the maintained live count, so nothing is counted here.
+template <typename Entries, typename IsLive>
+std::size_t findPageStart(const Entries& entries, std::size_t live, std::size_t first, std::size_t current,
+                          std::size_t target, std::size_t rows, IsLive isLive) {
+    rows = std::max<std::size_t>(1, rows);
+    const std::size_t wanted = target * rows;
+    if (wanted >= live) {
+        return entries.size();
+    }
+    const std::size_t here = current * rows;
+    const std::size_t fromHere = wanted > here ? wanted - here : here - wanted;
+    const std::size_t fromEnd = live - wanted;
+    if (wanted <= fromHere && wanted <= fromEnd) {
+        return skipLiveForward(entries, 0, wanted, isLive);
+    }
+    if (fromEnd < fromHere) {
+        return skipLiveBackward(entries, entries.size(), fromEnd, isLive);
+    }
+    return wanted >= here ? skipLiveForward(entries, first, fromHere, isLive)
+                          : skipLiveBackward(entries, first, fromHere, isLive);
+}
+
+// Shows live entries one page at a time. seek(first, current, target) finds where page target
+// starts given that page current starts at index position first; render(first, rows, number,
+// out) formats the page starting there into the reused buffer, which is written with a single
+// call. Enter or n moves on (leaving after the last page), p goes back, a page number jumps
+// and q leaves.
+void runPagedView(std::size_t live, std::size_t pageRows,
+                  const std::function<std::size_t(std::size_t, std::size_t, std::size_t)>& seek,
+                  const std::function<std::size_t(std::size_t, std::size_t, std::size_t, std::string&)>& render,
+                  const char* emptyMessage) {
+    const std::size_t pages = (live + pageRows - 1) / pageRows;
     system("cls");
-    ArtistFile artFile;
-    int idx = 0;
-    std::fstream ArtFile("Artist.bin", std::ios::in | std::ios::binary);
-    if (!ArtFile.is_open()) {
-        cout << "Error opening Artist.bin" << endl;
+    if (pages == 0) {
+        cout << emptyMessage << endl << endl;
         system("pause");
         return;
     }
-    ArtFile.seekg(0, ios::beg);
-    while (ArtFile.read((char*)&artFile, sizeof(artFile))) {
-        artFile.artistIds[7] = '\0';
-        artFile.names[49] = '\0';
-        artFile.phones[14] = '\0';
-        artFile.emails[49] = '\0';
-        // Sanitize strings to replace non-printable characters with spaces
-        for (size_t j = 0; j < sizeof(artFile.names) && artFile.names[j]; ++j) {
-            if (!isprint(artFile.names[j])) artFile.names[j] = ' ';
-        }
-        for (size_t j = 0; j < sizeof(artFile.artistIds) && artFile.artistIds[j]; ++j) {
-            if (!isprint(artFile.artistIds[j])) artFile.artistIds[j] = ' ';
-        }
-        for (size_t j = 0; j < sizeof(artFile.phones) && artFile.phones[j]; ++j) {
-            if (!isprint(artFile.phones[j])) artFile.phones[j] = ' ';
+    std::string page;
+    std::string command;
+    std::size_t current = 0;
+    std::size_t first = seek(0, 0, 0);
+    while (true) {
+        std::size_t number = current * pageRows + 1;
+        std::size_t shown = render(first, pageRows, number, page);
+        char footer[160];
+        std::snprintf(footer, sizeof(footer),
+                      "\n  Page %zu of %zu - entries %zu to %zu of %zu\n"
+                      "  [Enter/n] next   [p] previous   [number] go to page   [q] back: ",
+                      current + 1, pages, number, number + shown - 1, live);
+        page += footer;
+        cout.write(page.data(), static_cast<std::streamsize>(page.size()));
+        cout.flush();
+        if (!std::getline(cin, command)) {
+            cin.clear();
+            return;
         }
-        for (size_t j = 0; j < sizeof(artFile.emails) && artFile.emails[j]; ++j) {
-            if (!isprint(artFile.emails[j])) artFile.emails[j] = ' ';
+        command = sanitizeStringInput(command, 16);
+        if (command.empty() || command == "n" || command == "N") {
+            if (current + 1 == pages) {
+                return;
+            }
+            first = seek(first, current, current + 1);
+            ++current;
+        } else if (command == "p" || command == "P") {
+            if (current > 0) {
+                first = seek(first, current, current - 1);
+                --current;
+            }
+        } else if (command == "q" || command == "Q") {
+            return;
+        } else {
+            std::size_t target = 0;
+            const char* begin = command.data() + (command[0] == 'j' || command[0] == 'J' ? 1 : 0);
+            auto parsed = std::from_chars(begin, command.data() + command.size(), target);
+            if (parsed.ec == std::errc() && target >= 1) {
+                target = std::min(target, pages) - 1;
+                first = seek(first, current, target);
+                current = target;
+            }
         }
-        if (!isprint(artFile.genders)) artFile.genders = ' ';
-        if (std::string(artFile.artistIds) != "-1") {
-    if (idx == 0) {
-        cout << left << setw(5) << "No" << setw(10) << "Ids" << setw(25) << "Names" << setw(8) << "Gender" << setw(15) << "Phone" << setw(30) << "Email" << endl;
-        cout << string(93, '-') << endl;
+        system("cls");
     }
-    cout << left << setw(5) << ++idx << setw(10) << artFile.artistIds << setw(25) << artFile.names << setw(8) << artFile.genders << setw(15) << artFile.phones << setw(30) << artFile.emails << endl;
+}
+
+} // namespace
+
+std::size_t ArtistView::pageStart(const artistList& artists, std::size_t first, std::size_t current, std::size_t target,
+                                  std::size_t rows) {
+    return findPageStart(artists.artList, artists.live, first, current, target, rows,
+                         [](const artistIndex& entry) { return entry.artistId != "-1"; });
+}
+
+std::size_t ArtistView::renderPage(std::istream& ArtFile, const artistList& artists, std::size_t first, std::size_t rows,
+                                   std::size_t number, std::string& out) {
+    out.clear();
+    out += "No      Ids       Names                    Gender  Phone          Email\n";
+    out.append(96, '-');
+    out += '\n';
+    std::size_t shown = 0;
+    ArtistFile artFile;
+    for (std::size_t i = first; i < artists.artList.size() && shown < rows; ++i) {
+        const artistIndex& entry = artists.artList[i];
+        if (entry.artistId == "-1") {
+            continue;
         }
+        std::size_t row = number + shown++;
+        if (RecordCache::instance().read(ArtFile, entry.pos, artFile) != RecordStatus::Ok) {
+            appendCorruptRow(out, row, entry.pos);
+            continue;
+        }
+        appendDisplayNumber(out, row);
+        appendDisplayCell(out, artFile.artistIds, sizeof(artFile.artistIds), 10);
+        appendDisplayCell(out, artFile.names, sizeof(artFile.names), 25);
+        appendDisplayCell(out, &artFile.genders, 2, 8);
+        appendDisplayCell(out, artFile.phones, sizeof(artFile.phones), 15);
+        appendDisplayCell(out, artFile.emails, sizeof(artFile.emails), 0);
+        out += '\n';
     }
-    ArtFile.close();
-    if(idx == 0){
-        system("cls");
-        cout << "\nThere is nothing to display.\n" ;
+    return shown;
+}
+
+void ArtistView::displayAll(const artistList& artists) {
+    std::ifstream ArtFile(artistFilePath.str(), std::ios::binary);
+    if (!ArtFile.is_open()) {
+        cout << "Error opening " << artistFilePath.str() << endl;
+        system("pause");
+        return;
     }
-    cout << endl << endl;
-    system("pause");
+    const std::size_t pageRows = static_cast<std::size_t>(std::max(1, AppConfig::instance().settings().pageRows));
+    runPagedView(artists.live, pageRows,
+                 [&](std::size_t first, std::size_t current, std::size_t target) {
+                     return pageStart(artists, first, current, target, pageRows);
+                 },
+                 [&](std::size_t first, std::size_t rows, std::size_t number, std::string& out) {
+                     return renderPage(ArtFile, artists, first, rows, number, out);
+                 },
+                 "\nThere is nothing to display.\n");
 }
 
 void ArtistView::displaySearchResult(const artistList& artists, const indexSet& result) {
@@ -4382,34 +10727,18 @@ void ArtistView::displaySearchResult(const artistList& artists, const indexSet&
         cout << "\t" << result.indexes.size() << " artist found." << endl << endl;
         cout << left << setw(5) << "No" << setw(10) << "Ids" << setw(25) << "Names" << setw(8) << "Gender" << setw(15) << "Phone" << setw(30) << "Email" << endl;
         cout << string(93, '-') << endl;
-        std::fstream ArtFile("Artist.bin", std::ios::in | std::ios::binary);
+        std::fstream ArtFile(artistFilePath.str(), std::ios::in | std::ios::binary);
         if (!ArtFile.is_open()) {
-            cout << "Error opening Artist.bin" << endl;
+            cout << "Error opening " << artistFilePath.str() << endl;
             return;
         }
         for (size_t i = 0; i < result.indexes.size(); i++)
         {
             size_t target_idx = result.indexes[i];
-            ArtFile.seekg(artists.artList[target_idx].pos, ios::beg);
-            ArtFile.read((char*)&artFile, sizeof(ArtistFile));
-            artFile.artistIds[7] = '\0';
-            artFile.names[49] = '\0';
-            artFile.phones[14] = '\0';
-            artFile.emails[49] = '\0';
-            // Sanitize strings to replace non-printable characters with spaces
-            for (size_t j = 0; j < sizeof(artFile.names) && artFile.names[j]; ++j) {
-                if (!isprint(artFile.names[j])) artFile.names[j] = ' ';
-            }
-            for (size_t j = 0; j < sizeof(artFile.artistIds) && artFile.artistIds[j]; ++j) {
-                if (!isprint(artFile.artistIds[j])) artFile.artistIds[j] = ' ';
-            }
-            for (size_t j = 0; j < sizeof(artFile.phones) && artFile.phones[j]; ++j) {
-                if (!isprint(artFile.phones[j])) artFile.phones[j] = ' ';
-            }
-            for (size_t j = 0; j < sizeof(artFile.emails) && artFile.emails[j]; ++j) {
-                if (!isprint(artFile.emails[j])) artFile.emails[j] = ' ';
-            }
-            if (!isprint(artFile.genders)) artFile.genders = ' ';
+            if (RecordCache::instance().read(ArtFile, artists.artList[target_idx].pos, artFile) != RecordStatus::Ok) {
+                cout << left << setw(5) << i+1 << "[corrupt record at offset " << artists.artList[target_idx].pos << "]" << endl;
+                continue;
+            }
             cout << left << setw(5) << i+1 << setw(10) << artFile.artistIds << setw(25) << artFile.names << setw(8) << artFile.genders << setw(15) << artFile.phones << setw(30) << artFile.emails << endl;
         }
         ArtFile.close();
@@ -4424,39 +10753,25 @@ void ArtistView::displayOne(const artistList& artists, int idx) {
     }
 
     ArtistFile artFile{};
-    std::fstream ArtFile("Artist.bin", std::ios::in | std::ios::binary);
+    std::fstream ArtFile(artistFilePath.str(), std::ios::in | std::ios::binary);
     if (!ArtFile.is_open()) {
-        cout << "Error opening Artist.bin" << endl;
+        cout << "Error opening " << artistFilePath.str() << endl;
         system("pause");
         return;
     }
 
-    ArtFile.seekg(artists.artList[idx].pos, ios::beg);
-    if (!ArtFile.read((char*)&artFile, sizeof(artFile))) {
-        cout << "Failed to read artist details." << endl;
+    RecordStatus status = RecordCache::instance().read(ArtFile, artists.artList[idx].pos, artFile);
+    if (status != RecordStatus::Ok) {
+        if (status == RecordStatus::Corrupt) {
+            cout << "Artist record at offset " << artists.artList[idx].pos << " is corrupt." << endl;
+        } else {
+            cout << "Failed to read artist details." << endl;
+        }
         system("pause");
         ArtFile.close();
         return;
     }
 
-    artFile.artistIds[7] = '\0';
-    artFile.names[49] = '\0';
-    artFile.phones[14] = '\0';
-    artFile.emails[49] = '\0';
-    for (size_t j = 0; j < sizeof(artFile.names) && artFile.names[j]; ++j) {
-        if (!isprint(artFile.names[j])) artFile.names[j] = ' ';
-    }
-    for (size_t j = 0; j < sizeof(artFile.artistIds) && artFile.artistIds[j]; ++j) {
-        if (!isprint(artFile.artistIds[j])) artFile.artistIds[j] = ' ';
-    }
-    for (size_t j = 0; j < sizeof(artFile.phones) && artFile.phones[j]; ++j) {
-        if (!isprint(artFile.phones[j])) artFile.phones[j] = ' ';
-    }
-    for (size_t j = 0; j < sizeof(artFile.emails) && artFile.emails[j]; ++j) {
-        if (!isprint(artFile.emails[j])) artFile.emails[j] = ' ';
-    }
-    if (!isprint(artFile.genders)) artFile.genders = ' ';
-
     cout << endl << endl;
     cout << "\tId:     " << artFile.artistIds << endl;
     cout << "\tName:   " << artFile.names << endl;
@@ -4469,49 +10784,52 @@ void ArtistView::displayOne(const artistList& artists, int idx) {
 }
 
 // AlbumView implementations
-void AlbumView::displayAll(std::fstream& AlbFile, const albumList& albums) {
-    system("cls");
+std::size_t AlbumView::pageStart(const albumList& albums, std::size_t first, std::size_t current, std::size_t target,
+                                 std::size_t rows) {
+    return findPageStart(albums.albList, albums.stats.albums, first, current, target, rows,
+                         [](const albumIndex& entry) { return entry.albumId != "-1"; });
+}
+
+std::size_t AlbumView::renderPage(std::istream& AlbFile, const albumList& albums, std::size_t first, std::size_t rows,
+                                  std::size_t number, std::string& out) {
+    out.clear();
+    out += "No      Titles                                  IdsRef    AlbumIds  Format  Date        Paths\n";
+    out.append(110, '-');
+    out += '\n';
+    std::size_t shown = 0;
     AlbumFile albFile;
-    int idx = 0;
-    cout << endl << "\tNo.\t" << "Titles\t" << setw(33) << "IdsRef" << setw(11) << "\tAlbumIds";
-    cout << "\tRecordFormat \t" << "DatePublisheds" << setw(5) << "\tPaths" << endl;
-    for (size_t i = 0; i < albums.albList.size(); i++){
-        if(albums.albList[i].albumId != "-1"){
-            AlbFile.seekg(albums.albList[i].pos, ios::beg);
-            AlbFile.read((char*)&albFile, sizeof(albFile));
-            albFile.albumIds[7] = '\0';
-            albFile.artistIdRefs[7] = '\0';
-            albFile.titles[79] = '\0';
-            albFile.recordFormats[11] = '\0';
-            albFile.datePublished[10] = '\0';
-            albFile.paths[99] = '\0';
-            // Sanitize strings to replace non-printable characters with spaces
-            for (size_t j = 0; j < sizeof(albFile.albumIds) && albFile.albumIds[j]; ++j) {
-                if (!isprint(albFile.albumIds[j])) albFile.albumIds[j] = ' ';
-            }
-            for (size_t j = 0; j < sizeof(albFile.artistIdRefs) && albFile.artistIdRefs[j]; ++j) {
-                if (!isprint(albFile.artistIdRefs[j])) albFile.artistIdRefs[j] = ' ';
-            }
-            for (size_t j = 0; j < sizeof(albFile.titles) && albFile.titles[j]; ++j) {
-                if (!isprint(albFile.titles[j])) albFile.titles[j] = ' ';
-            }
-            for (size_t j = 0; j < sizeof(albFile.recordFormats) && albFile.recordFormats[j]; ++j) {
-                if (!isprint(albFile.recordFormats[j])) albFile.recordFormats[j] = ' ';
-            }
-            for (size_t j = 0; j < sizeof(albFile.datePublished) && albFile.datePublished[j]; ++j) {
-                if (!isprint(albFile.datePublished[j])) albFile.datePublished[j] = ' ';
-            }
-            for (size_t j = 0; j < sizeof(albFile.paths) && albFile.paths[j]; ++j) {
-                if (!isprint(albFile.paths[j])) albFile.paths[j] = ' ';
-            }
-            cout << '\t' << ++idx << '\t' << albFile.titles << ' ' << setw(40 - strlen(albFile.titles)) << albums.albList[i].artistId;
-            cout << '\t' << albums.albList[i].albumId << setw(3) << '\t' << '.' << albFile.recordFormats << setw(10) << '\t' << albFile.datePublished << setw(5) << '\t' << albFile.paths << endl;
+    for (std::size_t i = first; i < albums.albList.size() && shown < rows; ++i) {
+        const albumIndex& entry = albums.albList[i];
+        if (entry.albumId == "-1") {
+            continue;
+        }
+        std::size_t row = number + shown++;
+        if (RecordCache::instance().read(AlbFile, entry.pos, albFile) != RecordStatus::Ok) {
+            appendCorruptRow(out, row, entry.pos);
+            continue;
         }
+        appendDisplayNumber(out, row);
+        appendDisplayCell(out, albFile.titles, sizeof(albFile.titles), 40);
+        appendDisplayCell(out, albFile.artistIdRefs, sizeof(albFile.artistIdRefs), 10);
+        appendDisplayCell(out, albFile.albumIds, sizeof(albFile.albumIds), 10);
+        appendDisplayCell(out, albFile.recordFormats, sizeof(albFile.recordFormats), 8);
+        appendDisplayCell(out, albFile.datePublished, sizeof(albFile.datePublished), 12);
+        appendDisplayCell(out, albFile.paths, sizeof(albFile.paths), 0);
+        out += '\n';
     }
-    cout << endl << endl;
-    if(idx == 0)
-        cout << "\tNothing to display. Please add an album." << endl;
-    system("pause");
+    return shown;
+}
+
+void AlbumView::displayAll(std::fstream& AlbFile, const albumList& albums) {
+    const std::size_t pageRows = static_cast<std::size_t>(std::max(1, AppConfig::instance().settings().pageRows));
+    runPagedView(albums.stats.albums, pageRows,
+                 [&](std::size_t first, std::size_t current, std::size_t target) {
+                     return pageStart(albums, first, current, target, pageRows);
+                 },
+                 [&](std::size_t first, std::size_t rows, std::size_t number, std::string& out) {
+                     return renderPage(AlbFile, albums, first, rows, number, out);
+                 },
+                 "\n\tNothing to display. Please add an album.\n");
 }
 
 void AlbumView::displaySearchResult(std::fstream& AlbFile, const albumList& albums, const indexSet& result) {
@@ -4522,32 +10840,9 @@ void AlbumView::displaySearchResult(std::fstream& AlbFile, const albumList& albu
     cout << "\tRecordFormat \t" << "DatePublisheds" << setw(5) << "\tPaths" << endl;
     for (size_t i = 0; i < result.indexes.size(); i++){
         size_t idx = result.indexes[i];
-        AlbFile.seekg(albums.albList[idx].pos, ios::beg);
-        AlbFile.read((char*)&albFile, sizeof(albFile));
-        albFile.albumIds[7] = '\0';
-        albFile.artistIdRefs[7] = '\0';
-        albFile.titles[79] = '\0';
-        albFile.recordFormats[11] = '\0';
-        albFile.datePublished[10] = '\0';
-        albFile.paths[99] = '\0';
-        // Sanitize strings to replace non-printable characters with spaces
-        for (size_t j = 0; j < sizeof(albFile.albumIds) && albFile.albumIds[j]; ++j) {
-            if (!isprint(albFile.albumIds[j])) albFile.albumIds[j] = ' ';
-        }
-        for (size_t j = 0; j < sizeof(albFile.artistIdRefs) && albFile.artistIdRefs[j]; ++j) {
-            if (!isprint(albFile.artistIdRefs[j])) albFile.artistIdRefs[j] = ' ';
-        }
-        for (size_t j = 0; j < sizeof(albFile.titles) && albFile.titles[j]; ++j) {
-            if (!isprint(albFile.titles[j])) albFile.titles[j] = ' ';
-        }
-        for (size_t j = 0; j < sizeof(albFile.recordFormats) && albFile.recordFormats[j]; ++j) {
-            if (!isprint(albFile.recordFormats[j])) albFile.recordFormats[j] = ' ';
-        }
-        for (size_t j = 0; j < sizeof(albFile.datePublished) && albFile.datePublished[j]; ++j) {
-            if (!isprint(albFile.datePublished[j])) albFile.datePublished[j] = ' ';
-        }
-        for (size_t j = 0; j < sizeof(albFile.paths) && albFile.paths[j]; ++j) {
-            if (!isprint(albFile.paths[j])) albFile.paths[j] = ' ';
+        if (RecordCache::instance().read(AlbFile, albums.albList[idx].pos, albFile) != RecordStatus::Ok) {
+            cout << '\t' << idx << "\t[corrupt record at offset " << albums.albList[idx].pos << "]" << endl;
+            continue;
         }
         cout << '\t' << idx << '\t' << albFile.titles << setw(40 - strlen(albFile.titles)) << albums.albList[idx].artistId;
         cout << '\t' << albums.albList[idx].albumId << setw(3) << '\t' << '.' << albFile.recordFormats << setw(10) << '\t' << albFile.datePublished << setw(5) << '\t' << albFile.paths << endl;
@@ -4557,32 +10852,10 @@ void AlbumView::displaySearchResult(std::fstream& AlbFile, const albumList& albu
 
 void AlbumView::displayOne(std::fstream& AlbFile, const albumList& albums, int idx) {
     AlbumFile albFile;
-    AlbFile.seekg(albums.albList[idx].pos, ios::beg);
-    AlbFile.read((char*)&albFile, sizeof(albFile));
-    albFile.albumIds[7] = '\0';
-    albFile.artistIdRefs[7] = '\0';
-    albFile.titles[79] = '\0';
-    albFile.recordFormats[11] = '\0';
-    albFile.datePublished[10] = '\0';
-    albFile.paths[99] = '\0';
-    // Sanitize strings to replace non-printable characters with spaces
-    for (size_t j = 0; j < sizeof(albFile.albumIds) && albFile.albumIds[j]; ++j) {
-        if (!isprint(albFile.albumIds[j])) albFile.albumIds[j] = ' ';
-    }
-    for (size_t j = 0; j < sizeof(albFile.artistIdRefs) && albFile.artistIdRefs[j]; ++j) {
-        if (!isprint(albFile.artistIdRefs[j])) albFile.artistIdRefs[j] = ' ';
-    }
-    for (size_t j = 0; j < sizeof(albFile.titles) && albFile.titles[j]; ++j) {
-        if (!isprint(albFile.titles[j])) albFile.titles[j] = ' ';
-    }
-    for (size_t j = 0; j < sizeof(albFile.recordFormats) && albFile.recordFormats[j]; ++j) {
-        if (!isprint(albFile.recordFormats[j])) albFile.recordFormats[j] = ' ';
-    }
-    for (size_t j = 0; j < sizeof(albFile.datePublished) && albFile.datePublished[j]; ++j) {
-        if (!isprint(albFile.datePublished[j])) albFile.datePublished[j] = ' ';
-    }
-    for (size_t j = 0; j < sizeof(albFile.paths) && albFile.paths[j]; ++j) {
-        if (!isprint(albFile.paths[j])) albFile.paths[j] = ' ';
+    if (RecordCache::instance().read(AlbFile, albums.albList[idx].pos, albFile) != RecordStatus::Ok) {
+        cout << endl << "\tAlbum record at offset " << albums.albList[idx].pos << " is corrupt." << endl << endl;
+        system("pause");
+        return;
     }
     cout << endl << endl;
     cout << "\t\tTitle:          " << albFile.titles << endl;
@@ -4610,18 +10883,19 @@ int MenuView::mainMenu() {
         cout<<"\n\n                       Enter  4 :  >> STATISTICS                              ";
         cout<<"\n\n                       Enter  5 :  >> UNDO " << (undoDesc.empty() ? "(none)" : "- " + undoDesc);
         cout<<"\n\n                       Enter  6 :  >> REDO " << (redoDesc.empty() ? "(none)" : "- " + redoDesc);
-        cout<<"\n\n                       Enter  7 :  >> EXIT.                              \n\n ";
+        cout<<"\n\n                       Enter  7 :  >> PERFORMANCE METRICS                     ";
+        cout<<"\n\n                       Enter  8 :  >> EXIT.                              \n\n ";
         cout<<"\n choice:    ";
         cin>>c;
         cin.clear();
         cin.ignore(INT_MAX,'\n');
-        if (c>7 || c<1){
+        if (c>8 || c<1){
             cout<<"Wrong Choice!";
             cout<<endl<<endl;
             system ("pause");
             system ("cls");
         }
-    }while(c>7 || c<1);
+    }while(c>8 || c<1);
     return c;
 }
 
@@ -4634,18 +10908,47 @@ int MenuView::backupMenu() {
         cout<<"\n                              *BACKUP & RESTORE MENU*               ";
         cout<<"\n\n                       Enter  1 :  >> Create backup snapshot                ";
         cout<<"\n\n                       Enter  2 :  >> Restore from snapshot                 ";
-        cout<<"\n\n                       Enter  3 :  >> Go Back                               \n\n ";
+        cout<<"\n\n                       Enter  3 :  >> Restore to point in time              ";
+        cout<<"\n\n                       Enter  4 :  >> Verify data files (scrub)             ";
+        cout<<"\n\n                       Enter  5 :  >> Import from CSV/JSON                  ";
+        cout<<"\n\n                       Enter  6 :  >> Go Back                               \n\n ";
         cout<<"\n choice:    ";
         cin>>c;
         cin.clear();
         cin.ignore(INT_MAX,'\n');
-        if (c>3 || c<1){
+        if (c>6 || c<1){
             cout<<"Wrong Choice!";
             cout<<endl<<endl;
             system ("pause");
             system ("cls");
         }
-    }while(c>3 || c<1);
+    }while(c>6 || c<1);
+    return c;
+}
+
+int MenuView::statisticsMenu() {
+    int c;
+    do{
+        system("COLOR 3F");
+        system("cls");
+        cout<<"\n\n";
+        cout<<"\n                                 *STATISTICS MENU*               ";
+        cout<<"\n\n                       Enter  1 :  >> Overview                              ";
+        cout<<"\n\n                       Enter  2 :  >> Top artists by album count            ";
+        cout<<"\n\n                       Enter  3 :  >> Albums per decade                     ";
+        cout<<"\n\n                       Enter  4 :  >> Format share by year                  ";
+        cout<<"\n\n                       Enter  5 :  >> Go Back                               \n\n ";
+        cout<<"\n choice:    ";
+        cin>>c;
+        cin.clear();
+        cin.ignore(INT_MAX,'\n');
+        if (c>5 || c<1){
+            cout<<"Wrong Choice!";
+            cout<<endl<<endl;
+            system ("pause");
+            system ("cls");
+        }
+    }while(c>5 || c<1);
     return c;
 }
 
@@ -4658,7 +10961,7 @@ int MenuView::artistMenu() {
         cout<<"\n                                 *Artist Menu*               ";
         cout<<"\n\n                       Enter  1 :  >> Artist Viewer                           ";
         cout<<"\n\n                       Enter  2 :  >> Artist Editor                            ";
-        cout<<"\n\n                       Enter  3 :  >> Export Artists to CSV                              ";
+        cout<<"\n\n                       Enter  3 :  >> Export Artists (CSV/JSONL)                        ";
         cout<<"\n\n                       Enter  4 :  >> Go To Main Menu                              ";
         cout<<"\n\n                       Enter  5 :  >> EXIT.                              \n\n ";
         cout<<"\n choice:    ";
@@ -4709,18 +11012,19 @@ int MenuView::editArtistMenu() {
         cout<<"\n\n                       Enter  1 :  >> ADD Artist    ";
         cout<<"\n\n                       Enter  2 :  >> Edit Artist  ";
         cout<<"\n\n                       Enter  3 :  >> Delete Artist  ";
-        cout<<"\n\n                       Enter  4 :  >> GO BACK.          \n\n ";
+        cout<<"\n\n                       Enter  4 :  >> Merge Duplicate Artists  ";
+        cout<<"\n\n                       Enter  5 :  >> GO BACK.          \n\n ";
         cout<<"\n choice:    ";
         cin>>c;
         cin.clear();
         cin.ignore(INT_MAX,'\n');
-        if (c>4 || c<1){
+        if (c>5 || c<1){
             cout<<"Wrong Choice!"<<endl;
             cout<<endl<<endl;
             system ("pause");
             system ("cls");
             }
-    }while(c>4 || c<1);
+    }while(c>5 || c<1);
     return c;
 }
 
@@ -4733,7 +11037,7 @@ int MenuView::albumMenu() {
         cout<<"\n                                 *Album Menu*               ";
         cout<<"\n\n                       Enter  1 :  >> Album Viewer                           ";
         cout<<"\n\n                       Enter  2 :  >> Album Editor                            ";
-        cout<<"\n\n                       Enter  3 :  >> Export Albums to CSV                              ";
+        cout<<"\n\n                       Enter  3 :  >> Export Albums (CSV/JSONL/Columnar)                ";
         cout<<"\n\n                       Enter  4 :  >> Go To Main Menu                              ";
         cout<<"\n\n                       Enter  5 :  >> EXIT.                              \n\n ";
         cout<<"\n choice:    ";
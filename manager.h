@@ -15,6 +15,8 @@
 #include <vector>
 #include <exception>
 #include <algorithm>
+#include <array>
+#include <map>
 #include <fstream>
 #include <filesystem>
 #include <chrono>
@@ -22,6 +24,16 @@
 #include <memory>
 #include <cstring>
 #include <climits>
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <iosfwd>
 
 const int DEFAULT_SIZE = 10;
 extern int lastArtistID, lastAlbumID;
@@ -31,6 +43,20 @@ struct AppConfigSettings {
     std::string albumFile;
     std::string backupDirectory;
     std::string backupIndexFile;
+    std::string journalFile;
+    std::string logLevel;
+    std::string logFormat;
+    std::uint64_t logMaxSizeMB = 10;
+    int logRotateHours = 24;
+    int logRetention = 5;
+    bool logCompress = false;
+    std::string metricsFile;
+    int metricsPort = 0;
+    int metricsIntervalSeconds = 15;
+    int memorySampleSeconds = 60;
+    std::string traceFile;
+    int pageRows = 20;
+    int recordCacheEntries = 4096;
 };
 
 class AppConfig {
@@ -65,14 +91,200 @@ const std::string& getArtistFilePath();
 const std::string& getAlbumFilePath();
 const std::string& getBackupDirectory();
 const std::string& getBackupIndexFile();
+const std::string& getJournalFile();
 
 extern const ConfigValue artistFilePath;
 extern const ConfigValue albumFilePath;
 extern const ConfigValue backupDirectory;
 extern const ConfigValue backupIndexFile;
+extern const ConfigValue journalFile;
 
 void loadApplicationConfig(const std::string& path);
 
+// Checksum Engine
+
+/**
+ * @brief Hash algorithms understood by the checksum engine.
+ */
+enum class ChecksumAlgorithm {
+    Fnv1a32,  /**< Legacy byte-at-a-time FNV-1a, kept to verify old backup index entries */
+    Crc32c,   /**< Castagnoli CRC, SSE4.2 accelerated when the CPU supports it */
+    XxHash64  /**< 64-bit xxHash, used for new backup snapshots */
+};
+
+/**
+ * @brief A checksum value tagged with the algorithm that produced it.
+ */
+struct Checksum {
+    ChecksumAlgorithm algorithm = ChecksumAlgorithm::XxHash64; /**< Producing algorithm */
+    std::uint64_t value = 0;                                   /**< Digest value */
+
+    /**
+     * @brief Serializes the checksum for the backup index.
+     *
+     * Legacy FNV values are written as plain decimal numbers so older builds
+     * can still read them; other algorithms use an "name:hex" form.
+     * @return Textual representation.
+     */
+    std::string toString() const;
+    /**
+     * @brief Parses a checksum written by toString() or by older builds.
+     * @param text Text to parse.
+     * @param out Parsed checksum.
+     * @return True if the text was understood.
+     */
+    static bool parse(const std::string& text, Checksum& out);
+    /**
+     * @brief Reports whether the checksum carries no information.
+     * @return True for the legacy "0" placeholder.
+     */
+    bool isEmpty() const { return value == 0; }
+    bool operator==(const Checksum& other) const { return algorithm == other.algorithm && value == other.value; }
+    bool operator!=(const Checksum& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Interface for pluggable block hash implementations.
+ */
+class ChecksumEngine {
+public:
+    /**
+     * @brief Virtual destructor.
+     */
+    virtual ~ChecksumEngine() = default;
+    /**
+     * @brief Gets the algorithm implemented by this engine.
+     * @return Algorithm identifier.
+     */
+    virtual ChecksumAlgorithm algorithm() const = 0;
+    /**
+     * @brief Gets a short, stable name used in the backup index.
+     * @return Engine name.
+     */
+    virtual const char* name() const = 0;
+    /**
+     * @brief Hashes a contiguous block.
+     * @param data Block start.
+     * @param length Block length in bytes.
+     * @param seed Seed, or the running state for sequential engines.
+     * @return Digest of the block.
+     */
+    virtual std::uint64_t digest(const void* data, std::size_t length, std::uint64_t seed) const = 0;
+    /**
+     * @brief Reports whether files must be hashed as one sequential stream.
+     *
+     * Non-sequential engines hash fixed-size chunks in parallel and combine
+     * the chunk digests, so their file checksums depend on the chunk size.
+     * @return True for sequential (legacy) engines.
+     */
+    virtual bool sequential() const { return false; }
+};
+
+/**
+ * @brief Chunk size used when hashing files in parallel.
+ */
+const std::size_t CHECKSUM_CHUNK_SIZE = 1 << 20;
+
+/**
+ * @brief Looks up the engine for an algorithm.
+ * @param algorithm Algorithm to look up.
+ * @return Engine reference (static lifetime).
+ */
+const ChecksumEngine& checksumEngine(ChecksumAlgorithm algorithm);
+
+/**
+ * @brief Computes the CRC32C (Castagnoli) of a block.
+ * @param data Block start.
+ * @param length Block length in bytes.
+ * @param crc Previous CRC, to continue a running checksum.
+ * @return Updated CRC.
+ */
+std::uint32_t crc32c(const void* data, std::size_t length, std::uint32_t crc = 0);
+
+/**
+ * @brief Computes the 64-bit xxHash of a block.
+ * @param data Block start.
+ * @param length Block length in bytes.
+ * @param seed Hash seed.
+ * @return Digest.
+ */
+std::uint64_t xxHash64(const void* data, std::size_t length, std::uint64_t seed = 0);
+
+/**
+ * @brief Combines per-chunk digests into a file digest.
+ * @param engine Engine used for the chunks.
+ * @param chunkDigests Digests of consecutive CHECKSUM_CHUNK_SIZE chunks.
+ * @param totalLength Total number of bytes hashed.
+ * @return Combined digest.
+ */
+std::uint64_t combineChunkDigests(const ChecksumEngine& engine, const std::vector<std::uint64_t>& chunkDigests, std::uint64_t totalLength);
+
+/**
+ * @brief Computes the checksum of a file.
+ *
+ * Sequential engines stream the file; other engines split it into
+ * CHECKSUM_CHUNK_SIZE chunks hashed on worker threads.
+ * @param path File path.
+ * @param algorithm Algorithm to use.
+ * @return Checksum; value 0 if the file cannot be read.
+ */
+Checksum computeFileChecksum(const std::string& path, ChecksumAlgorithm algorithm = ChecksumAlgorithm::XxHash64);
+
+// File Copy
+
+/**
+ * @brief Mechanism that performed a file copy, fastest first.
+ */
+enum class CopyMethod {
+    Reflink,       /**< FICLONE: the destination shares the source extents */
+    CopyFileRange, /**< copy_file_range: in-kernel copy, may be offloaded by the filesystem */
+    Sendfile,      /**< sendfile: in-kernel copy through the page cache */
+    Buffered       /**< User-space read/write loop */
+};
+
+/**
+ * @brief Returns a short name for a copy method, as used in the log.
+ * @param method Copy method.
+ * @return Method name.
+ */
+const char* copyMethodName(CopyMethod method);
+
+/**
+ * @brief Copies a file, creating or truncating the destination.
+ *
+ * On Linux the copy is attempted in-kernel (reflink, then copy_file_range, then sendfile)
+ * before falling back to a buffered loop; each step is only tried if the previous one is
+ * unsupported for this pair of files. The method used is written to the log.
+ * @param source Source file path.
+ * @param destination Destination file path.
+ * @param used Optional; receives the method that completed the copy.
+ * @return True if the whole file was copied.
+ */
+bool copyFileContents(const std::string& source, const std::string& destination, CopyMethod* used = nullptr);
+
+/**
+ * @brief Renames a file over another, replacing it.
+ *
+ * On Windows a just-closed handle can keep the destination locked for a moment, so
+ * the rename is retried a few times after clearing the destination's attributes.
+ * @param source File to move.
+ * @param destination Path it replaces.
+ * @return True if the file now lives at destination.
+ */
+bool replaceFile(const std::string& source, const std::string& destination);
+
+/**
+ * @brief Moves staged files over their live counterparts as one unit.
+ *
+ * Each live file is moved aside to "<live>.prev" before its staged copy takes its
+ * place. If any move fails, the files already swapped are put back, so the live
+ * set never mixes old and new files. The asides are removed once all moves succeed.
+ * @param moves (staged path, live path) pairs, swapped in order.
+ * @param error Receives a description of the failed step.
+ * @return True if every staged file was installed.
+ */
+bool swapInStagedFiles(const std::vector<std::pair<std::string, std::string>>& moves, std::string& error);
+
 // Custom Exception Classes
 
 /**
@@ -130,161 +342,888 @@ public:
     SearchException(const std::string& msg) : AlbumManagementException("Search Error: " + msg) {}
 };
 
-// Simple Logging Class
+// Logging
+
+/**
+ * @brief Severity of a log message.
+ */
+enum class LogLevel : std::uint8_t {
+    Trace = 0, /**< Per-record detail */
+    Debug = 1, /**< Routine repository and file activity */
+    Info = 2,  /**< Notable operations (default threshold) */
+    Warn = 3,  /**< Recoverable problems */
+    Error = 4, /**< Failed operations */
+    Off = 5    /**< Threshold that disables logging */
+};
+
+/**
+ * @brief Lowest level compiled into the program.
+ *
+ * Calls below it are removed by ALBUM_LOG and never evaluate their arguments.
+ * Override with e.g. -DALBUM_LOG_MIN_LEVEL=2 to drop Trace and Debug from a build.
+ */
+#ifndef ALBUM_LOG_MIN_LEVEL
+#define ALBUM_LOG_MIN_LEVEL 0
+#endif
+
+/**
+ * @brief Checks a level against ALBUM_LOG_MIN_LEVEL at compile time.
+ * @param level Message level.
+ * @return True if messages at this level are compiled in.
+ */
+constexpr bool logLevelCompiledIn(LogLevel level) {
+    return static_cast<int>(level) - ALBUM_LOG_MIN_LEVEL >= 0;
+}
+
+/**
+ * @brief On-disk format of the log.
+ */
+enum class LogFormat {
+    Text,  /**< album_system.log, one formatted line per message */
+    Binary /**< album_system.logb, interned templates plus raw typed arguments; see decodeBinaryLog */
+};
+
+/**
+ * @brief Type tags of encoded log arguments (shared by the queue and the binary format).
+ */
+enum class LogArgType : std::uint8_t {
+    Int = 1,    /**< int64 */
+    UInt = 2,   /**< uint64 */
+    Double = 3, /**< IEEE double */
+    String = 4, /**< uint32 length + bytes */
+    Char = 5,   /**< one byte */
+    Bool = 6    /**< one byte, 0 or 1 */
+};
+
+/**
+ * @brief What Logger::log does when the queue is full.
+ */
+enum class LogOverflowPolicy {
+    Block, /**< The caller waits for the writer thread to free a slot; nothing is lost */
+    Drop   /**< The message is discarded and counted; the count is written to the log later */
+};
+
+/**
+ * @brief When and how the active log file is rotated.
+ */
+struct LogRotationSettings {
+    std::uint64_t maxBytes = 0;     /**< Rotate once the segment reaches this size; 0 disables */
+    std::int64_t maxAgeSeconds = 0; /**< Rotate once the segment is this old; 0 disables */
+    int retention = 0;              /**< Rotated segments kept; older ones are deleted; 0 keeps all */
+    bool compress = false;          /**< Gzip rotated segments on a background thread (needs zlib) */
+};
+
+/**
+ * @brief Parses a level name ("trace", "debug", "info", "warn", "error", "off").
+ * @param text Level name, case-insensitive.
+ * @param fallback Level returned for unknown names.
+ * @return Parsed level.
+ */
+LogLevel parseLogLevel(const std::string& text, LogLevel fallback = LogLevel::Info);
+
+/**
+ * @brief Returns the upper-case name of a level as written in the log.
+ * @param level Log level.
+ * @return Level name.
+ */
+const char* logLevelName(LogLevel level);
+
+/**
+ * @brief Appends one typed argument to an encoded argument buffer.
+ * @param out Buffer to append to.
+ * @param value Argument value.
+ */
+void encodeLogArg(std::string& out, std::int64_t value);
+/** @copydoc encodeLogArg(std::string&, std::int64_t) */
+void encodeLogArg(std::string& out, std::uint64_t value);
+/** @copydoc encodeLogArg(std::string&, std::int64_t) */
+void encodeLogArg(std::string& out, double value);
+/** @copydoc encodeLogArg(std::string&, std::int64_t) */
+void encodeLogArg(std::string& out, const char* value, std::size_t length);
+/** @copydoc encodeLogArg(std::string&, std::int64_t) */
+void encodeLogArg(std::string& out, char value);
+/** @copydoc encodeLogArg(std::string&, std::int64_t) */
+void encodeLogArg(std::string& out, bool value);
+
+/**
+ * @brief Substitutes encoded arguments into a message template.
+ *
+ * Each "{}" takes the next argument; arguments left over are appended after a space.
+ * @param out String to append the message to.
+ * @param templ Message template.
+ * @param templLength Template length in bytes.
+ * @param args Encoded arguments.
+ * @param length Size of the encoded arguments in bytes.
+ * @return False if the argument buffer is malformed.
+ */
+bool formatLogMessage(std::string& out, const char* templ, std::size_t templLength, const char* args, std::size_t length);
 
 /**
- * @brief Singleton logger class for logging messages to a file.
+ * @brief Converts a binary log to the text format.
+ * @param in Binary log stream.
+ * @param out Receives one text line per message.
+ * @return False if the stream is not a binary log or ends in a damaged record.
+ */
+bool decodeBinaryLog(std::istream& in, std::ostream& out);
+
+/**
+ * @brief Singleton asynchronous logger writing to album_system.log.
+ *
+ * Messages are a template plus typed arguments. They are pushed into a bounded lock-free
+ * multi-producer ring already encoded; a background thread drains the ring in batches and
+ * either formats each line (with a cached per-second timestamp) or copies the encoded
+ * arguments straight into the binary log, then writes the batch with a single flush.
  */
 class Logger {
-private:
-    std::ofstream logFile;
-    static Logger* instance;
-    /**
-     * @brief Private constructor for singleton pattern.
-     */
-    Logger() {
-        logFile.open("album_system.log", std::ios::app);
-        if (logFile.is_open()) {
-            log("Logger initialized");
-        }
-    }
 public:
     /**
      * @brief Gets the singleton instance of the logger.
      * @return Pointer to the logger instance.
      */
-    static Logger* getInstance() {
-        if (instance == nullptr) {
-            instance = new Logger();
-        }
-        return instance;
-    }
+    static Logger* getInstance();
     /**
-     * @brief Logs a message with timestamp.
+     * @brief Queues a preformatted message at Info level.
      * @param message The message to log.
      */
-    void log(const std::string& message) {
-        if (logFile.is_open()) {
-            auto now = std::chrono::system_clock::now();
-            auto time = std::chrono::system_clock::to_time_t(now);
-            logFile << std::ctime(&time) << ": " << message << std::endl;
+    void log(const std::string& message);
+    /**
+     * @brief Queues a message template with typed arguments.
+     *
+     * Prefer the ALBUM_LOG_* macros, which also skip argument evaluation for disabled levels.
+     * @param level Message level.
+     * @param templ Message template with "{}" placeholders; must outlive the program (a literal).
+     * @param args Arguments: integers, floating point, bool, char, strings or enums.
+     */
+    template <typename... Args>
+    void write(LogLevel level, const char* templ, const Args&... args) {
+        if (!enabled(level)) {
+            return;
         }
+        std::string& buffer = encodeBuffer();
+        buffer.clear();
+        (encodeArg(buffer, args), ...);
+        submit(level, templ, buffer);
+    }
+    /**
+     * @brief Checks the runtime level threshold.
+     * @param level Message level.
+     * @return True if messages at this level are recorded.
+     */
+    bool enabled(LogLevel level) const {
+        return static_cast<std::uint8_t>(level) >= static_cast<std::uint8_t>(minLevel.load(std::memory_order_relaxed));
     }
     /**
-     * @brief Destructor that logs shutdown and closes the file.
+     * @brief Sets the runtime level threshold.
+     * @param level Lowest level recorded.
+     */
+    void setLevel(LogLevel level);
+    /**
+     * @brief Switches between the text and binary log files.
+     * @param format New format.
+     */
+    void setFormat(LogFormat format);
+    /**
+     * @brief Sets the rotation policy of the active log file.
+     *
+     * Rotated segments are renamed to "<log file>.<YYYYmmdd_HHMMSS>" and, with compression
+     * enabled, gzipped to "<segment>.gz" by a background thread.
+     * @param settings Rotation thresholds, retention and compression.
+     */
+    void setRotation(const LogRotationSettings& settings);
+    /**
+     * @brief Lists the rotated segments of the active log file, oldest first.
+     * @return Segment paths.
+     */
+    std::vector<std::string> rotatedSegments() const;
+    /**
+     * @brief Waits until every message queued before the call is written to disk
+     * and every rotated segment waiting for compression has been compressed.
+     */
+    void flush();
+    /**
+     * @brief Stops the writer thread after draining the queue; later messages are written synchronously.
+     */
+    void shutdown();
+    /**
+     * @brief Sets the policy applied when the queue is full.
+     * @param policy Block or Drop.
+     */
+    void setOverflowPolicy(LogOverflowPolicy policy);
+    /**
+     * @brief Number of messages discarded under the Drop policy.
+     * @return Dropped message count.
      */
-    ~Logger() {
-        if (logFile.is_open()) {
-            log("Logger shutting down");
-            logFile.close();
+    std::uint64_t droppedCount() const;
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /** Ring capacity in messages (a power of two). */
+    static constexpr std::size_t QUEUE_CAPACITY = 8192;
+    /** Text log file name. */
+    static constexpr const char* TEXT_LOG_FILE = "album_system.log";
+    /** Binary log file name. */
+    static constexpr const char* BINARY_LOG_FILE = "album_system.logb";
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        std::int64_t timestampMs = 0;
+        LogLevel level = LogLevel::Info;
+        const char* templ = nullptr;
+        std::string args;
+    };
+
+    template <typename T>
+    static void encodeArg(std::string& out, const T& value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            encodeLogArg(out, value);
+        } else if constexpr (std::is_same_v<T, char>) {
+            encodeLogArg(out, value);
+        } else if constexpr (std::is_enum_v<T>) {
+            encodeArg(out, static_cast<std::underlying_type_t<T>>(value));
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            encodeLogArg(out, static_cast<std::int64_t>(value));
+        } else if constexpr (std::is_integral_v<T>) {
+            encodeLogArg(out, static_cast<std::uint64_t>(value));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            encodeLogArg(out, static_cast<double>(value));
+        } else {
+            std::string_view text(value);
+            encodeLogArg(out, text.data(), text.size());
         }
     }
+
+    Logger();
+    static std::string& encodeBuffer();
+    void submit(LogLevel level, const char* templ, const std::string& args);
+    bool tryPush(std::int64_t timestampMs, LogLevel level, const char* templ, const std::string& args);
+    bool hasPending() const;
+    void run();
+    void appendRecord(std::string& batch, std::int64_t timestampMs, LogLevel level, const char* templ, const std::string& args);
+    void openLogFile();
+    void wakeWriter();
+    const char* activeLogPath() const;
+    bool rotationDue() const;
+    void rotateLogFile();
+    void pruneSegments();
+    void runCompressor();
+    void stopCompressor();
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<std::size_t> enqueuePos{0};
+    std::size_t dequeuePos = 0;
+    std::atomic<std::uint64_t> accepted{0};
+    std::atomic<std::uint64_t> written{0};
+    std::atomic<std::uint64_t> dropped{0};
+    std::uint64_t droppedReported = 0;
+    std::atomic<LogOverflowPolicy> policy{LogOverflowPolicy::Block};
+    std::atomic<LogLevel> minLevel{LogLevel::Info};
+    std::atomic<bool> running{false};
+    std::atomic<bool> writerIdle{false};
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::condition_variable drained;
+    std::thread writer;
+    std::mutex fileMutex;
+    std::ofstream logFile;
+    LogFormat format = LogFormat::Text;
+    std::unordered_map<const char*, std::uint32_t> templateIds;
+    LogRotationSettings rotation;
+    std::uint64_t segmentBytes = 0;
+    std::int64_t segmentOpenedMs = 0;
+    mutable std::mutex compressMutex;
+    std::condition_variable compressWake;
+    std::condition_variable compressDone;
+    std::vector<std::string> compressQueue;
+    bool compressing = false;
+    bool compressorStop = false;
+    std::thread compressor;
+    std::int64_t cachedSecond = -1;
+    char cachedStamp[24] = {};
 };
 
-//Artist information
+/**
+ * @brief Logs a message template with typed arguments at the given level.
+ *
+ * Levels below ALBUM_LOG_MIN_LEVEL compile to nothing; levels below the runtime threshold
+ * return before any argument is evaluated or encoded.
+ */
+#define ALBUM_LOG(level, ...)                                                     \
+    do {                                                                          \
+        if constexpr (logLevelCompiledIn(level)) {                                \
+            Logger* albumLogger = Logger::getInstance();                          \
+            if (albumLogger->enabled(level)) {                                    \
+                albumLogger->write(level, __VA_ARGS__);                           \
+            }                                                                     \
+        }                                                                         \
+    } while (0)
+
+#define ALBUM_LOG_TRACE(...) ALBUM_LOG(LogLevel::Trace, __VA_ARGS__)
+#define ALBUM_LOG_DEBUG(...) ALBUM_LOG(LogLevel::Debug, __VA_ARGS__)
+#define ALBUM_LOG_INFO(...) ALBUM_LOG(LogLevel::Info, __VA_ARGS__)
+#define ALBUM_LOG_WARN(...) ALBUM_LOG(LogLevel::Warn, __VA_ARGS__)
+#define ALBUM_LOG_ERROR(...) ALBUM_LOG(LogLevel::Error, __VA_ARGS__)
 
 /**
- * @brief Struct representing artist data in binary file format.
+ * @brief Monotonic event counter; an increment is one relaxed atomic add.
  */
-struct ArtistFile {
-    char artistIds[8]; /**< Artist ID as char array */
-    char names[50];    /**< Artist name as char array */
-    char genders;      /**< Artist gender as char */
-    char phones[15];   /**< Artist phone as char array */
-    char emails[50];   /**< Artist email as char array */
+class MetricCounter {
+public:
+    /**
+     * @brief Adds to the counter.
+     * @param amount Amount to add.
+     */
+    void add(std::uint64_t amount = 1) { total.fetch_add(amount, std::memory_order_relaxed); }
+    /**
+     * @brief Gets the current count.
+     * @return Count since start or the last reset.
+     */
+    std::uint64_t value() const { return total.load(std::memory_order_relaxed); }
+    /**
+     * @brief Sets the counter back to zero.
+     */
+    void reset() { total.store(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> total{0};
 };
 
 /**
- * @brief Class representing an Artist with encapsulated data and methods.
+ * @brief Point-in-time value such as a list size or stack depth.
  */
-class Artist {
-private:
-    std::string artistId; /**< Unique identifier for the artist */
-    std::string name;     /**< Artist's name */
-    char gender;          /**< Artist's gender ('M' or 'F') */
-    std::string phone;    /**< Artist's phone number */
-    std::string email;    /**< Artist's email address */
+class MetricGauge {
 public:
     /**
-     * @brief Default constructor.
+     * @brief Replaces the value.
+     * @param newValue New value.
      */
-    Artist() = default;
+    void set(std::int64_t newValue) { current.store(newValue, std::memory_order_relaxed); }
     /**
-     * @brief Parameterized constructor.
-     * @param id Artist ID.
-     * @param n Name.
-     * @param g Gender.
-     * @param p Phone.
-     * @param e Email.
+     * @brief Adds to the value.
+     * @param delta Amount to add; may be negative.
      */
-    Artist(const std::string& id, const std::string& n, char g, const std::string& p, const std::string& e)
-        : artistId(id), name(n), gender(g), phone(p), email(e) {}
+    void add(std::int64_t delta) { current.fetch_add(delta, std::memory_order_relaxed); }
     /**
-     * @brief Gets the artist ID.
-     * @return Artist ID.
+     * @brief Gets the value.
+     * @return Current value.
      */
-    const std::string& getArtistId() const { return artistId; }
+    std::int64_t value() const { return current.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::int64_t> current{0};
+};
+
+/**
+ * @brief Lock-free latency histogram with HDR-style log-linear buckets.
+ *
+ * Each power of two is split into 32 linear sub-buckets, so a percentile is reported
+ * within about 3% of the recorded value across the whole 64-bit range. Recording is a
+ * handful of relaxed atomic operations and never allocates.
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr std::size_t SUB_BUCKETS = std::size_t{1} << SUB_BUCKET_BITS;
+    static constexpr std::size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
     /**
-     * @brief Gets the artist's name.
-     * @return Artist's name.
+     * @brief Records one sample.
+     * @param value Sample value, normally nanoseconds.
      */
-    const std::string& getName() const { return name; }
+    void record(std::uint64_t value);
     /**
-     * @brief Gets the artist's gender.
-     * @return Artist's gender.
+     * @brief Gets the number of samples recorded.
+     * @return Sample count.
      */
-    char getGender() const { return gender; }
+    std::uint64_t count() const { return samples.load(std::memory_order_relaxed); }
     /**
-     * @brief Gets the artist's phone number.
-     * @return Artist's phone.
+     * @brief Gets the sum of all samples.
+     * @return Sample sum.
      */
-    const std::string& getPhone() const { return phone; }
+    std::uint64_t sum() const { return total.load(std::memory_order_relaxed); }
     /**
-     * @brief Gets the artist's email.
-     * @return Artist's email.
+     * @brief Gets the largest sample.
+     * @return Largest sample, or 0 if empty.
      */
-    const std::string& getEmail() const { return email; }
+    std::uint64_t max() const { return largest.load(std::memory_order_relaxed); }
     /**
-     * @brief Sets the artist ID.
-     * @param id New artist ID.
+     * @brief Estimates a percentile from the buckets.
+     * @param percent Percentile in [0, 100], e.g. 99.9.
+     * @return Upper bound of the bucket holding the percentile, capped at max(); 0 if empty.
      */
-    void setArtistId(const std::string& id) { artistId = id; }
+    std::uint64_t percentile(double percent) const;
     /**
-     * @brief Sets the artist's name.
-     * @param n New name.
+     * @brief Clears all samples.
      */
-    void setName(const std::string& n) { name = n; }
+    void reset();
     /**
-     * @brief Sets the artist's gender.
-     * @param g New gender.
+     * @brief Maps a value to its bucket.
+     * @param value Sample value.
+     * @return Bucket index below BUCKET_COUNT.
      */
-    void setGender(char g) { gender = g; }
+    static std::size_t bucketIndex(std::uint64_t value);
     /**
-     * @brief Sets the artist's phone number.
-     * @param p New phone.
+     * @brief Gets the largest value that maps to a bucket.
+     * @param index Bucket index.
+     * @return Inclusive upper bound of the bucket.
      */
-    void setPhone(const std::string& p) { phone = p; }
+    static std::uint64_t bucketUpperBound(std::size_t index);
+
+private:
+    std::atomic<std::uint64_t> buckets[BUCKET_COUNT] = {};
+    std::atomic<std::uint64_t> samples{0};
+    std::atomic<std::uint64_t> total{0};
+    std::atomic<std::uint64_t> largest{0};
+};
+
+/**
+ * @brief Copy of every registered metric taken at one moment, sorted by name.
+ */
+struct MetricsSnapshot {
     /**
-     * @brief Sets the artist's email.
-     * @param e New email.
+     * @brief Summary of one latency histogram; all values in nanoseconds.
      */
-    void setEmail(const std::string& e) { email = e; }
+    struct Latency {
+        std::string name;
+        std::uint64_t count = 0;
+        std::uint64_t sum = 0;
+        std::uint64_t p50 = 0;
+        std::uint64_t p99 = 0;
+        std::uint64_t p999 = 0;
+        std::uint64_t max = 0;
+    };
+    std::vector<std::pair<std::string, std::uint64_t>> counters;
+    std::vector<std::pair<std::string, double>> gauges;
+    std::vector<Latency> latencies;
 };
 
 /**
- * @brief Struct representing an artist index entry for quick lookup.
+ * @brief Process-wide registry of named counters, gauges and latency histograms.
+ *
+ * Lookups take a mutex and return a reference that stays valid for the life of the
+ * process, so hot paths look a metric up once (ALBUM_TIME_SCOPE caches it in a static)
+ * and afterwards only touch atomics.
  */
-struct artistIndex {
-    std::string artistId; /**< Artist ID starting from 1000 */
-    std::string name;     /**< Artist name */
-    long pos;             /**< Position in file */
+class MetricsRegistry {
+public:
+    /**
+     * @brief Gets the singleton registry.
+     * @return Registry instance.
+     */
+    static MetricsRegistry& instance();
+    /**
+     * @brief Gets or creates a counter.
+     * @param name Metric name (lower_snake_case).
+     * @return Counter registered under the name.
+     */
+    MetricCounter& counter(const std::string& name);
+    /**
+     * @brief Gets or creates a gauge.
+     * @param name Metric name (lower_snake_case).
+     * @return Gauge registered under the name.
+     */
+    MetricGauge& gauge(const std::string& name);
+    /**
+     * @brief Gets or creates a latency histogram.
+     * @param name Metric name (lower_snake_case); samples are nanoseconds.
+     * @return Histogram registered under the name.
+     */
+    LatencyHistogram& histogram(const std::string& name);
+    /**
+     * @brief Writes every metric as a table, histograms with p50/p99/p999 in microseconds.
+     * @param out Stream to write to.
+     */
+    void dump(std::ostream& out) const;
+    /**
+     * @brief Copies every metric; safe to call from any thread.
+     * @return Snapshot sorted by metric name.
+     */
+    MetricsSnapshot snapshot() const;
+    /**
+     * @brief Clears counters and histograms; gauges keep their value.
+     */
+    void reset();
+
+private:
+    MetricsRegistry() = default;
+
+    mutable std::mutex mutex;
+    std::vector<std::pair<std::string, std::unique_ptr<MetricCounter>>> counters;
+    std::vector<std::pair<std::string, std::unique_ptr<MetricGauge>>> gauges;
+    std::vector<std::pair<std::string, std::unique_ptr<LatencyHistogram>>> histograms;
 };
 
 /**
- * @brief Struct containing a list of artist indices.
+ * @brief Records the time from construction to destruction into a histogram.
+ */
+class ScopedLatency {
+public:
+    /**
+     * @brief Starts timing.
+     * @param target Histogram that receives the elapsed nanoseconds.
+     */
+    explicit ScopedLatency(LatencyHistogram& target)
+        : histogram(target), start(std::chrono::steady_clock::now()) {}
+    ~ScopedLatency() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        histogram.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LatencyHistogram& histogram;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define ALBUM_METRIC_CONCAT_INNER(a, b) a##b
+#define ALBUM_METRIC_CONCAT(a, b) ALBUM_METRIC_CONCAT_INNER(a, b)
+
+// Tracing
+
+#ifndef ALBUM_TRACING
+#define ALBUM_TRACING 0
+#endif
+
+#if ALBUM_TRACING
+/**
+ * @brief One completed span; the name must be a string literal.
+ */
+struct TraceEvent {
+    const char* name;
+    std::uint64_t startNs;
+    std::uint64_t durationNs;
+};
+
+/**
+ * @brief RAII span appended to the calling thread's trace buffer when it ends.
+ *
+ * Each thread owns its buffer, so recording only takes that buffer's uncontended lock.
+ */
+class TraceSpan {
+public:
+    /**
+     * @brief Opens a span.
+     * @param name Span name; must outlive the trace (use a string literal).
+     */
+    explicit TraceSpan(const char* name);
+    ~TraceSpan();
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name;
+    std::uint64_t startNs;
+};
+
+/**
+ * @brief Writes every recorded span as Chrome/Perfetto trace-event JSON.
+ * @param out Stream to write to.
+ * @return False if the stream failed.
+ */
+bool writeChromeTrace(std::ostream& out);
+
+/**
+ * @brief Writes the trace to a file (load it in chrome://tracing or ui.perfetto.dev).
+ * @param path Output path.
+ * @return False if the file could not be written.
+ */
+bool writeChromeTraceFile(const std::string& path);
+
+/**
+ * @brief Counts the spans recorded so far across all threads.
+ * @return Span count.
+ */
+std::size_t traceEventCount();
+
+/**
+ * @brief Discards every recorded span.
+ */
+void clearTrace();
+
+/**
+ * @brief Records the rest of the enclosing scope as a trace span.
+ */
+#define ALBUM_TRACE_SCOPE(name) TraceSpan ALBUM_METRIC_CONCAT(albumSpan_, __LINE__)(name)
+#else
+#define ALBUM_TRACE_SCOPE(name) static_cast<void>(0)
+#endif
+
+/**
+ * @brief Times the rest of the enclosing scope into the named histogram.
+ *
+ * The histogram is looked up once per call site and cached in a function-local static.
+ * With tracing compiled in the scope is also recorded as a trace span.
+ */
+#define ALBUM_TIME_SCOPE(name)                                                                   \
+    static LatencyHistogram& ALBUM_METRIC_CONCAT(albumHistogram_, __LINE__) =                    \
+        MetricsRegistry::instance().histogram(name);                                             \
+    ScopedLatency ALBUM_METRIC_CONCAT(albumTimer_, __LINE__)(ALBUM_METRIC_CONCAT(albumHistogram_, __LINE__)); \
+    ALBUM_TRACE_SCOPE(name)
+
+/**
+ * @brief Gets the resident set size of this process.
+ * @return Resident bytes, or -1 where the platform does not expose it.
+ */
+std::int64_t residentMemoryBytes();
+
+/**
+ * @brief Formats a snapshot in the Prometheus text exposition format (version 0.0.4).
+ *
+ * Names gain an "album_" prefix. Counters end in "_total"; latency histograms become
+ * summaries in seconds with 0.5, 0.99 and 0.999 quantiles plus _sum and _count.
+ * @param snapshot Metrics to format.
+ * @return Exposition text.
+ */
+std::string formatPrometheusText(const MetricsSnapshot& snapshot);
+
+/**
+ * @brief Where and how often MetricsExporter publishes.
+ */
+struct MetricsExportSettings {
+    std::string filePath;     /**< File rewritten atomically every interval; empty disables */
+    int port = 0;             /**< Serve GET /metrics on 127.0.0.1:port; 0 disables */
+    int intervalSeconds = 15; /**< Seconds between file rewrites */
+};
+
+/**
+ * @brief Background thread that publishes the metrics registry plus engine health
+ * (record slots, tombstone ratio, index sizes, RSS) in Prometheus format.
+ *
+ * All rendering and I/O happen on the exporter thread; the menu loop only updates
+ * atomics. The HTTP endpoint listens on the loopback interface only.
+ */
+class MetricsExporter {
+public:
+    /**
+     * @brief Gets the singleton exporter.
+     * @return Exporter instance.
+     */
+    static MetricsExporter& instance();
+    /**
+     * @brief Starts publishing; restarts if already running.
+     * @param settings Destinations and interval.
+     * @return False if nothing is enabled or the port cannot be bound.
+     */
+    bool start(const MetricsExportSettings& settings);
+    /**
+     * @brief Writes the file one last time and stops the thread; registered with atexit.
+     */
+    void stop();
+    /**
+     * @brief Checks whether the exporter thread is running.
+     * @return True while running.
+     */
+    bool running() const;
+    /**
+     * @brief Samples engine health and renders everything as exposition text.
+     * @return Exposition text.
+     */
+    std::string render() const;
+
+private:
+    MetricsExporter() = default;
+    void run();
+    void writeFile() const;
+    void serveClient(int client) const;
+
+    MetricsExportSettings settings;
+    std::thread worker;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    bool stopRequested = false;
+    int listenSocket = -1;
+};
+
+//Artist information
+
+/**
+ * @brief Struct representing artist data in binary file format.
+ */
+struct ArtistFile {
+    char artistIds[8]; /**< Artist ID as char array */
+    char names[50];    /**< Artist name as char array */
+    char genders;      /**< Artist gender as char */
+    char phones[15];   /**< Artist phone as char array */
+    char emails[50];   /**< Artist email as char array */
+};
+
+/**
+ * @brief Class representing an Artist with encapsulated data and methods.
+ */
+class Artist {
+private:
+    std::string artistId; /**< Unique identifier for the artist */
+    std::string name;     /**< Artist's name */
+    char gender = '\0';   /**< Artist's gender ('M' or 'F'); '\0' until set */
+    std::string phone;    /**< Artist's phone number */
+    std::string email;    /**< Artist's email address */
+public:
+    /**
+     * @brief Default constructor.
+     */
+    Artist() = default;
+    /**
+     * @brief Parameterized constructor.
+     * @param id Artist ID.
+     * @param n Name.
+     * @param g Gender.
+     * @param p Phone.
+     * @param e Email.
+     */
+    Artist(const std::string& id, const std::string& n, char g, const std::string& p, const std::string& e)
+        : artistId(id), name(n), gender(g), phone(p), email(e) {}
+    /**
+     * @brief Gets the artist ID.
+     * @return Artist ID.
+     */
+    const std::string& getArtistId() const { return artistId; }
+    /**
+     * @brief Gets the artist's name.
+     * @return Artist's name.
+     */
+    const std::string& getName() const { return name; }
+    /**
+     * @brief Gets the artist's gender.
+     * @return Artist's gender.
+     */
+    char getGender() const { return gender; }
+    /**
+     * @brief Gets the artist's phone number.
+     * @return Artist's phone.
+     */
+    const std::string& getPhone() const { return phone; }
+    /**
+     * @brief Gets the artist's email.
+     * @return Artist's email.
+     */
+    const std::string& getEmail() const { return email; }
+    /**
+     * @brief Sets the artist ID.
+     * @param id New artist ID.
+     */
+    void setArtistId(const std::string& id) { artistId = id; }
+    /**
+     * @brief Sets the artist's name.
+     * @param n New name.
+     */
+    void setName(const std::string& n) { name = n; }
+    /**
+     * @brief Sets the artist's gender.
+     * @param g New gender.
+     */
+    void setGender(char g) { gender = g; }
+    /**
+     * @brief Sets the artist's phone number.
+     * @param p New phone.
+     */
+    void setPhone(const std::string& p) { phone = p; }
+    /**
+     * @brief Sets the artist's email.
+     * @param e New email.
+     */
+    void setEmail(const std::string& e) { email = e; }
+};
+
+// Memory accounting
+
+/**
+ * @brief Owners whose heap use is tracked by CountingAllocator.
+ */
+enum class MemoryCategory : std::uint8_t {
+    ArtistIndex, /**< artistList entries */
+    AlbumIndex,  /**< albumList entries */
+    UndoHistory, /**< Undo and redo stacks */
+    RecordCache, /**< Decoded record caches */
+    Count
+};
+
+/**
+ * @brief Live, peak and allocation counts for one category.
+ */
+struct MemoryCategoryStats {
+    std::atomic<std::int64_t> liveBytes{0};
+    std::atomic<std::int64_t> peakBytes{0};
+    std::atomic<std::uint64_t> allocations{0};
+};
+
+/**
+ * @brief Gets the counters of a category.
+ * @param category Memory category.
+ * @return Process-wide counters.
+ */
+inline MemoryCategoryStats& memoryCategoryStats(MemoryCategory category) {
+    static MemoryCategoryStats stats[static_cast<std::size_t>(MemoryCategory::Count)];
+    return stats[static_cast<std::size_t>(category)];
+}
+
+/**
+ * @brief Returns the lower_snake_case name of a category.
+ * @param category Memory category.
+ * @return Category name.
+ */
+const char* memoryCategoryName(MemoryCategory category);
+
+/**
+ * @brief Standard allocator that charges every block to a memory category.
+ *
+ * Accounting is three relaxed atomic operations per allocation. Only the container's own
+ * storage is counted; heap owned by the elements (long strings, std::function captures)
+ * is not.
+ */
+template <typename T, MemoryCategory Category>
+class CountingAllocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = CountingAllocator<U, Category>;
+    };
+
+    CountingAllocator() noexcept = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U, Category>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        T* block = std::allocator<T>().allocate(n);
+        MemoryCategoryStats& stats = memoryCategoryStats(Category);
+        auto bytes = static_cast<std::int64_t>(n * sizeof(T));
+        std::int64_t live = stats.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        stats.allocations.fetch_add(1, std::memory_order_relaxed);
+        std::int64_t peak = stats.peakBytes.load(std::memory_order_relaxed);
+        while (live > peak && !stats.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+        return block;
+    }
+
+    void deallocate(T* block, std::size_t n) noexcept {
+        std::allocator<T>().deallocate(block, n);
+        memoryCategoryStats(Category).liveBytes.fetch_sub(static_cast<std::int64_t>(n * sizeof(T)), std::memory_order_relaxed);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U, Category>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U, Category>&) const noexcept { return false; }
+};
+
+/**
+ * @brief Struct representing an artist index entry for quick lookup.
+ */
+struct artistIndex {
+    std::string artistId; /**< Artist ID starting from 1000 */
+    std::string name;     /**< Artist name */
+    long pos;             /**< Position in file */
+};
+
+/**
+ * @brief Struct containing a list of artist indices.
  */
 struct artistList {
-    std::vector<artistIndex> artList; /**< Vector of artist indices */
+    std::vector<artistIndex, CountingAllocator<artistIndex, MemoryCategory::ArtistIndex>> artList; /**< Vector of artist indices */
+    std::size_t live = 0; /**< Live entries in artList; kept up to date by load, add, delete, merge and their undos */
 };
 
 //Album information
@@ -394,17 +1333,138 @@ public:
  * @brief Struct representing an album index entry for quick lookup.
  */
 struct albumIndex {
-    std::string albumId;  /**< Album ID starting from 2000 */
-    std::string artistId; /**< Artist ID starting from 1000 */
-    std::string title;    /**< Album title */
-    long pos;             /**< Position in file */
+    std::string albumId;    /**< Album ID starting from 2000 */
+    std::string artistId;   /**< Artist ID starting from 1000 */
+    std::string title;      /**< Album title */
+    long pos;               /**< Position in file */
+    std::uint16_t year = 0; /**< Publication year, 0 when the date is malformed */
+    std::uint8_t format = 0; /**< recordFormatCode() of the record format, 0 when unknown */
+};
+
+/** @brief Number of record format codes, including 0 for unknown formats. */
+constexpr std::size_t RECORD_FORMAT_CODES = 11;
+
+/**
+ * @brief Maps a record format ("flac", case-insensitive) to its code.
+ * @param format Format as stored in the record.
+ * @return 1..RECORD_FORMAT_CODES-1 for the formats validateAlbumFormat accepts, else 0.
+ */
+std::uint8_t recordFormatCode(const std::string& format);
+
+/**
+ * @brief Label of a record format code.
+ * @param code Code from recordFormatCode().
+ * @return Lower-case format name, or "unknown" for 0 and out-of-range codes.
+ */
+const char* recordFormatLabel(std::uint8_t code);
+
+/**
+ * @brief Extracts the year of a DD/MM/YYYY date.
+ * @param date Date as stored in the record.
+ * @return The year, or 0 when the date has another shape.
+ */
+std::uint16_t publicationYear(const std::string& date);
+
+/**
+ * @brief Album totals kept up to date as the index changes, so reports never rescan it.
+ *
+ * Loads, restores and imports rebuild it with recountCatalogStatistics() once the index
+ * is sorted. The add, edit, delete, artist removal and merge commands (and their
+ * undo/redo) and the AlbumManager methods uncount an entry before changing it and count
+ * it again afterwards. Tombstones (albumId "-1") are never counted.
+ */
+struct CatalogStatistics {
+    std::size_t albums = 0; /**< Live albums */
+    std::unordered_map<std::string, std::size_t> albumsPerArtist; /**< Artist ID -> live albums; artists with none are absent */
+    std::array<std::size_t, RECORD_FORMAT_CODES> albumsPerFormat{}; /**< Live albums by format code */
+    std::map<std::uint16_t, std::size_t> albumsPerYear; /**< Year (0 = unknown) -> live albums; empty years are absent */
+
+    /**
+     * @brief Counts a live index entry; tombstones are ignored.
+     * @param entry Index entry.
+     */
+    void add(const albumIndex& entry);
+    /**
+     * @brief Uncounts a live index entry previously passed to add(); tombstones are ignored.
+     * @param entry Index entry.
+     */
+    void remove(const albumIndex& entry);
+    /**
+     * @brief Resets every count.
+     */
+    void clear();
+    /**
+     * @brief Live albums of one artist.
+     * @param artistId Artist ID.
+     * @return Album count.
+     */
+    std::size_t albumsBy(const std::string& artistId) const;
 };
 
 /**
  * @brief Struct containing a list of album indices.
  */
 struct albumList {
-    std::vector<albumIndex> albList; /**< Vector of album indices */
+    std::vector<albumIndex, CountingAllocator<albumIndex, MemoryCategory::AlbumIndex>> albList; /**< Vector of album indices */
+    CatalogStatistics stats; /**< Totals of the live entries in albList */
+};
+
+/**
+ * @brief Recomputes album.stats from album.albList in one pass.
+ *
+ * Entries of one artist are adjacent in a sorted index, so the per-artist map is touched
+ * once per artist rather than once per album.
+ * @param album Album list, normally just sorted.
+ */
+void recountCatalogStatistics(albumList& album);
+
+/**
+ * @brief Samples RSS and the allocator categories on a background thread and prints a
+ * memory breakdown on demand.
+ *
+ * Each sample updates the resident_memory_bytes, resident_memory_peak_bytes and
+ * memory_<category>_bytes gauges, so the metrics dump and exporter pick them up.
+ */
+class MemoryProfiler {
+public:
+    /**
+     * @brief Gets the singleton profiler.
+     * @return Profiler instance.
+     */
+    static MemoryProfiler& instance();
+    /**
+     * @brief Starts periodic sampling; restarts if already running.
+     * @param intervalSeconds Seconds between samples; 0 or less only samples on demand.
+     * @return True if the sampling thread was started.
+     */
+    bool start(int intervalSeconds);
+    /**
+     * @brief Stops the sampling thread; registered with atexit.
+     */
+    void stop();
+    /**
+     * @brief Takes one sample now and publishes it as gauges; safe from any thread.
+     */
+    void sample();
+    /**
+     * @brief Writes bytes per category, index string payloads, RSS and the unaccounted rest.
+     *
+     * Walks the lists to size their string payloads, so call it from the thread that owns them.
+     * @param out Stream to write to.
+     * @param artists Artist index.
+     * @param albums Album index.
+     */
+    void writeBreakdown(std::ostream& out, const artistList& artists, const albumList& albums);
+
+private:
+    MemoryProfiler() = default;
+    void run(int intervalSeconds);
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopRequested = false;
+    std::atomic<std::int64_t> peakResident{0};
 };
 
 /**
@@ -549,10 +1609,41 @@ class FileHandler;
 class ArtistView {
 public:
     /**
-     * @brief Displays all artists.
+     * @brief Pages through all live artists in index order, pageRows (config.json) at a time.
+     *
+     * Pages hold live entries only. Nothing is precomputed: each move walks the index from
+     * the current page, skipping deleted entries, and the page count comes from artist.live.
+     * Only the rows of the current page are read and formatted.
      * @param artist Artist list.
      */
     static void displayAll(const artistList& artist);
+    /**
+     * @brief Finds the index position where a page of live artists starts.
+     *
+     * Walks from whichever of the index start, the current page and the index end is fewest
+     * live entries away from the target, so moving to a neighbouring page costs one page of
+     * index entries however large the catalog is.
+     * @param artist Artist list.
+     * @param first Index position of the current page's first entry.
+     * @param current Current page, from 0.
+     * @param target Page to find, from 0.
+     * @param rows Live entries per page.
+     * @return Index position of the target page's first entry; artList.size() past the end.
+     */
+    static std::size_t pageStart(const artistList& artist, std::size_t first, std::size_t current, std::size_t target,
+                                 std::size_t rows);
+    /**
+     * @brief Formats one page of artists as a table.
+     * @param ArtFile Artist data stream.
+     * @param artist Artist list.
+     * @param first Index position of the page's first entry (see pageStart).
+     * @param rows Live entries per page; deleted entries are skipped without counting.
+     * @param number Row number shown for the first row.
+     * @param out Buffer receiving the table; cleared first and reused between pages.
+     * @return Rows formatted; fewer than rows only at the end of the index.
+     */
+    static std::size_t renderPage(std::istream& ArtFile, const artistList& artist, std::size_t first, std::size_t rows,
+                                  std::size_t number, std::string& out);
     /**
      * @brief Displays search results for artists.
      * @param artist Artist list.
@@ -579,11 +1670,36 @@ public:
 class AlbumView {
 public:
     /**
-     * @brief Displays all albums.
+     * @brief Pages through all albums in index order.
      * @param AlbFile Album file stream.
      * @param album Album list.
+     * @see ArtistView::displayAll
      */
     static void displayAll(std::fstream& AlbFile, const albumList& album);
+    /**
+     * @brief Finds the index position where a page of live albums starts.
+     * @param album Album list; album.stats.albums is the live count.
+     * @param first Index position of the current page's first entry.
+     * @param current Current page, from 0.
+     * @param target Page to find, from 0.
+     * @param rows Live entries per page.
+     * @return Index position of the target page's first entry; albList.size() past the end.
+     * @see ArtistView::pageStart
+     */
+    static std::size_t pageStart(const albumList& album, std::size_t first, std::size_t current, std::size_t target,
+                                 std::size_t rows);
+    /**
+     * @brief Formats one page of albums as a table.
+     * @param AlbFile Album data stream.
+     * @param album Album list.
+     * @param first Index position of the page's first entry (see pageStart).
+     * @param rows Live entries per page; deleted entries are skipped without counting.
+     * @param number Row number shown for the first row.
+     * @param out Buffer receiving the table; cleared first and reused between pages.
+     * @return Rows formatted; fewer than rows only at the end of the index.
+     */
+    static std::size_t renderPage(std::istream& AlbFile, const albumList& album, std::size_t first, std::size_t rows,
+                                  std::size_t number, std::string& out);
     /**
      * @brief Displays search results for albums.
      * @param AlbFile Album file stream.
@@ -603,84 +1719,910 @@ public:
 /**
  * @brief Static class for displaying menus and getting user choices.
  */
-class MenuView {
+class MenuView {
+public:
+    /**
+     * @brief Displays the main menu and gets user choice.
+     * @return User's menu choice.
+     */
+    static int mainMenu();
+    /**
+     * @brief Displays the artist menu and gets user choice.
+     * @return User's menu choice.
+     */
+    static int artistMenu();
+    /**
+     * @brief Displays the album menu and gets user choice.
+     * @return User's menu choice.
+     */
+    static int albumMenu();
+    /**
+     * @brief Displays the view artist menu and gets user choice.
+     * @return User's menu choice.
+     */
+    static int viewArtistMenu();
+    /**
+     * @brief Displays the view album menu and gets user choice.
+     * @return User's menu choice.
+     */
+    static int viewAlbumMenu();
+    /**
+     * @brief Displays the edit artist menu and gets user choice.
+     * @return User's menu choice.
+     */
+    static int editArtistMenu();
+    /**
+     * @brief Displays the edit album menu and gets user choice.
+     * @return User's menu choice.
+     */
+    static int editAlbumMenu();
+    /**
+     * @brief Displays the backup menu and gets user choice.
+     * @return User's menu choice.
+     */
+    static int backupMenu();
+    /**
+     * @brief Displays the statistics menu and gets user choice.
+     * @return User's menu choice.
+     */
+    static int statisticsMenu();
+};
+
+//Prototype Declarations
+
+/**
+ * @brief Displays the welcome message.
+ */
+void welcome();
+
+/**
+ * @brief Prints an error message based on error ID.
+ * @param errId Error identifier.
+ */
+void printError(int errId);
+
+/**
+ * @brief Largest number a record ID can carry.
+ *
+ * A record ID is a three-letter prefix and four more characters in a 7-character field.
+ * Numbers up to 9999 are written in decimal; larger ones use four base-62 characters
+ * (0-9, A-Z, a-z) that start with a letter, so they never collide with decimal IDs.
+ */
+const int MAX_RECORD_ID_NUMBER = 10000 + 52 * 62 * 62 * 62 - 1;
+
+/**
+ * @brief Writes the part of a record ID that follows its prefix.
+ * @param number ID number, at most MAX_RECORD_ID_NUMBER.
+ * @param out Receives the characters; needs room for 12 plus a terminator.
+ * @return Number of characters written, not counting the terminator.
+ */
+std::size_t formatRecordIdNumber(int number, char* out);
+
+/**
+ * @brief Converts an integer to a string with a prefix.
+ * @param last Last used ID.
+ * @param prefix Prefix string.
+ * @return Formatted string; see MAX_RECORD_ID_NUMBER for the encoding.
+ */
+std::string intToString(int last, const std::string& prefix);
+
+/**
+ * @brief Converts a char array to an integer.
+ * @param arr Char array containing the number, decimal or in the extended form.
+ * @return Integer value.
+ */
+int stringToInt(const std::string& arr);
+
+/**
+ * @brief Opens a file stream for the given path.
+ * @param fstr File stream to open.
+ * @param path File path.
+ */
+void openFile(std::fstream& fstr, const std::string& path);
+
+// Record Format
+
+/**
+ * @brief Magic bytes that open every versioned data file.
+ */
+const char RECORD_FILE_MAGIC[4] = {'A', 'M', 'S', 'D'};
+
+/**
+ * @brief Current on-disk record format version.
+ *
+ * Version 1 is the original headerless layout of raw ArtistFile/AlbumFile structs.
+ * Version 2 adds a file header and a CRC32C trailer after every record.
+ */
+const std::uint16_t RECORD_FORMAT_VERSION = 2;
+
+/**
+ * @brief Size in bytes of the data file header (magic, version, kind, record size, header CRC).
+ */
+const long RECORD_HEADER_SIZE = 16;
+
+/**
+ * @brief Size in bytes of the CRC32C trailer stored after each record payload.
+ */
+const long RECORD_CRC_SIZE = sizeof(std::uint32_t);
+
+/**
+ * @brief Size in bytes of one artist slot (payload plus CRC).
+ */
+const long ARTIST_RECORD_SIZE = sizeof(ArtistFile) + RECORD_CRC_SIZE;
+
+/**
+ * @brief Size in bytes of one album slot (payload plus CRC).
+ */
+const long ALBUM_RECORD_SIZE = sizeof(AlbumFile) + RECORD_CRC_SIZE;
+
+/**
+ * @brief Identifies which record type a data file holds.
+ */
+enum class RecordKind : std::uint16_t {
+    Artist = 1,
+    Album = 2
+};
+
+/**
+ * @brief Outcome of reading one record slot.
+ */
+enum class RecordStatus {
+    Ok,      /**< Payload read and CRC matched */
+    Corrupt, /**< Payload read but CRC did not match */
+    Missing  /**< Slot lies beyond the end of the file */
+};
+
+/**
+ * @brief Returns the slot size for a record kind.
+ * @param kind Record kind.
+ * @return Slot size in bytes.
+ */
+long recordSizeFor(RecordKind kind);
+
+/**
+ * @brief Returns how many complete record slots a data file stream holds.
+ * @param in Stream positioned anywhere; the position is not preserved.
+ * @param kind Record kind stored in the stream.
+ * @return Number of complete slots after the header.
+ */
+long recordCount(std::istream& in, RecordKind kind);
+
+/**
+ * @brief Reads an artist record and verifies its CRC.
+ * @param in Data file stream.
+ * @param pos Byte offset of the slot.
+ * @param record Receives the payload (filled even when corrupt).
+ * @return Read status.
+ */
+RecordStatus readRecordAt(std::istream& in, long pos, ArtistFile& record);
+
+/**
+ * @brief Reads an album record and verifies its CRC.
+ * @param in Data file stream.
+ * @param pos Byte offset of the slot.
+ * @param record Receives the payload (filled even when corrupt).
+ * @return Read status.
+ */
+RecordStatus readRecordAt(std::istream& in, long pos, AlbumFile& record);
+
+/**
+ * @brief Writes an artist record with its CRC trailer.
+ * @param out Data file stream.
+ * @param pos Byte offset of the slot.
+ * @param record Payload to write.
+ * @return True if the write succeeded.
+ */
+bool writeRecordAt(std::ostream& out, long pos, const ArtistFile& record);
+
+/**
+ * @brief Writes an album record with its CRC trailer.
+ * @param out Data file stream.
+ * @param pos Byte offset of the slot.
+ * @param record Payload to write.
+ * @return True if the write succeeded.
+ */
+bool writeRecordAt(std::ostream& out, long pos, const AlbumFile& record);
+
+/**
+ * @brief Appends an artist record after the last complete slot.
+ * @param io Data file stream.
+ * @param record Payload to write.
+ * @param outPos Receives the byte offset of the new slot.
+ * @return True if the write succeeded.
+ */
+bool appendRecord(std::fstream& io, const ArtistFile& record, long& outPos);
+
+/**
+ * @brief Appends an album record after the last complete slot.
+ * @param io Data file stream.
+ * @param record Payload to write.
+ * @param outPos Receives the byte offset of the new slot.
+ * @return True if the write succeeded.
+ */
+bool appendRecord(std::fstream& io, const AlbumFile& record, long& outPos);
+
+/**
+ * @brief Writes a fresh version 2 header at the start of a stream.
+ * @param out Stream to write to.
+ * @param kind Record kind the file will hold.
+ * @return True if the write succeeded.
+ */
+bool writeRecordFileHeader(std::ostream& out, RecordKind kind);
+
+/**
+ * @brief Checks whether a non-empty file predates the versioned record format.
+ * @param path File path.
+ * @return True if the file has data but no version 2 header.
+ */
+bool isLegacyRecordFile(const std::string& path);
+
+/**
+ * @brief Rewrites a legacy data file into the versioned format.
+ *
+ * The original file is kept beside the new one with a ".v1" suffix.
+ * @param path File path.
+ * @param kind Record kind stored in the file.
+ * @return True if the file was migrated (or did not need it).
+ */
+bool migrateLegacyRecordFile(const std::string& path, RecordKind kind);
+
+/**
+ * @brief Opens a data file, migrating legacy files and initialising empty ones.
+ *
+ * Drops the RecordCache entries of the kind, since the cache does not tell files apart.
+ * @param fstr File stream to open.
+ * @param path File path.
+ * @param kind Record kind stored in the file.
+ * @throws FileException if the file cannot be opened or holds another format.
+ */
+void openRecordFile(std::fstream& fstr, const std::string& path, RecordKind kind);
+
+/**
+ * @brief A single problem found while scrubbing a data file.
+ */
+struct ScrubIssue {
+    long offset = 0;    /**< Byte offset of the bad header, slot or tail */
+    std::string reason; /**< Human readable description */
+};
+
+/**
+ * @brief Result of scrubbing one data file.
+ */
+struct ScrubReport {
+    std::string path;               /**< File that was scrubbed */
+    RecordKind kind = RecordKind::Artist; /**< Record kind expected in the file */
+    long records = 0;               /**< Number of complete slots checked */
+    std::vector<ScrubIssue> issues; /**< Problems ordered by offset */
+
+    /**
+     * @brief Checks whether the scrub found no problems.
+     * @return True if clean.
+     */
+    bool clean() const { return issues.empty(); }
+};
+
+/**
+ * @brief Validates the header and every record CRC of a data file.
+ *
+ * The slots are split into contiguous ranges that are read in large blocks by worker threads.
+ * @param path File path.
+ * @param kind Record kind expected in the file.
+ * @param threads Worker count; 0 uses the hardware concurrency.
+ * @return Scrub report listing bad offsets.
+ */
+ScrubReport scrubRecordFile(const std::string& path, RecordKind kind, unsigned threads = 0);
+
+/**
+ * @brief Scrubs the configured artist and album files and prints any problems.
+ * @param verbose Also print a summary when the files are clean.
+ * @return True if both files are clean.
+ */
+bool scrubDataFiles(bool verbose);
+
+/**
+ * @brief Copies a snapshot of the artist file to a staging path while indexing it.
+ *
+ * The snapshot is read once in large blocks; each block is written to the staging file and its
+ * records are added to the index in the same pass. Legacy (v1) snapshots are converted first.
+ * The caller renames the staging file over the live file to install it.
+ * @param source Snapshot file.
+ * @param stagedPath Staging file to create.
+ * @param artists Receives the index of live records.
+ * @param deleted Receives the positions of free slots.
+ * @return True if the staging file was written completely.
+ */
+bool stageRestoredRecords(const std::string& source, const std::string& stagedPath, artistList& artists, indexSet& deleted);
+
+/**
+ * @brief Album counterpart of the artist overload.
+ * @param source Snapshot file.
+ * @param stagedPath Staging file to create.
+ * @param albums Receives the index of live records.
+ * @param deleted Receives the positions of free slots.
+ * @return True if the staging file was written completely.
+ */
+bool stageRestoredRecords(const std::string& source, const std::string& stagedPath, albumList& albums, indexSet& deleted);
+
+// Record Decoding
+
+/**
+ * @brief Lengths of the text fields of an artist record, up to their NUL terminator.
+ */
+struct ArtistFieldLengths {
+    std::size_t artistId = 0;
+    std::size_t name = 0;
+    std::size_t phone = 0;
+    std::size_t email = 0;
+};
+
+/**
+ * @brief Lengths of the text fields of an album record, up to their NUL terminator.
+ */
+struct AlbumFieldLengths {
+    std::size_t albumId = 0;
+    std::size_t artistIdRef = 0;
+    std::size_t title = 0;
+    std::size_t recordFormat = 0;
+    std::size_t datePublished = 0;
+    std::size_t path = 0;
+};
+
+/**
+ * @brief Implementation used to scan a record.
+ */
+enum class RecordDecoderPath {
+    Scalar, /**< Byte at a time; always available */
+    Simd    /**< 16 bytes per step (SSE2 on x86-64); falls back to Scalar elsewhere */
+};
+
+/**
+ * @brief Checks whether RecordDecoderPath::Simd has a vector implementation in this build.
+ * @return True on x86-64.
+ */
+bool simdRecordDecoderAvailable();
+
+/**
+ * @brief Sanitizes an artist record in place and measures its fields.
+ *
+ * The whole record is scanned at once: every byte that is neither NUL nor printable ASCII
+ * becomes a space, the last byte of each text field becomes NUL, an unprintable gender
+ * becomes a space, and the field lengths come from the NUL positions found in the same scan.
+ * Both paths produce identical bytes.
+ * @param record Record to decode.
+ * @param lengths Receives the field lengths.
+ * @param path Implementation to use.
+ */
+void decodeRecord(ArtistFile& record, ArtistFieldLengths& lengths, RecordDecoderPath path = RecordDecoderPath::Simd);
+
+/**
+ * @brief Sanitizes an album record in place and measures its fields.
+ * @param record Record to decode.
+ * @param lengths Receives the field lengths.
+ * @param path Implementation to use.
+ * @see decodeRecord(ArtistFile&, ArtistFieldLengths&, RecordDecoderPath)
+ */
+void decodeRecord(AlbumFile& record, AlbumFieldLengths& lengths, RecordDecoderPath path = RecordDecoderPath::Simd);
+
+/**
+ * @brief Measures the fields of an artist record without changing it.
+ *
+ * A field without a NUL ends before its last byte. Exporters use this to keep the stored bytes.
+ * @param record Record to scan.
+ * @param lengths Receives the field lengths.
+ * @param path Implementation to use.
+ */
+void measureRecord(const ArtistFile& record, ArtistFieldLengths& lengths, RecordDecoderPath path = RecordDecoderPath::Simd);
+
+/**
+ * @brief Measures the fields of an album record without changing it.
+ * @param record Record to scan.
+ * @param lengths Receives the field lengths.
+ * @param path Implementation to use.
+ */
+void measureRecord(const AlbumFile& record, AlbumFieldLengths& lengths, RecordDecoderPath path = RecordDecoderPath::Simd);
+
+// Record Fields
+
+/**
+ * @brief One fixed-width text field of a record struct.
+ *
+ * The field tables are the one description of the record layout shared by the Artist/Album
+ * conversions, the CSV and JSON Lines exports and the imports.
+ */
+struct RecordFieldSpec {
+    const char* name;     /**< CSV column and JSON key */
+    std::size_t offset;   /**< Byte offset in the record */
+    std::size_t size;     /**< Bytes the field occupies */
+    std::size_t capacity; /**< Longest text it holds: size - 1, or 1 for the gender byte */
+};
+
+/**
+ * @brief Artist record fields, in export order.
+ */
+enum ArtistField : std::size_t {
+    ARTIST_FIELD_ID,
+    ARTIST_FIELD_NAME,
+    ARTIST_FIELD_GENDER,
+    ARTIST_FIELD_PHONE,
+    ARTIST_FIELD_EMAIL,
+    ARTIST_FIELD_COUNT
+};
+
+/**
+ * @brief Album record fields, in export order.
+ */
+enum AlbumField : std::size_t {
+    ALBUM_FIELD_ID,
+    ALBUM_FIELD_ARTIST_ID,
+    ALBUM_FIELD_TITLE,
+    ALBUM_FIELD_RECORD_FORMAT,
+    ALBUM_FIELD_DATE_PUBLISHED,
+    ALBUM_FIELD_PATH,
+    ALBUM_FIELD_COUNT
+};
+
+extern const RecordFieldSpec ARTIST_FIELDS[ARTIST_FIELD_COUNT]; /**< Indexed by ArtistField */
+extern const RecordFieldSpec ALBUM_FIELDS[ALBUM_FIELD_COUNT];   /**< Indexed by AlbumField */
+
+/**
+ * @brief Calls visit(field, spec, text, length) for each field of an artist record, in order.
+ *
+ * Lengths come from measureRecord, so text points into the record and nothing is allocated.
+ * The gender byte has length 0 when it is NUL.
+ * @param record Record to read.
+ * @param visit Field visitor.
+ */
+template <typename Visitor>
+void forEachRecordField(const ArtistFile& record, Visitor&& visit) {
+    ArtistFieldLengths lengths;
+    measureRecord(record, lengths);
+    const std::size_t measured[ARTIST_FIELD_COUNT] = {
+        lengths.artistId, lengths.name, record.genders != '\0' ? std::size_t{1} : std::size_t{0}, lengths.phone, lengths.email};
+    const char* base = reinterpret_cast<const char*>(&record);
+    for (std::size_t field = 0; field < ARTIST_FIELD_COUNT; ++field) {
+        visit(field, ARTIST_FIELDS[field], base + ARTIST_FIELDS[field].offset, measured[field]);
+    }
+}
+
+/**
+ * @brief Calls visit(field, spec, text, length) for each field of an album record, in order.
+ * @param record Record to read.
+ * @param visit Field visitor.
+ * @see forEachRecordField(const ArtistFile&, Visitor&&)
+ */
+template <typename Visitor>
+void forEachRecordField(const AlbumFile& record, Visitor&& visit) {
+    AlbumFieldLengths lengths;
+    measureRecord(record, lengths);
+    const std::size_t measured[ALBUM_FIELD_COUNT] = {
+        lengths.albumId, lengths.artistIdRef, lengths.title, lengths.recordFormat, lengths.datePublished, lengths.path};
+    const char* base = reinterpret_cast<const char*>(&record);
+    for (std::size_t field = 0; field < ALBUM_FIELD_COUNT; ++field) {
+        visit(field, ALBUM_FIELDS[field], base + ALBUM_FIELDS[field].offset, measured[field]);
+    }
+}
+
+/**
+ * @brief Stores text in one field of an artist record.
+ *
+ * Text longer than the field's capacity is cut; the rest of the field is zero-filled.
+ * @param record Record to change.
+ * @param field Field to set.
+ * @param text Field text.
+ * @param length Bytes of text.
+ */
+void setRecordField(ArtistFile& record, ArtistField field, const char* text, std::size_t length);
+
+/**
+ * @brief Stores text in one field of an album record.
+ * @param record Record to change.
+ * @param field Field to set.
+ * @param text Field text.
+ * @param length Bytes of text.
+ * @see setRecordField(ArtistFile&, ArtistField, const char*, std::size_t)
+ */
+void setRecordField(AlbumFile& record, AlbumField field, const char* text, std::size_t length);
+
+/**
+ * @brief Stores a string in one field of an artist record.
+ * @param record Record to change.
+ * @param field Field to set.
+ * @param text Field text.
+ */
+inline void setRecordField(ArtistFile& record, ArtistField field, const std::string& text) {
+    setRecordField(record, field, text.data(), text.size());
+}
+
+/**
+ * @brief Stores a string in one field of an album record.
+ * @param record Record to change.
+ * @param field Field to set.
+ * @param text Field text.
+ */
+inline void setRecordField(AlbumFile& record, AlbumField field, const std::string& text) {
+    setRecordField(record, field, text.data(), text.size());
+}
+
+// Record Cache
+
+/**
+ * @brief Default number of records held by RecordCache (recordCacheEntries in config.json).
+ */
+const std::size_t RECORD_CACHE_DEFAULT_ENTRIES = 4096;
+
+/**
+ * @brief Counters of the record cache.
+ */
+struct RecordCacheStats {
+    std::uint64_t hits = 0;          /**< Reads served from the cache */
+    std::uint64_t misses = 0;        /**< Reads that went to the file */
+    std::uint64_t invalidations = 0; /**< Cached slots dropped because they were written */
+    std::uint64_t evictions = 0;     /**< Least recently used slots dropped to make room */
+    std::size_t entries = 0;         /**< Records currently cached */
+    std::size_t capacity = 0;        /**< Maximum records cached; 0 disables the cache */
+};
+
+/**
+ * @brief Bounded LRU cache of decoded, sanitized records keyed by record kind and file offset.
+ *
+ * The views and the artist/album selection screens read through it, so paging back and forth
+ * neither re-reads nor re-decodes a record (decodeRecord). Only slots whose CRC matched are cached.
+ * Every write to a data file drops exactly the slots it covers: writeRecordAt, appendRecord,
+ * block appends and album re-parenting per slot, header resets, migration and restores per
+ * file. Keys do not name the file, so opening a data file (openRecordFile, which every loader
+ * and repository goes through) clears its kind. Entries sit in one slab linked into an intrusive
+ * LRU list; the slab and the offset map are charged to MemoryCategory::RecordCache.
+ */
+class RecordCache {
+public:
+    /**
+     * @brief Gets the process-wide cache.
+     * @return Cache instance.
+     */
+    static RecordCache& instance();
+    /**
+     * @brief Reads a sanitized artist record, from the cache when possible.
+     * @param in Artist data stream used on a miss.
+     * @param pos Byte offset of the slot.
+     * @param record Receives the sanitized payload (raw bytes when corrupt).
+     * @return Read status of the slot.
+     */
+    RecordStatus read(std::istream& in, long pos, ArtistFile& record);
+    /**
+     * @brief Reads a sanitized album record, from the cache when possible.
+     * @param in Album data stream used on a miss.
+     * @param pos Byte offset of the slot.
+     * @param record Receives the sanitized payload (raw bytes when corrupt).
+     * @return Read status of the slot.
+     */
+    RecordStatus read(std::istream& in, long pos, AlbumFile& record);
+    /**
+     * @brief Drops the consecutive slots written by one operation.
+     * @param kind Record kind of the file written.
+     * @param firstPos Byte offset of the first slot.
+     * @param count Number of slots.
+     */
+    void invalidate(RecordKind kind, long firstPos, std::size_t count = 1);
+    /**
+     * @brief Drops every cached record of one kind.
+     * @param kind Record kind.
+     */
+    void clear(RecordKind kind);
+    /**
+     * @brief Drops every cached record and releases the slab.
+     */
+    void clear();
+    /**
+     * @brief Changes the number of records kept; the cache is emptied.
+     * @param entries Maximum records; 0 disables caching.
+     */
+    void setCapacity(std::size_t entries);
+    /**
+     * @brief Copies the counters.
+     * @return Current statistics.
+     */
+    RecordCacheStats stats() const;
+
+private:
+    static constexpr std::uint32_t NONE = UINT32_MAX;
+
+    struct Entry {
+        std::uint64_t key;  /**< Record kind in the top byte, file offset below */
+        std::uint32_t prev; /**< Toward the most recently used entry */
+        std::uint32_t next; /**< Toward the least recently used entry */
+        union {
+            ArtistFile artist;
+            AlbumFile album;
+        };
+    };
+
+    RecordCache() = default;
+    template <typename Record>
+    RecordStatus readThrough(std::istream& in, long pos, Record& record);
+    void unlink(std::uint32_t slot);
+    void pushFront(std::uint32_t slot);
+    void remove(std::uint32_t slot);
+
+    mutable std::mutex mutex;
+    std::vector<Entry, CountingAllocator<Entry, MemoryCategory::RecordCache>> entries;
+    std::vector<std::uint32_t, CountingAllocator<std::uint32_t, MemoryCategory::RecordCache>> freeSlots;
+    std::unordered_map<std::uint64_t, std::uint32_t, std::hash<std::uint64_t>, std::equal_to<std::uint64_t>,
+                       CountingAllocator<std::pair<const std::uint64_t, std::uint32_t>, MemoryCategory::RecordCache>> slots;
+    std::uint32_t head = NONE;
+    std::uint32_t tail = NONE;
+    std::size_t capacity = RECORD_CACHE_DEFAULT_ENTRIES;
+    RecordCacheStats counters;
+};
+
+// Synthetic Catalog Generator
+
+/**
+ * @brief Version of the generator output. Bumped whenever the same settings start producing
+ * different files, so tools that cache generated catalogs know to regenerate them.
+ */
+const int SYNTHETIC_CATALOG_VERSION = 2;
+
+/**
+ * @brief Shape of a generated catalog. The same settings always produce byte-identical files.
+ */
+struct CatalogGeneratorSettings {
+    std::uint64_t seed = 1;        /**< Seed for every random choice */
+    std::int64_t artists = 1000;   /**< Live artist records */
+    std::int64_t albums = 4000;    /**< Live album records */
+    double zipfExponent = 1.1;     /**< Skew of albums per artist (0 = uniform) */
+    unsigned maxTitleWords = 8;    /**< Longest album title in words; most titles are short */
+    int firstYear = 1960;          /**< Earliest publication year */
+    int lastYear = 2024;           /**< Latest publication year */
+    double tombstoneRatio = 0.0;   /**< Fraction of slots in each file left as deleted (-1) records */
+};
+
+/**
+ * @brief Counts and timing from one generator run.
+ */
+struct CatalogGeneratorReport {
+    std::int64_t artistSlots = 0;      /**< Slots written to the artist file, tombstones included */
+    std::int64_t albumSlots = 0;       /**< Slots written to the album file, tombstones included */
+    std::int64_t artistTombstones = 0; /**< Deleted artist slots */
+    std::int64_t albumTombstones = 0;  /**< Deleted album slots */
+    std::uint64_t bytesWritten = 0;    /**< Total bytes across both files */
+    double seconds = 0.0;              /**< Wall time for the whole run */
+};
+
+/**
+ * @brief Writes a synthetic artist file and album file in the current record format.
+ *
+ * Albums are assigned to artists by a Zipf distribution over a seeded artist ranking, titles
+ * vary in length, dates spread over the configured years and tombstones are interleaved at
+ * the requested ratio. Slots are encoded into large blocks and written sequentially; the
+ * change journal is not touched. IDs follow the application's art/alb numbering, which
+ * switches to the extended form past 9999 (see MAX_RECORD_ID_NUMBER); settings that would
+ * run past the ID space are rejected.
+ * @param artistPath Artist file to create (replaced if present).
+ * @param albumPath Album file to create (replaced if present).
+ * @param settings Catalog shape.
+ * @param report Optional; receives counts and timing.
+ * @return True if both files were written completely.
+ */
+bool generateSyntheticCatalog(const std::string& artistPath, const std::string& albumPath,
+                              const CatalogGeneratorSettings& settings, CatalogGeneratorReport* report = nullptr);
+
+/**
+ * @brief Prepares the catalog directory shared by the benchmark and perf-gate tools.
+ *
+ * The catalog holds `records` albums and a quarter as many artists (seed 42, 2% tombstones)
+ * in directory/Artist.bin and directory/Album.bin. It is generated only when
+ * directory/catalog.stamp does not match these settings, the record format and
+ * SYNTHETIC_CATALOG_VERSION, so repeated runs reuse it. A config.json pointing the
+ * application at the catalog, with backups under directory/backups, is rewritten every time.
+ * @param directory Catalog directory, created if missing.
+ * @param records Number of live album records.
+ * @param progress Optional; told when a catalog has to be generated.
+ * @return Path of the config.json, or an empty string if generation failed.
+ */
+std::string prepareSyntheticCatalogDirectory(const std::string& directory, std::int64_t records,
+                                             std::ostream* progress = nullptr);
+
+// Performance Regression Gate
+
+/**
+ * @brief Repeated timings of one operation, one sample per repetition.
+ */
+struct PerfSeries {
+    std::string name;                   /**< Operation name, e.g. "load_albums" */
+    std::vector<double> samplesNs;      /**< Nanoseconds per operation, one entry per repetition */
+};
+
+/**
+ * @brief One stored perf run, as written by album_perf run.
+ */
+struct PerfRun {
+    std::string label;                  /**< Free-form run label (commit, branch, machine) */
+    std::string timestamp;              /**< Local time the run finished, "YYYY-MM-DD HH:MM:SS" */
+    std::string version;                /**< Application version that produced the run */
+    std::int64_t records = 0;           /**< Album records in the catalog the run used */
+    std::vector<PerfSeries> series;     /**< One entry per timed operation */
+};
+
+/**
+ * @brief Writes a perf run as JSON.
+ * @param out Destination stream.
+ * @param run Run to write.
+ * @return True if the stream is still good.
+ */
+bool writePerfRun(std::ostream& out, const PerfRun& run);
+
+/**
+ * @brief Reads a perf run written by writePerfRun.
+ * @param in Source stream.
+ * @param run Receives the run.
+ * @return False if the input is not a perf run document.
+ */
+bool readPerfRun(std::istream& in, PerfRun& run);
+
+/**
+ * @brief Outcome of comparing one operation across two runs.
+ */
+enum class PerfVerdict {
+    Unchanged,    /**< No significant difference beyond the threshold */
+    Regression,   /**< Significantly slower by more than the threshold */
+    Improvement,  /**< Significantly faster by more than the threshold */
+    Insufficient  /**< Fewer than two samples on one side, or missing from one run */
+};
+
+/**
+ * @brief Welch comparison of one operation between a baseline and a candidate run.
+ */
+struct PerfComparison {
+    std::string name;                   /**< Operation name */
+    double baselineMeanNs = 0.0;        /**< Baseline mean */
+    double candidateMeanNs = 0.0;       /**< Candidate mean */
+    double deltaPercent = 0.0;          /**< (candidate - baseline) / baseline, in percent */
+    double ciLowPercent = 0.0;          /**< Lower confidence bound of deltaPercent */
+    double ciHighPercent = 0.0;         /**< Upper confidence bound of deltaPercent */
+    PerfVerdict verdict = PerfVerdict::Insufficient;
+};
+
+/**
+ * @brief Compares two sample sets with Welch's t-test.
+ *
+ * A regression is flagged only when the whole confidence interval of the slowdown lies above
+ * thresholdPercent; the threshold absorbs the run-to-run drift that repeated samples within
+ * one run cannot see, and the interval keeps large but noisy differences from failing.
+ * @param baseline Baseline samples.
+ * @param candidate Candidate samples.
+ * @param thresholdPercent Smallest slowdown worth flagging.
+ * @param confidence Two-sided confidence level (0.90, 0.95 or 0.99).
+ * @return Comparison result.
+ */
+PerfComparison comparePerfSeries(const PerfSeries& baseline, const PerfSeries& candidate,
+                                 double thresholdPercent = 10.0, double confidence = 0.95);
+
+/**
+ * @brief Compares every operation of the candidate run against the baseline run.
+ * @param baseline Baseline run.
+ * @param candidate Candidate run.
+ * @param thresholdPercent Smallest slowdown worth flagging.
+ * @param confidence Two-sided confidence level.
+ * @return One comparison per operation found in either run, in candidate order.
+ */
+std::vector<PerfComparison> comparePerfRuns(const PerfRun& baseline, const PerfRun& candidate,
+                                            double thresholdPercent = 10.0, double confidence = 0.95);
+
+/**
+ * @brief Gets a short name for a verdict ("ok", "REGRESSION", "faster", "n/a").
+ * @param verdict Verdict.
+ * @return Verdict name.
+ */
+const char* perfVerdictName(PerfVerdict verdict);
+
+// Change Journal
+
+/**
+ * @brief Kind of change captured by a journal entry.
+ */
+enum class JournalOp : std::uint8_t {
+    Write = 1, /**< A record slot was written */
+    Reset = 2  /**< The data file was reinitialised to an empty header */
+};
+
+/**
+ * @brief One decoded change journal entry.
+ */
+struct JournalEntry {
+    std::int64_t timestampMs = 0;         /**< Wall clock time of the change in ms since the epoch */
+    RecordKind kind = RecordKind::Artist; /**< Data file the change applies to */
+    JournalOp op = JournalOp::Write;      /**< Type of change */
+    long pos = 0;                         /**< Byte offset of the written slot */
+    std::vector<unsigned char> payload;   /**< Record payload for writes */
+};
+
+/**
+ * @brief Append-only log of record mutations used for point-in-time restore.
+ *
+ * Every record write made through writeRecordAt/appendRecord is appended as a
+ * physical redo entry. Journaling stays off until open() is called, so tools and
+ * tests that write scratch data files never touch the application journal.
+ */
+class ChangeJournal {
 public:
     /**
-     * @brief Displays the main menu and gets user choice.
-     * @return User's menu choice.
+     * @brief Gets the process-wide journal.
+     * @return Journal instance.
      */
-    static int mainMenu();
+    static ChangeJournal& instance();
     /**
-     * @brief Displays the artist menu and gets user choice.
-     * @return User's menu choice.
+     * @brief Opens (or creates) the journal file for appending.
+     * @param path Journal file path.
+     * @return True if the journal is ready.
      */
-    static int artistMenu();
+    bool open(const std::string& path);
     /**
-     * @brief Displays the album menu and gets user choice.
-     * @return User's menu choice.
+     * @brief Stops journaling and closes the file.
      */
-    static int albumMenu();
+    void close();
     /**
-     * @brief Displays the view artist menu and gets user choice.
-     * @return User's menu choice.
+     * @brief Checks whether changes are currently journaled.
+     * @return True if open.
      */
-    static int viewArtistMenu();
+    bool isOpen() const;
     /**
-     * @brief Displays the view album menu and gets user choice.
-     * @return User's menu choice.
+     * @brief Returns the byte offset the next entry will be written at.
+     * @return End offset, or -1 when closed.
      */
-    static int viewAlbumMenu();
+    std::int64_t endOffset() const;
     /**
-     * @brief Displays the edit artist menu and gets user choice.
-     * @return User's menu choice.
+     * @brief Appends one change and flushes it.
+     * @param kind Data file the change applies to.
+     * @param op Type of change.
+     * @param pos Byte offset of the slot.
+     * @param payload Record payload (may be null for resets).
+     * @param length Payload length in bytes.
      */
-    static int editArtistMenu();
+    void append(RecordKind kind, JournalOp op, long pos, const void* payload, std::size_t length);
     /**
-     * @brief Displays the edit album menu and gets user choice.
-     * @return User's menu choice.
+     * @brief Appends one Write entry per slot of a contiguous block and flushes once.
+     * @param kind Data file the slots belong to.
+     * @param firstPos Byte offset of the first slot.
+     * @param slots Encoded slots (payload followed by CRC32C), back to back.
+     * @param count Number of slots.
      */
-    static int editAlbumMenu();
+    void appendWrites(RecordKind kind, long firstPos, const unsigned char* slots, std::size_t count);
     /**
-     * @brief Displays the backup menu and gets user choice.
-     * @return User's menu choice.
+     * @brief Reads the entry at the stream position.
+     * @param in Journal stream.
+     * @param entry Receives the decoded entry.
+     * @return False at end of journal or on a torn/corrupt entry.
      */
-    static int backupMenu();
-};
-
-//Prototype Declarations
-
-/**
- * @brief Displays the welcome message.
- */
-void welcome();
-
-/**
- * @brief Prints an error message based on error ID.
- * @param errId Error identifier.
- */
-void printError(int errId);
+    static bool readEntry(std::istream& in, JournalEntry& entry);
 
-/**
- * @brief Converts an integer to a string with a prefix.
- * @param last Last used ID.
- * @param prefix Prefix string.
- * @return Formatted string.
- */
-std::string intToString(int last, const std::string& prefix);
+private:
+    ChangeJournal() = default;
+    std::ofstream file;       /**< Journal output stream */
+    std::string filePath;     /**< Journal path */
+    std::int64_t offset = -1; /**< Current end offset */
+};
 
 /**
- * @brief Converts a char array to an integer.
- * @param arr Char array containing the number.
- * @return Integer value.
+ * @brief Returns the wall clock time used for journal timestamps.
+ * @return Milliseconds since the epoch.
  */
-int stringToInt(const std::string& arr);
+std::int64_t currentTimeMillis();
 
 /**
- * @brief Opens a file stream for the given path.
- * @param fstr File stream to open.
- * @param path File path.
+ * @brief Replays journal entries onto a pair of data files.
+ *
+ * Reading starts at fromOffset (the journal end recorded with a snapshot) and stops at
+ * the first entry newer than untilMs, so the cost depends only on the replayed changes.
+ * @param journalPath Journal file path.
+ * @param fromOffset Byte offset to start reading at.
+ * @param untilMs Last timestamp to apply, in ms since the epoch.
+ * @param artistPath Artist data file to modify.
+ * @param albumPath Album data file to modify.
+ * @param applied Receives the number of entries applied.
+ * @return True if the files were updated without I/O errors.
  */
-void openFile(std::fstream& fstr, const std::string& path);
+bool replayJournal(const std::string& journalPath, std::int64_t fromOffset, std::int64_t untilMs,
+                   const std::string& artistPath, const std::string& albumPath, std::size_t& applied);
 
 
 /**
@@ -859,6 +2801,15 @@ int editArtistMenu();
  */
 bool addArtist(std::fstream& ArtFile, artistList& artist);
 
+/**
+ * @brief Adds an artist without prompting, as one undoable command.
+ * @param ArtFile Artist file stream.
+ * @param artist Artist list.
+ * @param art Artist details; a fresh ID is assigned.
+ * @return True if added successfully.
+ */
+bool addArtistRecord(std::fstream& ArtFile, artistList& artist, Artist art);
+
 /**
  * @brief Gets artist information from user input.
  * @return Artist object with user input.
@@ -957,6 +2908,16 @@ int selectArtist(std::fstream& ArtFile, const artistList& artist, indexSet& resu
  */
 bool editArtistInfo(std::fstream& ArtFile, artistList& artist, int idx);
 
+/**
+ * @brief Replaces an artist's details without prompting, as one undoable command.
+ * @param ArtFile Artist file stream.
+ * @param artist Artist list.
+ * @param idx Index of artist to edit.
+ * @param updated New details; the existing artist ID is kept.
+ * @return True if edited successfully.
+ */
+bool editArtistRecord(std::fstream& ArtFile, artistList& artist, int idx, Artist updated);
+
 /**
  * @brief Displays a single artist.
  * @param ArtFile Artist file stream.
@@ -989,6 +2950,52 @@ void deleteArtist(std::fstream& ArtFile, std::fstream& AlbFile, artistList& arti
  */
 void removeArtist(std::fstream& ArtFile, std::fstream& AlbFile, artistList& artist, albumList& album, indexSet& delArtArray, indexSet& delAlbArray, int idx);
 
+/**
+ * @brief Removes an artist and its albums without confirmation, as one undoable command.
+ * @param ArtFile Artist file stream.
+ * @param AlbFile Album file stream.
+ * @param artist Artist list.
+ * @param album Album list.
+ * @param delArtArray Deleted artist indices.
+ * @param delAlbArray Deleted album indices.
+ * @param idx Index to remove.
+ * @return True if removed successfully.
+ */
+bool removeArtistRecord(std::fstream& ArtFile, std::fstream& AlbFile, artistList& artist, albumList& album, indexSet& delArtArray, indexSet& delAlbArray, int idx);
+
+/**
+ * @brief Merges a duplicate artist into a canonical one as one undoable command.
+ *
+ * Every album of the duplicate is re-pointed to the canonical artist with one sorted batch
+ * of slot rewrites, where adjacent slots share one write and one journal flush. The duplicate
+ * is then tombstoned and the album index updated in one pass. All album slots are read and
+ * checked before anything is written, and a failed write puts back the slots already
+ * rewritten, so a failed merge (or undo) leaves both files and the indexes as they were.
+ * @param ArtFile Artist file stream.
+ * @param AlbFile Album file stream.
+ * @param artist Artist list.
+ * @param album Album list.
+ * @param delArtArray Deleted artist indices.
+ * @param duplicateIdx Index of the artist to merge away.
+ * @param canonicalIdx Index of the artist that keeps the albums.
+ * @param movedAlbums Receives the number of re-parented albums when not null.
+ * @return False for invalid or equal indexes, a corrupt album slot or an I/O error.
+ */
+bool mergeArtists(std::fstream& ArtFile, std::fstream& AlbFile, artistList& artist, albumList& album,
+                  indexSet& delArtArray, int duplicateIdx, int canonicalIdx, std::size_t* movedAlbums = nullptr);
+
+/**
+ * @brief Prompts for a duplicate and a canonical artist and merges them.
+ * @param ArtFile Artist file stream.
+ * @param AlbFile Album file stream.
+ * @param artist Artist list.
+ * @param album Album list.
+ * @param result Search result scratch set.
+ * @param delArtArray Deleted artist indices.
+ */
+void mergeArtistsMenu(std::fstream& ArtFile, std::fstream& AlbFile, artistList& artist, albumList& album,
+                      indexSet& result, indexSet& delArtArray);
+
 /**
  * @brief Removes all albums of an artist.
  * @param ArtFile Artist file stream.
@@ -1262,6 +3269,391 @@ void removeAlbum(std::fstream& AlbFile, albumList& album, indexSet& delAlbArray,
  */
 void displayStatistics(const artistList& artist, const albumList& album);
 
+/**
+ * @brief Writes every indexed artist to a CSV file.
+ * @param artist Artist list.
+ * @param filename Output CSV path.
+ */
+void exportArtistsToCSV(const artistList& artist, const std::string& filename);
+
+/**
+ * @brief Writes every indexed album to a CSV file.
+ * @param album Album list.
+ * @param filename Output CSV path.
+ */
+void exportAlbumsToCSV(const albumList& album, const std::string& filename);
+
+/** Index entries the CSV export formats per window; about 64 MB of rows for albums. */
+const std::size_t CSV_EXPORT_WINDOW_ROWS = std::size_t{1} << 20;
+
+/**
+ * @brief Counts reported by the CSV and JSON Lines exports.
+ */
+struct CsvExportReport {
+    std::size_t rows = 0;          /**< Data rows written */
+    std::size_t deleted = 0;       /**< Index entries skipped because they are tombstones */
+    std::size_t unreadable = 0;    /**< Index entries skipped because the slot is missing or corrupt */
+    std::uint64_t bytesWritten = 0; /**< Size of the CSV file, header included */
+    double seconds = 0.0;          /**< Wall time of the export */
+};
+
+/**
+ * @brief Exports the indexed artists of a data file as RFC 4180 CSV, in index order.
+ *
+ * The index is taken in windows of @p windowRows entries. Within a window, slots are read
+ * front to back in large blocks by several workers, each formatting the rows of its part of
+ * the file; the rows are then written in index order through one buffered writer, so memory
+ * is bounded by one window of formatted rows rather than the whole CSV. Fields holding a
+ * comma, quote or line break are quoted and lines end in CRLF. The data file is checked
+ * before @p filename is truncated, so a failed export leaves an earlier file in place.
+ * @param artist Artist list giving the rows and their order.
+ * @param dataPath Artist data file.
+ * @param filename Output CSV path.
+ * @param report Receives counts and timing when not null.
+ * @param threads Worker count; 0 uses the hardware concurrency.
+ * @param windowRows Index entries formatted per window.
+ * @return False if either file cannot be opened or the CSV cannot be written.
+ */
+bool writeArtistsCsv(const artistList& artist, const std::string& dataPath, const std::string& filename,
+                     CsvExportReport* report = nullptr, unsigned threads = 0,
+                     std::size_t windowRows = CSV_EXPORT_WINDOW_ROWS);
+
+/**
+ * @brief Exports the indexed albums of a data file as RFC 4180 CSV, in index order.
+ * @param album Album list giving the rows and their order.
+ * @param dataPath Album data file.
+ * @param filename Output CSV path.
+ * @param report Receives counts and timing when not null.
+ * @param threads Worker count; 0 uses the hardware concurrency.
+ * @param windowRows Index entries formatted per window.
+ * @return False if either file cannot be opened or the CSV cannot be written.
+ * @see writeArtistsCsv
+ */
+bool writeAlbumsCsv(const albumList& album, const std::string& dataPath, const std::string& filename,
+                    CsvExportReport* report = nullptr, unsigned threads = 0,
+                    std::size_t windowRows = CSV_EXPORT_WINDOW_ROWS);
+
+/**
+ * @brief Exports the indexed artists of a data file as JSON Lines, one object per line.
+ *
+ * Slots are read in file order in large blocks and each object is escaped straight from the
+ * record's fixed-width fields into one reused write buffer, so memory stays constant and no
+ * per-row strings are allocated. Keys match the CSV header (ID, Name, Gender, Phone, Email),
+ * so the output imports back with importArtists.
+ * @param artist Artist list giving the slots to export.
+ * @param dataPath Artist data file.
+ * @param filename Output path.
+ * @param report Receives counts and timing when not null.
+ * @return False if either file cannot be opened or the output cannot be written.
+ */
+bool writeArtistsJsonl(const artistList& artist, const std::string& dataPath, const std::string& filename,
+                       CsvExportReport* report = nullptr);
+
+/**
+ * @brief Exports the indexed albums of a data file as JSON Lines, one object per line.
+ *
+ * Keys match the CSV header (AlbumID, ArtistID, Title, RecordFormat, DatePublished, Path).
+ * @param album Album list giving the slots to export.
+ * @param dataPath Album data file.
+ * @param filename Output path.
+ * @param report Receives counts and timing when not null.
+ * @return False if either file cannot be opened or the output cannot be written.
+ * @see writeArtistsJsonl
+ */
+bool writeAlbumsJsonl(const albumList& album, const std::string& dataPath, const std::string& filename,
+                      CsvExportReport* report = nullptr);
+
+/**
+ * @brief Writes every indexed artist to a JSON Lines file and prints a summary.
+ * @param artist Artist list.
+ * @param filename Output path.
+ */
+void exportArtistsToJsonl(const artistList& artist, const std::string& filename);
+
+/**
+ * @brief Writes every indexed album to a JSON Lines file and prints a summary.
+ * @param album Album list.
+ * @param filename Output path.
+ */
+void exportAlbumsToJsonl(const albumList& album, const std::string& filename);
+
+// Columnar Export
+
+/**
+ * @brief Magic bytes that open and close a columnar album file.
+ */
+const char COLUMNAR_FILE_MAGIC[8] = {'A', 'L', 'B', 'C', 'O', 'L', '0', '1'};
+
+/**
+ * @brief Current columnar file layout version.
+ */
+const std::uint32_t COLUMNAR_FORMAT_VERSION = 1;
+
+/**
+ * @brief Default number of rows per row group; the writer buffers one group at a time.
+ */
+const std::size_t COLUMNAR_ROW_GROUP_ROWS = 65536;
+
+/**
+ * @brief Physical type of a column in a columnar album file.
+ */
+enum class ColumnType : std::uint8_t {
+    UInt32 = 1,    /**< uint32 per row */
+    Enum8 = 2,     /**< uint8 code per row indexing the file's enum labels */
+    Dictionary = 3 /**< uint32 code per row indexing the row group's string dictionary */
+};
+
+/**
+ * @brief Column order of a columnar album file.
+ */
+enum class AlbumColumn : std::uint32_t {
+    AlbumId,       /**< UInt32: number after the "alb" prefix, 0 if the ID has another shape */
+    ArtistId,      /**< UInt32: number after the "art" prefix, 0 if the ID has another shape */
+    DatePublished, /**< UInt32: YYYYMMDD, 0 if the stored date does not parse */
+    RecordFormat,  /**< Enum8: index into formatLabels(), 0 for unknown formats */
+    Title,         /**< Dictionary */
+    Path,          /**< Dictionary */
+    Count
+};
+
+/**
+ * @brief Counts reported by writeAlbumsColumnar.
+ */
+struct ColumnarExportReport {
+    std::size_t rows = 0;           /**< Rows written */
+    std::size_t rowGroups = 0;      /**< Row groups written */
+    std::size_t deleted = 0;        /**< Index entries skipped because they are tombstones */
+    std::size_t unreadable = 0;     /**< Index entries skipped because the slot is missing or corrupt */
+    std::uint64_t bytesWritten = 0; /**< Size of the columnar file */
+    double seconds = 0.0;           /**< Wall time of the export */
+};
+
+/**
+ * @brief Exports the indexed albums of a data file in the columnar analytics format.
+ *
+ * Slots are read in file order in large blocks and appended to a row group; each full group
+ * is encoded and written before the next is read, so memory stays bounded by one group.
+ * Layout (native little-endian, every section 8-byte aligned so readers can mmap the file):
+ * a header with the magic, version, column descriptors and enum labels; the row groups,
+ * each a row count followed by one chunk per column; and a footer listing the group offsets,
+ * the total row count, the footer offset and the magic again.
+ * @param album Album list giving the slots to export.
+ * @param dataPath Album data file.
+ * @param filename Output path.
+ * @param report Receives counts and timing when not null.
+ * @param rowGroupRows Rows per row group; 0 uses COLUMNAR_ROW_GROUP_ROWS.
+ * @return False if either file cannot be opened or the output cannot be written.
+ * @see ColumnarAlbumReader
+ */
+bool writeAlbumsColumnar(const albumList& album, const std::string& dataPath, const std::string& filename,
+                         ColumnarExportReport* report = nullptr, std::size_t rowGroupRows = 0);
+
+/**
+ * @brief Writes every indexed album to a columnar file and prints a summary.
+ * @param album Album list.
+ * @param filename Output path.
+ */
+void exportAlbumsColumnar(const albumList& album, const std::string& filename);
+
+/**
+ * @brief Loads the configured album file and exports it in the columnar format.
+ * @param filename Output path.
+ * @return True if the export succeeded.
+ */
+bool exportColumnarDataFile(const std::string& filename);
+
+/**
+ * @brief One decoded row group of a columnar album file.
+ *
+ * Dictionary columns keep their codes; resolve them through the matching dictionary or
+ * use ColumnarAlbumReader::album for a whole row.
+ */
+struct ColumnarAlbumBatch {
+    std::vector<std::uint32_t> albumIds;     /**< AlbumId column */
+    std::vector<std::uint32_t> artistIds;    /**< ArtistId column */
+    std::vector<std::uint32_t> dates;        /**< DatePublished column (YYYYMMDD) */
+    std::vector<std::uint8_t> formats;       /**< RecordFormat column */
+    std::vector<std::uint32_t> titleCodes;   /**< Title column codes */
+    std::vector<std::string> titles;         /**< Title dictionary */
+    std::vector<std::uint32_t> pathCodes;    /**< Path column codes */
+    std::vector<std::string> paths;          /**< Path dictionary */
+
+    /**
+     * @brief Number of rows in the batch.
+     * @return Row count.
+     */
+    std::size_t size() const { return albumIds.size(); }
+};
+
+/**
+ * @brief Reads files written by writeAlbumsColumnar one row group at a time.
+ */
+class ColumnarAlbumReader {
+public:
+    /**
+     * @brief Opens a file and reads its header and footer.
+     * @param path Columnar file path.
+     * @return False if the file is missing, truncated or not a columnar album file.
+     */
+    bool open(const std::string& path);
+    /**
+     * @brief Total rows in the file.
+     * @return Row count.
+     */
+    std::uint64_t rowCount() const { return rows; }
+    /**
+     * @brief Number of row groups in the file.
+     * @return Row group count.
+     */
+    std::size_t rowGroupCount() const { return groupOffsets.size(); }
+    /**
+     * @brief Labels of the RecordFormat enum; index 0 is "unknown".
+     * @return Enum labels.
+     */
+    const std::vector<std::string>& formatLabels() const { return labels; }
+    /**
+     * @brief Decodes one row group.
+     * @param group Row group index.
+     * @param batch Receives the columns.
+     * @return False if the group index is out of range or its chunks are malformed.
+     */
+    bool readRowGroup(std::size_t group, ColumnarAlbumBatch& batch);
+    /**
+     * @brief Rebuilds one row as an Album (IDs re-prefixed, date as DD/MM/YYYY).
+     * @param batch Decoded row group.
+     * @param row Row within the batch.
+     * @return The album.
+     */
+    Album album(const ColumnarAlbumBatch& batch, std::size_t row) const;
+
+private:
+    std::ifstream in;
+    std::uint64_t fileSize = 0;
+    std::uint64_t rows = 0;
+    std::vector<std::uint64_t> groupOffsets;
+    std::vector<std::string> labels;
+};
+
+// Bulk Import
+
+/**
+ * @brief Input formats accepted by the bulk import.
+ */
+enum class ImportFormat {
+    Csv,  /**< RFC 4180 CSV with a header row naming the columns */
+    Json  /**< A JSON array of flat objects, or JSON Lines: one object per line */
+};
+
+/**
+ * @brief Picks the import format from a file name: ".json", ".jsonl" and ".ndjson" are JSON,
+ * anything else CSV.
+ * @param path Source file path.
+ * @return Import format.
+ */
+ImportFormat importFormatForPath(const std::string& path);
+
+/**
+ * @brief One rejected input row.
+ */
+struct ImportIssue {
+    std::size_t row = 0;   /**< 1-based data row (CSV) or array element (JSON) */
+    std::string reason;    /**< Validation message or parse error */
+};
+
+/**
+ * @brief Outcome of one bulk import.
+ */
+struct ImportReport {
+    std::size_t rowsRead = 0;          /**< Data rows parsed */
+    std::size_t imported = 0;          /**< Records appended to the data file */
+    std::size_t rejected = 0;          /**< Rows that failed validation */
+    std::vector<ImportIssue> issues;   /**< The first ImportSettings::maxIssues rejections */
+    double seconds = 0.0;              /**< Wall time of the import */
+};
+
+/**
+ * @brief Tuning for the bulk import.
+ */
+struct ImportSettings {
+    std::size_t batchRecords = 65536;  /**< Records validated, assigned IDs and appended per batch */
+    std::size_t maxIssues = 100;       /**< Rejections kept in ImportReport::issues */
+};
+
+/**
+ * @brief Imports artists from a CSV or JSON stream.
+ *
+ * Rows are parsed one at a time, validated and formatted with the same rules as the
+ * interactive prompts, given fresh IDs a batch at a time and appended (and journaled) in one
+ * write per batch. The index is sorted once at the end. Columns or keys are matched by name
+ * ignoring case and underscores: Name, Gender, Phone and Email, plus an optional ID that is
+ * recorded in idMap so an album import can refer to the imported artists. Imports are not
+ * undoable.
+ * @param in Source stream.
+ * @param format Source format.
+ * @param ArtFile Artist file stream; the configured file is opened if it is closed.
+ * @param artist Artist list to extend.
+ * @param report Receives counts and rejected rows.
+ * @param idMap When not null, receives source ID -> assigned ID for rows that had an ID.
+ * @param settings Batch size and issue limit.
+ * @return False on a malformed source, when the data file cannot be written or when a batch
+ *         would need IDs past MAX_RECORD_ID_NUMBER (that batch is rejected whole); rows
+ *         imported before the failure are kept.
+ */
+bool importArtists(std::istream& in, ImportFormat format, std::fstream& ArtFile, artistList& artist,
+                   ImportReport& report, std::unordered_map<std::string, std::string>* idMap = nullptr,
+                   const ImportSettings& settings = ImportSettings());
+
+/**
+ * @brief Imports albums from a CSV or JSON stream.
+ *
+ * Columns: ArtistID, Title, RecordFormat, DatePublished (DD/MM/YYYY) and Path; an AlbumID
+ * column is ignored. ArtistID is looked up in artistIdMap first and must otherwise name an
+ * artist already in the index.
+ * @param in Source stream.
+ * @param format Source format.
+ * @param AlbFile Album file stream; the configured file is opened if it is closed.
+ * @param artist Artist list used to check artist references.
+ * @param album Album list to extend.
+ * @param report Receives counts and rejected rows.
+ * @param artistIdMap Optional source ID -> assigned ID map from importArtists.
+ * @param settings Batch size and issue limit.
+ * @return False on a malformed source, when the data file cannot be written or when the IDs
+ *         run out, as for importArtists.
+ * @see importArtists
+ */
+bool importAlbums(std::istream& in, ImportFormat format, std::fstream& AlbFile, const artistList& artist,
+                  albumList& album, ImportReport& report,
+                  const std::unordered_map<std::string, std::string>* artistIdMap = nullptr,
+                  const ImportSettings& settings = ImportSettings());
+
+/**
+ * @brief Imports artist and album files into the configured data files without the UI.
+ *
+ * Loads the current indexes, imports artistSource then albumSource (either may be empty)
+ * and prints a summary of each; backs the --import command line option.
+ * @param artistSource Artist CSV/JSON file, or empty.
+ * @param albumSource Album CSV/JSON file, or empty.
+ * @return True if every given file was read and no row was rejected.
+ */
+bool importDataFiles(const std::string& artistSource, const std::string& albumSource);
+
+/**
+ * @brief Prompts for artist and album files and imports them into the loaded catalog.
+ * @param ArtFile Artist file stream.
+ * @param AlbFile Album file stream.
+ * @param artist Artist list.
+ * @param album Album list.
+ */
+void importDataMenu(std::fstream& ArtFile, std::fstream& AlbFile, artistList& artist, albumList& album);
+
+/**
+ * @brief Prints the metrics registry (counters, gauges, p50/p99/p999 latencies) and the
+ * memory breakdown.
+ * @param artist Artist list.
+ * @param album Album list.
+ */
+void displayMetrics(const artistList& artist, const albumList& album);
+
 /**
  * @brief Searches albums by title.
  * @param AlbFile Album file stream.
@@ -1295,6 +3687,61 @@ bool searchAlbumByDateRange(std::fstream& AlbFile, const albumList& album, index
  */
 void advancedSearchAlbums(std::fstream& AlbFile, const albumList& album, indexSet& result);
 
+// Aggregate Queries
+
+/**
+ * @brief Index sizes below which runAggregateQuery stays on one thread; larger indexes give
+ * each worker at least this many entries.
+ */
+const std::size_t AGGREGATE_PARALLEL_MIN_ENTRIES = 65536;
+
+/**
+ * @brief Group-by and ranking options for runAggregateQuery.
+ *
+ * Any combination of the three keys may be set; with none, the query returns a single
+ * row for the whole catalog.
+ */
+struct AggregateQuery {
+    bool byArtist = false;         /**< Group by artist ID */
+    bool byYear = false;           /**< Group by publication year, yearBucket years per group */
+    bool byFormat = false;         /**< Group by record format code */
+    std::uint16_t yearBucket = 1;  /**< Years per group, e.g. 10 for decades; 0 is treated as 1 */
+    std::size_t topK = 0;          /**< Keep the K groups with the most albums; 0 keeps every group */
+    unsigned threads = 0;          /**< Worker threads; 0 uses every core */
+};
+
+/**
+ * @brief One group of an aggregate query.
+ */
+struct AggregateRow {
+    std::string artistId;      /**< Artist ID, empty unless grouped by artist */
+    std::uint16_t year = 0;    /**< First year of the bucket (0 = unknown date), 0 unless grouped by year */
+    std::uint8_t format = 0;   /**< Format code (recordFormatLabel), 0 unless grouped by format */
+    std::size_t count = 0;     /**< Live albums in the group */
+    std::uint16_t minYear = 0; /**< Earliest known publication year, 0 if none is known */
+    std::uint16_t maxYear = 0; /**< Latest known publication year, 0 if none is known */
+};
+
+/**
+ * @brief Counts the live albums of the index per group, with their first and last year.
+ *
+ * Workers aggregate contiguous slices of the index into private hash tables that are
+ * merged at the end, so no locks are taken per album. With topK set, the best K groups
+ * are selected with a bounded heap instead of sorting every group.
+ * @param album Album list; only its index entries are read.
+ * @param query Group-by keys, bucket width, K and thread count.
+ * @return Groups ordered by count descending when topK is set, otherwise by key
+ *         (artist ID, year, format) ascending; ties in count are broken by key.
+ */
+std::vector<AggregateRow> runAggregateQuery(const albumList& album, const AggregateQuery& query);
+
+/**
+ * @brief Statistics submenu: overview, top artists, albums per decade and format share by year.
+ * @param artist Artist list, used for artist names.
+ * @param album Album list.
+ */
+void statisticsMenu(const artistList& artist, const albumList& album);
+
 // Command pattern helpers
 
 /**
@@ -0,0 +1,303 @@
+/**
+ * @file perf_gate.cpp
+ * @brief Timing runner and regression comparison for the load and search paths.
+ *
+ * Usage:
+ *   album_perf run [--records N] [--repetitions R] [--label TEXT] [--data DIR] [--store DIR] [--out FILE]
+ *       Times each operation R times on a synthetic catalog of N albums and stores the run
+ *       as JSON: FILE if given, otherwise DIR/<timestamp>.json plus DIR/latest.json.
+ *   album_perf compare BASELINE CANDIDATE [--threshold PCT] [--confidence C] [--init-missing]
+ *       Prints a Welch comparison per operation and exits with 1 if any operation regressed.
+ *       With --init-missing an absent baseline is created from the candidate instead.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "manager.h"
+#include "version.h"
+
+namespace {
+
+const double TARGET_SAMPLE_NS = 20e6;
+
+struct RunOptions {
+    std::int64_t records = 100000;
+    int repetitions = 10;
+    std::string label;
+    std::string dataDir = "perf_data";
+    std::string storeDir = "perf_results";
+    std::string outPath;
+};
+
+std::string localTimestamp(const char* format) {
+    std::time_t now = std::time(nullptr);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &now);
+#else
+    localtime_r(&now, &tm);
+#endif
+    std::ostringstream oss;
+    oss << std::put_time(&tm, format);
+    return oss.str();
+}
+
+// Generates (or reuses) the catalog and points the configuration at it.
+bool prepareCatalog(const RunOptions& options) {
+    std::string directory = options.dataDir + "/catalog_" + std::to_string(options.records);
+    std::string configPath = prepareSyntheticCatalogDirectory(directory, options.records, &std::cerr);
+    if (configPath.empty()) {
+        return false;
+    }
+    loadApplicationConfig(configPath);
+    return true;
+}
+
+// Runs op repeatedly per sample so that cheap operations still take ~20 ms per sample,
+// and records the mean time per call of each sample.
+PerfSeries timeOperation(const std::string& name, int repetitions, const std::function<void()>& op) {
+    using Clock = std::chrono::steady_clock;
+    auto elapsedNs = [](Clock::time_point start) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    };
+    auto start = Clock::now();
+    op();
+    double warmup = std::max(elapsedNs(start), 1.0);
+    long calls = std::max(1L, std::min(10000L, static_cast<long>(std::ceil(TARGET_SAMPLE_NS / warmup))));
+
+    PerfSeries series;
+    series.name = name;
+    for (int r = 0; r < repetitions; ++r) {
+        start = Clock::now();
+        for (long c = 0; c < calls; ++c) {
+            op();
+        }
+        series.samplesNs.push_back(elapsedNs(start) / static_cast<double>(calls));
+    }
+    return series;
+}
+
+int runCommand(const RunOptions& options) {
+    if (!prepareCatalog(options)) {
+        std::cerr << "Failed to prepare the catalog" << std::endl;
+        return 2;
+    }
+
+    PerfRun run;
+    run.label = options.label;
+    run.version = ALBUM_APP_VERSION;
+    run.records = options.records;
+    {
+        // The loaders print a blank line per open; keep the report readable.
+        std::ofstream sink;
+        std::streambuf* previous = std::cout.rdbuf(sink.rdbuf());
+
+        std::fstream artistFile;
+        std::fstream albumFile;
+        artistList artists;
+        albumList albums;
+        indexSet deletedArtists;
+        indexSet deletedAlbums;
+        loadArtist(artistFile, artists, deletedArtists);
+        loadAlbum(albumFile, albums, deletedAlbums);
+
+        run.series.push_back(timeOperation("load_artists", options.repetitions, [] {
+            std::fstream file;
+            artistList list;
+            indexSet deleted;
+            loadArtist(file, list, deleted);
+        }));
+        run.series.push_back(timeOperation("load_albums", options.repetitions, [] {
+            std::fstream file;
+            albumList list;
+            indexSet deleted;
+            loadAlbum(file, list, deleted);
+        }));
+
+        indexSet result;
+        std::string artistId = artists.artList.empty() ? "art1000" : artists.artList[artists.artList.size() / 2].artistId;
+        run.series.push_back(timeOperation("search_artist_by_id", options.repetitions, [&] {
+            searchArtistById(artists, result, artistId);
+        }));
+        run.series.push_back(timeOperation("search_artist_by_name", options.repetitions, [&] {
+            searchArtistByName(artists, result, "sa");
+        }));
+        run.series.push_back(timeOperation("search_album_by_artist_id", options.repetitions, [&] {
+            searchAlbumByArtistId(albumFile, albums, result, artistId);
+        }));
+        run.series.push_back(timeOperation("search_album_by_title", options.repetitions, [&] {
+            searchAlbumByTitle(albumFile, albums, result, "Love");
+        }));
+        run.series.push_back(timeOperation("search_album_by_date_range", options.repetitions, [&] {
+            searchAlbumByDateRange(albumFile, albums, result, 1, 1, 1990, 31, 12, 1999);
+        }));
+        std::cout.rdbuf(previous);
+    }
+    run.timestamp = localTimestamp("%Y-%m-%d %H:%M:%S");
+
+    std::vector<std::string> outputs;
+    if (!options.outPath.empty()) {
+        outputs.push_back(options.outPath);
+    } else {
+        std::filesystem::create_directories(options.storeDir);
+        std::string name = localTimestamp("%Y%m%d_%H%M%S") + (options.label.empty() ? "" : "_" + options.label);
+        outputs.push_back(options.storeDir + "/" + name + ".json");
+        outputs.push_back(options.storeDir + "/latest.json");
+    }
+    for (const auto& path : outputs) {
+        std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        if (!parent.empty()) {
+            std::filesystem::create_directories(parent);
+        }
+        std::ofstream out(path, std::ios::trunc);
+        if (!out || !writePerfRun(out, run)) {
+            std::cerr << "Cannot write " << path << std::endl;
+            return 2;
+        }
+    }
+
+    std::cout << std::left << std::setw(30) << "operation" << std::right << std::setw(14) << "mean (us)"
+              << std::setw(12) << "stddev %" << std::endl;
+    for (const auto& series : run.series) {
+        double mean = 0.0;
+        for (double sample : series.samplesNs) {
+            mean += sample;
+        }
+        mean /= static_cast<double>(series.samplesNs.size());
+        double variance = 0.0;
+        for (double sample : series.samplesNs) {
+            variance += (sample - mean) * (sample - mean);
+        }
+        double stddev = series.samplesNs.size() > 1 ? std::sqrt(variance / static_cast<double>(series.samplesNs.size() - 1)) : 0.0;
+        std::cout << std::left << std::setw(30) << series.name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << mean / 1000.0 << std::setw(12) << (mean > 0.0 ? 100.0 * stddev / mean : 0.0) << std::endl;
+    }
+    std::cout << "Stored " << outputs.front() << std::endl;
+    return 0;
+}
+
+bool loadRun(const std::string& path, PerfRun& run) {
+    std::ifstream in(path);
+    if (!in || !readPerfRun(in, run)) {
+        std::cerr << "Cannot read perf run " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int compareCommand(const std::string& baselinePath, const std::string& candidatePath, double threshold,
+                   double confidence, bool initMissing) {
+    if (initMissing && !std::filesystem::exists(baselinePath)) {
+        std::filesystem::path parent = std::filesystem::path(baselinePath).parent_path();
+        if (!parent.empty()) {
+            std::filesystem::create_directories(parent);
+        }
+        std::filesystem::copy_file(candidatePath, baselinePath);
+        std::cout << "No baseline yet; recorded " << candidatePath << " as " << baselinePath << std::endl;
+        return 0;
+    }
+    PerfRun baseline;
+    PerfRun candidate;
+    if (!loadRun(baselinePath, baseline) || !loadRun(candidatePath, candidate)) {
+        return 2;
+    }
+    if (baseline.records != candidate.records) {
+        std::cout << "Warning: baseline used " << baseline.records << " records, candidate " << candidate.records << std::endl;
+    }
+
+    int regressions = 0;
+    std::cout << std::left << std::setw(30) << "operation" << std::right << std::setw(14) << "base (us)"
+              << std::setw(14) << "new (us)" << std::setw(10) << "delta %" << std::setw(24)
+              << (std::to_string(static_cast<int>(confidence * 100 + 0.5)) + "% CI %") << "  verdict" << std::endl;
+    for (const auto& result : comparePerfRuns(baseline, candidate, threshold, confidence)) {
+        std::ostringstream interval;
+        interval << std::fixed << std::setprecision(1) << "[" << result.ciLowPercent << ", " << result.ciHighPercent << "]";
+        std::cout << std::left << std::setw(30) << result.name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << result.baselineMeanNs / 1000.0 << std::setw(14) << result.candidateMeanNs / 1000.0
+                  << std::setw(10) << result.deltaPercent << std::setw(24) << interval.str()
+                  << "  " << perfVerdictName(result.verdict) << std::endl;
+        if (result.verdict == PerfVerdict::Regression) {
+            ++regressions;
+        }
+    }
+    if (regressions > 0) {
+        std::cout << regressions << " operation(s) regressed by more than " << threshold << "%" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+void printUsage() {
+    std::cerr << "Usage: album_perf run [--records N] [--repetitions R] [--label TEXT] [--data DIR] [--store DIR] [--out FILE]\n"
+                 "       album_perf compare BASELINE CANDIDATE [--threshold PCT] [--confidence C] [--init-missing]"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::string command = argc > 1 ? argv[1] : "";
+    try {
+        if (command == "run") {
+            RunOptions options;
+            for (int i = 2; i < argc; ++i) {
+                std::string arg = argv[i];
+                if (i + 1 >= argc) {
+                    printUsage();
+                    return 2;
+                }
+                std::string value = argv[++i];
+                if (arg == "--records") {
+                    options.records = std::stoll(value);
+                } else if (arg == "--repetitions") {
+                    options.repetitions = std::max(2, std::stoi(value));
+                } else if (arg == "--label") {
+                    options.label = value;
+                } else if (arg == "--data") {
+                    options.dataDir = value;
+                } else if (arg == "--store") {
+                    options.storeDir = value;
+                } else if (arg == "--out") {
+                    options.outPath = value;
+                } else {
+                    printUsage();
+                    return 2;
+                }
+            }
+            return runCommand(options);
+        }
+        if (command == "compare" && argc >= 4) {
+            double threshold = 10.0;
+            double confidence = 0.95;
+            bool initMissing = false;
+            for (int i = 4; i < argc; ++i) {
+                std::string arg = argv[i];
+                if (arg == "--init-missing") {
+                    initMissing = true;
+                } else if (arg == "--threshold" && i + 1 < argc) {
+                    threshold = std::stod(argv[++i]);
+                } else if (arg == "--confidence" && i + 1 < argc) {
+                    confidence = std::stod(argv[++i]);
+                } else {
+                    printUsage();
+                    return 2;
+                }
+            }
+            return compareCommand(argv[2], argv[3], threshold, confidence, initMissing);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid argument: " << e.what() << std::endl;
+        return 2;
+    }
+    printUsage();
+    return 2;
+}
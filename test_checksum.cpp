@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "manager.h"
+
+class ChecksumTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tempFile = "temp_checksum.bin";
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(tempFile);
+    }
+
+    void writeBytes(std::size_t size) {
+        std::ofstream out(tempFile, std::ios::binary | std::ios::trunc);
+        for (std::size_t i = 0; i < size; ++i) {
+            out.put(static_cast<char>((i * 31 + 7) & 0xFF));
+        }
+    }
+
+    std::string tempFile;
+};
+
+TEST_F(ChecksumTest, Crc32c_KnownVector) {
+    const char* input = "123456789";
+    EXPECT_EQ(crc32c(input, std::strlen(input)), 0xE3069283u);
+}
+
+TEST_F(ChecksumTest, Crc32c_IncrementalMatchesOneShot) {
+    const char* input = "The quick brown fox jumps over the lazy dog";
+    std::size_t length = std::strlen(input);
+    std::uint32_t partial = crc32c(input, 10);
+    EXPECT_EQ(crc32c(input + 10, length - 10, partial), crc32c(input, length));
+}
+
+TEST_F(ChecksumTest, XxHash64_KnownVectors) {
+    EXPECT_EQ(xxHash64("", 0, 0), 0xEF46DB3751D8E999ULL);
+    EXPECT_EQ(xxHash64("a", 1, 0), 0xD24EC4F1A98C6E5BULL);
+}
+
+TEST_F(ChecksumTest, Checksum_ParsesLegacyDecimal) {
+    Checksum parsed;
+    EXPECT_TRUE(Checksum::parse("2166136261", parsed));
+    EXPECT_EQ(parsed.algorithm, ChecksumAlgorithm::Fnv1a32);
+    EXPECT_EQ(parsed.value, 2166136261u);
+    EXPECT_EQ(parsed.toString(), "2166136261");
+}
+
+TEST_F(ChecksumTest, Checksum_RoundTripsTaggedHex) {
+    Checksum original{ChecksumAlgorithm::XxHash64, 0x0123456789ABCDEFULL};
+    Checksum parsed;
+    EXPECT_TRUE(Checksum::parse(original.toString(), parsed));
+    EXPECT_EQ(parsed, original);
+    EXPECT_FALSE(Checksum::parse("md5:abc", parsed));
+}
+
+TEST_F(ChecksumTest, ComputeFileChecksum_LegacyFnvMatchesByteLoop) {
+    writeBytes(5000);
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < 5000; ++i) {
+        hash ^= static_cast<unsigned char>((i * 31 + 7) & 0xFF);
+        hash *= 16777619u;
+    }
+    Checksum sum = computeFileChecksum(tempFile, ChecksumAlgorithm::Fnv1a32);
+    EXPECT_EQ(sum.value, hash);
+}
+
+TEST_F(ChecksumTest, ComputeFileChecksum_ChunkedDigestIsDeterministic) {
+    writeBytes(CHECKSUM_CHUNK_SIZE * 2 + 123);
+    Checksum first = computeFileChecksum(tempFile);
+    Checksum second = computeFileChecksum(tempFile);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first.algorithm, ChecksumAlgorithm::XxHash64);
+
+    std::fstream file(tempFile, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(static_cast<std::streamoff>(CHECKSUM_CHUNK_SIZE + 5));
+    file.put('\x00');
+    file.close();
+    EXPECT_NE(computeFileChecksum(tempFile), first);
+    EXPECT_NE(computeFileChecksum(tempFile, ChecksumAlgorithm::Crc32c), computeFileChecksum(tempFile, ChecksumAlgorithm::XxHash64));
+}
+
+TEST_F(ChecksumTest, CopyFileContents_CopiesEveryByte) {
+    writeBytes(CHECKSUM_CHUNK_SIZE + 4097);
+    std::string copyPath = tempFile + ".copy";
+    {
+        std::ofstream stale(copyPath, std::ios::binary);
+        stale << std::string(CHECKSUM_CHUNK_SIZE * 2, 'x');
+    }
+    CopyMethod used = CopyMethod::Reflink;
+    ASSERT_TRUE(copyFileContents(tempFile, copyPath, &used));
+    EXPECT_EQ(std::filesystem::file_size(copyPath), std::filesystem::file_size(tempFile));
+    EXPECT_EQ(computeFileChecksum(copyPath), computeFileChecksum(tempFile));
+#ifndef __linux__
+    EXPECT_EQ(used, CopyMethod::Buffered);
+#endif
+    EXPECT_FALSE(copyFileContents(tempFile + ".missing", copyPath));
+    std::filesystem::remove(copyPath);
+}
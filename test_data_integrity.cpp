@@ -21,13 +21,28 @@ struct AlbumFile {
     char paths[100];
 };
 
+// Versioned data files start with a 16-byte header and carry a 4-byte CRC after
+// each record; legacy files are bare records. Returns the extra bytes per record.
+static std::streamoff skipHeader(std::ifstream& file) {
+    char magic[4] = {};
+    if (file.read(magic, sizeof(magic)) && std::memcmp(magic, "AMSD", 4) == 0) {
+        file.seekg(16, std::ios::beg);
+        return 4;
+    }
+    file.clear();
+    file.seekg(0, std::ios::beg);
+    return 0;
+}
+
 int main() {
     std::cout << "Testing Artist.bin data integrity:" << std::endl;
     
     std::ifstream artFile("Artist.bin", std::ios::binary);
     if (artFile.is_open()) {
         ArtistFile artist;
+        std::streamoff trailer = skipHeader(artFile);
         while (artFile.read((char*)&artist, sizeof(ArtistFile))) {
+            artFile.seekg(trailer, std::ios::cur);
             // Apply null termination like in the fixed code
             artist.artistIds[7] = '\0';
             artist.names[49] = '\0';
@@ -51,7 +66,9 @@ int main() {
     std::ifstream albFile("Album.bin", std::ios::binary);
     if (albFile.is_open()) {
         AlbumFile album;
+        std::streamoff trailer = skipHeader(albFile);
         while (albFile.read((char*)&album, sizeof(AlbumFile))) {
+            albFile.seekg(trailer, std::ios::cur);
             // Apply null termination like in the fixed code
             album.albumIds[7] = '\0';
             album.artistIdRefs[7] = '\0';
@@ -0,0 +1,431 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+#include "manager.h"
+
+class ExportTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tempArtistFile = "temp_export_artist.bin";
+        tempAlbumFile = "temp_export_album.bin";
+        tempCsvFile = "temp_export.csv";
+        tempColumnarFile = "temp_export.alcol";
+    }
+
+    void TearDown() override {
+        for (const auto& path : {tempArtistFile, tempAlbumFile, tempCsvFile, tempColumnarFile}) {
+            std::filesystem::remove(path);
+        }
+    }
+
+    static ArtistFile makeArtist(const std::string& id, const std::string& name) {
+        ArtistFile artFile{};
+        std::strncpy(artFile.artistIds, id.c_str(), 7);
+        std::strncpy(artFile.names, name.c_str(), 49);
+        artFile.genders = 'M';
+        std::strncpy(artFile.phones, "0911000000", 14);
+        std::strncpy(artFile.emails, "a@b.com", 49);
+        return artFile;
+    }
+
+    std::string readCsv() const {
+        std::ifstream in(tempCsvFile, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+
+    std::string tempArtistFile;
+    std::string tempAlbumFile;
+    std::string tempCsvFile;
+    std::string tempColumnarFile;
+};
+
+TEST_F(ExportTest, CsvQuotesFieldsAndFollowsIndexOrder) {
+    std::fstream file;
+    openRecordFile(file, tempArtistFile, RecordKind::Artist);
+    long plain = 0;
+    long quoted = 0;
+    long deleted = 0;
+    ASSERT_TRUE(appendRecord(file, makeArtist("art1000", "Zed"), plain));
+    ASSERT_TRUE(appendRecord(file, makeArtist("art1001", "Bob \"The\" Band, Jr"), quoted));
+    ASSERT_TRUE(appendRecord(file, makeArtist("-1", ""), deleted));
+    file.close();
+
+    artistList artists;
+    artists.artList.push_back({"art1001", "Bob \"The\" Band, Jr", quoted});
+    artists.artList.push_back({"-1", "", deleted});
+    artists.artList.push_back({"art1000", "Zed", plain});
+    CsvExportReport report;
+    ASSERT_TRUE(writeArtistsCsv(artists, tempArtistFile, tempCsvFile, &report));
+    EXPECT_EQ(readCsv(), "ID,Name,Gender,Phone,Email\r\n"
+                         "art1001,\"Bob \"\"The\"\" Band, Jr\",M,0911000000,a@b.com\r\n"
+                         "art1000,Zed,M,0911000000,a@b.com\r\n");
+    EXPECT_EQ(report.rows, 2u);
+    EXPECT_EQ(report.deleted, 1u);
+    EXPECT_EQ(report.unreadable, 0u);
+    EXPECT_EQ(report.bytesWritten, std::filesystem::file_size(tempCsvFile));
+}
+
+TEST_F(ExportTest, ParallelCsvMatchesSingleWorkerAndSkipsCorruptSlots) {
+    CatalogGeneratorSettings settings;
+    settings.artists = 500;
+    settings.albums = 30000;
+    settings.tombstoneRatio = 0.1;
+    ASSERT_TRUE(generateSyntheticCatalog(tempArtistFile, tempAlbumFile, settings));
+    albumList albums;
+    indexSet deleted;
+    std::string staged = tempAlbumFile + ".restore";
+    ASSERT_TRUE(stageRestoredRecords(tempAlbumFile, staged, albums, deleted));
+    std::filesystem::remove(staged);
+    std::sort(albums.albList.begin(), albums.albList.end(),
+              [](const albumIndex& a, const albumIndex& b) { return a.title < b.title; });
+    {
+        std::fstream data(tempAlbumFile, std::ios::binary | std::ios::in | std::ios::out);
+        data.seekp(albums.albList[123].pos + 20);
+        data.put('#');
+    }
+
+    CsvExportReport single;
+    ASSERT_TRUE(writeAlbumsCsv(albums, tempAlbumFile, tempCsvFile, &single, 1));
+    std::string expected = readCsv();
+    CsvExportReport parallel;
+    ASSERT_TRUE(writeAlbumsCsv(albums, tempAlbumFile, tempCsvFile, &parallel, 4));
+    EXPECT_EQ(readCsv(), expected);
+    EXPECT_EQ(parallel.rows, albums.albList.size() - 1);
+    EXPECT_EQ(parallel.unreadable, 1u);
+    EXPECT_EQ(single.rows, parallel.rows);
+
+    std::size_t lineStart = expected.find("\r\n") + 2;
+    std::size_t lineEnd = expected.find(',', lineStart);
+    EXPECT_EQ(expected.substr(lineStart, lineEnd - lineStart), albums.albList[0].albumId);
+}
+
+TEST_F(ExportTest, WindowedCsvMatchesOneWindow) {
+    CatalogGeneratorSettings settings;
+    settings.artists = 200;
+    settings.albums = 5000;
+    settings.tombstoneRatio = 0.1;
+    ASSERT_TRUE(generateSyntheticCatalog(tempArtistFile, tempAlbumFile, settings));
+    albumList albums;
+    indexSet deleted;
+    std::string staged = tempAlbumFile + ".restore";
+    ASSERT_TRUE(stageRestoredRecords(tempAlbumFile, staged, albums, deleted));
+    std::filesystem::remove(staged);
+    std::reverse(albums.albList.begin(), albums.albList.end());
+
+    CsvExportReport whole;
+    ASSERT_TRUE(writeAlbumsCsv(albums, tempAlbumFile, tempCsvFile, &whole, 2));
+    std::string expected = readCsv();
+    CsvExportReport windowed;
+    ASSERT_TRUE(writeAlbumsCsv(albums, tempAlbumFile, tempCsvFile, &windowed, 2, 333));
+    EXPECT_EQ(readCsv(), expected);
+    EXPECT_EQ(windowed.rows, whole.rows);
+    EXPECT_EQ(windowed.bytesWritten, whole.bytesWritten);
+}
+
+TEST_F(ExportTest, CsvLeavesEarlierExportWhenDataFileIsMissing) {
+    {
+        std::ofstream out(tempCsvFile, std::ios::binary);
+        out << "earlier export\r\n";
+    }
+    artistList artists;
+    artists.artList.push_back({"art1000", "Zed", RECORD_HEADER_SIZE});
+    EXPECT_FALSE(writeArtistsCsv(artists, tempArtistFile, tempCsvFile));
+    EXPECT_EQ(readCsv(), "earlier export\r\n");
+}
+
+TEST_F(ExportTest, ColumnarRoundTripsAlbumsAcrossRowGroups) {
+    CatalogGeneratorSettings settings;
+    settings.artists = 300;
+    settings.albums = 10000;
+    settings.tombstoneRatio = 0.1;
+    ASSERT_TRUE(generateSyntheticCatalog(tempArtistFile, tempAlbumFile, settings));
+    albumList albums;
+    indexSet deleted;
+    std::string staged = tempAlbumFile + ".restore";
+    ASSERT_TRUE(stageRestoredRecords(tempAlbumFile, staged, albums, deleted));
+    std::filesystem::remove(staged);
+    {
+        std::fstream data;
+        openRecordFile(data, tempAlbumFile, RecordKind::Album);
+        AlbumFile odd{};
+        std::strncpy(odd.albumIds, "alb0042", sizeof(odd.albumIds));
+        std::strncpy(odd.artistIdRefs, "art1000", sizeof(odd.artistIdRefs));
+        std::strncpy(odd.titles, "Odd One", 79);
+        std::strncpy(odd.recordFormats, "Tape", 11);
+        std::strncpy(odd.datePublished, "unknown", 10);
+        long pos = 0;
+        ASSERT_TRUE(appendRecord(data, odd, pos));
+        albums.albList.push_back({"alb0042", "art1000", "Odd One", pos});
+    }
+    std::reverse(albums.albList.begin(), albums.albList.end());
+
+    ColumnarExportReport report;
+    ASSERT_TRUE(writeAlbumsColumnar(albums, tempAlbumFile, tempColumnarFile, &report, 4096));
+    EXPECT_EQ(report.rows, albums.albList.size());
+    EXPECT_EQ(report.rowGroups, (report.rows + 4095) / 4096);
+    EXPECT_EQ(report.bytesWritten, std::filesystem::file_size(tempColumnarFile));
+    EXPECT_EQ(report.bytesWritten % 8, 0u);
+
+    ColumnarAlbumReader reader;
+    ASSERT_TRUE(reader.open(tempColumnarFile));
+    EXPECT_EQ(reader.rowCount(), report.rows);
+    ASSERT_EQ(reader.rowGroupCount(), report.rowGroups);
+    EXPECT_EQ(reader.formatLabels().front(), "unknown");
+
+    // Rows come out in file order.
+    std::vector<long> positions;
+    for (const albumIndex& entry : albums.albList) {
+        positions.push_back(entry.pos);
+    }
+    std::sort(positions.begin(), positions.end());
+    std::fstream data(tempAlbumFile, std::ios::binary | std::ios::in);
+    std::size_t row = 0;
+    ColumnarAlbumBatch batch;
+    for (std::size_t group = 0; group < reader.rowGroupCount(); ++group) {
+        ASSERT_TRUE(reader.readRowGroup(group, batch));
+        EXPECT_LT(batch.titles.size(), batch.size() + 1);
+        for (std::size_t i = 0; i < batch.size(); ++i, ++row) {
+            AlbumFile expected{};
+            ASSERT_EQ(readRecordAt(data, positions[row], expected), RecordStatus::Ok);
+            Album actual = reader.album(batch, i);
+            if (row + 1 == positions.size()) {
+                EXPECT_EQ(actual.getAlbumId(), "");
+                EXPECT_EQ(actual.getRecordFormat(), "unknown");
+                EXPECT_EQ(actual.getDatePublished(), "");
+                EXPECT_EQ(actual.getTitle(), "Odd One");
+                continue;
+            }
+            ASSERT_EQ(actual.getAlbumId(), expected.albumIds) << row;
+            EXPECT_EQ(actual.getArtistId(), expected.artistIdRefs);
+            EXPECT_EQ(actual.getTitle(), expected.titles);
+            EXPECT_EQ(actual.getRecordFormat(), expected.recordFormats);
+            EXPECT_EQ(actual.getDatePublished(), expected.datePublished);
+            EXPECT_EQ(actual.getPath(), expected.paths);
+        }
+    }
+    EXPECT_EQ(row, positions.size());
+    EXPECT_FALSE(reader.readRowGroup(reader.rowGroupCount(), batch));
+
+    std::filesystem::resize_file(tempColumnarFile, report.bytesWritten - 4);
+    EXPECT_FALSE(reader.open(tempColumnarFile));
+}
+
+TEST_F(ExportTest, CsvImportValidatesRowsAndAppendsInBatches) {
+    std::fstream file;
+    openRecordFile(file, tempArtistFile, RecordKind::Artist);
+    artistList artists;
+    lastArtistID = 999;
+    std::istringstream csv("\xEF\xBB\xBFid,Name,Gender,Phone,EMAIL\r\n"
+                           "x1,zara lane,f,0911000001,zara@mail.com\r\n"
+                           "x2,\"Bad, Name\",M,0911000002,bad@mail.com\r\n"
+                           "x3,Abel,m,0911000003,abel@mail.com\n"
+                           "x4,Cara,Q,0911000004,cara@mail.com\n"
+                           "x5,Dan,M,0911000005\n"
+                           "\n"
+                           "x6,Eve,F,0911000006,eve@mail.com\n");
+    ImportReport report;
+    ImportSettings settings;
+    settings.batchRecords = 2;
+    std::unordered_map<std::string, std::string> idMap;
+    ASSERT_TRUE(importArtists(csv, ImportFormat::Csv, file, artists, report, &idMap, settings));
+    EXPECT_EQ(report.rowsRead, 6u);
+    EXPECT_EQ(report.imported, 3u);
+    EXPECT_EQ(report.rejected, 3u);
+    ASSERT_EQ(report.issues.size(), 3u);
+    EXPECT_EQ(report.issues[0].row, 2u);
+    EXPECT_EQ(report.issues[0].reason, "Validation Error: Artist name contains invalid characters!");
+    EXPECT_EQ(report.issues[2].reason, "expected 5 fields, found 4");
+    EXPECT_EQ(lastArtistID, 1002);
+
+    ASSERT_EQ(artists.artList.size(), 3u);
+    EXPECT_EQ(artists.artList[0].name, "Abel");
+    EXPECT_EQ(artists.artList[2].name, "Zara Lane");
+    EXPECT_EQ(idMap["x1"], "art1000");
+    EXPECT_EQ(idMap["x6"], "art1002");
+    EXPECT_EQ(recordCount(file, RecordKind::Artist), 3);
+    ArtistFile loaded{};
+    ASSERT_EQ(readRecordAt(file, artists.artList[0].pos, loaded), RecordStatus::Ok);
+    EXPECT_STREQ(loaded.artistIds, "art1001");
+    EXPECT_EQ(loaded.genders, 'M');
+    EXPECT_STREQ(loaded.emails, "abel@mail.com");
+}
+
+TEST_F(ExportTest, ImportKeepsIdsUniquePastFourDigitsAndRefusesWhenTheyRunOut) {
+    std::fstream file;
+    openRecordFile(file, tempArtistFile, RecordKind::Artist);
+    artistList artists;
+    lastArtistID = 9995;
+    std::string rows = "Name,Gender,Phone,Email\n";
+    for (int i = 0; i < 12; ++i) {
+        rows += "Artist " + std::string(1, static_cast<char>('a' + i)) + ",M,09110000" + std::to_string(10 + i) + ",artist@mail.com\n";
+    }
+    std::istringstream csv(rows);
+    ImportReport report;
+    ImportSettings settings;
+    settings.batchRecords = 5;
+    ASSERT_TRUE(importArtists(csv, ImportFormat::Csv, file, artists, report, nullptr, settings));
+    EXPECT_EQ(report.imported, 12u);
+    EXPECT_EQ(lastArtistID, 10007);
+    std::set<std::string> ids;
+    for (const auto& entry : artists.artList) {
+        ArtistFile loaded{};
+        ASSERT_EQ(readRecordAt(file, entry.pos, loaded), RecordStatus::Ok);
+        EXPECT_EQ(entry.artistId, loaded.artistIds);
+        EXPECT_GT(stringToInt(loaded.artistIds), 9995) << loaded.artistIds;
+        ids.insert(loaded.artistIds);
+    }
+    EXPECT_EQ(ids.size(), 12u);
+    EXPECT_EQ(ids.count("art9999"), 1u);
+    EXPECT_EQ(ids.count(intToString(10000, "art")), 1u);
+
+    lastArtistID = MAX_RECORD_ID_NUMBER - 3;
+    std::istringstream tooMany(rows);
+    EXPECT_FALSE(importArtists(tooMany, ImportFormat::Csv, file, artists, report, nullptr, settings));
+    EXPECT_EQ(report.imported, 0u);
+    EXPECT_EQ(report.rejected, 5u);
+    ASSERT_EQ(report.issues.size(), 1u);
+    EXPECT_NE(report.issues[0].reason.find("no IDs left"), std::string::npos);
+    EXPECT_EQ(lastArtistID, MAX_RECORD_ID_NUMBER - 3);
+    EXPECT_EQ(recordCount(file, RecordKind::Artist), 12);
+}
+
+TEST_F(ExportTest, JsonImportResolvesArtistReferences) {
+    std::fstream artFile;
+    std::fstream albFile;
+    openRecordFile(artFile, tempArtistFile, RecordKind::Artist);
+    openRecordFile(albFile, tempAlbumFile, RecordKind::Album);
+    artistList artists;
+    artists.artList.push_back({"art1500", "Existing", RECORD_HEADER_SIZE});
+    albumList albums;
+    lastAlbumID = 1999;
+    std::unordered_map<std::string, std::string> idMap = {{"src-7", "art1500"}};
+    std::istringstream json(R"([
+        {"artist_id": "src-7", "title": "blue \u0074rain", "recordFormat": "FLAC",
+         "datePublished": "5/3/1998", "path": "c:\\music\\blue", "extra": {"nested": [1, 2]}},
+        {"ArtistID": "art1500", "Title": "Night Drive", "RecordFormat": "mp3",
+         "DatePublished": "31/04/2001", "Path": "c:\\x"},
+        {"ArtistID": "art9999", "Title": "Lost", "RecordFormat": "mp3", "DatePublished": "01/01/2001", "Path": "c:\\x"},
+        {"ArtistID": "art1500", "Title": ["Nested"], "RecordFormat": "mp3", "DatePublished": "01/01/2001", "Path": "c:\\x"},
+        {"ArtistID": "art1500", "Title": "Late Show", "RecordFormat": "wav", "DatePublished": "29/02/2000", "Path": "d:\\late", "year": null}
+    ])");
+    ImportReport report;
+    ASSERT_TRUE(importAlbums(json, ImportFormat::Json, albFile, artists, albums, report, &idMap));
+    EXPECT_EQ(report.rowsRead, 5u);
+    EXPECT_EQ(report.imported, 2u);
+    ASSERT_EQ(report.issues.size(), 3u);
+    EXPECT_EQ(report.issues[1].reason, "Validation Error: Unknown artist ID \"art9999\"!");
+    EXPECT_EQ(report.issues[2].reason, "field \"Title\" must be a string or number");
+
+    ASSERT_EQ(albums.albList.size(), 2u);
+    AlbumFile loaded{};
+    ASSERT_EQ(readRecordAt(albFile, RECORD_HEADER_SIZE, loaded), RecordStatus::Ok);
+    EXPECT_STREQ(loaded.albumIds, "alb2000");
+    EXPECT_STREQ(loaded.artistIdRefs, "art1500");
+    EXPECT_STREQ(loaded.titles, "Blue Train");
+    EXPECT_STREQ(loaded.recordFormats, "flac");
+    EXPECT_STREQ(loaded.datePublished, "05/03/1998");
+    EXPECT_STREQ(loaded.paths, "C:\\Music\\Blue");
+
+    std::istringstream broken(R"([{"ArtistID": "art1500", "Title": "Good", "RecordFormat": "mp3",
+        "DatePublished": "01/01/2001", "Path": "c:\\x"} {"ArtistID": "art1500"}])");
+    EXPECT_FALSE(importAlbums(broken, ImportFormat::Json, albFile, artists, albums, report));
+    EXPECT_EQ(report.imported, 1u);
+    ASSERT_EQ(report.issues.size(), 1u);
+    EXPECT_EQ(report.issues[0].reason, "expected ',' between array elements (element 1)");
+    EXPECT_EQ(importFormatForPath("dump/Albums.JSON"), ImportFormat::Json);
+    EXPECT_EQ(importFormatForPath("albums.csv"), ImportFormat::Csv);
+}
+
+TEST_F(ExportTest, JsonlExportEscapesFieldsAndImportsBack) {
+    std::fstream file;
+    openRecordFile(file, tempArtistFile, RecordKind::Artist);
+    long quoted = 0;
+    long deleted = 0;
+    ASSERT_TRUE(appendRecord(file, makeArtist("art1000", "Say \"Hi\"\t\\ \x01"), quoted));
+    ASSERT_TRUE(appendRecord(file, makeArtist("-1", ""), deleted));
+    file.close();
+    artistList artists;
+    artists.artList.push_back({"-1", "", deleted});
+    artists.artList.push_back({"art1000", "Say", quoted});
+    CsvExportReport report;
+    ASSERT_TRUE(writeArtistsJsonl(artists, tempArtistFile, tempCsvFile, &report));
+    EXPECT_EQ(readCsv(), "{\"ID\":\"art1000\",\"Name\":\"Say \\\"Hi\\\"\\t\\\\ \\u0001\",\"Gender\":\"M\","
+                         "\"Phone\":\"0911000000\",\"Email\":\"a@b.com\"}\n");
+    EXPECT_EQ(report.rows, 1u);
+    EXPECT_EQ(report.deleted, 1u);
+
+    // Generated artists and their albums survive export and re-import, references included.
+    CatalogGeneratorSettings settings;
+    settings.artists = 200;
+    settings.albums = 0;
+    settings.tombstoneRatio = 0.05;
+    ASSERT_TRUE(generateSyntheticCatalog(tempArtistFile, tempAlbumFile, settings));
+    artistList sourceArtists;
+    indexSet deletedSlots;
+    ASSERT_TRUE(stageRestoredRecords(tempArtistFile, tempArtistFile + ".restore", sourceArtists, deletedSlots));
+    std::filesystem::remove(tempArtistFile + ".restore");
+    albumList sourceAlbums;
+    {
+        std::fstream data;
+        openRecordFile(data, tempAlbumFile, RecordKind::Album);
+        for (int i = 0; i < 50; ++i) {
+            AlbumFile record{};
+            std::string id = "alb" + std::to_string(2000 + i);
+            const std::string& artistId = sourceArtists.artList[static_cast<std::size_t>(i) % sourceArtists.artList.size()].artistId;
+            std::strncpy(record.albumIds, id.c_str(), 7);
+            std::strncpy(record.artistIdRefs, artistId.c_str(), 7);
+            std::string title = std::string("Take ") + static_cast<char>('A' + i % 26) + static_cast<char>('a' + i / 26);
+            std::strncpy(record.titles, title.c_str(), 79);
+            std::strncpy(record.recordFormats, "flac", 11);
+            std::strncpy(record.datePublished, "07/06/1999", sizeof(record.datePublished));
+            std::strncpy(record.paths, "C:\\Music\\Take", 99);
+            long pos = 0;
+            ASSERT_TRUE(appendRecord(data, record, pos));
+            sourceAlbums.albList.push_back({id, artistId, record.titles, pos});
+        }
+    }
+    const std::string albumJsonl = tempColumnarFile;
+    ASSERT_TRUE(writeArtistsJsonl(sourceArtists, tempArtistFile, tempCsvFile, &report));
+    EXPECT_EQ(report.rows, sourceArtists.artList.size());
+    ASSERT_TRUE(writeAlbumsJsonl(sourceAlbums, tempAlbumFile, albumJsonl, &report));
+    EXPECT_EQ(report.rows, sourceAlbums.albList.size());
+    std::filesystem::remove(tempArtistFile);
+    std::filesystem::remove(tempAlbumFile);
+
+    std::fstream artFile;
+    std::fstream albFile;
+    openRecordFile(artFile, tempArtistFile, RecordKind::Artist);
+    openRecordFile(albFile, tempAlbumFile, RecordKind::Album);
+    artistList imported;
+    albumList importedAlbums;
+    std::unordered_map<std::string, std::string> idMap;
+    ImportReport importReport;
+    lastArtistID = 4999;
+    lastAlbumID = 4999;
+    std::ifstream artistIn(tempCsvFile, std::ios::binary);
+    ASSERT_TRUE(importArtists(artistIn, importFormatForPath("artists.jsonl"), artFile, imported, importReport, &idMap));
+    EXPECT_EQ(importReport.imported, sourceArtists.artList.size());
+    std::ifstream albumIn(albumJsonl, std::ios::binary);
+    ASSERT_TRUE(importAlbums(albumIn, ImportFormat::Json, albFile, imported, importedAlbums, importReport, &idMap));
+    ASSERT_EQ(importReport.imported, sourceAlbums.albList.size());
+    std::unordered_map<std::string, std::string> sourceArtistOf;
+    for (const albumIndex& entry : sourceAlbums.albList) {
+        sourceArtistOf[entry.title] = entry.artistId;
+    }
+    for (const albumIndex& entry : importedAlbums.albList) {
+        EXPECT_EQ(entry.artistId, idMap[sourceArtistOf[entry.title]]) << entry.title;
+    }
+
+    std::istringstream badLine("{\"ID\":\"x1\",\"Name\":\"Ann\",\"Gender\":\"F\",\"Phone\":\"0911000001\",\"Email\":\"ann@mail.com\"}\n"
+                               "\n"
+                               "[1, 2]\n");
+    EXPECT_FALSE(importArtists(badLine, ImportFormat::Json, artFile, imported, importReport));
+    EXPECT_EQ(importReport.imported, 1u);
+    ASSERT_EQ(importReport.issues.size(), 1u);
+    EXPECT_EQ(importReport.issues[0].reason, "each line must hold an object (record 2)");
+}
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <fstream>
 #include <filesystem>
 #include "manager.h"
@@ -65,4 +66,397 @@ TEST(IntegrationTest, AddAlbumAndPersist) {
 
     std::filesystem::remove(tempArtistFile);
     std::filesystem::remove(tempAlbumFile);
-}
\ No newline at end of file
+}
+TEST(IntegrationTest, MergeArtistsReparentsAlbumsAndUndoes) {
+    std::string tempArtistFile = "temp_artist_merge.bin";
+    std::string tempAlbumFile = "temp_album_merge.bin";
+    CatalogGeneratorSettings settings;
+    settings.seed = 11;
+    settings.artists = 200;
+    settings.albums = 5000;
+    ASSERT_TRUE(generateSyntheticCatalog(tempArtistFile, tempAlbumFile, settings));
+
+    artistList artists;
+    albumList albums;
+    indexSet deletedArtists, deletedAlbums;
+    ASSERT_TRUE(FileArtistRepository(tempArtistFile).loadArtists(artists, deletedArtists));
+    ASSERT_TRUE(FileAlbumRepository(tempAlbumFile).loadAlbums(albums, deletedAlbums));
+    sortArtist(artists);
+    sortAlbum(albums);
+    std::fstream artFile, albFile;
+    openRecordFile(artFile, tempArtistFile, RecordKind::Artist);
+    openRecordFile(albFile, tempAlbumFile, RecordKind::Album);
+
+    auto albumsOf = [&](const std::string& id) {
+        return std::count_if(albums.albList.begin(), albums.albList.end(),
+                             [&](const albumIndex& entry) { return entry.artistId == id; });
+    };
+    int duplicateIdx = 0;
+    for (int i = 1; i < static_cast<int>(artists.artList.size()); ++i) {
+        if (albumsOf(artists.artList[i].artistId) > albumsOf(artists.artList[duplicateIdx].artistId)) {
+            duplicateIdx = i;
+        }
+    }
+    int canonicalIdx = duplicateIdx == 0 ? 1 : 0;
+    std::string duplicateId = artists.artList[duplicateIdx].artistId;
+    std::string duplicateName = artists.artList[duplicateIdx].name;
+    std::string canonicalId = artists.artList[canonicalIdx].artistId;
+    long duplicateAlbums = albumsOf(duplicateId);
+    long canonicalAlbums = albumsOf(canonicalId);
+    ASSERT_GT(duplicateAlbums, 500);
+    EXPECT_EQ(artists.live, 200u);
+
+    indexSet delArtArray;
+    std::size_t moved = 0;
+    ASSERT_TRUE(mergeArtists(artFile, albFile, artists, albums, delArtArray, duplicateIdx, canonicalIdx, &moved));
+    EXPECT_EQ(static_cast<long>(moved), duplicateAlbums);
+    EXPECT_EQ(albumsOf(duplicateId), 0);
+    EXPECT_EQ(albumsOf(canonicalId), canonicalAlbums + duplicateAlbums);
+    EXPECT_TRUE(std::is_sorted(albums.albList.begin(), albums.albList.end(),
+                               [](const albumIndex& a, const albumIndex& b) { return a.artistId < b.artistId; }));
+    EXPECT_EQ(artists.artList[duplicateIdx].artistId, "-1");
+    EXPECT_EQ(artists.live, 199u);
+    for (const auto& entry : albums.albList) {
+        AlbumFile record{};
+        ASSERT_EQ(readRecordAt(albFile, entry.pos, record), RecordStatus::Ok);
+        ASSERT_EQ(entry.artistId, record.artistIdRefs);
+    }
+    EXPECT_FALSE(mergeArtists(artFile, albFile, artists, albums, delArtArray, duplicateIdx, canonicalIdx));
+
+    ASSERT_TRUE(undoLastAction());
+    EXPECT_EQ(albumsOf(duplicateId), duplicateAlbums);
+    EXPECT_EQ(albumsOf(canonicalId), canonicalAlbums);
+    EXPECT_EQ(artists.artList[duplicateIdx].artistId, duplicateId);
+    EXPECT_EQ(artists.artList[duplicateIdx].name, duplicateName);
+    EXPECT_EQ(artists.live, 200u);
+    EXPECT_TRUE(delArtArray.indexes.empty());
+    for (const auto& entry : albums.albList) {
+        AlbumFile record{};
+        ASSERT_EQ(readRecordAt(albFile, entry.pos, record), RecordStatus::Ok);
+        ASSERT_EQ(entry.artistId, record.artistIdRefs);
+    }
+    artFile.close();
+    albFile.close();
+    EXPECT_TRUE(scrubRecordFile(tempAlbumFile, RecordKind::Album).clean());
+    std::filesystem::remove(tempArtistFile);
+    std::filesystem::remove(tempAlbumFile);
+}
+
+TEST(IntegrationTest, FailedMergeAndUndoLeaveFilesAndIndexesUnchanged) {
+    std::string tempArtistFile = "temp_artist_merge_fail.bin";
+    std::string tempAlbumFile = "temp_album_merge_fail.bin";
+    CatalogGeneratorSettings settings;
+    settings.seed = 5;
+    settings.artists = 50;
+    settings.albums = 2000;
+    ASSERT_TRUE(generateSyntheticCatalog(tempArtistFile, tempAlbumFile, settings));
+
+    artistList artists;
+    albumList albums;
+    indexSet deletedArtists, deletedAlbums;
+    ASSERT_TRUE(FileArtistRepository(tempArtistFile).loadArtists(artists, deletedArtists));
+    ASSERT_TRUE(FileAlbumRepository(tempAlbumFile).loadAlbums(albums, deletedAlbums));
+    sortArtist(artists);
+    sortAlbum(albums);
+    auto expectIndexMatchesFile = [&](std::fstream& albFile, const char* stage) {
+        for (const auto& entry : albums.albList) {
+            AlbumFile record{};
+            ASSERT_EQ(readRecordAt(albFile, entry.pos, record), RecordStatus::Ok) << stage;
+            ASSERT_EQ(entry.artistId, record.artistIdRefs) << stage;
+        }
+    };
+    std::string duplicateId = artists.artList[0].artistId;
+    std::string canonicalId = artists.artList[1].artistId;
+    auto albumsOf = [&](const std::string& id) {
+        return std::count_if(albums.albList.begin(), albums.albList.end(),
+                             [&](const albumIndex& entry) { return entry.artistId == id; });
+    };
+    long duplicateAlbums = albumsOf(duplicateId);
+    ASSERT_GT(duplicateAlbums, 0);
+
+    // A read-only artist file makes the tombstone write fail after the albums were rewritten.
+    std::fstream artFile(tempArtistFile, std::ios::in | std::ios::binary);
+    std::fstream albFile;
+    openRecordFile(albFile, tempAlbumFile, RecordKind::Album);
+    indexSet delArtArray;
+    bool couldUndo = canUndo();
+    EXPECT_FALSE(mergeArtists(artFile, albFile, artists, albums, delArtArray, 0, 1));
+    EXPECT_EQ(canUndo(), couldUndo);
+    EXPECT_EQ(albumsOf(duplicateId), duplicateAlbums);
+    EXPECT_EQ(artists.artList[0].artistId, duplicateId);
+    expectIndexMatchesFile(albFile, "failed merge");
+
+    artFile.close();
+    openRecordFile(artFile, tempArtistFile, RecordKind::Artist);
+    ASSERT_TRUE(mergeArtists(artFile, albFile, artists, albums, delArtArray, 0, 1));
+    ASSERT_EQ(albumsOf(duplicateId), 0);
+
+    // The same fault during undo keeps the merge rather than leaving it half undone.
+    artFile.close();
+    artFile.open(tempArtistFile, std::ios::in | std::ios::binary);
+    ASSERT_TRUE(undoLastAction());
+    EXPECT_EQ(albumsOf(duplicateId), 0);
+    EXPECT_EQ(artists.artList[0].artistId, "-1");
+    expectIndexMatchesFile(albFile, "failed undo");
+    ArtistFile tombstone{};
+    ASSERT_EQ(readRecordAt(artFile, artists.artList[0].pos, tombstone), RecordStatus::Ok);
+    EXPECT_STREQ(tombstone.artistIds, "-1");
+
+    artFile.close();
+    albFile.close();
+    EXPECT_TRUE(scrubRecordFile(tempAlbumFile, RecordKind::Album).clean());
+    std::filesystem::remove(tempArtistFile);
+    std::filesystem::remove(tempAlbumFile);
+}
+
+TEST(IntegrationTest, StatisticsFollowMergeRemovalAndUndo) {
+    std::string tempArtistFile = "temp_artist_stats.bin";
+    std::string tempAlbumFile = "temp_album_stats.bin";
+    CatalogGeneratorSettings settings;
+    settings.seed = 5;
+    settings.artists = 50;
+    settings.albums = 2000;
+    ASSERT_TRUE(generateSyntheticCatalog(tempArtistFile, tempAlbumFile, settings));
+
+    artistList artists;
+    albumList albums;
+    indexSet deletedArtists, deletedAlbums;
+    ASSERT_TRUE(FileArtistRepository(tempArtistFile).loadArtists(artists, deletedArtists));
+    ASSERT_TRUE(FileAlbumRepository(tempAlbumFile).loadAlbums(albums, deletedAlbums));
+    sortArtist(artists);
+    sortAlbum(albums);
+    std::fstream artFile, albFile;
+    openRecordFile(artFile, tempArtistFile, RecordKind::Artist);
+    openRecordFile(albFile, tempAlbumFile, RecordKind::Album);
+
+    // Recounts from the records on disk, which is what the incremental totals must match.
+    auto expectStatsMatchFile = [&](const char* step) {
+        CatalogStatistics expected;
+        for (const auto& entry : albums.albList) {
+            AlbumFile record{};
+            ASSERT_EQ(readRecordAt(albFile, entry.pos, record), RecordStatus::Ok) << step;
+            expected.add(albumIndex{record.albumIds, record.artistIdRefs, record.titles, entry.pos,
+                                    publicationYear(record.datePublished), recordFormatCode(record.recordFormats)});
+        }
+        EXPECT_EQ(albums.stats.albums, expected.albums) << step;
+        EXPECT_EQ(albums.stats.albumsPerArtist, expected.albumsPerArtist) << step;
+        EXPECT_EQ(albums.stats.albumsPerFormat, expected.albumsPerFormat) << step;
+        EXPECT_EQ(albums.stats.albumsPerYear, expected.albumsPerYear) << step;
+    };
+    expectStatsMatchFile("load");
+    EXPECT_EQ(albums.stats.albums, 2000u);
+    EXPECT_EQ(albums.stats.albumsPerFormat[0], 0u);
+    EXPECT_EQ(albums.stats.albumsPerYear.count(0), 0u);
+    CatalogStatistics loaded = albums.stats;
+
+    std::string duplicateId = artists.artList[0].artistId;
+    std::string canonicalId = artists.artList[1].artistId;
+    std::size_t duplicateAlbums = albums.stats.albumsBy(duplicateId);
+    std::size_t canonicalAlbums = albums.stats.albumsBy(canonicalId);
+    indexSet delArtArray, delAlbArray;
+    ASSERT_TRUE(mergeArtists(artFile, albFile, artists, albums, delArtArray, 0, 1));
+    expectStatsMatchFile("merge");
+    EXPECT_EQ(albums.stats.albumsBy(duplicateId), 0u);
+    EXPECT_EQ(albums.stats.albumsBy(canonicalId), canonicalAlbums + duplicateAlbums);
+
+    int removedIdx = 2;
+    std::string removedId = artists.artList[removedIdx].artistId;
+    std::size_t removedAlbums = albums.stats.albumsBy(removedId);
+    ASSERT_TRUE(removeArtistRecord(artFile, albFile, artists, albums, delArtArray, delAlbArray, removedIdx));
+    expectStatsMatchFile("remove artist");
+    EXPECT_EQ(albums.stats.albumsBy(removedId), 0u);
+    EXPECT_EQ(albums.stats.albums, 2000u - removedAlbums);
+
+    ASSERT_TRUE(undoLastAction());
+    expectStatsMatchFile("undo remove");
+    EXPECT_EQ(artists.artList[removedIdx].artistId, removedId);
+    ASSERT_TRUE(undoLastAction());
+    expectStatsMatchFile("undo merge");
+    EXPECT_EQ(albums.stats.albumsPerArtist, loaded.albumsPerArtist);
+    EXPECT_EQ(albums.stats.albumsPerYear, loaded.albumsPerYear);
+    ASSERT_TRUE(redoLastAction());
+    expectStatsMatchFile("redo merge");
+
+    artFile.close();
+    albFile.close();
+    std::filesystem::remove(tempArtistFile);
+    std::filesystem::remove(tempAlbumFile);
+}
+
+TEST(IntegrationTest, UndoingArtistRemovalPutsEveryAlbumBackInTheIndex) {
+    std::string tempArtistFile = "temp_artist_undo_remove.bin";
+    std::string tempAlbumFile = "temp_album_undo_remove.bin";
+    CatalogGeneratorSettings settings;
+    settings.seed = 9;
+    settings.artists = 20;
+    settings.albums = 3000;
+    ASSERT_TRUE(generateSyntheticCatalog(tempArtistFile, tempAlbumFile, settings));
+
+    artistList artists;
+    albumList albums;
+    indexSet deletedArtists, deletedAlbums;
+    ASSERT_TRUE(FileArtistRepository(tempArtistFile).loadArtists(artists, deletedArtists));
+    ASSERT_TRUE(FileAlbumRepository(tempAlbumFile).loadAlbums(albums, deletedAlbums));
+    sortArtist(artists);
+    sortAlbum(albums);
+    std::fstream artFile, albFile;
+    openRecordFile(artFile, tempArtistFile, RecordKind::Artist);
+    openRecordFile(albFile, tempAlbumFile, RecordKind::Album);
+    auto before = albums.albList;
+
+    int removedIdx = 3;
+    std::string removedId = artists.artList[removedIdx].artistId;
+    std::size_t removedAlbums = albums.stats.albumsBy(removedId);
+    ASSERT_GT(removedAlbums, 50u);
+    indexSet delArtArray, delAlbArray;
+    ASSERT_TRUE(removeArtistRecord(artFile, albFile, artists, albums, delArtArray, delAlbArray, removedIdx));
+    EXPECT_EQ(delAlbArray.indexes.size(), removedAlbums);
+
+    // Redo blanked the album IDs, so undo has to find the entries by slot.
+    ASSERT_TRUE(undoLastAction());
+    EXPECT_TRUE(delAlbArray.indexes.empty());
+    EXPECT_EQ(albums.stats.albumsBy(removedId), removedAlbums);
+    ASSERT_EQ(albums.albList.size(), before.size());
+    for (std::size_t i = 0; i < before.size(); ++i) {
+        ASSERT_EQ(albums.albList[i].albumId, before[i].albumId) << i;
+        ASSERT_EQ(albums.albList[i].artistId, before[i].artistId) << i;
+        ASSERT_EQ(albums.albList[i].pos, before[i].pos) << i;
+    }
+
+    artFile.close();
+    albFile.close();
+    std::filesystem::remove(tempArtistFile);
+    std::filesystem::remove(tempAlbumFile);
+}
+
+TEST(IntegrationTest, AggregateQueriesAgreeAcrossWorkersAndWithStatistics) {
+    std::string tempArtistFile = "temp_artist_aggregate.bin";
+    std::string tempAlbumFile = "temp_album_aggregate.bin";
+    CatalogGeneratorSettings settings;
+    settings.seed = 9;
+    settings.artists = 3000;
+    settings.albums = 3 * AGGREGATE_PARALLEL_MIN_ENTRIES;
+    ASSERT_TRUE(generateSyntheticCatalog(tempArtistFile, tempAlbumFile, settings));
+    albumList albums;
+    indexSet deletedAlbums;
+    ASSERT_TRUE(FileAlbumRepository(tempAlbumFile).loadAlbums(albums, deletedAlbums));
+    albums.stats.remove(albums.albList[0]);
+    albums.albList[0].albumId = "-1";
+    albums.albList[0].artistId = "-1";
+
+    AggregateQuery byArtist;
+    byArtist.byArtist = true;
+    byArtist.threads = 1;
+    std::vector<AggregateRow> single = runAggregateQuery(albums, byArtist);
+    byArtist.threads = 3;
+    std::vector<AggregateRow> parallel = runAggregateQuery(albums, byArtist);
+    ASSERT_EQ(single.size(), parallel.size());
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < single.size(); ++i) {
+        ASSERT_EQ(single[i].artistId, parallel[i].artistId);
+        ASSERT_EQ(single[i].count, parallel[i].count);
+        ASSERT_EQ(single[i].minYear, parallel[i].minYear);
+        ASSERT_EQ(single[i].maxYear, parallel[i].maxYear);
+        ASSERT_NE(single[i].artistId, "-1");
+        ASSERT_LE(single[i].minYear, single[i].maxYear);
+        total += single[i].count;
+    }
+    EXPECT_TRUE(std::is_sorted(single.begin(), single.end(),
+                               [](const AggregateRow& a, const AggregateRow& b) { return a.artistId < b.artistId; }));
+    EXPECT_EQ(total, albums.albList.size() - 1);
+
+    std::vector<AggregateRow> ranked = single;
+    std::sort(ranked.begin(), ranked.end(), [](const AggregateRow& a, const AggregateRow& b) {
+        return a.count != b.count ? a.count > b.count : a.artistId < b.artistId;
+    });
+    byArtist.topK = 20;
+    byArtist.threads = 0;
+    std::vector<AggregateRow> top = runAggregateQuery(albums, byArtist);
+    ASSERT_EQ(top.size(), 20u);
+    for (std::size_t i = 0; i < top.size(); ++i) {
+        EXPECT_EQ(top[i].artistId, ranked[i].artistId) << i;
+        EXPECT_EQ(top[i].count, ranked[i].count) << i;
+    }
+
+    AggregateQuery byDecade;
+    byDecade.byYear = true;
+    byDecade.yearBucket = 10;
+    std::size_t decadeTotal = 0;
+    for (const auto& row : runAggregateQuery(albums, byDecade)) {
+        EXPECT_EQ(row.year % 10, 0);
+        EXPECT_GE(row.minYear, row.year);
+        EXPECT_LT(row.maxYear, row.year + 10);
+        decadeTotal += row.count;
+    }
+    EXPECT_EQ(decadeTotal, total);
+
+    AggregateQuery byYearAndFormat;
+    byYearAndFormat.byYear = true;
+    byYearAndFormat.byFormat = true;
+    std::map<std::uint16_t, std::size_t> perYear;
+    std::array<std::size_t, RECORD_FORMAT_CODES> perFormat{};
+    for (const auto& row : runAggregateQuery(albums, byYearAndFormat)) {
+        EXPECT_TRUE(row.artistId.empty());
+        perYear[row.year] += row.count;
+        perFormat[row.format] += row.count;
+    }
+    EXPECT_EQ(perYear, albums.stats.albumsPerYear);
+    EXPECT_EQ(perFormat, albums.stats.albumsPerFormat);
+
+    std::filesystem::remove(tempArtistFile);
+    std::filesystem::remove(tempAlbumFile);
+}
+
+TEST(IntegrationTest, PagedAlbumViewFormatsOnlyTheRequestedPage) {
+    std::string tempArtistFile = "temp_artist_paging.bin";
+    std::string tempAlbumFile = "temp_album_paging.bin";
+    CatalogGeneratorSettings settings;
+    settings.artists = 50;
+    settings.albums = 1000;
+    ASSERT_TRUE(generateSyntheticCatalog(tempArtistFile, tempAlbumFile, settings));
+    albumList albums;
+    indexSet deleted;
+    ASSERT_TRUE(stageRestoredRecords(tempAlbumFile, tempAlbumFile + ".restore", albums, deleted));
+    std::filesystem::remove(tempAlbumFile + ".restore");
+    ASSERT_EQ(albums.albList.size(), 1000u);
+    recountCatalogStatistics(albums);
+    albums.stats.remove(albums.albList[41]);
+    albums.albList[41].albumId = "-1";
+    {
+        std::fstream data(tempAlbumFile, std::ios::binary | std::ios::in | std::ios::out);
+        data.seekp(albums.albList[42].pos + 30);
+        data.put('#');
+    }
+
+    // Pages count live entries only, so the tombstone at 41 shifts later pages by one. The
+    // same start is found walking from the index start, from a neighbouring page or from the end.
+    EXPECT_EQ(albums.stats.albums, 999u);
+    const std::size_t third = AlbumView::pageStart(albums, 0, 0, 2, 20);
+    EXPECT_EQ(third, 40u);
+    EXPECT_EQ(AlbumView::pageStart(albums, third, 2, 3, 20), 61u);
+    EXPECT_EQ(AlbumView::pageStart(albums, 61, 3, 2, 20), 40u);
+    EXPECT_EQ(AlbumView::pageStart(albums, 61, 3, 1, 20), 20u);
+    EXPECT_EQ(AlbumView::pageStart(albums, 0, 0, 49, 20), 981u);
+    EXPECT_EQ(AlbumView::pageStart(albums, 981, 49, 30, 20), 601u);
+    EXPECT_EQ(AlbumView::pageStart(albums, 0, 0, 50, 20), albums.albList.size());
+
+    std::fstream albFile(tempAlbumFile, std::ios::binary | std::ios::in);
+    std::string page;
+    EXPECT_EQ(AlbumView::renderPage(albFile, albums, third, 20, 41, page), 20u);
+    std::size_t lines = static_cast<std::size_t>(std::count(page.begin(), page.end(), '\n'));
+    EXPECT_EQ(lines, 2u + 20u);
+    EXPECT_NE(page.find("41      "), std::string::npos);
+    EXPECT_NE(page.find("42      [corrupt record at offset " + std::to_string(albums.albList[42].pos) + "]"), std::string::npos);
+    EXPECT_NE(page.find(albums.albList[60].albumId), std::string::npos);
+    EXPECT_EQ(page.find(albums.albList[61].albumId + " "), std::string::npos);
+    EXPECT_EQ(page.find("\n61 "), std::string::npos);
+
+    const std::size_t capacity = page.capacity();
+    EXPECT_EQ(AlbumView::renderPage(albFile, albums, 981, 20, 981, page), 19u);
+    EXPECT_EQ(page.capacity(), capacity);
+    EXPECT_EQ(AlbumView::renderPage(albFile, albums, 5000, 20, 1, page), 0u);
+
+    albFile.close();
+    std::filesystem::remove(tempArtistFile);
+    std::filesystem::remove(tempAlbumFile);
+}
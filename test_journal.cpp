@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "manager.h"
+
+class ChangeJournalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        journalPath = "temp_journal/journal.bin";
+        liveArtistFile = "temp_journal_artist.bin";
+        replayArtistFile = "temp_journal_artist_replay.bin";
+        replayAlbumFile = "temp_journal_album_replay.bin";
+        ASSERT_TRUE(ChangeJournal::instance().open(journalPath));
+    }
+
+    void TearDown() override {
+        ChangeJournal::instance().close();
+        std::filesystem::remove_all("temp_journal");
+        for (const auto& path : {liveArtistFile, replayArtistFile, replayAlbumFile}) {
+            std::filesystem::remove(path);
+        }
+    }
+
+    static ArtistFile makeArtist(int n) {
+        ArtistFile artFile{};
+        std::string id = "art" + std::to_string(1000 + n);
+        std::string name = "Artist " + std::to_string(n);
+        std::strncpy(artFile.artistIds, id.c_str(), 7);
+        std::strncpy(artFile.names, name.c_str(), 49);
+        artFile.genders = 'M';
+        std::strncpy(artFile.phones, "0911000000", 14);
+        std::strncpy(artFile.emails, "a@b.com", 49);
+        return artFile;
+    }
+
+    // Creates empty replay targets standing in for a restored snapshot.
+    void createReplayTargets() {
+        std::fstream file;
+        ChangeJournal::instance().close();
+        openRecordFile(file, replayArtistFile, RecordKind::Artist);
+        file.close();
+        openRecordFile(file, replayAlbumFile, RecordKind::Album);
+        file.close();
+    }
+
+    std::string journalPath;
+    std::string liveArtistFile;
+    std::string replayArtistFile;
+    std::string replayAlbumFile;
+};
+
+TEST_F(ChangeJournalTest, RecordWritesRoundTrip) {
+    std::fstream file;
+    openRecordFile(file, liveArtistFile, RecordKind::Artist);
+    long pos = 0;
+    ASSERT_TRUE(appendRecord(file, makeArtist(1), pos));
+    file.close();
+    EXPECT_GT(ChangeJournal::instance().endOffset(), 0);
+
+    std::ifstream in(journalPath, std::ios::binary);
+    JournalEntry entry;
+    ASSERT_TRUE(ChangeJournal::readEntry(in, entry));
+    EXPECT_EQ(entry.op, JournalOp::Reset);
+    EXPECT_EQ(entry.kind, RecordKind::Artist);
+    ASSERT_TRUE(ChangeJournal::readEntry(in, entry));
+    EXPECT_EQ(entry.op, JournalOp::Write);
+    EXPECT_EQ(entry.pos, pos);
+    ASSERT_EQ(entry.payload.size(), sizeof(ArtistFile));
+    ArtistFile decoded;
+    std::memcpy(&decoded, entry.payload.data(), sizeof(decoded));
+    EXPECT_STREQ(decoded.artistIds, "art1001");
+    EXPECT_FALSE(ChangeJournal::readEntry(in, entry));
+}
+
+TEST_F(ChangeJournalTest, ReplayStopsAtTargetTime) {
+    std::fstream file;
+    openRecordFile(file, liveArtistFile, RecordKind::Artist);
+    long first = 0;
+    long second = 0;
+    ASSERT_TRUE(appendRecord(file, makeArtist(1), first));
+    ASSERT_TRUE(appendRecord(file, makeArtist(2), second));
+    file.close();
+    std::int64_t cutoff = currentTimeMillis();
+    while (currentTimeMillis() <= cutoff) {
+    }
+    openRecordFile(file, liveArtistFile, RecordKind::Artist);
+    ASSERT_TRUE(writeRecordAt(file, first, ArtistFile{"-1", "", 'N', "", ""}));
+    file.close();
+
+    createReplayTargets();
+    std::size_t applied = 0;
+    ASSERT_TRUE(replayJournal(journalPath, 0, cutoff, replayArtistFile, replayAlbumFile, applied));
+    EXPECT_EQ(applied, 3u);
+
+    openRecordFile(file, replayArtistFile, RecordKind::Artist);
+    EXPECT_EQ(recordCount(file, RecordKind::Artist), 2);
+    ArtistFile loaded{};
+    ASSERT_EQ(readRecordAt(file, first, loaded), RecordStatus::Ok);
+    EXPECT_STREQ(loaded.artistIds, "art1001");
+    file.close();
+
+    ASSERT_TRUE(replayJournal(journalPath, 0, currentTimeMillis(), replayArtistFile, replayAlbumFile, applied));
+    EXPECT_EQ(applied, 4u);
+    openRecordFile(file, replayArtistFile, RecordKind::Artist);
+    ASSERT_EQ(readRecordAt(file, first, loaded), RecordStatus::Ok);
+    EXPECT_STREQ(loaded.artistIds, "-1");
+}
+
+TEST_F(ChangeJournalTest, TornTailIsIgnored) {
+    std::fstream file;
+    openRecordFile(file, liveArtistFile, RecordKind::Artist);
+    long pos = 0;
+    ASSERT_TRUE(appendRecord(file, makeArtist(1), pos));
+    file.close();
+    std::int64_t complete = ChangeJournal::instance().endOffset();
+    ChangeJournal::instance().close();
+    std::filesystem::resize_file(journalPath, static_cast<std::uintmax_t>(complete - 10));
+
+    createReplayTargets();
+    std::size_t applied = 0;
+    ASSERT_TRUE(replayJournal(journalPath, 0, currentTimeMillis(), replayArtistFile, replayAlbumFile, applied));
+    EXPECT_EQ(applied, 1u);
+}
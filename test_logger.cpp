@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "manager.h"
+
+class LoggerTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        Logger::getInstance()->setOverflowPolicy(LogOverflowPolicy::Block);
+    }
+
+    static std::size_t countLinesContaining(const std::string& marker) {
+        std::ifstream in("album_system.log");
+        std::string line;
+        std::size_t count = 0;
+        while (std::getline(in, line)) {
+            if (line.find(marker) != std::string::npos) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    static std::string uniqueMarker(const std::string& name) {
+        return name + "-" + std::to_string(currentTimeMillis());
+    }
+};
+
+TEST_F(LoggerTest, ConcurrentProducersLoseNothingUnderBlockPolicy) {
+    const std::string marker = uniqueMarker("block");
+    const int producers = 4;
+    const int perProducer = static_cast<int>(Logger::QUEUE_CAPACITY);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < producers; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < perProducer; ++i) {
+                Logger::getInstance()->log(marker + " " + std::to_string(t) + ":" + std::to_string(i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    Logger::getInstance()->flush();
+    EXPECT_EQ(countLinesContaining(marker), static_cast<std::size_t>(producers * perProducer));
+}
+
+TEST_F(LoggerTest, DropPolicyAccountsForEveryMessage) {
+    const std::string marker = uniqueMarker("drop");
+    const std::size_t total = Logger::QUEUE_CAPACITY * 4;
+    std::uint64_t droppedBefore = Logger::getInstance()->droppedCount();
+    Logger::getInstance()->setOverflowPolicy(LogOverflowPolicy::Drop);
+    for (std::size_t i = 0; i < total; ++i) {
+        Logger::getInstance()->log(marker);
+    }
+    Logger::getInstance()->flush();
+    std::uint64_t dropped = Logger::getInstance()->droppedCount() - droppedBefore;
+    EXPECT_EQ(countLinesContaining(marker) + dropped, total);
+}
+
+TEST_F(LoggerTest, LinesCarryMillisecondTimestamps) {
+    const std::string marker = uniqueMarker("stamp");
+    Logger::getInstance()->log(marker);
+    Logger::getInstance()->flush();
+    std::ifstream in("album_system.log");
+    std::string line;
+    std::string found;
+    while (std::getline(in, line)) {
+        if (line.find(marker) != std::string::npos) {
+            found = line;
+        }
+    }
+    ASSERT_FALSE(found.empty());
+    // "YYYY-MM-DD HH:MM:SS.mmm : message"
+    ASSERT_GT(found.size(), 26u);
+    EXPECT_EQ(found[4], '-');
+    EXPECT_EQ(found[19], '.');
+    EXPECT_EQ(found.substr(23, 3), " : ");
+}
+
+TEST_F(LoggerTest, TemplatesFormatTypedArguments) {
+    std::string args;
+    encodeLogArg(args, std::int64_t{-42});
+    encodeLogArg(args, std::uint64_t{7});
+    encodeLogArg(args, 2.5);
+    encodeLogArg(args, "abc", 3);
+    encodeLogArg(args, 'x');
+    encodeLogArg(args, true);
+    const char* templ = "i={} u={} d={} s={} c={}";
+    std::string out;
+    ASSERT_TRUE(formatLogMessage(out, templ, std::strlen(templ), args.data(), args.size()));
+    EXPECT_EQ(out, "i=-42 u=7 d=2.5 s=abc c=x true");
+
+    std::string truncated;
+    EXPECT_FALSE(formatLogMessage(truncated, templ, std::strlen(templ), args.data(), 5));
+}
+
+TEST_F(LoggerTest, RuntimeLevelSkipsLowerMessages) {
+    const std::string marker = uniqueMarker("level");
+    Logger::getInstance()->setLevel(LogLevel::Warn);
+    EXPECT_FALSE(Logger::getInstance()->enabled(LogLevel::Info));
+    int evaluated = 0;
+    ALBUM_LOG_INFO("{} hidden {}", marker, ++evaluated);
+    ALBUM_LOG_WARN("{} shown {}", marker, 1);
+    Logger::getInstance()->setLevel(LogLevel::Info);
+    Logger::getInstance()->flush();
+    EXPECT_EQ(evaluated, 0);
+    EXPECT_EQ(countLinesContaining(marker), 1u);
+    EXPECT_EQ(countLinesContaining("[WARN] " + marker + " shown 1"), 1u);
+}
+
+TEST_F(LoggerTest, BinaryLogDecodesToTextLines) {
+    const std::string marker = uniqueMarker("binary");
+    std::filesystem::remove(Logger::BINARY_LOG_FILE);
+    Logger::getInstance()->setFormat(LogFormat::Binary);
+    ALBUM_LOG_INFO("{} count={} ratio={}", marker, 3, 0.5);
+    ALBUM_LOG_INFO("{} count={} ratio={}", marker, 4, 1.5);
+    Logger::getInstance()->setFormat(LogFormat::Text);
+
+    std::ifstream in(Logger::BINARY_LOG_FILE, std::ios::binary);
+    std::ostringstream decoded;
+    ASSERT_TRUE(decodeBinaryLog(in, decoded));
+    EXPECT_NE(decoded.str().find("[INFO] " + marker + " count=3 ratio=0.5\n"), std::string::npos);
+    EXPECT_NE(decoded.str().find("[INFO] " + marker + " count=4 ratio=1.5\n"), std::string::npos);
+    EXPECT_EQ(countLinesContaining(marker), 0u);
+    in.close();
+    std::filesystem::remove(Logger::BINARY_LOG_FILE);
+}
+
+class LogRotationTest : public LoggerTest {
+protected:
+    void TearDown() override {
+        Logger::getInstance()->setRotation(LogRotationSettings{});
+        for (const auto& segment : Logger::getInstance()->rotatedSegments()) {
+            std::filesystem::remove(segment);
+        }
+        LoggerTest::TearDown();
+    }
+
+    // Each flush ends a writer batch, and rotation is checked between batches.
+    static void logRounds(const std::string& marker, int rounds) {
+        for (int round = 0; round < rounds; ++round) {
+            for (int i = 0; i < 20; ++i) {
+                ALBUM_LOG_INFO("{} round {} message {} padding padding padding", marker, round, i);
+            }
+            Logger::getInstance()->flush();
+        }
+    }
+};
+
+TEST_F(LogRotationTest, SizeLimitRotatesAndKeepsRetention) {
+    Logger::getInstance()->flush();
+    for (const auto& segment : Logger::getInstance()->rotatedSegments()) {
+        std::filesystem::remove(segment);
+    }
+    LogRotationSettings settings;
+    settings.maxBytes = 2048;
+    settings.retention = 2;
+    Logger::getInstance()->setRotation(settings);
+    logRounds(uniqueMarker("rotate"), 10);
+
+    auto segments = Logger::getInstance()->rotatedSegments();
+    EXPECT_EQ(segments.size(), 2u);
+    EXPECT_LT(std::filesystem::file_size(Logger::TEXT_LOG_FILE), 2048u + 20 * 128);
+}
+
+TEST_F(LogRotationTest, RetentionKeepsNewestSegmentsRotatedInOneSecond) {
+    Logger::getInstance()->flush();
+    for (const auto& segment : Logger::getInstance()->rotatedSegments()) {
+        std::filesystem::remove(segment);
+    }
+    LogRotationSettings settings;
+    settings.maxBytes = 1024;
+    settings.retention = 3;
+    Logger::getInstance()->setRotation(settings);
+    // Enough rotations to pass a one-digit sequence number.
+    std::string marker = uniqueMarker("seq");
+    logRounds(marker, 14);
+
+    auto segments = Logger::getInstance()->rotatedSegments();
+    ASSERT_EQ(segments.size(), 3u);
+    for (const auto& segment : segments) {
+        std::ifstream in(segment);
+        std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        EXPECT_EQ(text.find(marker + " round 0 "), std::string::npos) << segment;
+        EXPECT_EQ(text.find(marker + " round 1 "), std::string::npos) << segment;
+    }
+}
+
+#ifdef ALBUM_HAVE_ZLIB
+TEST_F(LogRotationTest, RotatedSegmentsAreCompressed) {
+    Logger::getInstance()->flush();
+    LogRotationSettings settings;
+    settings.maxBytes = 1024;
+    settings.compress = true;
+    Logger::getInstance()->setRotation(settings);
+    logRounds(uniqueMarker("gzip"), 4);
+
+    auto segments = Logger::getInstance()->rotatedSegments();
+    ASSERT_FALSE(segments.empty());
+    for (const auto& segment : segments) {
+        EXPECT_EQ(segment.substr(segment.size() - 3), ".gz") << segment;
+    }
+}
+#endif
@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "manager.h"
+
+TEST(LatencyHistogramTest, BucketsCoverFullRangeContiguously) {
+    EXPECT_EQ(LatencyHistogram::bucketIndex(0), 0u);
+    EXPECT_EQ(LatencyHistogram::bucketIndex(31), 31u);
+    EXPECT_EQ(LatencyHistogram::bucketIndex(63), 63u);
+    EXPECT_EQ(LatencyHistogram::bucketIndex(UINT64_MAX), LatencyHistogram::BUCKET_COUNT - 1);
+    EXPECT_EQ(LatencyHistogram::bucketUpperBound(LatencyHistogram::BUCKET_COUNT - 1), UINT64_MAX);
+    for (std::size_t i = 1; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+        std::uint64_t firstValue = LatencyHistogram::bucketUpperBound(i - 1) + 1;
+        ASSERT_EQ(LatencyHistogram::bucketIndex(firstValue), i);
+        ASSERT_EQ(LatencyHistogram::bucketIndex(LatencyHistogram::bucketUpperBound(i)), i);
+    }
+}
+
+TEST(LatencyHistogramTest, PercentilesStayWithinBucketPrecision) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.percentile(50.0), 0u);
+    for (std::uint64_t v = 1; v <= 100000; ++v) {
+        histogram.record(v * 1000);
+    }
+    EXPECT_EQ(histogram.count(), 100000u);
+    EXPECT_EQ(histogram.max(), 100000000u);
+    auto within = [](std::uint64_t actual, double expected) {
+        return actual >= expected && actual <= expected * 1.04;
+    };
+    EXPECT_TRUE(within(histogram.percentile(50.0), 50000000.0)) << histogram.percentile(50.0);
+    EXPECT_TRUE(within(histogram.percentile(99.0), 99000000.0)) << histogram.percentile(99.0);
+    EXPECT_TRUE(within(histogram.percentile(99.9), 99900000.0)) << histogram.percentile(99.9);
+    EXPECT_EQ(histogram.percentile(100.0), histogram.max());
+
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.percentile(99.0), 0u);
+}
+
+TEST(MetricsRegistryTest, ConcurrentUpdatesAreNotLost) {
+    MetricCounter& counter = MetricsRegistry::instance().counter("test_concurrent_counter");
+    LatencyHistogram& histogram = MetricsRegistry::instance().histogram("test_concurrent_latency");
+    counter.reset();
+    histogram.reset();
+    EXPECT_EQ(&counter, &MetricsRegistry::instance().counter("test_concurrent_counter"));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&counter, &histogram, t] {
+            for (int i = 0; i < 10000; ++i) {
+                counter.add();
+                histogram.record(static_cast<std::uint64_t>(t * 10000 + i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(counter.value(), 40000u);
+    EXPECT_EQ(histogram.count(), 40000u);
+    EXPECT_EQ(histogram.max(), 39999u);
+}
+
+TEST(MetricsRegistryTest, InstrumentedSearchAppearsInDump) {
+    artistList artists;
+    artists.artList.push_back({"art1001", "Alpha", 0});
+    indexSet result;
+    LatencyHistogram& histogram = MetricsRegistry::instance().histogram("search_artist_by_name");
+    std::uint64_t before = histogram.count();
+    EXPECT_TRUE(searchArtistByName(artists, result, "al"));
+    EXPECT_EQ(histogram.count(), before + 1);
+
+    std::ostringstream out;
+    MetricsRegistry::instance().dump(out);
+    EXPECT_NE(out.str().find("search_artist_by_name"), std::string::npos);
+    EXPECT_NE(out.str().find("p999"), std::string::npos);
+}
+
+TEST(PrometheusExportTest, FormatsCountersGaugesAndSummaries) {
+    MetricsSnapshot snapshot;
+    snapshot.counters.emplace_back("command_execute_failures", 3);
+    snapshot.gauges.emplace_back("artist_tombstone_ratio", 0.25);
+    snapshot.latencies.push_back({"load_artists", 2, 3000000, 1000000, 2000000, 2000000, 2000000});
+
+    std::string text = formatPrometheusText(snapshot);
+    EXPECT_NE(text.find("# TYPE album_command_execute_failures_total counter\nalbum_command_execute_failures_total 3\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE album_artist_tombstone_ratio gauge\nalbum_artist_tombstone_ratio 0.25\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE album_load_artists_seconds summary\n"), std::string::npos);
+    EXPECT_NE(text.find("album_load_artists_seconds{quantile=\"0.5\"} 0.001\n"), std::string::npos);
+    EXPECT_NE(text.find("album_load_artists_seconds{quantile=\"0.999\"} 0.002\n"), std::string::npos);
+    EXPECT_NE(text.find("album_load_artists_seconds_sum 0.003\n"), std::string::npos);
+    EXPECT_NE(text.find("album_load_artists_seconds_count 2\n"), std::string::npos);
+}
+
+TEST(PrometheusExportTest, ExporterRewritesFileInBackground) {
+    const std::string path = "temp_metrics.prom";
+    std::filesystem::remove(path);
+    MetricsExportSettings settings;
+    settings.filePath = path;
+    settings.intervalSeconds = 1;
+    ASSERT_TRUE(MetricsExporter::instance().start(settings));
+    for (int i = 0; i < 50 && !std::filesystem::exists(path); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    MetricsExporter::instance().stop();
+    EXPECT_FALSE(MetricsExporter::instance().running());
+
+    std::ifstream in(path);
+    std::stringstream content;
+    content << in.rdbuf();
+    EXPECT_NE(content.str().find("# TYPE album_"), std::string::npos);
+#ifdef __linux__
+    EXPECT_NE(content.str().find("album_resident_memory_bytes "), std::string::npos);
+#endif
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+    std::filesystem::remove(path);
+}
+
+TEST(MemoryAccountingTest, CountingAllocatorTracksIndexStorage) {
+    MemoryCategoryStats& stats = memoryCategoryStats(MemoryCategory::ArtistIndex);
+    std::int64_t before = stats.liveBytes.load();
+    std::uint64_t allocationsBefore = stats.allocations.load();
+    {
+        artistList artists;
+        artists.artList.reserve(1000);
+        EXPECT_EQ(stats.liveBytes.load() - before, static_cast<std::int64_t>(1000 * sizeof(artistIndex)));
+        EXPECT_GE(stats.peakBytes.load(), stats.liveBytes.load());
+        EXPECT_EQ(stats.allocations.load(), allocationsBefore + 1);
+    }
+    EXPECT_EQ(stats.liveBytes.load(), before);
+}
+
+TEST(MemoryAccountingTest, BreakdownListsCategoriesAndStrings) {
+    artistList artists;
+    artists.artList.push_back({"art1001", std::string(40, 'n'), 0});
+    albumList albums;
+    std::ostringstream out;
+    MemoryProfiler::instance().writeBreakdown(out, artists, albums);
+    std::string text = out.str();
+    for (const char* name : {"artist_index", "album_index", "undo_history", "record_cache", "artist_index_strings"}) {
+        EXPECT_NE(text.find(name), std::string::npos) << name;
+    }
+    EXPECT_EQ(MetricsRegistry::instance().gauge("memory_artist_index_bytes").value(),
+              memoryCategoryStats(MemoryCategory::ArtistIndex).liveBytes.load());
+}
+
+#if ALBUM_TRACING
+TEST(TracingTest, SpansFromEveryThreadAppearInChromeTrace) {
+    clearTrace();
+    artistList artists;
+    artists.artList.push_back({"art1001", "Alpha", 0});
+    indexSet result;
+    searchArtistByName(artists, result, "al");
+    std::thread worker([] { ALBUM_TRACE_SCOPE("worker_span"); });
+    worker.join();
+    EXPECT_EQ(traceEventCount(), 2u);
+
+    std::ostringstream out;
+    ASSERT_TRUE(writeChromeTrace(out));
+    std::string json = out.str();
+    EXPECT_EQ(json.compare(0, 1, "{"), 0);
+    EXPECT_NE(json.find("\"traceEvents\":["), std::string::npos);
+    EXPECT_NE(json.find("{\"name\":\"search_artist_by_name\",\"cat\":\"album\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("{\"name\":\"worker_span\""), std::string::npos);
+    clearTrace();
+    EXPECT_EQ(traceEventCount(), 0u);
+}
+#endif
+
+TEST(PerfGateTest, RunRoundTripsThroughJson) {
+    PerfRun run;
+    run.label = "quote \" and \\ slash";
+    run.timestamp = "2024-05-01 12:00:00";
+    run.version = "1.2.0";
+    run.records = 100000;
+    run.series.push_back({"load_albums", {1500000.0, 1520000.5, 1490000.0}});
+    run.series.push_back({"search_album_by_title", {}});
+
+    std::stringstream buffer;
+    ASSERT_TRUE(writePerfRun(buffer, run));
+    PerfRun loaded;
+    ASSERT_TRUE(readPerfRun(buffer, loaded));
+    EXPECT_EQ(loaded.label, run.label);
+    EXPECT_EQ(loaded.timestamp, run.timestamp);
+    EXPECT_EQ(loaded.version, run.version);
+    EXPECT_EQ(loaded.records, run.records);
+    ASSERT_EQ(loaded.series.size(), 2u);
+    EXPECT_EQ(loaded.series[0].name, "load_albums");
+    EXPECT_EQ(loaded.series[0].samplesNs, run.series[0].samplesNs);
+    EXPECT_TRUE(loaded.series[1].samplesNs.empty());
+
+    std::istringstream notARun("[1, 2, 3]");
+    EXPECT_FALSE(readPerfRun(notARun, loaded));
+}
+
+TEST(PerfGateTest, VerdictsRequireSignificanceBeyondThreshold) {
+    PerfSeries baseline{"op", {100.0, 101.0, 99.0, 100.5, 99.5, 100.0}};
+    PerfSeries slower{"op", {130.0, 131.0, 129.0, 130.5, 129.5, 130.0}};
+    PerfSeries slightlySlower{"op", {105.0, 106.0, 104.0, 105.5, 104.5, 105.0}};
+    PerfSeries faster{"op", {70.0, 71.0, 69.0, 70.5, 69.5, 70.0}};
+    PerfSeries noisy{"op", {60.0, 200.0, 90.0, 180.0, 70.0, 190.0}};
+
+    PerfComparison regression = comparePerfSeries(baseline, slower);
+    EXPECT_EQ(regression.verdict, PerfVerdict::Regression);
+    EXPECT_NEAR(regression.deltaPercent, 30.0, 0.5);
+    EXPECT_LT(regression.ciLowPercent, regression.deltaPercent);
+    EXPECT_GT(regression.ciHighPercent, regression.deltaPercent);
+
+    EXPECT_EQ(comparePerfSeries(baseline, slightlySlower).verdict, PerfVerdict::Unchanged);
+    EXPECT_EQ(comparePerfSeries(baseline, faster).verdict, PerfVerdict::Improvement);
+    EXPECT_EQ(comparePerfSeries(baseline, noisy).verdict, PerfVerdict::Unchanged);
+    EXPECT_EQ(comparePerfSeries(baseline, PerfSeries{"op", {130.0}}).verdict, PerfVerdict::Insufficient);
+
+    PerfRun base;
+    base.series = {baseline};
+    PerfRun candidate;
+    candidate.series = {slower, PerfSeries{"new_op", {1.0, 2.0}}};
+    std::vector<PerfComparison> results = comparePerfRuns(base, candidate);
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].verdict, PerfVerdict::Regression);
+    EXPECT_EQ(results[1].name, "new_op");
+    EXPECT_EQ(results[1].verdict, PerfVerdict::Insufficient);
+}
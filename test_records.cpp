@@ -0,0 +1,507 @@
+#include <gtest/gtest.h>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include "manager.h"
+
+class RecordFormatTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tempArtistFile = "temp_records_artist.bin";
+        tempAlbumFile = "temp_records_album.bin";
+    }
+
+    void TearDown() override {
+        for (const auto& path : {tempArtistFile, tempAlbumFile}) {
+            std::filesystem::remove(path);
+            std::filesystem::remove(path + ".v1");
+        }
+    }
+
+    static ArtistFile makeArtist(int n) {
+        ArtistFile artFile{};
+        std::string id = "art" + std::to_string(1000 + n);
+        std::string name = "Artist " + std::to_string(n);
+        std::strncpy(artFile.artistIds, id.c_str(), 7);
+        std::strncpy(artFile.names, name.c_str(), 49);
+        artFile.genders = 'F';
+        std::strncpy(artFile.phones, "0911000000", 14);
+        std::strncpy(artFile.emails, "a@b.com", 49);
+        return artFile;
+    }
+
+    void flipByte(const std::string& path, long offset) {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekg(offset);
+        char c = 0;
+        file.get(c);
+        file.seekp(offset);
+        file.put(static_cast<char>(c ^ 0x5A));
+    }
+
+    std::string tempArtistFile;
+    std::string tempAlbumFile;
+};
+
+TEST_F(RecordFormatTest, NewFileGetsHeaderAndChecksummedSlots) {
+    std::fstream file;
+    openRecordFile(file, tempArtistFile, RecordKind::Artist);
+    long pos = 0;
+    ASSERT_TRUE(appendRecord(file, makeArtist(1), pos));
+    EXPECT_EQ(pos, RECORD_HEADER_SIZE);
+    ASSERT_TRUE(appendRecord(file, makeArtist(2), pos));
+    EXPECT_EQ(pos, RECORD_HEADER_SIZE + ARTIST_RECORD_SIZE);
+    file.close();
+
+    EXPECT_EQ(static_cast<long>(std::filesystem::file_size(tempArtistFile)), RECORD_HEADER_SIZE + 2 * ARTIST_RECORD_SIZE);
+    EXPECT_FALSE(isLegacyRecordFile(tempArtistFile));
+
+    openRecordFile(file, tempArtistFile, RecordKind::Artist);
+    ArtistFile loaded{};
+    EXPECT_EQ(readRecordAt(file, pos, loaded), RecordStatus::Ok);
+    EXPECT_STREQ(loaded.artistIds, "art1002");
+    EXPECT_EQ(readRecordAt(file, pos + ARTIST_RECORD_SIZE, loaded), RecordStatus::Missing);
+}
+
+TEST_F(RecordFormatTest, LegacyFileIsMigratedOnOpen) {
+    {
+        std::ofstream legacy(tempArtistFile, std::ios::binary);
+        for (int i = 0; i < 3; ++i) {
+            ArtistFile artFile = makeArtist(i);
+            legacy.write(reinterpret_cast<const char*>(&artFile), sizeof(artFile));
+        }
+    }
+    ASSERT_TRUE(isLegacyRecordFile(tempArtistFile));
+
+    std::fstream file;
+    openRecordFile(file, tempArtistFile, RecordKind::Artist);
+    EXPECT_EQ(recordCount(file, RecordKind::Artist), 3);
+    ArtistFile loaded{};
+    EXPECT_EQ(readRecordAt(file, RECORD_HEADER_SIZE + 2 * ARTIST_RECORD_SIZE, loaded), RecordStatus::Ok);
+    EXPECT_STREQ(loaded.names, "Artist 2");
+    file.close();
+
+    EXPECT_TRUE(std::filesystem::exists(tempArtistFile + ".v1"));
+    EXPECT_TRUE(scrubRecordFile(tempArtistFile, RecordKind::Artist).clean());
+}
+
+TEST_F(RecordFormatTest, OpenRejectsFileOfOtherKind) {
+    std::fstream file;
+    openRecordFile(file, tempArtistFile, RecordKind::Artist);
+    file.close();
+    std::fstream wrong;
+    EXPECT_THROW(openRecordFile(wrong, tempArtistFile, RecordKind::Album), FileException);
+}
+
+TEST_F(RecordFormatTest, ScrubReportsCorruptOffsetsAcrossWorkers) {
+    std::fstream file;
+    openRecordFile(file, tempArtistFile, RecordKind::Artist);
+    long pos = 0;
+    for (int i = 0; i < 20000; ++i) {
+        ASSERT_TRUE(appendRecord(file, makeArtist(i % 9000), pos));
+    }
+    file.close();
+
+    long first = RECORD_HEADER_SIZE + 17 * ARTIST_RECORD_SIZE;
+    long second = RECORD_HEADER_SIZE + 15000 * ARTIST_RECORD_SIZE;
+    flipByte(tempArtistFile, first + 10);
+    flipByte(tempArtistFile, second + ARTIST_RECORD_SIZE - 1);
+
+    ScrubReport report = scrubRecordFile(tempArtistFile, RecordKind::Artist, 4);
+    EXPECT_EQ(report.records, 20000);
+    ASSERT_EQ(report.issues.size(), 2u);
+    EXPECT_EQ(report.issues[0].offset, first);
+    EXPECT_EQ(report.issues[1].offset, second);
+}
+
+TEST_F(RecordFormatTest, ScrubReportsTruncatedTail) {
+    std::fstream file;
+    openRecordFile(file, tempAlbumFile, RecordKind::Album);
+    AlbumFile albFile{};
+    std::strncpy(albFile.albumIds, "alb2000", 7);
+    long pos = 0;
+    ASSERT_TRUE(appendRecord(file, albFile, pos));
+    file.close();
+    {
+        std::ofstream tail(tempAlbumFile, std::ios::binary | std::ios::app);
+        tail.write("xyz", 3);
+    }
+
+    ScrubReport report = scrubRecordFile(tempAlbumFile, RecordKind::Album);
+    EXPECT_EQ(report.records, 1);
+    ASSERT_EQ(report.issues.size(), 1u);
+    EXPECT_EQ(report.issues[0].offset, RECORD_HEADER_SIZE + ALBUM_RECORD_SIZE);
+
+    openRecordFile(file, tempAlbumFile, RecordKind::Album);
+    ASSERT_TRUE(appendRecord(file, albFile, pos));
+    EXPECT_EQ(pos, RECORD_HEADER_SIZE + ALBUM_RECORD_SIZE);
+}
+
+TEST_F(RecordFormatTest, RepositoryLoadSkipsCorruptRecords) {
+    FileArtistRepository repo(tempArtistFile);
+    ASSERT_TRUE(repo.saveArtist(Artist("art1000", "First", 'M', "0911000000", "a@b.com")));
+    ASSERT_TRUE(repo.saveArtist(Artist("art1001", "Second", 'F', "0911000001", "c@d.com")));
+    flipByte(tempArtistFile, RECORD_HEADER_SIZE + 9);
+
+    artistList artists;
+    indexSet deleted;
+    FileArtistRepository reader(tempArtistFile);
+    EXPECT_TRUE(reader.loadArtists(artists, deleted));
+    ASSERT_EQ(artists.artList.size(), 1u);
+    EXPECT_EQ(artists.artList[0].artistId, "art1001");
+    EXPECT_EQ(artists.artList[0].pos, RECORD_HEADER_SIZE + ARTIST_RECORD_SIZE);
+    EXPECT_TRUE(deleted.indexes.empty());
+}
+
+TEST_F(RecordFormatTest, StagedRestoreCopiesAndIndexesInOnePass) {
+    std::fstream file;
+    openRecordFile(file, tempArtistFile, RecordKind::Artist);
+    long pos = 0;
+    ASSERT_TRUE(appendRecord(file, makeArtist(1), pos));
+    ASSERT_TRUE(appendRecord(file, ArtistFile{"-1", "", 'N', "", ""}, pos));
+    ASSERT_TRUE(appendRecord(file, makeArtist(3), pos));
+    file.close();
+
+    std::string staged = tempAlbumFile + ".restore";
+    artistList artists;
+    indexSet deleted;
+    ASSERT_TRUE(stageRestoredRecords(tempArtistFile, staged, artists, deleted));
+    EXPECT_EQ(std::filesystem::file_size(staged), std::filesystem::file_size(tempArtistFile));
+    ASSERT_EQ(artists.artList.size(), 2u);
+    EXPECT_EQ(artists.artList[1].artistId, "art1003");
+    EXPECT_EQ(artists.artList[1].pos, RECORD_HEADER_SIZE + 2 * ARTIST_RECORD_SIZE);
+    ASSERT_EQ(deleted.indexes.size(), 1u);
+    EXPECT_EQ(deleted.indexes[0], RECORD_HEADER_SIZE + ARTIST_RECORD_SIZE);
+    EXPECT_TRUE(scrubRecordFile(staged, RecordKind::Artist).clean());
+    std::filesystem::remove(staged);
+}
+
+TEST_F(RecordFormatTest, StagedRestoreConvertsLegacySnapshot) {
+    {
+        std::ofstream legacy(tempArtistFile, std::ios::binary);
+        for (int i = 0; i < 2; ++i) {
+            ArtistFile artFile = makeArtist(i);
+            legacy.write(reinterpret_cast<const char*>(&artFile), sizeof(artFile));
+        }
+    }
+    std::string staged = tempAlbumFile + ".restore";
+    artistList artists;
+    indexSet deleted;
+    ASSERT_TRUE(stageRestoredRecords(tempArtistFile, staged, artists, deleted));
+    EXPECT_TRUE(isLegacyRecordFile(tempArtistFile));
+    EXPECT_FALSE(std::filesystem::exists(staged + ".legacy"));
+    EXPECT_EQ(artists.artList.size(), 2u);
+    EXPECT_EQ(static_cast<long>(std::filesystem::file_size(staged)), RECORD_HEADER_SIZE + 2 * ARTIST_RECORD_SIZE);
+    std::filesystem::remove(staged);
+}
+
+TEST_F(RecordFormatTest, StagedSwapPutsBothFilesBackWhenOneMoveFails) {
+    auto writeText = [](const std::string& path, const std::string& text) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << text;
+    };
+    auto readText = [](const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    };
+    writeText(tempArtistFile, "old artists");
+    writeText(tempAlbumFile, "old albums");
+    std::string artistStaged = tempArtistFile + ".restore";
+    std::string albumStaged = tempAlbumFile + ".restore";
+    writeText(artistStaged, "new artists");
+
+    // The album copy was never staged, so its move fails after the artist swap succeeded.
+    std::string error;
+    EXPECT_FALSE(swapInStagedFiles({{artistStaged, tempArtistFile}, {albumStaged, tempAlbumFile}}, error));
+    EXPECT_FALSE(error.empty());
+    EXPECT_EQ(readText(tempArtistFile), "old artists");
+    EXPECT_EQ(readText(tempAlbumFile), "old albums");
+    EXPECT_FALSE(std::filesystem::exists(tempArtistFile + ".prev"));
+    EXPECT_FALSE(std::filesystem::exists(tempAlbumFile + ".prev"));
+
+    writeText(artistStaged, "new artists");
+    writeText(albumStaged, "new albums");
+    ASSERT_TRUE(swapInStagedFiles({{artistStaged, tempArtistFile}, {albumStaged, tempAlbumFile}}, error));
+    EXPECT_EQ(readText(tempArtistFile), "new artists");
+    EXPECT_EQ(readText(tempAlbumFile), "new albums");
+    EXPECT_FALSE(std::filesystem::exists(artistStaged));
+    EXPECT_FALSE(std::filesystem::exists(tempAlbumFile + ".prev"));
+}
+
+TEST_F(RecordFormatTest, SyntheticCatalogIsDeterministicAndLoadable) {
+    CatalogGeneratorSettings settings;
+    settings.seed = 7;
+    settings.artists = 200;
+    settings.albums = 1000;
+    settings.tombstoneRatio = 0.2;
+    CatalogGeneratorReport report;
+    ASSERT_TRUE(generateSyntheticCatalog(tempArtistFile, tempAlbumFile, settings, &report));
+    EXPECT_EQ(report.artistSlots, 250);
+    EXPECT_EQ(report.artistTombstones, 50);
+    EXPECT_EQ(report.albumSlots, 1250);
+    EXPECT_EQ(report.albumTombstones, 250);
+    EXPECT_EQ(report.bytesWritten, std::filesystem::file_size(tempArtistFile) + std::filesystem::file_size(tempAlbumFile));
+    EXPECT_TRUE(scrubRecordFile(tempArtistFile, RecordKind::Artist).clean());
+    EXPECT_TRUE(scrubRecordFile(tempAlbumFile, RecordKind::Album).clean());
+
+    std::ifstream firstRun(tempAlbumFile, std::ios::binary);
+    std::string firstBytes((std::istreambuf_iterator<char>(firstRun)), std::istreambuf_iterator<char>());
+    firstRun.close();
+    ASSERT_TRUE(generateSyntheticCatalog(tempArtistFile, tempAlbumFile, settings));
+    std::ifstream secondRun(tempAlbumFile, std::ios::binary);
+    std::string secondBytes((std::istreambuf_iterator<char>(secondRun)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(firstBytes, secondBytes);
+
+    std::string staged = tempAlbumFile + ".restore";
+    albumList albums;
+    indexSet deleted;
+    ASSERT_TRUE(stageRestoredRecords(tempAlbumFile, staged, albums, deleted));
+    EXPECT_EQ(albums.albList.size(), 1000u);
+    EXPECT_EQ(deleted.indexes.size(), 250u);
+    std::map<std::string, int> perArtist;
+    for (const auto& album : albums.albList) {
+        ++perArtist[album.artistId];
+    }
+    int busiest = 0;
+    for (const auto& entry : perArtist) {
+        busiest = std::max(busiest, entry.second);
+    }
+    // Zipf with s = 1.1 over 200 artists gives the top artist roughly a sixth of all albums.
+    EXPECT_GT(busiest, 100);
+    std::filesystem::remove(staged);
+}
+
+TEST_F(RecordFormatTest, RecordIdsStayUniquePastFourDigits) {
+    for (int number : {1000, 9999, 10000, 10001, 1000000, MAX_RECORD_ID_NUMBER}) {
+        std::string id = intToString(number, "alb");
+        EXPECT_EQ(id.size(), 7u) << number;
+        EXPECT_EQ(stringToInt(id), number) << id;
+    }
+    EXPECT_EQ(intToString(10000, "art"), "artA000");
+
+    CatalogGeneratorSettings settings;
+    settings.artists = 9500;
+    settings.albums = 12000;
+    ASSERT_TRUE(generateSyntheticCatalog(tempArtistFile, tempAlbumFile, settings));
+    std::string staged = tempAlbumFile + ".restore";
+    albumList albums;
+    indexSet deleted;
+    ASSERT_TRUE(stageRestoredRecords(tempAlbumFile, staged, albums, deleted));
+    std::filesystem::remove(staged);
+    std::set<std::string> ids;
+    for (const auto& album : albums.albList) {
+        ids.insert(album.albumId);
+        EXPECT_EQ(album.artistId.size(), 7u);
+    }
+    EXPECT_EQ(ids.size(), 12000u);
+    EXPECT_EQ(stringToInt(*ids.rbegin()), 2000 + 12000 - 1);
+
+    settings.albums = static_cast<std::int64_t>(MAX_RECORD_ID_NUMBER);
+    EXPECT_FALSE(generateSyntheticCatalog(tempArtistFile, tempAlbumFile, settings));
+}
+
+TEST_F(RecordFormatTest, RecordCacheServesRepeatReadsUntilTheSlotIsWritten) {
+    RecordCache& cache = RecordCache::instance();
+    cache.setCapacity(2);
+    std::fstream file;
+    openRecordFile(file, tempArtistFile, RecordKind::Artist);
+    long first = 0;
+    long second = 0;
+    long third = 0;
+    ArtistFile dirty = makeArtist(1);
+    dirty.names[2] = '\x07';
+    ASSERT_TRUE(appendRecord(file, dirty, first));
+    ASSERT_TRUE(appendRecord(file, makeArtist(2), second));
+    ASSERT_TRUE(appendRecord(file, makeArtist(3), third));
+
+    const RecordCacheStats base = cache.stats();
+    ArtistFile record{};
+    ASSERT_EQ(cache.read(file, first, record), RecordStatus::Ok);
+    EXPECT_STREQ(record.names, "Ar ist 1");
+    ASSERT_EQ(cache.read(file, first, record), RecordStatus::Ok);
+    EXPECT_STREQ(record.names, "Ar ist 1");
+    RecordCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.misses - base.misses, 1u);
+    EXPECT_EQ(stats.hits - base.hits, 1u);
+
+    // The third distinct slot evicts the least recently used one (second).
+    cache.read(file, second, record);
+    cache.read(file, first, record);
+    cache.read(file, third, record);
+    stats = cache.stats();
+    EXPECT_EQ(stats.entries, 2u);
+    EXPECT_EQ(stats.evictions - base.evictions, 1u);
+    cache.read(file, first, record);
+    EXPECT_EQ(cache.stats().hits - base.hits, 3u);
+
+    // Writing a slot drops exactly that slot.
+    ASSERT_TRUE(writeRecordAt(file, first, makeArtist(9)));
+    stats = cache.stats();
+    EXPECT_EQ(stats.invalidations - base.invalidations, 1u);
+    EXPECT_EQ(stats.entries, 1u);
+    ASSERT_EQ(cache.read(file, first, record), RecordStatus::Ok);
+    EXPECT_STREQ(record.names, "Artist 9");
+    cache.read(file, third, record);
+    EXPECT_EQ(cache.stats().hits - base.hits, 4u);
+
+    // Corrupt slots are never cached.
+    file.close();
+    flipByte(tempArtistFile, second + 10);
+    file.open(tempArtistFile, std::ios::binary | std::ios::in | std::ios::out);
+    EXPECT_EQ(cache.read(file, second, record), RecordStatus::Corrupt);
+    EXPECT_EQ(cache.read(file, second, record), RecordStatus::Corrupt);
+    EXPECT_EQ(cache.stats().entries, 2u);
+    file.close();
+
+    cache.setCapacity(RECORD_CACHE_DEFAULT_ENTRIES);
+    EXPECT_EQ(cache.stats().entries, 0u);
+}
+
+TEST_F(RecordFormatTest, ResetToDefaultsRestoresRecordCacheSize) {
+    const std::string configFile = "temp_records_config.json";
+    {
+        std::ofstream config(configFile);
+        config << "{\n  \"recordCacheEntries\": 128\n}\n";
+    }
+    AppConfig::instance().loadFromFile(configFile);
+    EXPECT_EQ(AppConfig::instance().settings().recordCacheEntries, 128);
+
+    AppConfig::instance().resetToDefaults();
+    EXPECT_EQ(AppConfig::instance().settings().recordCacheEntries, static_cast<int>(RECORD_CACHE_DEFAULT_ENTRIES));
+    std::filesystem::remove(configFile);
+}
+
+TEST_F(RecordFormatTest, RecordCacheDoesNotServeOneFilesSlotForAnother) {
+    const std::string otherFile = "temp_records_artist_other.bin";
+    long pos = 0;
+    {
+        std::fstream file;
+        openRecordFile(file, tempArtistFile, RecordKind::Artist);
+        ASSERT_TRUE(appendRecord(file, makeArtist(1), pos));
+        std::fstream other;
+        openRecordFile(other, otherFile, RecordKind::Artist);
+        long otherPos = 0;
+        ASSERT_TRUE(appendRecord(other, makeArtist(2), otherPos));
+        ASSERT_EQ(otherPos, pos);
+    }
+
+    artistList artists;
+    indexSet deleted;
+    ASSERT_TRUE(FileArtistRepository(tempArtistFile).loadArtists(artists, deleted));
+    std::ifstream first(tempArtistFile, std::ios::binary);
+    ArtistFile record{};
+    ASSERT_EQ(RecordCache::instance().read(first, pos, record), RecordStatus::Ok);
+    EXPECT_STREQ(record.names, "Artist 1");
+
+    // Loading the other file of the same kind must not leave the first file's slot cached.
+    artistList otherArtists;
+    ASSERT_TRUE(FileArtistRepository(otherFile).loadArtists(otherArtists, deleted));
+    std::ifstream second(otherFile, std::ios::binary);
+    ASSERT_EQ(RecordCache::instance().read(second, pos, record), RecordStatus::Ok);
+    EXPECT_STREQ(record.names, "Artist 2");
+
+    first.close();
+    second.close();
+    std::filesystem::remove(otherFile);
+}
+
+TEST(RecordDecoderTest, SimdAndScalarPathsAgreeOnEveryByte) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> byte(0, 255);
+    for (int round = 0; round < 2000; ++round) {
+        AlbumFile raw;
+        auto* bytes = reinterpret_cast<unsigned char*>(&raw);
+        for (std::size_t i = 0; i < sizeof(raw); ++i) {
+            int value = byte(rng);
+            // Mostly printable text with scattered NULs and control or high bytes.
+            bytes[i] = static_cast<unsigned char>(value < 200 ? 0x20 + value % 0x5F : value < 225 ? 0 : value);
+        }
+        AlbumFile scalar = raw;
+        AlbumFile simd = raw;
+        AlbumFieldLengths scalarLengths;
+        AlbumFieldLengths simdLengths;
+        decodeRecord(scalar, scalarLengths, RecordDecoderPath::Scalar);
+        decodeRecord(simd, simdLengths, RecordDecoderPath::Simd);
+        ASSERT_EQ(std::memcmp(&scalar, &simd, sizeof(scalar)), 0) << "round " << round;
+        ASSERT_EQ(scalarLengths.title, simdLengths.title);
+        ASSERT_EQ(scalarLengths.path, simdLengths.path);
+        EXPECT_EQ(simdLengths.albumId, std::strlen(simd.albumIds));
+        EXPECT_EQ(simdLengths.artistIdRef, std::strlen(simd.artistIdRefs));
+        EXPECT_EQ(simdLengths.title, std::strlen(simd.titles));
+        EXPECT_EQ(simdLengths.recordFormat, std::strlen(simd.recordFormats));
+        EXPECT_EQ(simdLengths.datePublished, std::strlen(simd.datePublished));
+        EXPECT_EQ(simdLengths.path, std::strlen(simd.paths));
+        for (std::size_t i = 0; i < simdLengths.title; ++i) {
+            ASSERT_TRUE(std::isprint(static_cast<unsigned char>(simd.titles[i])));
+        }
+
+        // Measuring leaves the record alone and finds the same ends as decoding.
+        AlbumFieldLengths measured;
+        AlbumFile untouched = raw;
+        measureRecord(untouched, measured);
+        EXPECT_EQ(std::memcmp(&untouched, &raw, sizeof(raw)), 0);
+        EXPECT_EQ(measured.title, simdLengths.title);
+        EXPECT_EQ(measured.path, simdLengths.path);
+    }
+
+    ArtistFile artist{};
+    std::strncpy(artist.artistIds, "art1001", sizeof(artist.artistIds) - 1);
+    std::memset(artist.names, 'n', sizeof(artist.names));
+    artist.names[3] = '\x1b';
+    artist.genders = '\0';
+    std::strncpy(artist.emails, "a\x7f@b.com", sizeof(artist.emails) - 1);
+    ArtistFieldLengths lengths;
+    decodeRecord(artist, lengths);
+    EXPECT_EQ(lengths.artistId, 7u);
+    EXPECT_EQ(lengths.name, sizeof(artist.names) - 1);
+    EXPECT_EQ(artist.names[3], ' ');
+    EXPECT_EQ(artist.genders, ' ');
+    EXPECT_EQ(lengths.phone, 0u);
+    EXPECT_STREQ(artist.emails, "a @b.com");
+}
+
+TEST(RecordDecoderTest, FieldTablesCoverTheRecordsAndRoundTripText) {
+    std::size_t artistBytes = 0;
+    for (const auto& field : ARTIST_FIELDS) {
+        EXPECT_EQ(field.offset, artistBytes) << field.name;
+        artistBytes += field.size;
+    }
+    EXPECT_EQ(artistBytes, sizeof(ArtistFile));
+    std::size_t albumBytes = 0;
+    for (const auto& field : ALBUM_FIELDS) {
+        EXPECT_EQ(field.offset, albumBytes) << field.name;
+        albumBytes += field.size;
+    }
+    EXPECT_EQ(albumBytes, sizeof(AlbumFile));
+
+    AlbumFile album;
+    std::memset(&album, 'x', sizeof(album));
+    setRecordField(album, ALBUM_FIELD_ID, "alb1000");
+    setRecordField(album, ALBUM_FIELD_ARTIST_ID, "art1000-too-long");
+    setRecordField(album, ALBUM_FIELD_TITLE, std::string(200, 't'));
+    setRecordField(album, ALBUM_FIELD_RECORD_FORMAT, "");
+    setRecordField(album, ALBUM_FIELD_DATE_PUBLISHED, "01/02/2003");
+    setRecordField(album, ALBUM_FIELD_PATH, "C:\\Music");
+    std::vector<std::string> visited;
+    forEachRecordField(album, [&](std::size_t field, const RecordFieldSpec& spec, const char* text, std::size_t length) {
+        EXPECT_EQ(&spec, &ALBUM_FIELDS[field]);
+        visited.emplace_back(text, length);
+    });
+    ASSERT_EQ(visited.size(), static_cast<std::size_t>(ALBUM_FIELD_COUNT));
+    EXPECT_EQ(visited[ALBUM_FIELD_ARTIST_ID], "art1000");
+    EXPECT_EQ(visited[ALBUM_FIELD_TITLE], std::string(sizeof(album.titles) - 1, 't'));
+    EXPECT_EQ(visited[ALBUM_FIELD_RECORD_FORMAT], "");
+    EXPECT_EQ(visited[ALBUM_FIELD_PATH], "C:\\Music");
+    EXPECT_EQ(album.paths[sizeof(album.paths) - 1], '\0');
+
+    ArtistFile artist{};
+    char gender = 'F';
+    setRecordField(artist, ARTIST_FIELD_GENDER, &gender, 1);
+    EXPECT_EQ(artist.genders, 'F');
+    EXPECT_EQ(artist.phones[0], '\0');
+}